@@ -0,0 +1,241 @@
+// bench_report.h Header File -> Machine readable benchmark results (JSON/CSV) shared by the benchmarks
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+// Header only: the Makefile links every *_bench.cpp on its own
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace std;
+
+// Struct to hold the result of one benchmark case
+struct BENCH_RECORD
+{
+    string name;            // "<stage>/<what>/<implementation>", e.g. "convert/bayer_rg8_to_bgr8/reference"
+    uint32_t width;
+    uint32_t height;
+    uint64_t iterations;
+    double bytes_per_op;    // Frame bytes processed per iteration (input side), 0 if not meaningful
+    double total_seconds;   // Wall time of all iterations, including a final flush where there is one
+    double mean_ns;         // Per iteration
+    double p50_ns;
+    double p99_ns;
+    double max_ns;
+};
+
+// Collects BENCH_RECORDs, prints one line per record and writes them as JSON or CSV for regression tracking
+class BENCH_REPORT
+{
+    private:
+        string suite;
+        vector<BENCH_RECORD> records;
+
+        static string escape_json(const string& text);
+
+    public:
+        explicit BENCH_REPORT(const string& suite_name);
+
+        void add(const BENCH_RECORD& record);
+        const vector<BENCH_RECORD>& get_records() const;
+
+        int write_json(const string& path) const;
+        int write_csv(const string& path) const;
+};
+
+/**
+ * Returns a percentile of a sorted sample.
+ * @param sorted: Samples in ascending order.
+ * @param percent: The percentile (0-100).
+ * @return The sample at the percentile, 0 if there are no samples.
+ */
+inline double bench_percentile(const vector<double>& sorted, double percent)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(percent / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+/**
+ * Builds a record from per-iteration times.
+ * @param name: Case name.
+ * @param width: Frame width.
+ * @param height: Frame height.
+ * @param samples_ns: Time of every iteration in nanoseconds (sorted in place).
+ * @param bytes_per_op: Frame bytes per iteration.
+ * @param total_seconds: Wall time of the whole run, 0 -> sum of the samples.
+ * @return The record.
+ */
+inline BENCH_RECORD make_bench_record(const string& name, uint32_t width, uint32_t height, vector<double>& samples_ns, double bytes_per_op, double total_seconds)
+{
+    BENCH_RECORD record = {name, width, height, samples_ns.size(), bytes_per_op, total_seconds, 0.0, 0.0, 0.0, 0.0};
+
+    double sum_ns = 0.0;
+    for (double sample : samples_ns)
+    {
+        sum_ns += sample;
+    }
+    sort(samples_ns.begin(), samples_ns.end());
+
+    if (!samples_ns.empty())
+    {
+        record.mean_ns = sum_ns / samples_ns.size();
+        record.p50_ns = bench_percentile(samples_ns, 50.0);
+        record.p99_ns = bench_percentile(samples_ns, 99.0);
+        record.max_ns = samples_ns.back();
+    }
+    if (record.total_seconds <= 0.0)
+    {
+        record.total_seconds = sum_ns / 1e9;
+    }
+    return record;
+}
+
+/**
+ * Constructor for the BENCH_REPORT class.
+ * @param suite_name: Name of the benchmark binary, written into the files.
+ */
+inline BENCH_REPORT::BENCH_REPORT(const string& suite_name) : suite(suite_name)
+{
+}
+
+/**
+ * Adds a record and prints it.
+ * @param record: The record.
+ */
+inline void BENCH_REPORT::add(const BENCH_RECORD& record)
+{
+    records.push_back(record);
+
+    double mb_per_s = record.total_seconds > 0.0 ? record.bytes_per_op * record.iterations / record.total_seconds / 1e6 : 0.0;
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+
+    cout << left << setw(44) << record.name << right
+         << setw(6) << record.width << "x" << left << setw(6) << record.height << right
+         << fixed << setprecision(1)
+         << setw(12) << record.mean_ns / 1000.0 << " us mean"
+         << setw(12) << record.p50_ns / 1000.0 << " us p50"
+         << setw(12) << record.p99_ns / 1000.0 << " us p99"
+         << setw(12) << record.max_ns / 1000.0 << " us max";
+    if (mb_per_s > 0.0)
+    {
+        cout << setw(10) << mb_per_s << " MB/s";
+    }
+    cout << endl;
+
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+inline const vector<BENCH_RECORD>& BENCH_REPORT::get_records() const
+{
+    return records;
+}
+
+inline string BENCH_REPORT::escape_json(const string& text)
+{
+    string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/**
+ * Writes the records with the machine they ran on as JSON.
+ * @param path: Output file.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int BENCH_REPORT::write_json(const string& path) const
+{
+    ofstream file(path);
+    if (!file.is_open())
+    {
+        cerr << "[Bench] Unable to open " << path << endl;
+        return -1;
+    }
+
+    char host_name[256] = {0};
+    gethostname(host_name, sizeof(host_name) - 1);
+
+    time_t now = time(nullptr);
+    char time_text[32];
+    strftime(time_text, sizeof(time_text), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    file << "{\n"
+         << "  \"suite\": \"" << escape_json(suite) << "\",\n"
+         << "  \"time\": \"" << time_text << "\",\n"
+         << "  \"host\": \"" << escape_json(host_name) << "\",\n"
+         << "  \"cpus\": " << thread::hardware_concurrency() << ",\n"
+         << "  \"compiler\": \"" << escape_json(__VERSION__) << "\",\n"
+         << "  \"results\": [\n";
+
+    file << fixed << setprecision(1);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const BENCH_RECORD& record = records[i];
+        double mb_per_s = record.total_seconds > 0.0 ? record.bytes_per_op * record.iterations / record.total_seconds / 1e6 : 0.0;
+
+        file << "    {\"name\": \"" << escape_json(record.name) << "\", \"width\": " << record.width << ", \"height\": " << record.height
+             << ", \"iterations\": " << record.iterations << ", \"bytes_per_op\": " << record.bytes_per_op
+             << ", \"total_s\": " << setprecision(6) << record.total_seconds << setprecision(1)
+             << ", \"mean_ns\": " << record.mean_ns << ", \"p50_ns\": " << record.p50_ns << ", \"p99_ns\": " << record.p99_ns
+             << ", \"max_ns\": " << record.max_ns << ", \"mb_per_s\": " << mb_per_s << "}"
+             << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+
+    return file.good() ? 0 : -1;
+}
+
+/**
+ * Writes the records as CSV, one line per record with a header line.
+ * @param path: Output file.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int BENCH_REPORT::write_csv(const string& path) const
+{
+    ofstream file(path);
+    if (!file.is_open())
+    {
+        cerr << "[Bench] Unable to open " << path << endl;
+        return -1;
+    }
+
+    file << "suite,name,width,height,iterations,bytes_per_op,total_s,mean_ns,p50_ns,p99_ns,max_ns,mb_per_s\n";
+    file << fixed;
+    for (const BENCH_RECORD& record : records)
+    {
+        double mb_per_s = record.total_seconds > 0.0 ? record.bytes_per_op * record.iterations / record.total_seconds / 1e6 : 0.0;
+
+        file << suite << "," << record.name << "," << record.width << "," << record.height << "," << record.iterations << ","
+             << setprecision(0) << record.bytes_per_op << "," << setprecision(6) << record.total_seconds << "," << setprecision(1)
+             << record.mean_ns << "," << record.p50_ns << "," << record.p99_ns << "," << record.max_ns << "," << mb_per_s << "\n";
+    }
+
+    return file.good() ? 0 : -1;
+}
+
+#endif // BENCH_REPORT_H
@@ -0,0 +1,750 @@
+// Description: Per-frame cost of the capture pipeline stages (grab, convert, encode, file name, handoff, disk write), alone and end to end
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef WITH_SPINNAKER
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+#endif
+
+#ifdef WITH_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+#include "bench_report.h"
+#include "command_line.h"
+#include "frame_format.h"
+#include "frame_writer.h"
+#include "synthetic_camera.h"
+
+using namespace std;
+
+#ifdef WITH_SPINNAKER
+using namespace Spinnaker;
+#endif
+
+// Struct to hold the options shared by every case
+struct PIPELINE_BENCH_OPTIONS
+{
+    string folder_path;             // Disk and end-to-end cases write here
+    string filter;                  // Only cases whose name contains this
+    unsigned int iterations;        // Micro benchmarks
+    unsigned int frames;            // Disk and end-to-end cases
+    unsigned int warmup;
+    FRAME_WRITER_BACKEND writer_backend;
+    bool fsync_each;                // disk/raw/write_sync: fdatasync every file
+};
+
+// Struct to hold one frame size and the synthetic frames used at it
+struct PIPELINE_BENCH_FRAMES
+{
+    uint32_t width;
+    uint32_t height;
+    vector<uint8_t> mono8;
+    vector<uint8_t> bayer;
+    vector<uint8_t> bgr8;           // bayer, debayered by the reference converter
+};
+
+/**
+ * Checks whether a case should run.
+ * @param options: The options.
+ * @param name: Case name.
+ * @return true if the case matches --filter.
+ */
+static bool is_selected(const PIPELINE_BENCH_OPTIONS& options, const string& name)
+{
+    return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+/**
+ * Times a case: warmup iterations, then one sample per iteration.
+ * @param name: Case name.
+ * @param frames: Frame size.
+ * @param iterations: Timed iterations.
+ * @param warmup: Untimed iterations first.
+ * @param bytes_per_op: Frame bytes per iteration.
+ * @param work: Called with the iteration number.
+ * @return The record.
+ */
+template <class WORK>
+static BENCH_RECORD time_case(const string& name, const PIPELINE_BENCH_FRAMES& frames, unsigned int iterations, unsigned int warmup, double bytes_per_op, WORK work)
+{
+    for (unsigned int i = 0; i < warmup; i++)
+    {
+        work(i);
+    }
+
+    vector<double> samples_ns;
+    samples_ns.reserve(iterations);
+    for (unsigned int i = 0; i < iterations; i++)
+    {
+        auto start_time = chrono::steady_clock::now();
+        work(warmup + i);
+        samples_ns.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - start_time).count());
+    }
+
+    return make_bench_record(name, frames.width, frames.height, samples_ns, bytes_per_op, 0.0);
+}
+
+/**
+ * Mono8 to Mono16 as the capture tools store it (the 8 bit value in the high byte).
+ * @param source: Mono8 pixels.
+ * @param destination: Receives width * height 16 bit pixels.
+ * @param pixel_count: Number of pixels.
+ */
+static void convert_mono8_to_mono16(const uint8_t* source, uint16_t* destination, size_t pixel_count)
+{
+    for (size_t i = 0; i < pixel_count; i++)
+    {
+        destination[i] = static_cast<uint16_t>(source[i] << 8);
+    }
+}
+
+/**
+ * Bilinear BayerRG8 (RGGB) to BGR8, the reference for ImageProcessor's debayering. Edges repeat the nearest pixel.
+ * @param source: Bayer pixels.
+ * @param destination: Receives width * height * 3 bytes.
+ * @param width: Width in pixels.
+ * @param height: Height in pixels.
+ */
+static void convert_bayer_rg8_to_bgr8(const uint8_t* source, uint8_t* destination, uint32_t width, uint32_t height)
+{
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const uint8_t* row = source + static_cast<size_t>(y) * width;
+        const uint8_t* up = source + static_cast<size_t>(y > 0 ? y - 1 : y + 1) * width;
+        const uint8_t* down = source + static_cast<size_t>(y + 1 < height ? y + 1 : y - 1) * width;
+        uint8_t* out = destination + static_cast<size_t>(y) * width * 3;
+        bool red_row = (y & 1) == 0;
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint32_t left = x > 0 ? x - 1 : x + 1;
+            uint32_t right = x + 1 < width ? x + 1 : x - 1;
+            int center = row[x];
+            int cross = (up[x] + down[x] + row[left] + row[right] + 2) >> 2;
+            int diagonal = (up[left] + up[right] + down[left] + down[right] + 2) >> 2;
+            int horizontal = (row[left] + row[right] + 1) >> 1;
+            int vertical = (up[x] + down[x] + 1) >> 1;
+            int red, green, blue;
+
+            if (red_row)
+            {
+                if ((x & 1) == 0) { red = center; green = cross; blue = diagonal; }          // R
+                else { red = horizontal; green = center; blue = vertical; }                  // G on a red row
+            }
+            else
+            {
+                if ((x & 1) == 0) { red = vertical; green = center; blue = horizontal; }     // G on a blue row
+                else { red = diagonal; green = cross; blue = center; }                       // B
+            }
+
+            out[x * 3] = static_cast<uint8_t>(blue);
+            out[x * 3 + 1] = static_cast<uint8_t>(green);
+            out[x * 3 + 2] = static_cast<uint8_t>(red);
+        }
+    }
+}
+
+/**
+ * Builds the image file name like the infinity capture loop does (ostringstream per frame).
+ * @param folder_path: The folder.
+ * @param image_count: Frame counter.
+ * @param elapsed_seconds: Seconds since the start.
+ * @return The file name.
+ */
+static string make_filename_stream(const string& folder_path, int image_count, long elapsed_seconds)
+{
+    ostringstream filename;
+    filename << folder_path << "image_" << image_count + 1 << "_" << elapsed_seconds / 60 << ":" << elapsed_seconds % 60 << ".raw";
+    return filename.str();
+}
+
+/**
+ * Same file name with snprintf into a stack buffer.
+ * @param buffer: Receives the file name.
+ * @param size: Size of buffer.
+ * @param folder_path: The folder.
+ * @param image_count: Frame counter.
+ * @param elapsed_seconds: Seconds since the start.
+ */
+static void make_filename_printf(char* buffer, size_t size, const string& folder_path, int image_count, long elapsed_seconds)
+{
+    snprintf(buffer, size, "%simage_%d_%ld:%ld.raw", folder_path.c_str(), image_count + 1, elapsed_seconds / 60, elapsed_seconds % 60);
+}
+
+/**
+ * Grabs one frame from a free running synthetic camera.
+ * @param frames: Receives the frame for its size.
+ * @param pixel_format: FRAME_PIXEL_FORMAT_MONO8 or FRAME_PIXEL_FORMAT_BAYER_RG8.
+ * @param destination: Receives the pixels.
+ * @return 0 if successful, -1 otherwise.
+ */
+static int grab_synthetic_frame(const PIPELINE_BENCH_FRAMES& frames, uint32_t pixel_format, vector<uint8_t>& destination)
+{
+    SYNTHETIC_CAMERA_CONFIG config = default_synthetic_camera_config();
+    config.sensor_width = frames.width;
+    config.sensor_height = frames.height;
+    config.frame_rate = 0.0;
+
+    SYNTHETIC_CAMERA camera;
+    if (camera.configure(config) != 0 || camera.init() != 0 || camera.set_pixel_format(pixel_format) != 0 ||
+        camera.set_roi(frames.width, frames.height, 0, 0) != 0 || camera.start() != 0)
+    {
+        return -1;
+    }
+
+    CAMERA_FRAME frame;
+    int result = camera.next_frame(frame, 1000) == 0 ? 0 : -1;
+    if (result == 0)
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(frame.data);
+        destination.assign(data, data + frame.header.data_size);
+        camera.release_frame();
+    }
+    camera.stop();
+    camera.deinit();
+    return result;
+}
+
+/**
+ * Grabbing: what next_frame costs on the synthetic camera (the end-to-end cases include it).
+ */
+static void run_grab_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    const uint32_t formats[2] = {FRAME_PIXEL_FORMAT_MONO8, FRAME_PIXEL_FORMAT_BAYER_RG8};
+
+    for (uint32_t pixel_format : formats)
+    {
+        string name = string("grab/synthetic/") + get_frame_pixel_format_name(pixel_format);
+        if (!is_selected(options, name))
+        {
+            continue;
+        }
+
+        SYNTHETIC_CAMERA_CONFIG config = default_synthetic_camera_config();
+        config.sensor_width = frames.width;
+        config.sensor_height = frames.height;
+        config.frame_rate = 0.0;
+
+        SYNTHETIC_CAMERA camera;
+        camera.configure(config);
+        camera.init();
+        camera.set_pixel_format(pixel_format);
+        camera.set_roi(frames.width, frames.height, 0, 0);
+        camera.start();
+
+        report.add(time_case(name, frames, options.iterations, options.warmup, static_cast<double>(frames.width) * frames.height,
+                             [&](unsigned int)
+                             {
+                                 CAMERA_FRAME frame;
+                                 if (camera.next_frame(frame, 1000) == 0)
+                                 {
+                                     camera.release_frame();
+                                 }
+                             }));
+
+        camera.stop();
+        camera.deinit();
+    }
+}
+
+/**
+ * Conversion: Mono8 -> Mono16 and BayerRG8 -> BGR8 (reference, and ImageProcessor when built with Spinnaker).
+ */
+static void run_convert_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    size_t pixel_count = static_cast<size_t>(frames.width) * frames.height;
+    vector<uint16_t> mono16(pixel_count);
+    vector<uint8_t> bgr8(pixel_count * 3);
+
+    if (is_selected(options, "convert/mono8_to_mono16/reference"))
+    {
+        report.add(time_case("convert/mono8_to_mono16/reference", frames, options.iterations, options.warmup, pixel_count,
+                             [&](unsigned int) { convert_mono8_to_mono16(frames.mono8.data(), mono16.data(), pixel_count); }));
+    }
+    if (is_selected(options, "convert/bayer_rg8_to_bgr8/reference"))
+    {
+        report.add(time_case("convert/bayer_rg8_to_bgr8/reference", frames, options.iterations, options.warmup, pixel_count,
+                             [&](unsigned int) { convert_bayer_rg8_to_bgr8(frames.bayer.data(), bgr8.data(), frames.width, frames.height); }));
+    }
+
+#ifdef WITH_SPINNAKER
+    ImagePtr mono8_image = Image::Create(frames.width, frames.height, 0, 0, PixelFormat_Mono8, const_cast<uint8_t*>(frames.mono8.data()));
+    ImagePtr bayer_image = Image::Create(frames.width, frames.height, 0, 0, PixelFormat_BayerRG8, const_cast<uint8_t*>(frames.bayer.data()));
+
+    const ColorProcessingAlgorithm algorithms[2] = {SPINNAKER_COLOR_PROCESSING_ALGORITHM_HQ_LINEAR, SPINNAKER_COLOR_PROCESSING_ALGORITHM_DIRECTIONAL_FILTER};
+    const char* algorithm_names[2] = {"hq_linear", "directional_filter"};
+
+    for (int i = 0; i < 2; i++)
+    {
+        ImageProcessor processor;
+        processor.SetColorProcessing(algorithms[i]);
+
+        string name = string("convert/mono8_to_mono16/spinnaker_") + algorithm_names[i];
+        if (is_selected(options, name))
+        {
+            report.add(time_case(name, frames, options.iterations, options.warmup, pixel_count,
+                                 [&](unsigned int) { processor.Convert(mono8_image, PixelFormat_Mono16); }));
+        }
+
+        name = string("convert/bayer_rg8_to_bgr8/spinnaker_") + algorithm_names[i];
+        if (is_selected(options, name))
+        {
+            report.add(time_case(name, frames, options.iterations, options.warmup, pixel_count,
+                                 [&](unsigned int) { processor.Convert(bayer_image, PixelFormat_BGR8); }));
+        }
+    }
+#endif
+}
+
+/**
+ * Encoding: raw (header + copy), and JPEG/PNG through Image::Save (to a tmpfs file) and OpenCV (to memory) when available.
+ */
+static void run_encode_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    size_t pixel_count = static_cast<size_t>(frames.width) * frames.height;
+    vector<uint8_t> staging(sizeof(FRAME_HEADER) + pixel_count * 3);
+
+    const char* format_names[2] = {"mono8", "bgr8"};
+    const vector<uint8_t>* sources[2] = {&frames.mono8, &frames.bgr8};
+    const uint32_t pixel_formats[2] = {FRAME_PIXEL_FORMAT_MONO8, FRAME_PIXEL_FORMAT_BGR8};
+
+    for (int f = 0; f < 2; f++)
+    {
+        const vector<uint8_t>& source = *sources[f];
+        uint32_t bytes_per_pixel = frame_bytes_per_pixel(pixel_formats[f]);
+
+        string name = string("encode/raw_") + format_names[f] + "/copy";
+        if (is_selected(options, name))
+        {
+            report.add(time_case(name, frames, options.iterations, options.warmup, source.size(),
+                                 [&](unsigned int i)
+                                 {
+                                     FRAME_HEADER header;
+                                     init_frame_header(header, frames.width, frames.height, frames.width * bytes_per_pixel, pixel_formats[f], source.size());
+                                     header.frame_id = i;
+                                     memcpy(staging.data(), &header, sizeof(header));
+                                     memcpy(staging.data() + sizeof(header), source.data(), source.size());
+                                 }));
+        }
+
+#ifdef WITH_SPINNAKER
+        const char* extensions[2] = {"jpg", "png"};
+        for (const char* extension : extensions)
+        {
+            name = string("encode/") + extension + "_" + format_names[f] + "/spinnaker_save";
+            if (!is_selected(options, name))
+            {
+                continue;
+            }
+
+            string path = string("/dev/shm/capture_pipeline_bench.") + extension;
+            ImagePtr image = Image::Create(frames.width, frames.height, 0, 0, f == 0 ? PixelFormat_Mono8 : PixelFormat_BGR8,
+                                           const_cast<uint8_t*>(source.data()));
+            report.add(time_case(name, frames, options.iterations, options.warmup, source.size(),
+                                 [&](unsigned int) { image->Save(path.c_str()); }));
+            unlink(path.c_str());
+        }
+#endif
+
+#ifdef WITH_OPENCV
+        const char* cv_extensions[2] = {".jpg", ".png"};
+        cv::Mat image(frames.height, frames.width, f == 0 ? CV_8UC1 : CV_8UC3, const_cast<uint8_t*>(source.data()));
+        for (const char* extension : cv_extensions)
+        {
+            name = string("encode/") + (extension + 1) + "_" + format_names[f] + "/opencv_imencode";
+            if (!is_selected(options, name))
+            {
+                continue;
+            }
+
+            vector<uint8_t> encoded;
+            report.add(time_case(name, frames, options.iterations, options.warmup, source.size(),
+                                 [&](unsigned int) { cv::imencode(extension, image, encoded); }));
+        }
+#endif
+    }
+}
+
+/**
+ * File names: the ostringstream of the capture loop vs. snprintf.
+ */
+static void run_filename_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    string folder_path = "/folder/path/to/save/images/";
+    unsigned int iterations = options.iterations * 100;     // Too short to time one at a time otherwise
+
+    if (is_selected(options, "filename/image_name/ostringstream"))
+    {
+        report.add(time_case("filename/image_name/ostringstream", frames, iterations, options.warmup, 0.0,
+                             [&](unsigned int i) { string name = make_filename_stream(folder_path, i, i / 30); }));
+    }
+    if (is_selected(options, "filename/image_name/snprintf"))
+    {
+        char buffer[256];
+        report.add(time_case("filename/image_name/snprintf", frames, iterations, options.warmup, 0.0,
+                             [&](unsigned int i) { make_filename_printf(buffer, sizeof(buffer), folder_path, i, i / 30); }));
+    }
+}
+
+/**
+ * Handoff: what write_frame blocks the grab loop for when the disk is not the bottleneck (every frame goes to /dev/null).
+ */
+static void run_handoff_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    const FRAME_WRITER_BACKEND backends[2] = {FRAME_WRITER_BACKEND_URING, FRAME_WRITER_BACKEND_PWRITE};
+
+    for (FRAME_WRITER_BACKEND backend : backends)
+    {
+        unique_ptr<FRAME_WRITER> writer = create_frame_writer(default_frame_writer_config(backend, frames.mono8.size()));
+        if (!writer)
+        {
+            continue;
+        }
+
+        string name = string("handoff/write_frame/") + writer->get_name();
+        if (!is_selected(options, name))
+        {
+            continue;
+        }
+
+        FRAME_HEADER header;
+        init_frame_header(header, frames.width, frames.height, frames.width, FRAME_PIXEL_FORMAT_MONO8, frames.mono8.size());
+
+        report.add(time_case(name, frames, options.iterations, options.warmup, frames.mono8.size(),
+                             [&](unsigned int i)
+                             {
+                                 header.frame_id = i;
+                                 writer->write_frame("/dev/null", header, frames.mono8.data());
+                             }));
+        writer->flush();
+    }
+}
+
+/**
+ * Disk: one file per frame written synchronously, and through the frame writers including the final flush.
+ */
+static void run_disk_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    FRAME_HEADER header;
+    init_frame_header(header, frames.width, frames.height, frames.width, FRAME_PIXEL_FORMAT_MONO8, frames.mono8.size());
+    double frame_bytes = sizeof(FRAME_HEADER) + frames.mono8.size();
+
+    string name = options.fsync_each ? "disk/raw_mono8/write_fdatasync" : "disk/raw_mono8/write_sync";
+    if (is_selected(options, name))
+    {
+        report.add(time_case(name, frames, options.frames, 0, frame_bytes,
+                             [&](unsigned int i)
+                             {
+                                 string path = options.folder_path + "/frame_" + to_string(i) + ".raw";
+                                 int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+                                 if (fd < 0)
+                                 {
+                                     return;
+                                 }
+                                 header.frame_id = i;
+                                 if (write(fd, &header, sizeof(header)) < 0 || write(fd, frames.mono8.data(), frames.mono8.size()) < 0)
+                                 {
+                                     cerr << "[Bench] Write to " << path << " failed" << endl;
+                                 }
+                                 if (options.fsync_each)
+                                 {
+                                     fdatasync(fd);
+                                 }
+                                 close(fd);
+                             }));
+
+        for (unsigned int i = 0; i < options.frames; i++)
+        {
+            unlink((options.folder_path + "/frame_" + to_string(i) + ".raw").c_str());
+        }
+    }
+
+    const FRAME_WRITER_BACKEND backends[2] = {FRAME_WRITER_BACKEND_URING, FRAME_WRITER_BACKEND_PWRITE};
+    for (FRAME_WRITER_BACKEND backend : backends)
+    {
+        unique_ptr<FRAME_WRITER> writer = create_frame_writer(default_frame_writer_config(backend, frames.mono8.size()));
+        if (!writer)
+        {
+            continue;
+        }
+
+        name = string("disk/raw_mono8/") + writer->get_name();
+        if (!is_selected(options, name))
+        {
+            continue;
+        }
+
+        // Samples are the write_frame calls, the total (and MB/s) includes waiting for the disk in flush()
+        vector<double> samples_ns;
+        auto start_time = chrono::steady_clock::now();
+        for (unsigned int i = 0; i < options.frames; i++)
+        {
+            string path = options.folder_path + "/frame_" + to_string(i) + ".raw";
+            header.frame_id = i;
+
+            auto call_start = chrono::steady_clock::now();
+            writer->write_frame(path, header, frames.mono8.data());
+            samples_ns.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - call_start).count());
+        }
+        writer->flush();
+        double total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+        report.add(make_bench_record(name, frames.width, frames.height, samples_ns, frame_bytes, total_seconds));
+
+        for (unsigned int i = 0; i < options.frames; i++)
+        {
+            unlink((options.folder_path + "/frame_" + to_string(i) + ".raw").c_str());
+        }
+    }
+}
+
+/**
+ * End to end: synthetic grab -> conversion -> file name -> frame writer (raw), or -> Image::Save (JPEG) like the capture tools.
+ * Samples are whole loop iterations, the total includes the final flush.
+ */
+static void run_end_to_end_cases(BENCH_REPORT& report, const PIPELINE_BENCH_OPTIONS& options, const PIPELINE_BENCH_FRAMES& frames)
+{
+    struct END_TO_END_CASE
+    {
+        const char* name;
+        uint32_t camera_format;
+        uint32_t output_format;
+        bool jpeg;
+    };
+
+    const END_TO_END_CASE cases[] =
+    {
+        {"end_to_end/mono8_raw", FRAME_PIXEL_FORMAT_MONO8, FRAME_PIXEL_FORMAT_MONO8, false},
+        {"end_to_end/mono8_to_mono16_raw", FRAME_PIXEL_FORMAT_MONO8, FRAME_PIXEL_FORMAT_MONO16, false},
+        {"end_to_end/bayer_rg8_to_bgr8_raw", FRAME_PIXEL_FORMAT_BAYER_RG8, FRAME_PIXEL_FORMAT_BGR8, false},
+#ifdef WITH_SPINNAKER
+        {"end_to_end/mono8_jpeg_spinnaker_save", FRAME_PIXEL_FORMAT_MONO8, FRAME_PIXEL_FORMAT_MONO8, true},
+#endif
+    };
+
+    size_t pixel_count = static_cast<size_t>(frames.width) * frames.height;
+
+    for (const END_TO_END_CASE& end_to_end : cases)
+    {
+        // The writer backend is part of the name, as reported by the writer after a uring fallback
+        string name = end_to_end.name;
+        if (!is_selected(options, name))
+        {
+            continue;
+        }
+
+        uint32_t bytes_per_pixel = frame_bytes_per_pixel(end_to_end.output_format);
+        vector<uint8_t> converted(pixel_count * bytes_per_pixel);
+
+        unique_ptr<FRAME_WRITER> writer;
+        if (!end_to_end.jpeg)
+        {
+            writer = create_frame_writer(default_frame_writer_config(options.writer_backend, converted.size()));
+            if (!writer)
+            {
+                continue;
+            }
+            name = name + "/" + writer->get_name();
+        }
+
+        SYNTHETIC_CAMERA_CONFIG config = default_synthetic_camera_config();
+        config.sensor_width = frames.width;
+        config.sensor_height = frames.height;
+        config.frame_rate = 0.0;
+
+        SYNTHETIC_CAMERA camera;
+        camera.configure(config);
+        camera.init();
+        camera.set_pixel_format(end_to_end.camera_format);
+        camera.set_roi(frames.width, frames.height, 0, 0);
+        camera.start();
+
+        vector<string> written;
+        vector<double> samples_ns;
+        auto start_time = chrono::steady_clock::now();
+
+        for (unsigned int i = 0; i < options.frames; i++)
+        {
+            auto frame_start = chrono::steady_clock::now();
+
+            CAMERA_FRAME frame;
+            if (camera.next_frame(frame, 1000) != 0)
+            {
+                continue;
+            }
+            const uint8_t* pixels = static_cast<const uint8_t*>(frame.data);
+
+            const void* output = pixels;
+            if (end_to_end.output_format == FRAME_PIXEL_FORMAT_MONO16)
+            {
+                convert_mono8_to_mono16(pixels, reinterpret_cast<uint16_t*>(converted.data()), pixel_count);
+                output = converted.data();
+            }
+            else if (end_to_end.output_format == FRAME_PIXEL_FORMAT_BGR8)
+            {
+                convert_bayer_rg8_to_bgr8(pixels, converted.data(), frames.width, frames.height);
+                output = converted.data();
+            }
+
+            long elapsed_seconds = static_cast<long>(chrono::duration<double>(frame_start - start_time).count());
+            string path = make_filename_stream(options.folder_path + "/", i, elapsed_seconds);
+
+            if (writer)
+            {
+                FRAME_HEADER header = frame.header;
+                header.pixel_format = end_to_end.output_format;
+                header.stride = frames.width * bytes_per_pixel;
+                header.data_size = pixel_count * bytes_per_pixel;
+                writer->write_frame(path, header, output);
+            }
+#ifdef WITH_SPINNAKER
+            else
+            {
+                path.replace(path.size() - 4, 4, ".jpg");
+                ImagePtr image = Image::Create(frames.width, frames.height, 0, 0, PixelFormat_Mono8, const_cast<void*>(output));
+                image->Save(path.c_str());
+            }
+#endif
+            camera.release_frame();
+            written.push_back(path);
+
+            samples_ns.push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - frame_start).count());
+        }
+
+        if (writer)
+        {
+            writer->flush();
+        }
+        double total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+        camera.stop();
+        camera.deinit();
+
+        report.add(make_bench_record(name, frames.width, frames.height, samples_ns, pixel_count * bytes_per_pixel, total_seconds));
+
+        for (const string& path : written)
+        {
+            unlink(path.c_str());
+        }
+    }
+}
+
+/**
+ * Parses "2448x2048,1408x352".
+ * @param text: The list.
+ * @param sizes: Receives width/height pairs.
+ * @return true if every entry could be parsed.
+ */
+static bool parse_sizes(const string& text, vector<pair<uint32_t, uint32_t>>& sizes)
+{
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ','))
+    {
+        unsigned int width = 0, height = 0;
+        if (sscanf(item.c_str(), "%ux%u", &width, &height) != 2 || width < 2 || height < 2)
+        {
+            return false;
+        }
+        sizes.push_back(make_pair(width & ~1u, height & ~1u));  // Even, so the Bayer pattern is complete
+    }
+    return !sizes.empty();
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    PIPELINE_BENCH_OPTIONS options;
+    options.folder_path = command_line.get_string("dir", "/tmp/capture_pipeline_bench");
+    options.filter = command_line.get_string("filter", "");
+    options.iterations = static_cast<unsigned int>(command_line.get_int("iterations", 50));
+    options.frames = static_cast<unsigned int>(command_line.get_int("frames", 60));
+    options.warmup = static_cast<unsigned int>(command_line.get_int("warmup", 3));
+    options.fsync_each = command_line.has("fsync");
+    string json_path = command_line.get_string("json", "");
+    string csv_path = command_line.get_string("csv", "");
+
+    // Full Blackfly S 5 MP sensor and the ROIs of the mono and color capture tools
+    vector<pair<uint32_t, uint32_t>> sizes;
+    if (!parse_sizes(command_line.get_string("sizes", "2448x2048,1408x352,1424x408"), sizes))
+    {
+        cerr << "Invalid --sizes, expected e.g. 2448x2048,1408x352" << endl;
+        return -1;
+    }
+    if (!parse_frame_writer_backend(command_line.get_string("writer", "uring"), options.writer_backend))
+    {
+        cerr << "Unknown --writer, use uring or pwrite" << endl;
+        return -1;
+    }
+    if (options.iterations == 0 || options.frames == 0)
+    {
+        cerr << "--iterations and --frames must be at least 1" << endl;
+        return -1;
+    }
+
+    mkdir(options.folder_path.c_str(), 0755);
+
+    cout << "*** CAPTURE PIPELINE BENCHMARK ***" << endl;
+    cout << options.iterations << " iterations per stage, " << options.frames << " frames per disk/end-to-end case, files in " << options.folder_path << endl;
+#ifndef WITH_SPINNAKER
+    cout << "Built without Spinnaker: ImageProcessor and Image::Save cases skipped." << endl;
+#endif
+#ifndef WITH_OPENCV
+    cout << "Built without OpenCV: imencode cases skipped." << endl;
+#endif
+    cout << endl;
+
+    BENCH_REPORT report("capture_pipeline");
+
+    for (const pair<uint32_t, uint32_t>& size : sizes)
+    {
+        PIPELINE_BENCH_FRAMES frames;
+        frames.width = size.first;
+        frames.height = size.second;
+
+        if (grab_synthetic_frame(frames, FRAME_PIXEL_FORMAT_MONO8, frames.mono8) != 0 ||
+            grab_synthetic_frame(frames, FRAME_PIXEL_FORMAT_BAYER_RG8, frames.bayer) != 0)
+        {
+            cerr << "Unable to generate " << frames.width << "x" << frames.height << " frames" << endl;
+            return -1;
+        }
+        frames.bgr8.resize(frames.bayer.size() * 3);
+        convert_bayer_rg8_to_bgr8(frames.bayer.data(), frames.bgr8.data(), frames.width, frames.height);
+
+        run_grab_cases(report, options, frames);
+        run_convert_cases(report, options, frames);
+        run_encode_cases(report, options, frames);
+        run_filename_cases(report, options, frames);
+        run_handoff_cases(report, options, frames);
+        run_disk_cases(report, options, frames);
+        run_end_to_end_cases(report, options, frames);
+        cout << endl;
+    }
+
+    int result = 0;
+    if (!json_path.empty())
+    {
+        result = result | report.write_json(json_path);
+    }
+    if (!csv_path.empty())
+    {
+        result = result | report.write_csv(csv_path);
+    }
+    return result;
+}
@@ -0,0 +1,321 @@
+// Description: Measures lossless tiled LZ4/zstd compression of synthetic or recorded frames (ratio, MB/s per core, fps)
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aligned_buffer_pool.h"
+#include "command_line.h"
+#include "frame_compressor.h"
+#include "frame_format.h"
+#include "segment_recorder.h"
+
+using namespace std;
+
+// Struct to hold one frame kept in memory
+struct BENCH_FRAME
+{
+    FRAME_HEADER header;
+    vector<uint8_t> data;
+};
+
+// Sink that only counts what it receives (end-to-end runs without a disk)
+class COUNTING_SINK : public FRAME_SINK
+{
+    public:
+        uint64_t frames;
+        uint64_t bytes;
+
+        COUNTING_SINK() : frames(0), bytes(0) {}
+
+        int consume_frame(const FRAME_HEADER& header, const void* data)
+        {
+            (void)data;
+            frames++;
+            bytes += header.data_size;
+            return 0;
+        }
+
+        const char* get_sink_name() const { return "counter"; }
+};
+
+/**
+ * Creates a synthetic scene: smooth gradients and a few bright discs with sensor noise, so the codecs see data
+ * that behaves like a real image instead of a trivially compressible pattern.
+ * @param width: Frame width.
+ * @param height: Frame height.
+ * @param mono16: 12 bit data in Mono16 if true, Mono8 otherwise.
+ * @param noise: Noise amplitude in LSB.
+ * @param seed: Changes the noise and moves the discs between frames.
+ * @return The frame.
+ */
+static BENCH_FRAME make_synthetic_frame(unsigned int width, unsigned int height, bool mono16, unsigned int noise, unsigned int seed)
+{
+    BENCH_FRAME frame;
+    unsigned int bytes_per_pixel = mono16 ? 2 : 1;
+    init_frame_header(frame.header, width, height, width * bytes_per_pixel, mono16 ? FRAME_PIXEL_FORMAT_MONO16 : FRAME_PIXEL_FORMAT_MONO8,
+                      static_cast<uint64_t>(width) * height * bytes_per_pixel);
+    set_frame_serial(frame.header, "synthetic");
+    frame.header.frame_id = seed;
+    frame.data.resize(frame.header.data_size);
+
+    double full_scale = mono16 ? 4095.0 : 255.0;
+    uint32_t random = 2463534242u + seed * 7919u;
+
+    for (unsigned int y = 0; y < height; y++)
+    {
+        for (unsigned int x = 0; x < width; x++)
+        {
+            double value = 0.25 + 0.35 * x / width + 0.15 * sin(y * 0.01);
+            for (unsigned int disc = 0; disc < 3; disc++)
+            {
+                double cx = width * (0.2 + 0.3 * disc) + seed * 2.0;
+                double cy = height * 0.5;
+                double dx = x - cx;
+                double dy = y - cy;
+                if (dx * dx + dy * dy < (height * 0.15) * (height * 0.15))
+                {
+                    value += 0.3;
+                }
+            }
+
+            // xorshift32 noise
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            int jitter = noise > 0 ? static_cast<int>(random % (2 * noise + 1)) - static_cast<int>(noise) : 0;
+
+            int pixel = static_cast<int>(min(1.0, value) * full_scale) + jitter;
+            pixel = max(0, min(static_cast<int>(full_scale), pixel));
+
+            size_t index = static_cast<size_t>(y) * width + x;
+            if (mono16)
+            {
+                frame.data[2 * index] = static_cast<uint8_t>(pixel & 0xFF);
+                frame.data[2 * index + 1] = static_cast<uint8_t>(pixel >> 8);
+            }
+            else
+            {
+                frame.data[index] = static_cast<uint8_t>(pixel);
+            }
+        }
+    }
+
+    return frame;
+}
+
+/**
+ * Loads frames from a .raw file (one frame) or a .rec recording (page aligned records).
+ * @param path: The file.
+ * @param max_frames: Frames to load at most.
+ * @param frames: Receives the frames.
+ * @return 0 if at least one frame was loaded, -1 otherwise.
+ */
+static int load_recorded_frames(const string& path, unsigned int max_frames, vector<BENCH_FRAME>& frames)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        cerr << "Unable to open " << path << endl;
+        return -1;
+    }
+
+    uint64_t offset = 0;
+    while (frames.size() < max_frames)
+    {
+        BENCH_FRAME frame;
+        file.seekg(static_cast<streamoff>(offset));
+        if (!file.read(reinterpret_cast<char*>(&frame.header), sizeof(frame.header)) || !is_frame_header_valid(frame.header) ||
+            is_frame_compressed(frame.header))
+        {
+            break;
+        }
+
+        frame.data.resize(frame.header.data_size);
+        if (!file.read(reinterpret_cast<char*>(frame.data.data()), static_cast<streamsize>(frame.data.size())))
+        {
+            break;
+        }
+
+        offset += align_up(sizeof(FRAME_HEADER) + frame.header.data_size, PAGE_ALIGNMENT);
+        frames.push_back(frame);
+    }
+
+    return frames.empty() ? -1 : 0;
+}
+
+/**
+ * Compresses every frame through a COMPRESSION_STAGE into a sink, then checks that each frame decompresses to
+ * the original.
+ * @param frames: The input frames.
+ * @param config: The compressor configuration.
+ * @param record_path: Record the compressed frames here (empty = count only).
+ * @param repeat: Passes over the frames.
+ * @return False if a frame did not survive the round trip.
+ */
+static bool run_codec(const vector<BENCH_FRAME>& frames, const COMPRESSION_CONFIG& config, const string& record_path, unsigned int repeat)
+{
+    // Round trip check on the first frames with a plain compressor
+    FRAME_COMPRESSOR checker;
+    bool round_trip_ok = checker.init(config) == 0;
+    vector<uint8_t> block(round_trip_ok ? checker.get_max_compressed_size() : 0);
+    for (size_t i = 0; round_trip_ok && i < min<size_t>(frames.size(), 4); i++)
+    {
+        FRAME_HEADER compressed_header;
+        FRAME_HEADER restored_header;
+        vector<uint8_t> restored;
+        round_trip_ok = checker.compress(frames[i].header, frames[i].data.data(), compressed_header, block.data()) == 0 &&
+                        FRAME_COMPRESSOR::decompress(compressed_header, block.data(), restored_header, restored) == 0 &&
+                        restored == frames[i].data && restored_header.pixel_format == frames[i].header.pixel_format;
+    }
+
+    COUNTING_SINK counter;
+    SEGMENT_RECORDER recorder;
+    FRAME_SINK* sink = &counter;
+
+    COMPRESSION_STAGE stage;
+    if (!record_path.empty())
+    {
+        SEGMENT_RECORDER_CONFIG recorder_config = default_segment_recorder_config(record_path, get_max_compressed_frame_size(config.max_frame_bytes));
+        recorder_config.prefix = "compression_bench";
+        if (recorder.init(recorder_config) != 0)
+        {
+            return false;
+        }
+        sink = &recorder;
+    }
+
+    if (stage.init(config, sink, 8) != 0)
+    {
+        return false;
+    }
+
+    auto start_time = chrono::steady_clock::now();
+    for (unsigned int pass = 0; pass < repeat; pass++)
+    {
+        for (const auto& frame : frames)
+        {
+            stage.consume_frame(frame.header, frame.data.data());
+        }
+    }
+    stage.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+    COMPRESSION_STATS stats = stage.get_stats();
+    double raw_mb = stats.raw_bytes / (1024.0 * 1024.0);
+
+    cout << left << setw(6) << get_compression_codec_name(config.codec) << right << setw(6) << config.level << setw(8) << config.threads
+         << fixed << setprecision(2) << setw(9) << (stats.compressed_bytes > 0 ? static_cast<double>(stats.raw_bytes) / stats.compressed_bytes : 0.0)
+         << setprecision(1) << setw(12) << (stats.cpu_seconds > 0.0 ? raw_mb / stats.cpu_seconds : 0.0)
+         << setw(12) << (stats.wall_seconds > 0.0 ? raw_mb / stats.wall_seconds : 0.0)
+         << setw(10) << stats.frames / seconds
+         << setw(8) << stats.stalls
+         << setw(6) << (round_trip_ok ? "ok" : "FAIL") << endl;
+
+    if (!record_path.empty())
+    {
+        recorder.flush();
+        SEGMENT_RECORDER_STATS recorder_stats = recorder.get_stats();
+        for (unsigned int i = 0; i < recorder_stats.segments_opened; i++)
+        {
+            ostringstream path;
+            path << record_path << "/compression_bench_" << setw(6) << setfill('0') << i << ".rec";
+            unlink(path.str().c_str());
+        }
+    }
+
+    return round_trip_ok && stats.errors == 0;
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    string input_path = command_line.get_string("input", "");
+    string record_path = command_line.get_string("dir", "");
+    unsigned int frame_count = static_cast<unsigned int>(command_line.get_int("frames", 20));
+    unsigned int repeat = static_cast<unsigned int>(command_line.get_int("repeat", 5));
+    unsigned int width = static_cast<unsigned int>(command_line.get_int("width", 1216));
+    unsigned int height = static_cast<unsigned int>(command_line.get_int("height", 352));
+    bool mono16 = command_line.get_string("format", "mono16") == "mono16";
+    unsigned int noise = static_cast<unsigned int>(command_line.get_int("noise", 4));
+    unsigned int max_threads = static_cast<unsigned int>(command_line.get_int("threads", max(1u, thread::hardware_concurrency())));
+    bool shuffle = command_line.get_int("shuffle", 1) != 0;
+
+    vector<BENCH_FRAME> frames;
+    if (!input_path.empty())
+    {
+        if (load_recorded_frames(input_path, frame_count, frames) != 0)
+        {
+            return 1;
+        }
+    }
+    else
+    {
+        for (unsigned int i = 0; i < frame_count; i++)
+        {
+            frames.push_back(make_synthetic_frame(width, height, mono16, noise, i));
+        }
+    }
+
+    size_t max_frame_bytes = 0;
+    for (const auto& frame : frames)
+    {
+        max_frame_bytes = max<size_t>(max_frame_bytes, frame.header.data_size);
+    }
+
+    if (!record_path.empty())
+    {
+        mkdir(record_path.c_str(), 0755);
+    }
+
+    cout << "*** COMPRESSION BENCHMARK ***" << endl;
+    cout << frames.size() << (input_path.empty() ? " synthetic " : " recorded ") << frames[0].header.width << "x" << frames[0].header.height
+         << (frame_bytes_per_pixel(frames[0].header.pixel_format) == 2 ? " Mono16" : " Mono8") << " frames ("
+         << frames[0].header.data_size << " bytes) x " << repeat << " passes, shuffle " << (shuffle ? "on" : "off")
+         << (record_path.empty() ? ", no disk" : ", recorded to " + record_path) << endl << endl;
+
+    cout << left << setw(6) << "codec" << right << setw(6) << "level" << setw(8) << "threads" << setw(9) << "ratio"
+         << setw(12) << "MB/s/core" << setw(12) << "MB/s wall" << setw(10) << "fps" << setw(8) << "stalls" << setw(6) << "check" << endl;
+
+    bool all_ok = true;
+    struct RUN { COMPRESSION_CODEC codec; int level; };
+    const RUN runs[] = { {COMPRESSION_LZ4, 0}, {COMPRESSION_LZ4, 9}, {COMPRESSION_ZSTD, 1}, {COMPRESSION_ZSTD, 3}, {COMPRESSION_ZSTD, 9} };
+
+    for (const RUN& run : runs)
+    {
+        if (!is_compression_codec_available(run.codec))
+        {
+            if (&run != runs && (&run - 1)->codec == run.codec)
+            {
+                continue;   // Already reported
+            }
+            cout << left << setw(6) << get_compression_codec_name(run.codec) << "  not available (library not found at build time)" << endl;
+            continue;
+        }
+
+        // Thread counts 1, 2, 4, ... up to --threads
+        for (unsigned int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            COMPRESSION_CONFIG config = default_compression_config(run.codec, max_frame_bytes);
+            config.level = run.level;
+            config.threads = threads;
+            config.shuffle = shuffle;
+            all_ok = run_codec(frames, config, record_path, repeat) && all_ok;
+        }
+    }
+
+    cout << endl << "ratio = raw / compressed, MB/s/core = raw MB per CPU second in the codec, MB/s wall = raw MB per second of compress(),"
+         << endl << "fps = end-to-end frames per second through the compression stage" << (record_path.empty() ? "" : " and the recorder") << endl;
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+// Description: Streams synthetic frames to local clients with different drop policies and checks the grab loop never stalls
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "command_line.h"
+#include "frame_format.h"
+#include "frame_stream.h"
+
+using namespace std;
+
+// Struct to hold what one client saw
+struct CLIENT_RESULT
+{
+    string name;
+    STREAM_DROP_POLICY policy;
+    unsigned int delay_ms;      // Simulated processing time per frame
+    uint64_t received;
+    uint64_t reported_drops;    // Sum of the dropped fields (must match the gaps)
+    uint64_t sequence_gaps;     // Frames missing according to the sequence numbers
+    uint64_t bad_frames;        // Frame ID did not match the pattern
+    double seconds;
+};
+
+/**
+ * Client thread: receives frames until the server closes the connection.
+ * @param address: The server address.
+ * @param result: The client result (policy and delay are inputs).
+ * @param connected: Incremented once the HELLO was sent.
+ */
+static void run_client(const string& address, CLIENT_RESULT& result, atomic<unsigned int>& connected)
+{
+    FRAME_STREAM_CLIENT client;
+    if (client.connect_to(address, result.policy, 0) != 0)
+    {
+        cerr << "[" << result.name << "] Unable to connect to " << address << endl;
+        connected++;
+        return;
+    }
+    connected++;
+
+    STREAM_MESSAGE_HEADER message;
+    FRAME_HEADER header;
+    vector<uint8_t> data;
+    uint64_t expected_sequence = 0;     // Every client is connected before the first frame
+    auto start_time = chrono::steady_clock::now();
+
+    while (client.receive(message, header, data) == 0)
+    {
+        if (message.sequence > expected_sequence)
+        {
+            result.sequence_gaps += message.sequence - expected_sequence;
+        }
+        expected_sequence = message.sequence + 1;
+
+        result.received++;
+        result.reported_drops += message.dropped;
+        if (data.empty() || data[0] != static_cast<uint8_t>(header.frame_id))
+        {
+            result.bad_frames++;
+        }
+
+        if (result.delay_ms > 0)
+        {
+            this_thread::sleep_for(chrono::milliseconds(result.delay_ms));
+        }
+    }
+
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    string address = command_line.get_string("address", "unix:/tmp/frame_stream_bench.sock");
+    unsigned int frames = static_cast<unsigned int>(command_line.get_int("frames", 1000));
+    unsigned int width = static_cast<unsigned int>(command_line.get_int("width", 1216));
+    unsigned int height = static_cast<unsigned int>(command_line.get_int("height", 352));
+    double fps = command_line.get_double("fps", 100.0);
+    unsigned int slow_ms = static_cast<unsigned int>(command_line.get_int("slow-ms", 40));
+
+    FRAME_HEADER header;
+    init_frame_header(header, width, height, width * 2, FRAME_PIXEL_FORMAT_MONO16, static_cast<uint64_t>(width) * height * 2);
+    set_frame_serial(header, "bench");
+
+    cout << "*** FRAME STREAM BENCHMARK ***" << endl;
+    cout << frames << " frames of " << width << "x" << height << " Mono16 (" << header.data_size << " bytes) at "
+         << fps << " fps on " << address << ", slow clients take " << slow_ms << " ms per frame" << endl << endl;
+
+    FRAME_STREAM_SERVER server;
+    if (server.init(default_frame_stream_config(address, header.data_size)) != 0)
+    {
+        return 1;
+    }
+
+    vector<CLIENT_RESULT> results = {
+        {"fast/oldest", STREAM_DROP_OLDEST, 0, 0, 0, 0, 0, 0.0},
+        {"slow/oldest", STREAM_DROP_OLDEST, slow_ms, 0, 0, 0, 0, 0.0},
+        {"slow/newest", STREAM_DROP_NEWEST, slow_ms, 0, 0, 0, 0, 0.0},
+        {"slow/latest", STREAM_LATEST_ONLY, slow_ms, 0, 0, 0, 0, 0.0},
+        {"slow/disconnect", STREAM_DISCONNECT, slow_ms, 0, 0, 0, 0, 0.0},
+    };
+
+    atomic<unsigned int> connected(0);
+    vector<thread> client_threads;
+    for (auto& result : results)
+    {
+        client_threads.push_back(thread(run_client, address, ref(result), ref(connected)));
+    }
+
+    // Wait until every client is connected and its HELLO was processed
+    auto wait_start = chrono::steady_clock::now();
+    while ((connected < results.size() || server.get_client_count() < results.size()) &&
+           chrono::steady_clock::now() - wait_start < chrono::seconds(5))
+    {
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    this_thread::sleep_for(chrono::milliseconds(100));
+
+    vector<uint8_t> pixels(header.data_size);
+    vector<double> call_us;
+    call_us.reserve(frames);
+
+    auto period = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(fps > 0.0 ? 1.0 / fps : 0.0));
+    auto next_frame = chrono::steady_clock::now();
+    auto start_time = next_frame;
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        header.frame_id = i;
+        pixels[0] = static_cast<uint8_t>(i);
+
+        auto call_start = chrono::steady_clock::now();
+        server.consume_frame(header, pixels.data());
+        call_us.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - call_start).count());
+
+        next_frame += period;
+        this_thread::sleep_until(next_frame);
+    }
+
+    double grab_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+    this_thread::sleep_for(chrono::milliseconds(500));   // Let the fast client drain its queue
+    server.stop();
+    for (auto& client_thread : client_threads)
+    {
+        client_thread.join();
+    }
+
+    sort(call_us.begin(), call_us.end());
+    cout << endl << "Grab loop: " << fixed << setprecision(1) << frames / grab_seconds << " fps, consume_frame "
+         << call_us[call_us.size() / 2] << " us p50, " << call_us[call_us.size() * 99 / 100] << " us p99, "
+         << call_us.back() << " us max" << endl << endl;
+
+    cout << left << setw(18) << "client" << right << setw(10) << "received" << setw(10) << "fps"
+         << setw(10) << "dropped" << setw(10) << "gaps" << setw(8) << "bad" << endl;
+
+    int result = 0;
+    for (const auto& client : results)
+    {
+        cout << left << setw(18) << client.name << right << setw(10) << client.received
+             << setw(10) << setprecision(1) << (client.seconds > 0.0 ? client.received / client.seconds : 0.0)
+             << setw(10) << client.reported_drops << setw(10) << client.sequence_gaps << setw(8) << client.bad_frames << endl;
+
+        if (client.bad_frames > 0 || client.reported_drops != client.sequence_gaps)
+        {
+            result = 1;
+        }
+    }
+
+    FRAME_STREAM_STATS stats = server.get_stats();
+    cout << endl << "Server: " << stats.frames_sent << " frames sent (" << stats.bytes_sent / (1024 * 1024) << " MB), "
+         << stats.frames_dropped << " dropped, " << stats.clients_dropped << " client(s) disconnected" << endl;
+
+    return result;
+}
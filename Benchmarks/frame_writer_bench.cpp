@@ -0,0 +1,335 @@
+// Description: Compares the io_uring and pwrite frame writers with the Image::Save path used by the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef WITH_SPINNAKER
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+#endif
+
+#include "command_line.h"
+#include "frame_format.h"
+#include "frame_writer.h"
+#include "segment_recorder.h"
+#include "video_recorder.h"
+
+using namespace std;
+
+#ifdef WITH_SPINNAKER
+using namespace Spinnaker;
+#endif
+
+// Struct to hold the result of a single benchmark run
+struct BENCH_RESULT
+{
+    string name;
+    unsigned int frames;
+    double total_seconds;       // From first write to everything flushed
+    double mean_call_us;        // Time the capture loop is blocked per frame
+    double max_call_us;
+};
+
+/**
+ * Fills a buffer with a deterministic gradient so compression/encoding has realistic work to do.
+ * @param buffer: The buffer to fill.
+ * @param seed: Changes the pattern between frames.
+ */
+static void fill_pattern(vector<uint8_t>& buffer, unsigned int seed)
+{
+    for (size_t i = 0; i < buffer.size(); i++)
+    {
+        buffer[i] = static_cast<uint8_t>((i / 7 + seed * 3) & 0xFF);
+    }
+}
+
+/**
+ * Removes the files written by a run so the next run starts from the same state.
+ * @param folder_path: The benchmark folder.
+ * @param extension: File extension used by the run.
+ * @param frames: Number of files written.
+ */
+static void remove_frames(const string& folder_path, const string& extension, unsigned int frames)
+{
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        string path = folder_path + "/frame_" + to_string(i) + extension;
+        unlink(path.c_str());
+    }
+}
+
+/**
+ * Runs one writer backend.
+ * @param writer: The writer to benchmark.
+ * @param folder_path: The output folder.
+ * @param header: Header template for the frames.
+ * @param frames: Number of frames to write.
+ * @return The measured result.
+ */
+static BENCH_RESULT run_writer(FRAME_WRITER& writer, const string& folder_path, const FRAME_HEADER& header, unsigned int frames)
+{
+    vector<uint8_t> pixels(header.data_size);
+    BENCH_RESULT result = {writer.get_name(), frames, 0.0, 0.0, 0.0};
+
+    double total_call_us = 0.0;
+    auto start_time = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        fill_pattern(pixels, i);
+        FRAME_HEADER frame_header = header;
+        frame_header.frame_id = i;
+
+        string path = folder_path + "/frame_" + to_string(i) + ".raw";
+
+        auto call_start = chrono::steady_clock::now();
+        writer.write_frame(path, frame_header, pixels.data());
+        double call_us = chrono::duration<double, micro>(chrono::steady_clock::now() - call_start).count();
+
+        total_call_us += call_us;
+        result.max_call_us = max(result.max_call_us, call_us);
+    }
+
+    writer.flush();
+    result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    result.mean_call_us = total_call_us / frames;
+
+    remove_frames(folder_path, ".raw", frames);
+    return result;
+}
+
+/**
+ * Runs the O_DIRECT segment recorder (one preallocated file instead of a file per frame).
+ * @param folder_path: The output folder.
+ * @param header: Header template for the frames.
+ * @param frames: Number of frames to write.
+ * @param slots: Number of staging buffers.
+ * @return The measured result.
+ */
+static BENCH_RESULT run_recorder(const string& folder_path, const FRAME_HEADER& header, unsigned int frames, unsigned int slots)
+{
+    vector<uint8_t> pixels(header.data_size);
+    BENCH_RESULT result = {"segment recorder", frames, 0.0, 0.0, 0.0};
+
+    SEGMENT_RECORDER_CONFIG config = default_segment_recorder_config(folder_path, header.data_size);
+    config.prefix = "bench";
+    config.buffer_count = slots;
+
+    SEGMENT_RECORDER recorder;
+    if (recorder.init(config) != 0)
+    {
+        result.total_seconds = 1.0;
+        return result;
+    }
+
+    double total_call_us = 0.0;
+    auto start_time = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        fill_pattern(pixels, i);
+        FRAME_HEADER frame_header = header;
+        frame_header.frame_id = i;
+
+        auto call_start = chrono::steady_clock::now();
+        recorder.consume_frame(frame_header, pixels.data());
+        double call_us = chrono::duration<double, micro>(chrono::steady_clock::now() - call_start).count();
+
+        total_call_us += call_us;
+        result.max_call_us = max(result.max_call_us, call_us);
+    }
+
+    recorder.flush();
+    result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    result.mean_call_us = total_call_us / frames;
+
+    SEGMENT_RECORDER_STATS stats = recorder.get_stats();
+    cout << "  (" << stats.segments_opened << " segment(s), " << stats.stalls << " stalls, slowest write " << stats.max_write_ms << " ms)" << endl;
+
+    for (unsigned int i = 0; i < stats.segments_opened; i++)
+    {
+        ostringstream path;
+        path << folder_path << "/bench_" << setw(6) << setfill('0') << i << ".rec";
+        unlink(path.str().c_str());
+    }
+    return result;
+}
+
+/**
+ * Runs the AVI video recorder (appends to one container file instead of creating a file per frame).
+ * @param folder_path: The output folder.
+ * @param header: Header template for the frames.
+ * @param frames: Number of frames to write.
+ * @param slots: Number of staging buffers.
+ * @return The measured result.
+ */
+static BENCH_RESULT run_video(const string& folder_path, const FRAME_HEADER& header, unsigned int frames, unsigned int slots)
+{
+    vector<uint8_t> pixels(header.data_size);
+    BENCH_RESULT result = {"video recorder (AVI)", frames, 0.0, 0.0, 0.0};
+
+    VIDEO_RECORDER_CONFIG config = default_video_recorder_config(folder_path, header.data_size);
+    config.prefix = "bench";
+    config.buffer_count = slots;
+
+    VIDEO_RECORDER recorder;
+    if (recorder.init(config) != 0)
+    {
+        result.total_seconds = 1.0;
+        return result;
+    }
+
+    double total_call_us = 0.0;
+    auto start_time = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        fill_pattern(pixels, i);
+        FRAME_HEADER frame_header = header;
+        frame_header.frame_id = i;
+
+        auto call_start = chrono::steady_clock::now();
+        recorder.consume_frame(frame_header, pixels.data());
+        double call_us = chrono::duration<double, micro>(chrono::steady_clock::now() - call_start).count();
+
+        total_call_us += call_us;
+        result.max_call_us = max(result.max_call_us, call_us);
+    }
+
+    recorder.flush();
+    result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    result.mean_call_us = total_call_us / frames;
+
+    VIDEO_RECORDER_STATS stats = recorder.get_stats();
+    cout << "  (" << stats.segments_opened << " file(s), " << stats.stalls << " stalls)" << endl;
+
+    for (unsigned int i = 0; i < stats.segments_opened; i++)
+    {
+        ostringstream path;
+        path << folder_path << "/bench_camera_X0_" << setw(6) << setfill('0') << i;
+        unlink((path.str() + ".avi").c_str());
+        unlink((path.str() + ".csv").c_str());
+    }
+    return result;
+}
+
+#ifdef WITH_SPINNAKER
+/**
+ * Runs the current capture path: Image::Save with the format picked from the extension.
+ * @param folder_path: The output folder.
+ * @param header: Header template for the frames.
+ * @param frames: Number of frames to write.
+ * @param extension: ".jpg" (what capture_image does today) or ".raw".
+ * @return The measured result.
+ */
+static BENCH_RESULT run_image_save(const string& folder_path, const FRAME_HEADER& header, unsigned int frames, const string& extension)
+{
+    vector<uint8_t> pixels(header.data_size);
+    BENCH_RESULT result = {"Image::Save " + extension, frames, 0.0, 0.0, 0.0};
+
+    PixelFormatEnums pixel_format = header.pixel_format == FRAME_PIXEL_FORMAT_MONO16 ? PixelFormat_Mono16 :
+                                    header.pixel_format == FRAME_PIXEL_FORMAT_BGR8 ? PixelFormat_BGR8 : PixelFormat_Mono8;
+
+    double total_call_us = 0.0;
+    auto start_time = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        fill_pattern(pixels, i);
+        string path = folder_path + "/frame_" + to_string(i) + extension;
+
+        auto call_start = chrono::steady_clock::now();
+        ImagePtr image = Image::Create(header.width, header.height, 0, 0, pixel_format, pixels.data());
+        image->Save(path.c_str());
+        double call_us = chrono::duration<double, micro>(chrono::steady_clock::now() - call_start).count();
+
+        total_call_us += call_us;
+        result.max_call_us = max(result.max_call_us, call_us);
+    }
+
+    result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    result.mean_call_us = total_call_us / frames;
+
+    remove_frames(folder_path, extension, frames);
+    return result;
+}
+#endif
+
+/**
+ * Prints a result line.
+ * @param result: The result to print.
+ * @param frame_bytes: Bytes written per frame.
+ */
+static void print_result(const BENCH_RESULT& result, size_t frame_bytes)
+{
+    double fps = result.frames / result.total_seconds;
+    double mb_per_second = fps * frame_bytes / (1024.0 * 1024.0);
+
+    cout << left << setw(22) << result.name << right << fixed << setprecision(1)
+         << setw(10) << fps << " fps"
+         << setw(10) << mb_per_second << " MB/s"
+         << setw(12) << result.mean_call_us << " us/call"
+         << setw(12) << result.max_call_us << " us max" << endl;
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    string folder_path = command_line.get_string("dir", "/tmp/frame_writer_bench");
+    unsigned int frames = static_cast<unsigned int>(command_line.get_int("frames", 200));
+    unsigned int width = static_cast<unsigned int>(command_line.get_int("width", 1216));
+    unsigned int height = static_cast<unsigned int>(command_line.get_int("height", 352));
+    unsigned int batch = static_cast<unsigned int>(command_line.get_int("batch", 4));
+    unsigned int slots = static_cast<unsigned int>(command_line.get_int("slots", 8));
+    unsigned int threads = static_cast<unsigned int>(command_line.get_int("threads", 2));
+
+    mkdir(folder_path.c_str(), 0755);
+
+    FRAME_HEADER header;
+    init_frame_header(header, width, height, width * 2, FRAME_PIXEL_FORMAT_MONO16, static_cast<uint64_t>(width) * height * 2);
+
+    cout << "*** FRAME WRITER BENCHMARK ***" << endl;
+    cout << frames << " frames of " << width << "x" << height << " Mono16 (" << header.data_size << " bytes) to " << folder_path << endl << endl;
+
+    FRAME_WRITER_CONFIG config = default_frame_writer_config(FRAME_WRITER_BACKEND_URING, header.data_size);
+    config.batch_size = batch;
+    config.slot_count = slots;
+    config.thread_count = threads;
+
+    unique_ptr<FRAME_WRITER> uring_writer = create_frame_writer(config);
+    if (uring_writer)
+    {
+        print_result(run_writer(*uring_writer, folder_path, header, frames), sizeof(FRAME_HEADER) + header.data_size);
+        uring_writer.reset();
+    }
+
+    config.backend = FRAME_WRITER_BACKEND_PWRITE;
+    unique_ptr<FRAME_WRITER> pwrite_writer = create_frame_writer(config);
+    if (pwrite_writer)
+    {
+        print_result(run_writer(*pwrite_writer, folder_path, header, frames), sizeof(FRAME_HEADER) + header.data_size);
+        pwrite_writer.reset();
+    }
+
+    print_result(run_recorder(folder_path, header, frames, slots), sizeof(FRAME_HEADER) + header.data_size);
+    print_result(run_video(folder_path, header, frames, slots), header.data_size);
+
+#ifdef WITH_SPINNAKER
+    print_result(run_image_save(folder_path, header, frames, ".raw"), header.data_size);
+    print_result(run_image_save(folder_path, header, frames, ".jpg"), header.data_size);
+#else
+    cout << endl << "Built without Spinnaker: Image::Save baseline skipped." << endl;
+#endif
+
+    return 0;
+}
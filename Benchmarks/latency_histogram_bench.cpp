@@ -0,0 +1,94 @@
+// Description: Cost of recording into the latency histograms and accuracy of their percentiles
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "command_line.h"
+#include "latency_histogram.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+    uint64_t samples = static_cast<uint64_t>(command_line.get_int("samples", 10000000));
+    bool reader = !command_line.has("no-reader");
+
+    // Log-normal latencies around 200 us with a long tail, like a GetNextImage wait
+    mt19937_64 generator(1);
+    lognormal_distribution<double> distribution(log(200000.0), 0.8);
+    vector<uint64_t> values(1 << 16);
+    for (uint64_t& value : values)
+    {
+        value = static_cast<uint64_t>(distribution(generator));
+    }
+
+    cout << "*** LATENCY HISTOGRAM BENCHMARK ***" << endl;
+    cout << samples << " samples, " << LATENCY_HISTOGRAM::BUCKET_COUNT << " buckets ("
+         << LATENCY_HISTOGRAM::BUCKET_COUNT * sizeof(uint64_t) / 1024 << " KiB) per histogram"
+         << (reader ? ", reports every 0.1 s" : "") << endl << endl;
+
+    // Recording while the report thread reads the same histograms
+    LATENCY_MONITOR monitor;
+    if (reader)
+    {
+        monitor.start("bench", 0.1);
+    }
+
+    size_t mask = values.size() - 1;
+    auto start_time = chrono::steady_clock::now();
+    for (uint64_t i = 0; i < samples; i++)
+    {
+        monitor.record(LATENCY_GRAB_WAIT, values[i & mask]);
+    }
+    double record_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start_time).count() / samples;
+
+    // The same with the clock reads an acquisition loop needs per stage
+    start_time = chrono::steady_clock::now();
+    for (uint64_t i = 0; i < samples; i++)
+    {
+        uint64_t stage_start = latency_now_ns();
+        monitor.record(LATENCY_CONVERSION, latency_now_ns() - stage_start);
+    }
+    double timed_record_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start_time).count() / samples;
+
+    LATENCY_SUMMARY summary = monitor.get_summary(LATENCY_GRAB_WAIT);
+    monitor.stop();
+
+    // Exact percentiles of what was recorded
+    vector<uint64_t> recorded;
+    recorded.reserve(samples);
+    for (uint64_t i = 0; i < samples; i++)
+    {
+        recorded.push_back(values[i & mask]);
+    }
+    sort(recorded.begin(), recorded.end());
+    auto exact = [&](double percent) { return recorded[static_cast<size_t>(ceil(percent / 100.0 * recorded.size())) - 1]; };
+
+    cout << endl << fixed << setprecision(2);
+    cout << "record():                " << record_ns << " ns per sample" << endl;
+    cout << "2 x clock + record():    " << timed_record_ns << " ns per sample" << endl << endl;
+
+    const double percents[3] = {50.0, 99.0, 99.9};
+    const uint64_t reported[3] = {summary.p50_ns, summary.p99_ns, summary.p999_ns};
+    const char* names[3] = {"p50", "p99", "p999"};
+    double worst_error = 0.0;
+    for (int p = 0; p < 3; p++)
+    {
+        double error = (static_cast<double>(reported[p]) - exact(percents[p])) / exact(percents[p]) * 100.0;
+        worst_error = max(worst_error, fabs(error));
+        cout << setw(5) << names[p] << ": histogram " << setw(12) << reported[p] << " ns, exact " << setw(12) << exact(percents[p])
+             << " ns, error " << error << " %" << endl;
+    }
+    cout << "  max: histogram " << setw(12) << summary.max_ns << " ns, exact " << setw(12) << recorded.back() << " ns" << endl;
+
+    // Bucket values round up by less than one step of 1/64
+    return (worst_error < 1.6 && summary.count == samples && summary.max_ns == recorded.back()) ? 0 : 1;
+}
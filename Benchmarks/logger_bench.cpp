@@ -0,0 +1,168 @@
+// Description: Per-message cost of cout with endl (the current per-frame logging) vs. the asynchronous logger
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "async_logger.h"
+#include "command_line.h"
+#include "latency_histogram.h"
+
+using namespace std;
+
+// Struct to hold the result of one logging path
+struct LOGGER_BENCH_RESULT
+{
+    LATENCY_SUMMARY per_message;    // Time the calling thread spends per message
+    double producer_seconds;        // Until the last message was handed over
+    double total_seconds;           // Until the last message was written
+};
+
+/**
+ * Logs like capture_image does per frame: three lines with the camera index, the frame ID and the file path.
+ * Between frames the thread sleeps frame_gap_us, as the grab loop would while waiting for the next image.
+ */
+template <typename LOG_FUNCTION>
+static LOGGER_BENCH_RESULT run_case(uint64_t frames, unsigned int frame_gap_us, LOG_FUNCTION log_frame)
+{
+    LATENCY_HISTOGRAM histogram;
+    auto start_time = chrono::steady_clock::now();
+
+    for (uint64_t frame = 0; frame < frames; frame++)
+    {
+        uint64_t start_ns = latency_now_ns();
+        log_frame(frame);
+        histogram.record((latency_now_ns() - start_ns) / 3);
+
+        if (frame_gap_us > 0)
+        {
+            this_thread::sleep_for(chrono::microseconds(frame_gap_us));
+        }
+    }
+
+    LOGGER_BENCH_RESULT result;
+    result.producer_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    vector<uint64_t> counts;
+    histogram.copy_counts(counts);
+    result.per_message = LATENCY_HISTOGRAM::summarize(counts, histogram.get_sum(), histogram.get_max());
+    result.total_seconds = result.producer_seconds;
+    return result;
+}
+
+static void print_result(const char* name, uint64_t messages, const LOGGER_BENCH_RESULT& result)
+{
+    cout << left << setw(22) << name << right << fixed << setprecision(1)
+         << setw(10) << result.per_message.mean_ns << setw(10) << result.per_message.p50_ns / 1.0 << setw(10) << result.per_message.p99_ns / 1.0
+         << setw(12) << result.per_message.max_ns / 1.0 << setw(14) << setprecision(0) << messages / result.total_seconds << endl;
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+    uint64_t frames = static_cast<uint64_t>(command_line.get_int("frames", 50000));
+    unsigned int frame_gap_us = static_cast<unsigned int>(command_line.get_int("gap-us", 50));
+    string path = command_line.get_string("out", "/tmp/logger_bench.log");
+    size_t capacity = static_cast<size_t>(command_line.get_int("capacity", static_cast<long long>(default_log_config().capacity)));
+    uint64_t messages = frames * 3;
+
+    cout << "*** LOGGER BENCHMARK ***" << endl;
+    cout << frames << " frames x 3 messages to " << path << (frame_gap_us > 0 ? ", " + to_string(frame_gap_us) + " us between frames" : "")
+         << endl << endl;
+    cout << left << setw(22) << "path" << right << setw(10) << "mean" << setw(10) << "p50" << setw(10) << "p99" << setw(12) << "max"
+         << setw(14) << "msg/s" << "   (ns per message on the calling thread)" << endl;
+
+    string file_path = "/data/images/Serial_12345678_OffsetX_1216_Image_3.raw";
+
+    // Current path: cout << ... << endl, every line flushed
+    {
+        ofstream file(path, ios::trunc);
+        streambuf* console = cout.rdbuf(file.rdbuf());
+        LOGGER_BENCH_RESULT result = run_case(frames, frame_gap_us, [&](uint64_t frame)
+        {
+            cout << "[Camera " << frame % 2 << "] Frame " << frame << " converted" << endl;
+            cout << "[Camera " << frame % 2 << "] Image queued for: " << file_path << endl;
+            cout << "[Camera " << frame % 2 << "] Image captured successfully for OffsetX: " << 1216 << endl;
+        });
+        cout.rdbuf(console);
+        print_result("cout + endl", messages, result);
+    }
+
+    // The same lines without the flush, still formatted on the calling thread
+    {
+        ofstream file(path, ios::trunc);
+        streambuf* console = cout.rdbuf(file.rdbuf());
+        auto start_time = chrono::steady_clock::now();
+        LOGGER_BENCH_RESULT result = run_case(frames, frame_gap_us, [&](uint64_t frame)
+        {
+            cout << "[Camera " << frame % 2 << "] Frame " << frame << " converted\n";
+            cout << "[Camera " << frame % 2 << "] Image queued for: " << file_path << "\n";
+            cout << "[Camera " << frame % 2 << "] Image captured successfully for OffsetX: " << 1216 << "\n";
+        });
+        cout.flush();
+        result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        cout.rdbuf(console);
+        print_result("cout + \\n", messages, result);
+    }
+
+    // Asynchronous logger: binary record on the calling thread, formatting and writes on the writer thread
+    {
+        ofstream(path, ios::trunc);
+        LOG_CONFIG log_config = default_log_config();
+        log_config.path = path;
+        log_config.capacity = capacity;
+        log_config.min_level = LOG_DEBUG;
+        if (ASYNC_LOGGER::start(log_config) != 0)
+        {
+            return 1;
+        }
+
+        auto start_time = chrono::steady_clock::now();
+        LOGGER_BENCH_RESULT result = run_case(frames, frame_gap_us, [&](uint64_t frame)
+        {
+            int camera = static_cast<int>(frame % 2);
+            log_debug(log_tag("Camera", camera), "Frame {} converted", frame);
+            log_info(log_tag("Camera", camera), "Image queued for: {}", file_path);
+            log_info(log_tag("Camera", camera), "Image captured successfully for OffsetX: {}", 1216);
+        });
+        ASYNC_LOGGER::stop();
+        result.total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        print_result("async logger", messages, result);
+
+        cout << endl << "async logger: " << ASYNC_LOGGER::get_written_count() << " written, " << ASYNC_LOGGER::get_dropped_count()
+             << " dropped (queue of " << capacity << ")" << endl;
+    }
+
+    // Rate limit: an error repeated in a tight loop only reaches the log rate_limit times per second (synchronous path after stop())
+    {
+        int saved_stderr = dup(STDERR_FILENO);
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDERR_FILENO);
+
+        uint64_t before = ASYNC_LOGGER::get_written_count();
+        uint64_t attempts = 0;
+        auto start_time = chrono::steady_clock::now();
+        while (chrono::steady_clock::now() - start_time < chrono::milliseconds(2500))
+        {
+            log_error(log_tag("Camera", 0), "Incomplete image captured");
+            attempts++;
+        }
+        uint64_t logged = ASYNC_LOGGER::get_written_count() - before;
+
+        dup2(saved_stderr, STDERR_FILENO);
+        close(saved_stderr);
+        close(null_fd);
+
+        cout << "rate limit: " << logged << " of " << attempts << " repeated errors written in 2.5 s (limit "
+             << default_log_config().rate_limit << " per second)" << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Description: Measures publish-to-reader latency of the shared memory frame ring across two processes
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "command_line.h"
+#include "frame_format.h"
+#include "shm_frame_ring.h"
+
+using namespace std;
+
+/**
+ * Returns a percentile of a sorted sample.
+ * @param sorted: The sorted samples.
+ * @param percent: The percentile (0-100).
+ * @return The sample at the percentile, 0 if there are no samples.
+ */
+static double percentile(const vector<double>& sorted, double percent)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+
+    size_t index = static_cast<size_t>(percent / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+/**
+ * Prints a latency line.
+ * @param name: The measured step.
+ * @param samples: The samples in microseconds (sorted in place).
+ */
+static void print_latency(const string& name, vector<double>& samples)
+{
+    sort(samples.begin(), samples.end());
+
+    cout << left << setw(18) << name << right << fixed << setprecision(1)
+         << setw(10) << percentile(samples, 50.0) << " us p50"
+         << setw(10) << percentile(samples, 99.0) << " us p99"
+         << setw(10) << (samples.empty() ? 0.0 : samples.back()) << " us max" << endl;
+}
+
+/**
+ * Reader process: sleeps on the ring futex, takes a zero-copy view of every new frame and copies it out.
+ * @param ring_name: The shm object name.
+ * @param frames: Frames the publisher will send.
+ * @return The process exit code.
+ */
+static int run_reader(const string& ring_name, unsigned int frames)
+{
+    SHM_FRAME_READER reader;
+    for (int attempt = 0; reader.open_ring(ring_name) != 0; attempt++)
+    {
+        if (attempt == 500)
+        {
+            cerr << "[Reader] Ring " << ring_name << " did not appear" << endl;
+            return 1;
+        }
+        this_thread::sleep_for(chrono::milliseconds(10));
+    }
+
+    vector<double> view_latency_us;
+    vector<double> copy_us;
+    view_latency_us.reserve(frames);
+    copy_us.reserve(frames);
+
+    uint64_t seen = reader.get_write_index();
+    uint64_t missed = 0;
+    uint64_t torn = 0;
+    FRAME_HEADER header;
+    vector<uint8_t> data;
+
+    while (seen < frames)
+    {
+        if (!reader.wait_for_frame(seen, 2000))
+        {
+            cerr << "[Reader] Timed out after " << seen << " frames" << endl;
+            break;
+        }
+
+        SHM_FRAME_VIEW view;
+        if (!reader.get_latest(view))
+        {
+            continue;
+        }
+
+        uint64_t view_time = latency_now_ns();
+        view_latency_us.push_back((view_time - view.publish_time_ns) / 1000.0);
+
+        if (view.frame_index > seen)
+        {
+            missed += view.frame_index - seen;  // Frames overwritten before this reader woke up
+        }
+        seen = view.frame_index + 1;
+
+        uint64_t copy_start = latency_now_ns();
+        if (reader.copy_latest(header, data))
+        {
+            copy_us.push_back((latency_now_ns() - copy_start) / 1000.0);
+        }
+
+        if (!reader.is_view_valid(view))
+        {
+            torn++;
+        }
+    }
+
+    cout << "Reader saw " << view_latency_us.size() << " frames (" << missed << " skipped, " << torn << " overwritten while reading)" << endl;
+    print_latency("publish -> view", view_latency_us);
+    print_latency("copy out", copy_us);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    string ring_name = command_line.get_string("name", "/shm_ring_bench");
+    unsigned int frames = static_cast<unsigned int>(command_line.get_int("frames", 2000));
+    unsigned int width = static_cast<unsigned int>(command_line.get_int("width", 1216));
+    unsigned int height = static_cast<unsigned int>(command_line.get_int("height", 352));
+    unsigned int slots = static_cast<unsigned int>(command_line.get_int("slots", 8));
+    double fps = command_line.get_double("fps", 200.0);
+
+    FRAME_HEADER header;
+    init_frame_header(header, width, height, width * 2, FRAME_PIXEL_FORMAT_MONO16, static_cast<uint64_t>(width) * height * 2);
+    set_frame_serial(header, "bench");
+
+    cout << "*** SHARED MEMORY RING BENCHMARK ***" << endl;
+    cout << frames << " frames of " << width << "x" << height << " Mono16 (" << header.data_size << " bytes) at "
+         << fps << " fps through " << ring_name << " (" << slots << " slots)" << endl << endl;
+
+    SHM_FRAME_PUBLISHER publisher;
+    if (publisher.init(ring_name, slots, header.data_size) != 0)
+    {
+        return 1;
+    }
+
+    cout.flush();   // Otherwise the child prints the buffered output again
+    pid_t reader_pid = fork();
+    if (reader_pid < 0)
+    {
+        cerr << "fork failed" << endl;
+        return 1;
+    }
+
+    if (reader_pid == 0)
+    {
+        _exit(run_reader(ring_name, frames));
+    }
+
+    // Give the reader time to map the ring and go to sleep on the futex
+    this_thread::sleep_for(chrono::milliseconds(200));
+
+    vector<uint8_t> pixels(header.data_size);
+    vector<double> publish_us;
+    publish_us.reserve(frames);
+
+    auto period = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(fps > 0.0 ? 1.0 / fps : 0.0));
+    auto next_frame = chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        pixels[i % pixels.size()] = static_cast<uint8_t>(i);
+        header.frame_id = i;
+        header.timestamp_ns = latency_now_ns();
+
+        uint64_t start = latency_now_ns();
+        publisher.consume_frame(header, pixels.data());
+        publish_us.push_back((latency_now_ns() - start) / 1000.0);
+
+        next_frame += period;
+        this_thread::sleep_until(next_frame);
+    }
+
+    int status = 0;
+    waitpid(reader_pid, &status, 0);
+
+    print_latency("publish call", publish_us);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
@@ -0,0 +1,152 @@
+// Description: Fixed-size pool of page aligned staging buffers
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+#include "aligned_buffer_pool.h"
+
+using namespace std;
+
+/**
+ * Constructor for the ALIGNED_BUFFER_POOL class.
+ */
+ALIGNED_BUFFER_POOL::ALIGNED_BUFFER_POOL()
+    : buffer_size(0)
+{
+}
+
+/**
+ * Destructor for the ALIGNED_BUFFER_POOL class.
+ */
+ALIGNED_BUFFER_POOL::~ALIGNED_BUFFER_POOL()
+{
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        free(buffers[i]);
+    }
+}
+
+/**
+ * Allocates the buffers. They are zeroed so the pages are resident from the start.
+ * @param buffer_count: Number of buffers.
+ * @param size: Size of each buffer, rounded up to the alignment.
+ * @param alignment: Buffer alignment (power of two).
+ * @return 0 if successful, -1 if buffer_count is 0 or an allocation failed.
+ */
+int ALIGNED_BUFFER_POOL::init(unsigned int buffer_count, size_t size, size_t alignment)
+{
+    lock_guard<mutex> lock(pool_mutex);
+
+    if (!buffers.empty())
+    {
+        cerr << "[Buffer pool] Already initialized\n";
+        return -1;
+    }
+
+    if (buffer_count == 0)
+    {
+        cerr << "[Buffer pool] At least one buffer is needed, acquire() would wait forever\n";
+        return -1;
+    }
+
+    buffer_size = align_up(size, alignment);
+
+    for (unsigned int i = 0; i < buffer_count; i++)
+    {
+        void* buffer = NULL;
+        if (posix_memalign(&buffer, alignment, buffer_size) != 0)
+        {
+            cerr << "[Buffer pool] Unable to allocate buffer " << i << " (" << buffer_size << " bytes)\n";
+            return -1;
+        }
+        memset(buffer, 0, buffer_size);
+
+        buffers.push_back(static_cast<char*>(buffer));
+        free_buffers.push_back(i);
+    }
+
+    return 0;
+}
+
+/**
+ * Takes a free buffer without waiting.
+ * @param index: Receives the buffer index.
+ * @return true if a buffer was taken.
+ */
+bool ALIGNED_BUFFER_POOL::try_acquire(unsigned int& index)
+{
+    lock_guard<mutex> lock(pool_mutex);
+
+    if (free_buffers.empty())
+    {
+        return false;
+    }
+
+    index = free_buffers.back();
+    free_buffers.pop_back();
+    return true;
+}
+
+/**
+ * Takes a free buffer, waiting for one to be released if necessary.
+ * @return The buffer index.
+ */
+unsigned int ALIGNED_BUFFER_POOL::acquire()
+{
+    unique_lock<mutex> lock(pool_mutex);
+    buffer_available.wait(lock, [this] { return !free_buffers.empty(); });
+
+    unsigned int index = free_buffers.back();
+    free_buffers.pop_back();
+    return index;
+}
+
+/**
+ * Returns a buffer to the pool.
+ * @param index: The buffer index.
+ */
+void ALIGNED_BUFFER_POOL::release(unsigned int index)
+{
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        free_buffers.push_back(index);
+    }
+    buffer_available.notify_one();
+}
+
+/**
+ * Returns the memory of a buffer.
+ * @param index: The buffer index.
+ */
+char* ALIGNED_BUFFER_POOL::get_buffer(unsigned int index) const
+{
+    return buffers[index];
+}
+
+/**
+ * Returns the (aligned) size of every buffer.
+ */
+size_t ALIGNED_BUFFER_POOL::get_buffer_size() const
+{
+    return buffer_size;
+}
+
+/**
+ * Returns the number of buffers in the pool.
+ */
+unsigned int ALIGNED_BUFFER_POOL::get_buffer_count() const
+{
+    return static_cast<unsigned int>(buffers.size());
+}
+
+/**
+ * Returns the number of buffers currently free.
+ */
+unsigned int ALIGNED_BUFFER_POOL::get_free_count() const
+{
+    lock_guard<mutex> lock(pool_mutex);
+    return static_cast<unsigned int>(free_buffers.size());
+}
@@ -0,0 +1,50 @@
+// aligned_buffer_pool.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef ALIGNED_BUFFER_POOL_H
+#define ALIGNED_BUFFER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+const size_t PAGE_ALIGNMENT = 4096;
+
+// Rounds size up to a multiple of alignment (alignment must be a power of two)
+inline size_t align_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Fixed set of page aligned buffers, allocated once. Memory use never changes after init().
+class ALIGNED_BUFFER_POOL
+{
+    private:
+        vector<char*> buffers;
+        vector<unsigned int> free_buffers;
+        size_t buffer_size;
+
+        mutable mutex pool_mutex;
+        condition_variable buffer_available;
+
+    public:
+        ALIGNED_BUFFER_POOL();
+        ~ALIGNED_BUFFER_POOL();
+
+        int init(unsigned int buffer_count, size_t size, size_t alignment = PAGE_ALIGNMENT);  // Allocate (and touch) every buffer
+
+        bool try_acquire(unsigned int& index);  // Returns false if all buffers are taken
+        unsigned int acquire();                 // Blocks until a buffer is free
+        void release(unsigned int index);       // Returns a buffer to the pool
+
+        char* get_buffer(unsigned int index) const;
+        size_t get_buffer_size() const;
+        unsigned int get_buffer_count() const;
+        unsigned int get_free_count() const;
+};
+
+#endif // ALIGNED_BUFFER_POOL_H
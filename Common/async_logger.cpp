@@ -0,0 +1,477 @@
+// Description: Asynchronous structured logger with severity levels, per-camera tags and rate limiting for the acquisition loops
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "async_logger.h"
+
+using namespace std;
+
+atomic<bool> ASYNC_LOGGER::running(false);
+atomic<int> ASYNC_LOGGER::min_level(LOG_INFO);
+LOG_CONFIG ASYNC_LOGGER::config = default_log_config();
+vector<LOG_SLOT> ASYNC_LOGGER::slots;
+size_t ASYNC_LOGGER::slot_mask = 0;
+atomic<uint64_t> ASYNC_LOGGER::enqueue_position(0);
+uint64_t ASYNC_LOGGER::dequeue_position = 0;
+atomic<uint64_t> ASYNC_LOGGER::dropped(0);
+atomic<uint64_t> ASYNC_LOGGER::written(0);
+LOG_RATE_SLOT ASYNC_LOGGER::rate_slots[ASYNC_LOGGER::RATE_SLOTS];
+thread ASYNC_LOGGER::writer_thread;
+FILE* ASYNC_LOGGER::log_file = nullptr;
+
+/**
+ * Returns the default logger configuration: console, info and above, 8192 queued records, 10 repeated warnings/errors per second.
+ * @return The configuration.
+ */
+LOG_CONFIG default_log_config()
+{
+    LOG_CONFIG log_config;
+    log_config.path = "";
+    log_config.min_level = LOG_INFO;
+    log_config.capacity = 8192;
+    log_config.rate_limit = 10;
+    log_config.flush_interval_ms = 5;
+    return log_config;
+}
+
+/**
+ * Returns the name of a level as written in front of every line.
+ * @param level: The level.
+ * @return The name.
+ */
+const char* get_log_level_name(LOG_LEVEL level)
+{
+    switch (level)
+    {
+        case LOG_DEBUG:
+            return "DEBUG";
+        case LOG_INFO:
+            return "INFO";
+        case LOG_WARNING:
+            return "WARN";
+        case LOG_ERROR:
+            return "ERROR";
+        default:
+            return "?";
+    }
+}
+
+/**
+ * Parses a level name.
+ * @param name: debug, info, warning or error.
+ * @param level: Receives the level.
+ * @return true if the name is known.
+ */
+bool parse_log_level(const string& name, LOG_LEVEL& level)
+{
+    if (name == "debug")
+    {
+        level = LOG_DEBUG;
+    }
+    else if (name == "info")
+    {
+        level = LOG_INFO;
+    }
+    else if (name == "warning" || name == "warn")
+    {
+        level = LOG_WARNING;
+    }
+    else if (name == "error")
+    {
+        level = LOG_ERROR;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Allocates the queue and starts the writer thread.
+ * @param log_config: The configuration.
+ * @return 0 if successful, -1 if the log file cannot be opened or the logger was already started.
+ */
+int ASYNC_LOGGER::start(const LOG_CONFIG& log_config)
+{
+    if (running.load() || !slots.empty())
+    {
+        return -1;  // One queue per process, producers may still hold a slot of the first one
+    }
+
+    if (!log_config.path.empty())
+    {
+        log_file = fopen(log_config.path.c_str(), "a");
+        if (!log_file)
+        {
+            cerr << "[Log] Unable to open " << log_config.path << ": " << strerror(errno) << endl;
+            return -1;
+        }
+    }
+
+    config = log_config;
+    min_level.store(static_cast<int>(config.min_level));
+
+    size_t capacity = 2;
+    while (capacity < config.capacity)
+    {
+        capacity <<= 1;
+    }
+    slots = vector<LOG_SLOT>(capacity);
+    for (size_t i = 0; i < capacity; i++)
+    {
+        slots[i].sequence.store(i, memory_order_relaxed);
+    }
+    slot_mask = capacity - 1;
+    enqueue_position.store(0);
+    dequeue_position = 0;
+
+    running.store(true, memory_order_release);
+    writer_thread = thread(&ASYNC_LOGGER::writer_loop);
+    return 0;
+}
+
+/**
+ * Writes everything that is queued, stops the writer thread and reports dropped and rate limited messages.
+ * Later messages are written synchronously. Call when the acquisition threads have stopped logging.
+ */
+void ASYNC_LOGGER::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+
+    if (writer_thread.joinable())
+    {
+        writer_thread.join();   // Drains the queue before it returns
+    }
+
+    string summary;
+    for (size_t i = 0; i < RATE_SLOTS; i++)
+    {
+        uint32_t suppressed = rate_slots[i].suppressed.exchange(0);
+        const char* format = rate_slots[i].format.load();
+        if (suppressed > 0 && format)
+        {
+            summary += "[Log] " + to_string(suppressed) + " more message(s) like \"" + format + "\" suppressed by the rate limit\n";
+        }
+    }
+    if (dropped.load() > 0)
+    {
+        summary += "[Log] " + to_string(dropped.load()) + " message(s) dropped (queue full)\n";
+    }
+    if (!summary.empty())
+    {
+        write_lines("", summary);
+    }
+
+    if (log_file)
+    {
+        fclose(log_file);
+        log_file = nullptr;
+    }
+}
+
+/**
+ * Rate limit of warnings and errors: at most config.rate_limit messages per second from the same format string.
+ * Lock-free and approximate (concurrent callers may let one or two more through at a window change).
+ * @param format: The format string, identifies the call.
+ * @param now_ns: Current time.
+ * @param suppressed: Receives how many messages of this call were dropped since the last one that was logged.
+ * @return true if the message should be logged.
+ */
+bool ASYNC_LOGGER::allow(const char* format, uint64_t now_ns, uint32_t& suppressed)
+{
+    suppressed = 0;
+    if (config.rate_limit == 0)
+    {
+        return true;
+    }
+
+    size_t hash = (reinterpret_cast<uintptr_t>(format) >> 3) % RATE_SLOTS;
+    for (size_t probe = 0; probe < 4; probe++)
+    {
+        LOG_RATE_SLOT& slot = rate_slots[(hash + probe) % RATE_SLOTS];
+        const char* owner = slot.format.load(memory_order_acquire);
+        if (owner == nullptr)
+        {
+            const char* expected = nullptr;
+            if (!slot.format.compare_exchange_strong(expected, format) && expected != format)
+            {
+                continue;   // Taken by another call meanwhile
+            }
+        }
+        else if (owner != format)
+        {
+            continue;
+        }
+
+        uint64_t window_start_ns = slot.window_start_ns.load(memory_order_relaxed);
+        if (now_ns - window_start_ns >= 1000000000ULL)
+        {
+            if (slot.window_start_ns.compare_exchange_strong(window_start_ns, now_ns))
+            {
+                slot.count.store(0, memory_order_relaxed);
+            }
+        }
+
+        if (slot.count.fetch_add(1, memory_order_relaxed) < config.rate_limit)
+        {
+            suppressed = slot.suppressed.exchange(0, memory_order_relaxed);
+            return true;
+        }
+        slot.suppressed.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+
+    return true;    // No free slot for this call -> not limited
+}
+
+/**
+ * Claims the next queue slot (Vyukov bounded MPSC queue).
+ * @param position: Receives the queue position, pass it to publish().
+ * @return The slot to fill, nullptr if the queue is full.
+ */
+LOG_SLOT* ASYNC_LOGGER::claim(uint64_t& position)
+{
+    position = enqueue_position.load(memory_order_relaxed);
+    while (true)
+    {
+        LOG_SLOT* slot = &slots[position & slot_mask];
+        int64_t difference = static_cast<int64_t>(slot->sequence.load(memory_order_acquire) - position);
+        if (difference == 0)
+        {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+            {
+                return slot;
+            }
+        }
+        else if (difference < 0)
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+            return nullptr;     // The writer thread has not caught up with this slot yet
+        }
+        else
+        {
+            position = enqueue_position.load(memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * Hands a filled slot to the writer thread.
+ * @param slot: The slot from claim().
+ * @param position: The position from claim().
+ */
+void ASYNC_LOGGER::publish(LOG_SLOT* slot, uint64_t position)
+{
+    slot->sequence.store(position + 1, memory_order_release);
+}
+
+/**
+ * Appends the text of one argument.
+ * @param record: The record (holds the string arguments).
+ * @param arg: The argument.
+ * @param line: The text is appended here.
+ */
+static void append_log_arg(const LOG_RECORD& record, const LOG_ARG& arg, string& line)
+{
+    char number[32];
+    int length = 0;
+    switch (arg.type)
+    {
+        case LOG_ARG_INT:
+            length = snprintf(number, sizeof(number), "%" PRId64, arg.int_value);
+            break;
+        case LOG_ARG_UINT:
+            length = snprintf(number, sizeof(number), "%" PRIu64, arg.uint_value);
+            break;
+        case LOG_ARG_DOUBLE:
+            length = snprintf(number, sizeof(number), "%g", arg.double_value);
+            break;
+        default:
+            line.append(record.text + arg.text_offset, arg.text_length);
+            return;
+    }
+    line.append(number, static_cast<size_t>(length));
+}
+
+/**
+ * Formats a record as one line: "12:34:56.789012 INFO  [Camera 0] text".
+ * @param record: The record.
+ * @param line: The line is appended here.
+ */
+void ASYNC_LOGGER::format_record(const LOG_RECORD& record, string& line)
+{
+    // localtime_r is slow (time zone lookup), the lines of one second share it
+    static thread_local time_t cached_seconds = -1;
+    static thread_local struct tm local_time;
+    time_t seconds = static_cast<time_t>(record.time_ns / 1000000000ULL);
+    if (seconds != cached_seconds)
+    {
+        localtime_r(&seconds, &local_time);
+        cached_seconds = seconds;
+    }
+
+    char prefix[64];
+    int length = snprintf(prefix, sizeof(prefix), "%02d:%02d:%02d.%06u %-5s ", local_time.tm_hour, local_time.tm_min, local_time.tm_sec,
+                          static_cast<unsigned int>(record.time_ns % 1000000000ULL / 1000), get_log_level_name(static_cast<LOG_LEVEL>(record.level)));
+    line.append(prefix, static_cast<size_t>(length));
+
+    if (record.tag_name)
+    {
+        line += '[';
+        line += record.tag_name;
+        if (record.tag_index >= 0)
+        {
+            line += ' ';
+            line += to_string(record.tag_index);
+        }
+        line += "] ";
+    }
+
+    // {} -> next argument, arguments without a placeholder are appended
+    unsigned int next_arg = 0;
+    for (const char* text = record.format; *text; text++)
+    {
+        if (text[0] == '{' && text[1] == '}' && next_arg < record.arg_count)
+        {
+            append_log_arg(record, record.args[next_arg++], line);
+            text++;
+        }
+        else
+        {
+            line += *text;
+        }
+    }
+    while (next_arg < record.arg_count)
+    {
+        line += ' ';
+        append_log_arg(record, record.args[next_arg++], line);
+    }
+
+    if (record.suppressed > 0)
+    {
+        line += " (" + to_string(record.suppressed) + " similar message(s) suppressed)";
+    }
+    line += '\n';
+}
+
+/**
+ * Writes the text of a batch, one write per stream.
+ * @param out: Debug and info lines.
+ * @param err: Warning and error lines (to the same file as out if a log file is used).
+ */
+void ASYNC_LOGGER::write_lines(const string& out, const string& err)
+{
+    if (log_file)
+    {
+        fwrite(out.data(), 1, out.size(), log_file);
+        fwrite(err.data(), 1, err.size(), log_file);
+        fflush(log_file);
+        return;
+    }
+
+    if (!out.empty())
+    {
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+    if (!err.empty())
+    {
+        fwrite(err.data(), 1, err.size(), stderr);
+    }
+}
+
+/**
+ * Formats and writes a record right away (the writer thread is not running).
+ * @param record: The record.
+ */
+void ASYNC_LOGGER::write_now(const LOG_RECORD& record)
+{
+    string line;
+    format_record(record, line);
+    if (record.level >= LOG_WARNING)
+    {
+        write_lines("", line);
+    }
+    else
+    {
+        write_lines(line, "");
+    }
+    written.fetch_add(1, memory_order_relaxed);
+}
+
+/**
+ * Formats and writes every record that is ready, in queue order.
+ * @return Number of records written.
+ */
+size_t ASYNC_LOGGER::drain()
+{
+    string out;
+    string err;
+    size_t count = 0;
+
+    while (true)
+    {
+        LOG_SLOT& slot = slots[dequeue_position & slot_mask];
+        if (slot.sequence.load(memory_order_acquire) != dequeue_position + 1)
+        {
+            break;  // Not published yet (or empty)
+        }
+
+        format_record(slot.record, slot.record.level >= LOG_WARNING ? err : out);
+        slot.sequence.store(dequeue_position + slots.size(), memory_order_release);
+        dequeue_position++;
+        count++;
+
+        if (out.size() + err.size() > 256 * 1024)
+        {
+            write_lines(out, err);
+            out.clear();
+            err.clear();
+        }
+    }
+
+    if (!out.empty() || !err.empty())
+    {
+        write_lines(out, err);
+    }
+    written.fetch_add(count, memory_order_relaxed);
+    return count;
+}
+
+/**
+ * Writer thread: drains the queue, sleeps flush_interval_ms when it is empty. Drains once more after stop().
+ */
+void ASYNC_LOGGER::writer_loop()
+{
+    while (running.load(memory_order_acquire))
+    {
+        if (drain() == 0)
+        {
+            this_thread::sleep_for(chrono::milliseconds(config.flush_interval_ms));
+        }
+    }
+    drain();
+}
+
+uint64_t ASYNC_LOGGER::get_dropped_count()
+{
+    return dropped.load(memory_order_relaxed);
+}
+
+uint64_t ASYNC_LOGGER::get_written_count()
+{
+    return written.load(memory_order_relaxed);
+}
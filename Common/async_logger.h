@@ -0,0 +1,319 @@
+// async_logger.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace std;
+
+// Severity levels, messages below the configured level are skipped before anything is copied
+enum LOG_LEVEL
+{
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR
+};
+
+// Tag in front of a message: "[Camera 0]" (name and index) or "[Frame writer]" (index < 0). The name must be a string literal.
+struct LOG_TAG
+{
+    const char* name;
+    int index;
+};
+
+// Struct to hold the logger configuration
+struct LOG_CONFIG
+{
+    string path;                        // Log file (appended), empty -> stdout, warnings and errors to stderr
+    LOG_LEVEL min_level;
+    size_t capacity;                    // Records in the queue (rounded up to a power of two), a full queue drops messages
+    unsigned int rate_limit;            // Warnings/errors per second from the same call (format string), 0 -> unlimited
+    unsigned int flush_interval_ms;     // How long the writer thread sleeps when the queue is empty
+};
+
+// Argument of a message, stored in binary and formatted on the writer thread
+enum LOG_ARG_TYPE : uint8_t
+{
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_TEXT        // Copied into LOG_RECORD::text
+};
+
+struct LOG_ARG
+{
+    LOG_ARG_TYPE type;
+    uint16_t text_length;
+    union
+    {
+        int64_t int_value;
+        uint64_t uint_value;
+        double double_value;
+        uint32_t text_offset;
+    };
+};
+
+// One message as queued: the format string pointer, the tag and the arguments, no text formatting yet
+struct LOG_RECORD
+{
+    static const size_t MAX_ARGS = 8;
+    static const size_t TEXT_SIZE = 192;
+
+    uint64_t time_ns;           // system_clock
+    const char* format;         // String literal with {} placeholders
+    const char* tag_name;       // nullptr -> no tag
+    int32_t tag_index;
+    uint8_t level;
+    uint8_t arg_count;
+    uint16_t text_used;
+    uint32_t suppressed;        // Messages of the same call dropped by the rate limit before this one
+    LOG_ARG args[MAX_ARGS];
+    char text[TEXT_SIZE];       // String arguments, truncated when full
+};
+
+// Queue slot: sequence == position -> free for the producer, position + 1 -> record ready for the writer thread
+struct LOG_SLOT
+{
+    atomic<uint64_t> sequence;
+    LOG_RECORD record;
+};
+
+// Rate limit state of one call (keyed by the format string pointer)
+struct LOG_RATE_SLOT
+{
+    atomic<const char*> format;
+    atomic<uint64_t> window_start_ns;
+    atomic<uint32_t> count;
+    atomic<uint32_t> suppressed;
+};
+
+// Asynchronous logger for the acquisition loops. A message is a bounded MPSC queue slot claimed with one CAS and filled
+// with the binary arguments; formatting, the timestamp text and the writes (one per batch, no flush per line) happen on
+// the writer thread. A full queue drops and counts the message instead of blocking the caller. Before start() (and after
+// stop()) messages are formatted and written synchronously, so library code can always log.
+class ASYNC_LOGGER
+{
+    public:
+        static const size_t RATE_SLOTS = 64;
+
+    private:
+        static atomic<bool> running;
+        static atomic<int> min_level;
+        static LOG_CONFIG config;
+        static vector<LOG_SLOT> slots;      // Allocated by start(), kept until the process exits
+        static size_t slot_mask;
+        static atomic<uint64_t> enqueue_position;
+        static uint64_t dequeue_position;   // Writer thread only
+        static atomic<uint64_t> dropped;
+        static atomic<uint64_t> written;
+        static LOG_RATE_SLOT rate_slots[RATE_SLOTS];
+        static thread writer_thread;
+        static FILE* log_file;
+
+        static void writer_loop();
+        static size_t drain();
+        static void write_lines(const string& out, const string& err);
+
+    public:
+        static int start(const LOG_CONFIG& log_config);    // Start the writer thread
+        static void stop();                                 // Write what is queued and stop the writer thread
+
+        static inline bool is_enabled(LOG_LEVEL level);
+        static inline bool is_running();
+        static bool allow(const char* format, uint64_t now_ns, uint32_t& suppressed);  // Rate limit of warnings and errors
+        static LOG_SLOT* claim(uint64_t& position);         // nullptr -> queue full (counted as dropped)
+        static void publish(LOG_SLOT* slot, uint64_t position);
+        static void write_now(const LOG_RECORD& record);    // Synchronous path when the writer thread is not running
+        static void format_record(const LOG_RECORD& record, string& line);
+
+        static uint64_t get_dropped_count();
+        static uint64_t get_written_count();
+};
+
+LOG_CONFIG default_log_config();
+const char* get_log_level_name(LOG_LEVEL level);
+bool parse_log_level(const string& name, LOG_LEVEL& level);    // debug, info, warning, error
+
+/**
+ * Checks whether messages of a level are logged.
+ * @param level: The level.
+ * @return true if the level is at or above the configured minimum.
+ */
+inline bool ASYNC_LOGGER::is_enabled(LOG_LEVEL level)
+{
+    return static_cast<int>(level) >= min_level.load(memory_order_relaxed);
+}
+
+inline bool ASYNC_LOGGER::is_running()
+{
+    return running.load(memory_order_acquire);
+}
+
+/**
+ * Creates a tag for a camera (or another numbered component).
+ * @param name: String literal, e.g. "Camera".
+ * @param index: The index, < 0 -> only the name.
+ * @return The tag.
+ */
+inline LOG_TAG log_tag(const char* name, int index = -1)
+{
+    LOG_TAG tag = {name, index};
+    return tag;
+}
+
+// Argument encoding: integers and floating point values are stored as they are, strings are copied
+
+inline void add_log_text(LOG_RECORD& record, const char* text, size_t length)
+{
+    LOG_ARG& arg = record.args[record.arg_count++];
+    size_t available = LOG_RECORD::TEXT_SIZE - record.text_used;
+    length = length < available ? length : available;
+    memcpy(record.text + record.text_used, text, length);
+    arg.type = LOG_ARG_TEXT;
+    arg.text_offset = record.text_used;
+    arg.text_length = static_cast<uint16_t>(length);
+    record.text_used = static_cast<uint16_t>(record.text_used + length);
+}
+
+inline void add_log_arg(LOG_RECORD& record, const char* value)
+{
+    add_log_text(record, value ? value : "(null)", value ? strlen(value) : 6);
+}
+
+inline void add_log_arg(LOG_RECORD& record, const string& value)
+{
+    add_log_text(record, value.data(), value.size());
+}
+
+template <typename T>
+inline typename enable_if<is_integral<T>::value && is_signed<T>::value>::type add_log_arg(LOG_RECORD& record, T value)
+{
+    LOG_ARG& arg = record.args[record.arg_count++];
+    arg.type = LOG_ARG_INT;
+    arg.int_value = static_cast<int64_t>(value);
+}
+
+template <typename T>
+inline typename enable_if<is_integral<T>::value && !is_signed<T>::value>::type add_log_arg(LOG_RECORD& record, T value)
+{
+    LOG_ARG& arg = record.args[record.arg_count++];
+    arg.type = LOG_ARG_UINT;
+    arg.uint_value = static_cast<uint64_t>(value);
+}
+
+template <typename T>
+inline typename enable_if<is_floating_point<T>::value>::type add_log_arg(LOG_RECORD& record, T value)
+{
+    LOG_ARG& arg = record.args[record.arg_count++];
+    arg.type = LOG_ARG_DOUBLE;
+    arg.double_value = static_cast<double>(value);
+}
+
+inline void add_log_args(LOG_RECORD& record)
+{
+    (void)record;
+}
+
+template <typename FIRST, typename... REST>
+inline void add_log_args(LOG_RECORD& record, const FIRST& first, const REST&... rest)
+{
+    if (record.arg_count < LOG_RECORD::MAX_ARGS)
+    {
+        add_log_arg(record, first);
+        add_log_args(record, rest...);
+    }
+}
+
+/**
+ * Logs a message. Placeholders {} in the format are replaced by the arguments in order.
+ * @param level: The severity, warnings and errors are rate limited per format string.
+ * @param tag: The tag, e.g. log_tag("Camera", 0).
+ * @param format: String literal (only the pointer is queued).
+ * @param args: Up to LOG_RECORD::MAX_ARGS integers, floating point values or strings.
+ */
+template <typename... ARGS>
+inline void log_message(LOG_LEVEL level, const LOG_TAG& tag, const char* format, const ARGS&... args)
+{
+    if (!ASYNC_LOGGER::is_enabled(level))
+    {
+        return;
+    }
+
+    uint64_t now_ns = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count());
+    uint32_t suppressed = 0;
+    if (level >= LOG_WARNING && !ASYNC_LOGGER::allow(format, now_ns, suppressed))
+    {
+        return;
+    }
+
+    uint64_t position = 0;
+    LOG_SLOT* slot = nullptr;
+    LOG_RECORD local_record;
+    bool queued = ASYNC_LOGGER::is_running();
+    if (queued)
+    {
+        slot = ASYNC_LOGGER::claim(position);
+        if (!slot)
+        {
+            return;     // Queue full, counted as dropped
+        }
+    }
+
+    LOG_RECORD& record = queued ? slot->record : local_record;
+    record.time_ns = now_ns;
+    record.format = format;
+    record.tag_name = tag.name;
+    record.tag_index = tag.index;
+    record.level = static_cast<uint8_t>(level);
+    record.arg_count = 0;
+    record.text_used = 0;
+    record.suppressed = suppressed;
+    add_log_args(record, args...);
+
+    if (queued)
+    {
+        ASYNC_LOGGER::publish(slot, position);
+    }
+    else
+    {
+        ASYNC_LOGGER::write_now(record);
+    }
+}
+
+template <typename... ARGS>
+inline void log_debug(const LOG_TAG& tag, const char* format, const ARGS&... args)
+{
+    log_message(LOG_DEBUG, tag, format, args...);
+}
+
+template <typename... ARGS>
+inline void log_info(const LOG_TAG& tag, const char* format, const ARGS&... args)
+{
+    log_message(LOG_INFO, tag, format, args...);
+}
+
+template <typename... ARGS>
+inline void log_warning(const LOG_TAG& tag, const char* format, const ARGS&... args)
+{
+    log_message(LOG_WARNING, tag, format, args...);
+}
+
+template <typename... ARGS>
+inline void log_error(const LOG_TAG& tag, const char* format, const ARGS&... args)
+{
+    log_message(LOG_ERROR, tag, format, args...);
+}
+
+#endif // ASYNC_LOGGER_H
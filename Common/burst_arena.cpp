@@ -0,0 +1,309 @@
+// Description: Preallocated frame arena for burst capture with a parallel drain to disk
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "burst_arena.h"
+#include "direct_file.h"
+
+using namespace std;
+
+/**
+ * Constructor for the BURST_ARENA class.
+ */
+BURST_ARENA::BURST_ARENA()
+    : frame_count(0), has_last_frame_id(false), last_frame_id(0), first_timestamp_ns(0), last_timestamp_ns(0)
+{
+    memset(&report, 0, sizeof(report));
+}
+
+/**
+ * Allocates one page aligned slot per frame. All memory is touched here, not during the burst.
+ * @param frame_capacity: Maximum number of frames in a burst.
+ * @param max_frame_bytes: Largest pixel payload.
+ * @return 0 if successful, -1 otherwise.
+ */
+int BURST_ARENA::init(unsigned int frame_capacity, size_t max_frame_bytes)
+{
+    size_t record_size = align_up(sizeof(FRAME_HEADER) + max_frame_bytes, PAGE_ALIGNMENT);
+
+    if (frame_memory.init(frame_capacity, record_size) != 0)
+    {
+        cerr << "[Burst] Unable to allocate " << frame_capacity << " frames of " << record_size << " bytes\n";
+        return -1;
+    }
+
+    frames.resize(frame_capacity);
+    reset();
+
+    cout << "[Burst] Arena ready: " << frame_capacity << " frames, "
+         << (static_cast<double>(record_size) * frame_capacity) / (1024.0 * 1024.0) << " MB" << endl;
+    return 0;
+}
+
+/**
+ * Copies the frame into the next arena slot.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if stored, -1 if the arena is full or the frame is too large (counted as dropped).
+ */
+int BURST_ARENA::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    size_t payload_size = sizeof(FRAME_HEADER) + header.data_size;
+    size_t record_size = align_up(payload_size, PAGE_ALIGNMENT);
+
+    if (frame_count >= frames.size() || record_size > frame_memory.get_buffer_size())
+    {
+        report.frames_dropped++;
+        return -1;
+    }
+
+    // Gaps in the camera frame counter are frames the camera or the host lost
+    if (has_last_frame_id && header.frame_id > last_frame_id + 1)
+    {
+        report.frames_dropped += header.frame_id - last_frame_id - 1;
+    }
+    has_last_frame_id = true;
+    last_frame_id = header.frame_id;
+
+    char* buffer = frame_memory.get_buffer(frame_count);
+    memcpy(buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(buffer + sizeof(FRAME_HEADER), data, header.data_size);
+
+    BURST_FRAME& frame = frames[frame_count];
+    frame.record_size = record_size;
+    frame.frame_id = header.frame_id;
+    memcpy(frame.serial, header.serial, sizeof(frame.serial));
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (frame_count == 0)
+    {
+        first_frame_time = now;
+        first_timestamp_ns = header.timestamp_ns;
+    }
+    last_frame_time = now;
+    last_timestamp_ns = header.timestamp_ns;
+
+    frame_count++;
+    report.frames_captured = frame_count;
+    return 0;
+}
+
+/**
+ * Returns the sink name.
+ */
+const char* BURST_ARENA::get_sink_name() const
+{
+    return "burst arena";
+}
+
+/**
+ * Counts frames the caller lost before they reached the arena.
+ * @param count: Number of lost frames.
+ */
+void BURST_ARENA::add_dropped(uint64_t count)
+{
+    report.frames_dropped += count;
+}
+
+bool BURST_ARENA::is_full() const
+{
+    return frame_count >= frames.size();
+}
+
+unsigned int BURST_ARENA::get_frame_count() const
+{
+    return frame_count;
+}
+
+unsigned int BURST_ARENA::get_capacity() const
+{
+    return static_cast<unsigned int>(frames.size());
+}
+
+/**
+ * Finds the first burst number after the bursts of earlier drains, so a second burst into the same folder keeps them.
+ * @param folder_path: The output folder.
+ * @return The highest burst_<number>_*.raw in the folder plus 1, or 1 if there is none.
+ */
+static unsigned int find_next_burst_number(const string& folder_path)
+{
+    unsigned int next_number = 1;
+
+    DIR* directory = opendir(folder_path.empty() ? "." : folder_path.c_str());
+    if (directory == nullptr)
+    {
+        return next_number;     // The frame files report the error when they are created
+    }
+
+    while (struct dirent* entry = readdir(directory))
+    {
+        unsigned int number = 0;
+        int name_length = 0;
+        if (sscanf(entry->d_name, "burst_%4u_%n", &number, &name_length) == 1 && name_length == 11 && number >= next_number)
+        {
+            next_number = number + 1;   // Exactly 4 digits, so burst_<serial>_<frame_id>.raw of older versions is not a number
+        }
+    }
+    closedir(directory);
+
+    return next_number;
+}
+
+/**
+ * Writes every stored frame to <folder>/burst_<number>_<serial>_<frame_id>.raw using several threads. The number
+ * continues after the bursts already in the folder, and existing files are never replaced.
+ * The padded record is written (so O_DIRECT works) and the file is then trimmed to header + pixels.
+ * @param folder_path: Output folder.
+ * @param thread_count: Number of writer threads.
+ * @param use_direct_io: Write with O_DIRECT.
+ * @return 0 if every frame was written, -1 otherwise.
+ */
+int BURST_ARENA::drain(const string& folder_path, unsigned int thread_count, bool use_direct_io)
+{
+    if (thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    // Achieved rate of the burst, from the camera clock when available
+    report.capture_seconds = chrono::duration<double>(last_frame_time - first_frame_time).count();
+    if (frame_count > 1 && last_timestamp_ns > first_timestamp_ns)
+    {
+        report.capture_seconds = (last_timestamp_ns - first_timestamp_ns) / 1e9;
+    }
+    report.achieved_fps = report.capture_seconds > 0.0 ? (frame_count - 1) / report.capture_seconds : 0.0;
+
+    atomic<unsigned int> next_frame(0);
+    atomic<uint64_t> bytes_written(0);
+    atomic<uint64_t> frames_written(0);
+
+    string prefix = folder_path;
+    if (!prefix.empty() && prefix.back() != '/')
+    {
+        prefix += '/';
+    }
+
+    unsigned int burst_number = find_next_burst_number(folder_path);
+    atomic<uint64_t> frames_existing(0);
+
+    auto drain_worker = [&]()
+    {
+        unsigned int index;
+        while ((index = next_frame++) < frame_count)
+        {
+            const BURST_FRAME& frame = frames[index];
+            const char* buffer = frame_memory.get_buffer(index);
+            const FRAME_HEADER* header = reinterpret_cast<const FRAME_HEADER*>(buffer);
+
+            char serial[sizeof(frame.serial) + 1] = {0};
+            memcpy(serial, frame.serial, sizeof(frame.serial));
+
+            ostringstream path;
+            path << prefix << "burst_" << setw(4) << setfill('0') << burst_number << "_" << (serial[0] ? serial : "camera") << "_"
+                 << setw(8) << frame.frame_id << ".raw";
+
+            bool direct_io_active = false;
+            int fd = open_new_output_file(path.str(), use_direct_io, direct_io_active);
+            if (fd < 0)
+            {
+                if (errno == EEXIST)
+                {
+                    frames_existing++;
+                }
+                continue;
+            }
+
+            uint64_t file_size = sizeof(FRAME_HEADER) + header->data_size;
+            if (write_all(fd, buffer, frame.record_size, 0) == 0 && ftruncate(fd, static_cast<off_t>(file_size)) == 0)
+            {
+                if (!direct_io_active)
+                {
+                    drop_written_range(fd, 0, frame.record_size);
+                }
+                frames_written++;
+                bytes_written += file_size;
+            }
+            close(fd);
+        }
+    };
+
+    cout << "[Burst] Draining " << frame_count << " frames with " << thread_count << " thread(s) as burst " << burst_number << endl;
+    auto start_time = chrono::steady_clock::now();
+
+    vector<thread> workers;
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        workers.push_back(thread(drain_worker));
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    report.drain_seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    report.frames_drained = frames_written.load();
+    report.bytes_drained = bytes_written.load();
+    report.drain_threads = thread_count;
+
+    if (frames_existing > 0)
+    {
+        cerr << "[Burst] " << frames_existing.load() << " file(s) of burst " << burst_number << " already existed and were not replaced" << endl;
+    }
+
+    return report.frames_drained == frame_count ? 0 : -1;
+}
+
+/**
+ * Forgets the stored frames (the memory stays allocated for the next burst).
+ */
+void BURST_ARENA::reset()
+{
+    frame_count = 0;
+    has_last_frame_id = false;
+    last_frame_id = 0;
+    first_timestamp_ns = 0;
+    last_timestamp_ns = 0;
+    memset(&report, 0, sizeof(report));
+}
+
+/**
+ * Returns the burst report (capture numbers are final after drain()).
+ * @return The report.
+ */
+BURST_REPORT BURST_ARENA::get_report() const
+{
+    return report;
+}
+
+/**
+ * Prints a burst report.
+ * @param report: The report to print.
+ */
+void print_burst_report(const BURST_REPORT& report)
+{
+    double drain_mb_per_second = report.drain_seconds > 0.0 ? report.bytes_drained / report.drain_seconds / (1024.0 * 1024.0) : 0.0;
+
+    ostringstream text;     // Own stream, the format flags of cout are left alone
+    text << endl << "*** BURST REPORT ***" << endl << endl;
+    text << fixed << setprecision(2);
+    text << "Frames captured: " << report.frames_captured << endl;
+    text << "Frames dropped:  " << report.frames_dropped << endl;
+    text << "Capture time:    " << report.capture_seconds << " s" << endl;
+    text << "Achieved rate:   " << report.achieved_fps << " fps" << endl;
+    text << "Frames drained:  " << report.frames_drained << " (" << report.bytes_drained / (1024.0 * 1024.0) << " MB)" << endl;
+    text << "Drain time:      " << report.drain_seconds << " s (" << drain_mb_per_second << " MB/s, "
+         << report.drain_threads << " thread(s))" << endl;
+    cout << text.str();
+}
@@ -0,0 +1,88 @@
+// burst_arena.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef BURST_ARENA_H
+#define BURST_ARENA_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Struct to hold the burst settings of a capture tool
+struct BURST_CONFIG
+{
+    unsigned int frame_count;   // Stop after this many frames (0 = use seconds)
+    double seconds;             // Stop after this long (0 = use frame_count)
+    unsigned int drain_threads;
+    string folder_path;
+    bool use_direct_io;
+};
+
+// Struct to hold the result of a burst
+struct BURST_REPORT
+{
+    uint64_t frames_captured;       // Frames stored in the arena
+    uint64_t frames_dropped;        // Frame ID gaps + incomplete images + arena full
+    double capture_seconds;         // First to last stored frame
+    double achieved_fps;            // From the camera timestamps (wall clock if the camera reports none)
+    uint64_t frames_drained;
+    uint64_t bytes_drained;
+    double drain_seconds;
+    unsigned int drain_threads;
+};
+
+// Preallocated arena for burst capture. During the burst consume_frame only copies into memory, so acquisition
+// runs at sensor rate; drain() then writes every frame to its own .raw file with several threads.
+class BURST_ARENA : public FRAME_SINK
+{
+    private:
+        struct BURST_FRAME
+        {
+            size_t record_size;     // Page aligned size in the arena
+            uint64_t frame_id;
+            char serial[16];
+        };
+
+        ALIGNED_BUFFER_POOL frame_memory;
+        vector<BURST_FRAME> frames;
+        unsigned int frame_count;
+
+        bool has_last_frame_id;
+        uint64_t last_frame_id;
+        uint64_t first_timestamp_ns;
+        uint64_t last_timestamp_ns;
+        chrono::steady_clock::time_point first_frame_time;
+        chrono::steady_clock::time_point last_frame_time;
+
+        BURST_REPORT report;
+
+    public:
+        BURST_ARENA();
+
+        int init(unsigned int frame_capacity, size_t max_frame_bytes);     // Allocate (and touch) the whole arena
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);   // Returns -1 once the arena is full
+        const char* get_sink_name() const;
+
+        void add_dropped(uint64_t count);  // Frames the caller lost (e.g. incomplete images)
+        bool is_full() const;
+        unsigned int get_frame_count() const;
+        unsigned int get_capacity() const;
+
+        int drain(const string& folder_path, unsigned int thread_count, bool use_direct_io);  // Write burst_<number>_<serial>_<frame_id>.raw files
+        void reset();  // Forget the stored frames, keep the memory
+
+        BURST_REPORT get_report() const;
+};
+
+void print_burst_report(const BURST_REPORT& report);
+
+#endif // BURST_ARENA_H
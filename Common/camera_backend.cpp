@@ -0,0 +1,110 @@
+// Description: Camera backend helpers -> applying node settings and pixel format names
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+
+#include "camera_backend.h"
+
+using namespace std;
+
+/**
+ * Applies the settings to a stopped camera.
+ * @param camera: The camera.
+ * @param settings: The settings to apply.
+ * @return 0 if every setting was applied, -1 otherwise.
+ */
+int configure_camera_backend(CAMERA_BACKEND& camera, const CAMERA_BACKEND_SETTINGS& settings)
+{
+    int result = 0;
+
+    result |= camera.set_pixel_format(settings.pixel_format);
+    if (settings.width > 0 && settings.height > 0)
+    {
+        result |= camera.set_roi(settings.width, settings.height, settings.offset_x, settings.offset_y);
+    }
+    result |= camera.set_exposure(settings.exposure_us);
+    result |= camera.set_gain(settings.gain_db);
+    if (settings.gamma > 0.0)
+    {
+        result |= camera.set_gamma(settings.gamma);
+    }
+
+    if (result != 0)
+    {
+        cerr << "[Camera] " << camera.get_backend_name() << " " << camera.get_serial() << ": not every setting could be applied\n";
+    }
+    return result;
+}
+
+/**
+ * Returns the default settings.
+ * @return Mono8, full sensor, 10 ms exposure, 0 dB gain.
+ */
+CAMERA_BACKEND_SETTINGS default_camera_backend_settings()
+{
+    CAMERA_BACKEND_SETTINGS settings;
+    settings.pixel_format = FRAME_PIXEL_FORMAT_MONO8;
+    settings.width = 0;
+    settings.height = 0;
+    settings.offset_x = 0;
+    settings.offset_y = 0;
+    settings.exposure_us = 10000.0;
+    settings.gain_db = 0.0;
+    settings.gamma = 0.0;
+    return settings;
+}
+
+/**
+ * Parses a pixel format name.
+ * @param name: mono8, mono16, bgr8 or bayer_rg8.
+ * @param pixel_format: Receives the FRAME_PIXEL_FORMAT.
+ * @return true if the name is known.
+ */
+bool parse_frame_pixel_format(const string& name, uint32_t& pixel_format)
+{
+    if (name == "mono8")
+    {
+        pixel_format = FRAME_PIXEL_FORMAT_MONO8;
+        return true;
+    }
+    if (name == "mono16")
+    {
+        pixel_format = FRAME_PIXEL_FORMAT_MONO16;
+        return true;
+    }
+    if (name == "bgr8")
+    {
+        pixel_format = FRAME_PIXEL_FORMAT_BGR8;
+        return true;
+    }
+    if (name == "bayer_rg8")
+    {
+        pixel_format = FRAME_PIXEL_FORMAT_BAYER_RG8;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the name of a pixel format.
+ * @param pixel_format: One of FRAME_PIXEL_FORMAT.
+ * @return The name, "unknown" for anything else.
+ */
+const char* get_frame_pixel_format_name(uint32_t pixel_format)
+{
+    switch (pixel_format & ~FRAME_COMPRESSED_FLAG)
+    {
+        case FRAME_PIXEL_FORMAT_MONO8:
+            return "mono8";
+        case FRAME_PIXEL_FORMAT_MONO16:
+            return "mono16";
+        case FRAME_PIXEL_FORMAT_BGR8:
+            return "bgr8";
+        case FRAME_PIXEL_FORMAT_BAYER_RG8:
+            return "bayer_rg8";
+        default:
+            return "unknown";
+    }
+}
@@ -0,0 +1,74 @@
+// camera_backend.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef CAMERA_BACKEND_H
+#define CAMERA_BACKEND_H
+
+#include "frame_format.h"
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// A frame handed out by CAMERA_BACKEND::next_frame. data stays valid until release_frame().
+struct CAMERA_FRAME
+{
+    FRAME_HEADER header;
+    const void* data;
+};
+
+// Node settings applied by configure_camera_backend (the subset the tools use)
+struct CAMERA_BACKEND_SETTINGS
+{
+    uint32_t pixel_format;  // FRAME_PIXEL_FORMAT of the delivered frames
+    int64_t width;          // ROI, 0 -> leave the width/height as they are
+    int64_t height;
+    int64_t offset_x;
+    int64_t offset_y;
+    double exposure_us;     // Manual exposure time (auto exposure is turned off)
+    double gain_db;         // Manual gain (auto gain is turned off)
+    double gamma;           // <= 0 -> leave gamma as it is
+};
+
+// A camera as seen by the capture code: configure, start, take frames, stop.
+// SPINNAKER_CAMERA (spinnaker_camera.h) drives a real camera, SYNTHETIC_CAMERA generates frames without hardware.
+class CAMERA_BACKEND
+{
+    public:
+        virtual ~CAMERA_BACKEND() {}
+
+        virtual int init() = 0;     // Open the camera
+        virtual int deinit() = 0;   // Close it (stops acquisition first)
+
+        // Node configuration, only while stopped. Values outside the camera's range are clamped.
+        virtual int set_pixel_format(uint32_t pixel_format) = 0;
+        virtual int set_roi(int64_t width, int64_t height, int64_t offset_x, int64_t offset_y) = 0;
+        virtual int set_exposure(double exposure_us) = 0;
+        virtual int set_gain(double gain_db) = 0;
+        virtual int set_gamma(double gamma) = 0;
+
+        virtual int start() = 0;
+        virtual int stop() = 0;
+
+        // Waits for the next frame. Returns 0 with a frame (call release_frame() when done with it), 1 if no
+        // complete frame arrived within timeout_ms (skip it and go on), -1 on an error.
+        virtual int next_frame(CAMERA_FRAME& frame, unsigned int timeout_ms) = 0;
+        virtual void release_frame() = 0;
+
+        virtual string get_serial() const = 0;
+        virtual size_t get_max_frame_bytes() const = 0;    // Largest frame with the current ROI and pixel format
+        virtual const char* get_backend_name() const = 0;
+};
+
+// Applies the settings in the order the camera needs them (pixel format and ROI before exposure).
+int configure_camera_backend(CAMERA_BACKEND& camera, const CAMERA_BACKEND_SETTINGS& settings);
+
+// Default settings: Mono8, full sensor, 10 ms exposure, 0 dB gain, gamma untouched
+CAMERA_BACKEND_SETTINGS default_camera_backend_settings();
+
+bool parse_frame_pixel_format(const string& name, uint32_t& pixel_format);    // mono8 | mono16 | bgr8 | bayer_rg8
+const char* get_frame_pixel_format_name(uint32_t pixel_format);
+
+#endif // CAMERA_BACKEND_H
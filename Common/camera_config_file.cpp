@@ -0,0 +1,673 @@
+// Description: Sectioned camera settings file with global defaults and per-serial overrides, shared by the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "camera_config_file.h"
+
+using namespace std;
+
+static const char* const BUFFER_HANDLING_MODES[] = {"OldestFirst", "OldestFirstOverwrite", "NewestOnly", "NewestFirst"};
+
+/**
+ * Returns a profile with no settings given: the tools keep their own defaults, every frame goes to the sinks and the files.
+ * @return The profile.
+ */
+CAMERA_PROFILE default_camera_profile()
+{
+    CAMERA_PROFILE profile;
+    profile.serial = "";
+    profile.fields = 0;
+    profile.line = 0;
+    profile.exposure = 0.0;
+    profile.gain = 0.0;
+    profile.gamma = 0.0;
+    profile.sharpening = 0.0;
+    profile.saturation = 0.0;
+    profile.pixel_format = "";
+    profile.frame_rate = 0.0;
+    profile.buffer_count = 0;
+    profile.buffer_handling = "";
+    profile.outputs = FRAME_OUTPUT_ALL;
+    return profile;
+}
+
+// Removes leading and trailing white space
+static string trim(const string& text)
+{
+    size_t begin = 0;
+    size_t end = text.size();
+    while (begin < end && isspace(static_cast<unsigned char>(text[begin])))
+    {
+        begin++;
+    }
+    while (end > begin && isspace(static_cast<unsigned char>(text[end - 1])))
+    {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+static string to_lower(string text)
+{
+    transform(text.begin(), text.end(), text.begin(), ::tolower);
+    return text;
+}
+
+// Text after a number: nothing, or a unit in brackets as written by the trackbar tools ("20000 [μs]")
+static bool is_number_end(const char* end)
+{
+    string rest = trim(end);
+    return rest.empty() || rest[0] == '[';
+}
+
+static bool parse_double(const string& text, double& value)
+{
+    char* end = nullptr;
+    errno = 0;
+    value = strtod(text.c_str(), &end);
+    return end != text.c_str() && errno == 0 && is_number_end(end);
+}
+
+static bool parse_int(const string& text, int64_t& value)
+{
+    char* end = nullptr;
+    errno = 0;
+    value = strtoll(text.c_str(), &end, 10);
+    return end != text.c_str() && errno == 0 && is_number_end(end);
+}
+
+/**
+ * Constructor for the CAMERA_CONFIG_FILE class, starts with empty defaults.
+ */
+CAMERA_CONFIG_FILE::CAMERA_CONFIG_FILE()
+    : defaults(default_camera_profile())
+{
+}
+
+/**
+ * Reads and parses a settings file.
+ * @param path: The file.
+ * @return 0 if successful, -1 if the file cannot be read or a line is invalid.
+ */
+int CAMERA_CONFIG_FILE::load(const string& path)
+{
+    ifstream file_in(path);
+    if (!file_in)
+    {
+        cerr << "[Config] Unable to open " << path << endl;
+        return -1;
+    }
+
+    vector<string> lines;
+    string line;
+    while (getline(file_in, line))
+    {
+        lines.push_back(line);
+    }
+
+    return parse(lines, path);
+}
+
+/**
+ * Parses the lines of a settings file. Every invalid line is reported, not only the first one.
+ * @param lines: The file content.
+ * @param source: File name used in the messages.
+ * @return 0 if every line is valid, -1 otherwise (the sections that were read stay set).
+ */
+int CAMERA_CONFIG_FILE::parse(const vector<string>& lines, const string& source)
+{
+    int result = 0;
+    bool has_defaults_section = false;
+    CAMERA_PROFILE* section = &defaults;    // Lines before the first section (and the old format) go to the defaults
+
+    defaults = default_camera_profile();
+    cameras.clear();
+    cameras.reserve(lines.size());   // No reallocation while section points into it
+
+    for (size_t i = 0; i < lines.size(); i++)
+    {
+        string location = source + ":" + to_string(i + 1);
+        string line = trim(lines[i].substr(0, lines[i].find('#')));
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (line[0] == '[')
+        {
+            if (line[line.size() - 1] != ']')
+            {
+                cerr << "[Config] " << location << ": Missing ] in section header" << endl;
+                result = -1;
+                continue;
+            }
+
+            istringstream header(line.substr(1, line.size() - 2));
+            string kind;
+            string serial;
+            string extra;
+            header >> kind >> serial >> extra;
+            kind = to_lower(kind);
+
+            if (kind == "defaults" && serial.empty())
+            {
+                if (has_defaults_section)
+                {
+                    cerr << "[Config] " << location << ": Duplicate [defaults] section" << endl;
+                    result = -1;
+                }
+                has_defaults_section = true;
+                section = &defaults;
+            }
+            else if (kind == "camera" && !serial.empty() && extra.empty())
+            {
+                for (const CAMERA_PROFILE& camera : cameras)
+                {
+                    if (camera.serial == serial)
+                    {
+                        cerr << "[Config] " << location << ": Duplicate section for camera " << serial << " (first at line " << camera.line << ")" << endl;
+                        result = -1;
+                    }
+                }
+
+                CAMERA_PROFILE camera = default_camera_profile();
+                camera.serial = serial;
+                camera.line = static_cast<int>(i + 1);
+                cameras.push_back(camera);
+                section = &cameras.back();
+            }
+            else
+            {
+                cerr << "[Config] " << location << ": Unknown section " << line << ", use [defaults] or [camera <serial>]" << endl;
+                result = -1;
+            }
+            continue;
+        }
+
+        // "key = value", or "Key: value" of the old single camera files
+        size_t separator = line.find('=');
+        if (separator == string::npos)
+        {
+            separator = line.find(':');
+        }
+        if (separator == string::npos)
+        {
+            cerr << "[Config] " << location << ": Expected key = value" << endl;
+            result = -1;
+            continue;
+        }
+
+        string key = to_lower(trim(line.substr(0, separator)));
+        string value = trim(line.substr(separator + 1));
+        if (parse_setting(*section, key, value, location) != 0)
+        {
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Parses one setting into a profile and checks what can be checked without a camera.
+ * @param profile: The section the line belongs to.
+ * @param key: The key in lower case.
+ * @param value: The value text.
+ * @param location: file:line for the messages.
+ * @return 0 if the setting is valid, -1 otherwise.
+ */
+int CAMERA_CONFIG_FILE::parse_setting(CAMERA_PROFILE& profile, const string& key, const string& value, const string& location)
+{
+    double number = 0.0;
+    int64_t integer = 0;
+
+    // Floating point camera settings
+    struct FLOAT_SETTING
+    {
+        const char* key;
+        CAMERA_PROFILE_FIELD field;
+        double* target;
+        int minimum;        // 1 -> greater than 0, 0 -> 0 or more, -1 -> only the camera range
+    };
+    const FLOAT_SETTING float_settings[] =
+    {
+        {"exposure", PROFILE_EXPOSURE, &profile.exposure, 1},
+        {"gain", PROFILE_GAIN, &profile.gain, -1},
+        {"gamma", PROFILE_GAMMA, &profile.gamma, 1},
+        {"sharpening", PROFILE_SHARPENING, &profile.sharpening, -1},
+        {"saturation", PROFILE_SATURATION, &profile.saturation, -1},
+        {"frame_rate", PROFILE_FRAME_RATE, &profile.frame_rate, 0}
+    };
+
+    for (const FLOAT_SETTING& setting : float_settings)
+    {
+        if (key != setting.key)
+        {
+            continue;
+        }
+        if (!parse_double(value, number))
+        {
+            cerr << "[Config] " << location << ": " << key << " is not a number: " << value << endl;
+            return -1;
+        }
+        if ((setting.minimum == 1 && number <= 0.0) || (setting.minimum == 0 && number < 0.0))
+        {
+            cerr << "[Config] " << location << ": " << key << " must be " << (setting.minimum == 1 ? "greater than 0" : "0 or more") << endl;
+            return -1;
+        }
+        *setting.target = number;
+        profile.fields |= setting.field;
+        return 0;
+    }
+
+    if (key == "pixel_format")
+    {
+        if (value.empty() || !all_of(value.begin(), value.end(), [](char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; }))
+        {
+            cerr << "[Config] " << location << ": Invalid pixel format: " << value << endl;
+            return -1;
+        }
+        profile.pixel_format = value;
+        profile.fields |= PROFILE_PIXEL_FORMAT;
+        return 0;
+    }
+
+    if (key == "roi")
+    {
+        // offset_x, offset_y, width, height; every roi line of a section adds one region
+        int64_t numbers[4] = {0, 0, 0, 0};
+        istringstream fields(value);
+        string field;
+        int count = 0;
+        while (getline(fields, field, ','))
+        {
+            if (count == 4 || !parse_int(trim(field), numbers[count]))
+            {
+                count = -1;
+                break;
+            }
+            count++;
+        }
+        if (count != 4)
+        {
+            cerr << "[Config] " << location << ": roi must be offset_x, offset_y, width, height" << endl;
+            return -1;
+        }
+        if (numbers[0] < 0 || numbers[1] < 0 || numbers[2] <= 0 || numbers[3] <= 0)
+        {
+            cerr << "[Config] " << location << ": roi offsets must be 0 or more and the size greater than 0" << endl;
+            return -1;
+        }
+
+        if (!profile.has(PROFILE_ROIS))
+        {
+            profile.rois.clear();
+        }
+        ROI_SETTINGS roi = {numbers[0], numbers[1], numbers[2], numbers[3]};
+        profile.rois.push_back(roi);
+        profile.fields |= PROFILE_ROIS;
+        return 0;
+    }
+
+    if (key == "buffer_count")
+    {
+        if (!parse_int(value, integer) || integer < 1 || integer > 10000)
+        {
+            cerr << "[Config] " << location << ": buffer_count must be a number from 1 to 10000" << endl;
+            return -1;
+        }
+        profile.buffer_count = static_cast<unsigned int>(integer);
+        profile.fields |= PROFILE_BUFFER_COUNT;
+        return 0;
+    }
+
+    if (key == "buffer_handling")
+    {
+        for (const char* mode : BUFFER_HANDLING_MODES)
+        {
+            if (to_lower(value) == to_lower(mode))
+            {
+                profile.buffer_handling = mode;
+                profile.fields |= PROFILE_BUFFER_HANDLING;
+                return 0;
+            }
+        }
+        cerr << "[Config] " << location << ": Unknown buffer_handling " << value << ", use OldestFirst, OldestFirstOverwrite, NewestOnly or NewestFirst" << endl;
+        return -1;
+    }
+
+    if (key == "outputs")
+    {
+        // Comma separated: files, sinks, all or none
+        unsigned int outputs = 0;
+        istringstream names(value);
+        string name;
+        while (getline(names, name, ','))
+        {
+            name = to_lower(trim(name));
+            if (name == "files")
+            {
+                outputs |= FRAME_OUTPUT_FILES;
+            }
+            else if (name == "sinks")
+            {
+                outputs |= FRAME_OUTPUT_SINKS;
+            }
+            else if (name == "all")
+            {
+                outputs |= FRAME_OUTPUT_ALL;
+            }
+            else if (name != "none")
+            {
+                cerr << "[Config] " << location << ": Unknown output " << name << ", use files, sinks, all or none" << endl;
+                return -1;
+            }
+        }
+        profile.outputs = outputs;
+        profile.fields |= PROFILE_OUTPUTS;
+        return 0;
+    }
+
+    cerr << "[Config] " << location << ": Unknown key " << key << endl;
+    return -1;
+}
+
+/**
+ * Returns the settings of a camera: the defaults with the keys of its [camera <serial>] section applied.
+ * @param serial: The camera serial number.
+ * @return The profile (the defaults if the camera has no section).
+ */
+CAMERA_PROFILE CAMERA_CONFIG_FILE::get_profile(const string& serial) const
+{
+    CAMERA_PROFILE profile = defaults;
+    profile.serial = serial;
+
+    for (const CAMERA_PROFILE& camera : cameras)
+    {
+        if (camera.serial != serial)
+        {
+            continue;
+        }
+
+        profile.line = camera.line;
+        if (camera.has(PROFILE_EXPOSURE))
+        {
+            profile.exposure = camera.exposure;
+        }
+        if (camera.has(PROFILE_GAIN))
+        {
+            profile.gain = camera.gain;
+        }
+        if (camera.has(PROFILE_GAMMA))
+        {
+            profile.gamma = camera.gamma;
+        }
+        if (camera.has(PROFILE_SHARPENING))
+        {
+            profile.sharpening = camera.sharpening;
+        }
+        if (camera.has(PROFILE_SATURATION))
+        {
+            profile.saturation = camera.saturation;
+        }
+        if (camera.has(PROFILE_PIXEL_FORMAT))
+        {
+            profile.pixel_format = camera.pixel_format;
+        }
+        if (camera.has(PROFILE_FRAME_RATE))
+        {
+            profile.frame_rate = camera.frame_rate;
+        }
+        if (camera.has(PROFILE_ROIS))
+        {
+            profile.rois = camera.rois;     // The camera's list replaces the default one
+        }
+        if (camera.has(PROFILE_BUFFER_COUNT))
+        {
+            profile.buffer_count = camera.buffer_count;
+        }
+        if (camera.has(PROFILE_BUFFER_HANDLING))
+        {
+            profile.buffer_handling = camera.buffer_handling;
+        }
+        if (camera.has(PROFILE_OUTPUTS))
+        {
+            profile.outputs = camera.outputs;
+        }
+        profile.fields |= camera.fields;
+        break;
+    }
+
+    return profile;
+}
+
+const CAMERA_PROFILE& CAMERA_CONFIG_FILE::get_defaults() const
+{
+    return defaults;
+}
+
+const vector<CAMERA_PROFILE>& CAMERA_CONFIG_FILE::get_camera_sections() const
+{
+    return cameras;
+}
+
+/**
+ * Returns the largest ROI of any section, to size buffers before the cameras are known.
+ * @return Width x height in pixels, 0 if no section has a roi.
+ */
+int64_t CAMERA_CONFIG_FILE::get_max_roi_pixels() const
+{
+    int64_t max_pixels = 0;
+    for (const ROI_SETTINGS& roi : defaults.rois)
+    {
+        max_pixels = max(max_pixels, roi.width * roi.height);
+    }
+    for (const CAMERA_PROFILE& camera : cameras)
+    {
+        for (const ROI_SETTINGS& roi : camera.rois)
+        {
+            max_pixels = max(max_pixels, roi.width * roi.height);
+        }
+    }
+    return max_pixels;
+}
+
+/**
+ * Returns the most ROIs any section gives, to size per camera/ROI buffers before the cameras are known.
+ * @return The number of ROIs, 0 if no section has a roi.
+ */
+size_t CAMERA_CONFIG_FILE::get_max_roi_count() const
+{
+    size_t max_count = defaults.rois.size();
+    for (const CAMERA_PROFILE& camera : cameras)
+    {
+        max_count = max(max_count, camera.rois.size());
+    }
+    return max_count;
+}
+
+/**
+ * Describes the given settings of a profile in one line.
+ * @param profile: The profile.
+ * @return E.g. "exposure 20000 us, gain 6 dB, 2 ROI(s), outputs sinks".
+ */
+string describe_camera_profile(const CAMERA_PROFILE& profile)
+{
+    ostringstream text;
+    const char* separator = "";
+
+    if (profile.has(PROFILE_EXPOSURE))
+    {
+        text << separator << "exposure " << profile.exposure << " us";
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_GAIN))
+    {
+        text << separator << "gain " << profile.gain << " dB";
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_GAMMA))
+    {
+        text << separator << "gamma " << profile.gamma;
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_SHARPENING))
+    {
+        text << separator << "sharpening " << profile.sharpening;
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_SATURATION))
+    {
+        text << separator << "saturation " << profile.saturation;
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_PIXEL_FORMAT))
+    {
+        text << separator << profile.pixel_format;
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_FRAME_RATE))
+    {
+        text << separator;
+        if (profile.frame_rate > 0.0)
+        {
+            text << profile.frame_rate << " fps";
+        }
+        else
+        {
+            text << "free running";
+        }
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_ROIS))
+    {
+        text << separator << profile.rois.size() << " ROI(s)";
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_BUFFER_COUNT))
+    {
+        text << separator << profile.buffer_count << " buffers";
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_BUFFER_HANDLING))
+    {
+        text << separator << profile.buffer_handling;
+        separator = ", ";
+    }
+    if (profile.has(PROFILE_OUTPUTS))
+    {
+        text << separator << "outputs "
+             << ((profile.outputs & FRAME_OUTPUT_FILES) ? "files" : "")
+             << ((profile.outputs & FRAME_OUTPUT_ALL) == FRAME_OUTPUT_ALL ? "+" : "")
+             << ((profile.outputs & FRAME_OUTPUT_SINKS) ? "sinks" : "")
+             << (profile.outputs == 0 ? "none" : "");
+        separator = ", ";
+    }
+
+    string description = text.str();
+    return description.empty() ? "no settings" : description;
+}
+
+/**
+ * Compares two versions of a camera's settings, e.g. before and after the file was edited. A key that was removed
+ * from the file is not a change: the camera keeps the value it has, as at startup for keys that are not given.
+ * @param current: The settings the camera runs with.
+ * @param updated: The new settings.
+ * @return CAMERA_PROFILE_FIELD bits of the settings updated gives with a different value (or for the first time).
+ */
+uint32_t compare_camera_profiles(const CAMERA_PROFILE& current, const CAMERA_PROFILE& updated)
+{
+    uint32_t changes = 0;
+
+    auto compare = [&](CAMERA_PROFILE_FIELD field, bool same)
+    {
+        if (updated.has(field) && (!current.has(field) || !same))
+        {
+            changes |= field;
+        }
+    };
+
+    compare(PROFILE_EXPOSURE, current.exposure == updated.exposure);
+    compare(PROFILE_GAIN, current.gain == updated.gain);
+    compare(PROFILE_GAMMA, current.gamma == updated.gamma);
+    compare(PROFILE_SHARPENING, current.sharpening == updated.sharpening);
+    compare(PROFILE_SATURATION, current.saturation == updated.saturation);
+    compare(PROFILE_PIXEL_FORMAT, current.pixel_format == updated.pixel_format);
+    compare(PROFILE_FRAME_RATE, current.frame_rate == updated.frame_rate);
+    compare(PROFILE_BUFFER_COUNT, current.buffer_count == updated.buffer_count);
+    compare(PROFILE_BUFFER_HANDLING, current.buffer_handling == updated.buffer_handling);
+    compare(PROFILE_OUTPUTS, current.outputs == updated.outputs);
+
+    bool same_rois = current.rois.size() == updated.rois.size();
+    for (size_t i = 0; same_rois && i < current.rois.size(); i++)
+    {
+        const ROI_SETTINGS& a = current.rois[i];
+        const ROI_SETTINGS& b = updated.rois[i];
+        same_rois = a.offset_x == b.offset_x && a.offset_y == b.offset_y && a.width == b.width && a.height == b.height;
+    }
+    compare(PROFILE_ROIS, same_rois);
+
+    return changes;
+}
+
+/**
+ * Hashes the settings a camera stores in a UserSet: everything of the profile that is a camera node (not the stream
+ * buffers and outputs, which live on the host) and the settings the tool always writes (shutter mode, fixed ROI, ...).
+ * @param profile: The camera's profile, as it is applied.
+ * @param tool_settings: The tool's own settings in text form, so two tools never take each other's UserSet for theirs.
+ * @return 64-bit FNV-1a hash.
+ */
+uint64_t hash_camera_profile(const CAMERA_PROFILE& profile, const string& tool_settings)
+{
+    // Fixed text form: a key that is not given is hashed as such, the camera keeps whatever value it has for it
+    ostringstream text;
+    text.precision(17);
+    text << tool_settings << "\n" << profile.serial << "\n";
+    if (profile.has(PROFILE_EXPOSURE))
+    {
+        text << "exposure=" << profile.exposure << "\n";
+    }
+    if (profile.has(PROFILE_GAIN))
+    {
+        text << "gain=" << profile.gain << "\n";
+    }
+    if (profile.has(PROFILE_GAMMA))
+    {
+        text << "gamma=" << profile.gamma << "\n";
+    }
+    if (profile.has(PROFILE_SHARPENING))
+    {
+        text << "sharpening=" << profile.sharpening << "\n";
+    }
+    if (profile.has(PROFILE_SATURATION))
+    {
+        text << "saturation=" << profile.saturation << "\n";
+    }
+    if (profile.has(PROFILE_FRAME_RATE))
+    {
+        text << "frame_rate=" << profile.frame_rate << "\n";
+    }
+    text << "pixel_format=" << profile.pixel_format << "\n";
+    for (const ROI_SETTINGS& roi : profile.rois)
+    {
+        text << "roi=" << roi.offset_x << "," << roi.offset_y << "," << roi.width << "," << roi.height << "\n";
+    }
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text.str())
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,107 @@
+// camera_config_file.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef CAMERA_CONFIG_FILE_H
+#define CAMERA_CONFIG_FILE_H
+
+#include "frame_pipeline.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Settings of a profile that were given in the file, the rest keeps the tool's own default
+enum CAMERA_PROFILE_FIELD : uint32_t
+{
+    PROFILE_EXPOSURE = 1 << 0,
+    PROFILE_GAIN = 1 << 1,
+    PROFILE_GAMMA = 1 << 2,
+    PROFILE_SHARPENING = 1 << 3,
+    PROFILE_SATURATION = 1 << 4,
+    PROFILE_PIXEL_FORMAT = 1 << 5,
+    PROFILE_FRAME_RATE = 1 << 6,
+    PROFILE_ROIS = 1 << 7,
+    PROFILE_BUFFER_COUNT = 1 << 8,
+    PROFILE_BUFFER_HANDLING = 1 << 9,
+    PROFILE_OUTPUTS = 1 << 10
+};
+
+// Settings a streaming camera takes between two frames; the pixel format, ROIs and stream buffers need the acquisition stopped
+const uint32_t PROFILE_LIVE_FIELDS = PROFILE_EXPOSURE | PROFILE_GAIN | PROFILE_GAMMA | PROFILE_SHARPENING | PROFILE_SATURATION |
+                                     PROFILE_FRAME_RATE | PROFILE_OUTPUTS;
+
+// Struct to hold one region of interest
+struct ROI_SETTINGS
+{
+    int64_t offset_x;
+    int64_t offset_y;
+    int64_t width;
+    int64_t height;
+};
+
+// Struct to hold the settings of one camera: the [defaults] section with the [camera <serial>] section on top
+struct CAMERA_PROFILE
+{
+    string serial;                  // Empty -> the defaults
+    uint32_t fields;                // CAMERA_PROFILE_FIELD bits of the settings that were given
+    int line;                       // Line of the section header, for messages
+
+    double exposure;                // [μs]
+    double gain;                    // [dB]
+    double gamma;
+    double sharpening;              // Color cameras only
+    double saturation;              // Color cameras only
+    string pixel_format;            // PixelFormat entry, e.g. Mono16
+    double frame_rate;              // [fps], 0 -> free running (AcquisitionFrameRateEnable off)
+    vector<ROI_SETTINGS> rois;      // Captured in turn (dual tool), the single camera tools use the first one
+    unsigned int buffer_count;      // StreamBufferCountManual
+    string buffer_handling;         // StreamBufferHandlingMode: OldestFirst, OldestFirstOverwrite, NewestOnly or NewestFirst
+    unsigned int outputs;           // FRAME_OUTPUT bits: the per-frame files and/or the frame sinks
+
+    bool has(CAMERA_PROFILE_FIELD field) const { return (fields & field) != 0; }
+};
+
+// Camera settings file shared by the capture tools. Sections and "key = value" lines, # starts a comment:
+//
+//   [defaults]
+//   exposure = 20000
+//   roi = 0, 0, 1216, 352
+//   roi = 1216, 0, 1216, 352
+//
+//   [camera 12345678]
+//   gain = 6.0
+//
+// A camera section only overrides the keys it lists. The old "Exposure: 20000 [μs]" lines written by the trackbar
+// tools are read into the defaults. Everything that does not depend on the camera (unknown keys, malformed numbers,
+// negative sizes, unknown modes, duplicate sections) is rejected with the line number when the file is loaded;
+// the camera limits are checked by validate_camera_profile() in spinnaker_profile.h before acquisition starts.
+class CAMERA_CONFIG_FILE
+{
+    private:
+        CAMERA_PROFILE defaults;
+        vector<CAMERA_PROFILE> cameras;     // Per-serial overrides, only the given fields are set
+
+        int parse_setting(CAMERA_PROFILE& profile, const string& key, const string& value, const string& location);
+
+    public:
+        CAMERA_CONFIG_FILE();
+
+        int load(const string& path);   // Read and parse a file
+        int parse(const vector<string>& lines, const string& source);   // 0 if every line is valid, -1 otherwise (all errors are printed)
+
+        CAMERA_PROFILE get_profile(const string& serial) const;     // The defaults with the camera's section applied
+        const CAMERA_PROFILE& get_defaults() const;
+        const vector<CAMERA_PROFILE>& get_camera_sections() const;
+        int64_t get_max_roi_pixels() const;     // Largest ROI of any section, 0 if none is given
+        size_t get_max_roi_count() const;       // Most ROIs of any section, 0 if none is given
+};
+
+CAMERA_PROFILE default_camera_profile();
+string describe_camera_profile(const CAMERA_PROFILE& profile);     // One line with the given settings, for the startup log
+uint32_t compare_camera_profiles(const CAMERA_PROFILE& current, const CAMERA_PROFILE& updated);    // Fields updated gives with another value
+uint64_t hash_camera_profile(const CAMERA_PROFILE& profile, const string& tool_settings);    // Identifies what a UserSet holds
+
+#endif // CAMERA_CONFIG_FILE_H
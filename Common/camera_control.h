@@ -0,0 +1,748 @@
+// camera_control.h Header File -> GenICam node configuration shared by the single camera tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef CAMERA_CONTROL_H
+#define CAMERA_CONTROL_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK.
+// The mono and color tools share CAMERA_CONTROL; what differs between the sensors (pixel format, debayering,
+// shutter mode and black level vs. sharpening and saturation) comes from the MONO_CAMERA/COLOR_CAMERA policy,
+// so each tool only compiles the paths for its own sensor.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "camera_config_file.h"
+#include "spinnaker_profile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace Spinnaker::GenICam;
+using namespace std;
+
+// Struct to hold the camera settings of the current camera (sharpening/saturation are only used by color cameras)
+struct CAMERA_VALUES
+{
+    double exposure;        // [μs]
+    double gain;            // [dB]
+    double gamma;
+    double sharpening;
+    double saturation;
+};
+
+/**
+ * Enables a float feature and sets it, clamped to the range of the camera.
+ * @param node_map: The GenICam node map.
+ * @param enable_name: Boolean node that enables the feature, nullptr if there is none.
+ * @param value_name: The float node.
+ * @param display_name: Name used in the messages, e.g. "Gamma".
+ * @param value: The value, receives the clamped value.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int config_float_feature(INodeMap& node_map, const char* enable_name, const char* value_name, const string& display_name, double& value)
+{
+    int result = 0;
+
+    string banner = display_name;
+    transform(banner.begin(), banner.end(), banner.begin(), ::toupper);
+    cout << endl << endl << "*** CONFIGURING " << banner << " ***" << endl << endl;
+
+    try
+    {
+        double requested_value = value;
+        int status = set_float_setting(node_map, nullptr, enable_name, value_name, value);
+        if (status < 0)
+        {
+            cout << "Unable to get or set " << display_name << ". Aborting" << endl;
+            return -1;
+        }
+        if (status == 1)
+        {
+            cout << "Unable to enable " << display_name << endl;
+            return -1;
+        }
+        if (enable_name)
+        {
+            cout << display_name << " enabled" << endl;
+        }
+
+        // Report if the value was outside the acceptable range
+        if (value < requested_value)
+        {
+            cout << display_name << " value too high. Set to maximum value" << endl;
+        }
+        else if (value > requested_value)
+        {
+            cout << display_name << " value too low. Set to minimum value" << endl;
+        }
+        cout << display_name << " set to: " << value << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// Monochrome sensor (BFS-U3-50S5M): Mono8 out of the camera, global shutter and black level clamping
+struct MONO_CAMERA
+{
+    static const char* get_pixel_format_name() { return "Mono8"; }
+    static PixelFormatEnums get_pixel_format() { return PixelFormat_Mono8; }
+    static ColorProcessingAlgorithm get_color_processing() { return SPINNAKER_COLOR_PROCESSING_ALGORITHM_HQ_LINEAR; }
+    static size_t get_bytes_per_pixel() { return 1; }
+
+    static int config_sensor_shutter_mode(INodeMap& node_map);
+    static int config_black_level_clamping_enable(INodeMap& node_map);
+
+    static int config_sensor(INodeMap& node_map, CAMERA_VALUES& values);              // Before exposure (the shutter mode changes its range)
+    static int config_image_processing(INodeMap& node_map, CAMERA_VALUES& values);    // After gain
+};
+
+// Color sensor (BFS-U3-50S5C): debayered to BGR8, with the camera's sharpening and saturation
+struct COLOR_CAMERA
+{
+    static const char* get_pixel_format_name() { return "BGR8"; }
+    static PixelFormatEnums get_pixel_format() { return PixelFormat_BGR8; }
+    static ColorProcessingAlgorithm get_color_processing() { return SPINNAKER_COLOR_PROCESSING_ALGORITHM_DIRECTIONAL_FILTER; }
+    static size_t get_bytes_per_pixel() { return 3; }
+
+    static int config_sharpening(INodeMap& node_map, double& sharpening);
+    static int config_saturation(INodeMap& node_map, double& saturation);
+
+    static int config_sensor(INodeMap& node_map, CAMERA_VALUES& values);
+    static int config_image_processing(INodeMap& node_map, CAMERA_VALUES& values);
+};
+
+// Camera configuration shared by the mono and color tools, CAMERA_TYPE is MONO_CAMERA or COLOR_CAMERA
+template <class CAMERA_TYPE>
+class CAMERA_CONTROL
+{
+    protected:
+        CAMERA_VALUES values = {0.0, 0.0, 0.0, 0.0, 0.0}; // Settings of the current camera
+        CAMERA_CONFIG_FILE config_file; // Settings file: [defaults] and [camera <serial>] sections
+        CAMERA_PROFILE profile = default_camera_profile(); // Settings of the current camera, from select_camera
+        string settings_source = "settings"; // File name for the messages
+
+    public:
+        typedef CAMERA_TYPE camera_type;
+
+        vector<string> load_from_file(const string& filename); // Load From File
+        int get_values(const vector<string>& file_content); // Get Values, -1 If A Line Is Invalid
+        int select_camera(INodeMap& node_map, INodeMap& node_map_tl_device, INodeMap& stream_node_map, bool validate = true); // Settings Of This Serial, Checked Against The Camera
+        const CAMERA_VALUES& get_settings() const; // Settings After Clamping
+        const CAMERA_PROFILE& get_profile() const; // Settings Of The Current Camera
+        const CAMERA_CONFIG_FILE& get_config_file() const; // The Parsed Settings File
+
+        static int print_device_info(INodeMap& node_map); // Print Device Information
+
+        static int config_pixel_format(INodeMap& node_map); // Pixel Format Of CAMERA_TYPE
+        static int config_pixel_format(INodeMap& node_map, const string& pixel_format_name); // Camera Output Format, Converted To CAMERA_TYPE
+        static int config_roi(INodeMap& node_map, int64_t width_value, int64_t height_value); // Custom Region Of Interest
+        static int config_roi(INodeMap& node_map, int64_t width_value, int64_t height_value, int64_t x_offset_value, int64_t y_offset_value);
+        static int config_exposure(INodeMap& node_map, double& exposure_value); // Custom Exposure Time
+        static int config_gain(INodeMap& node_map, double& gain_value); // Custom Gain
+        static int config_gamma(INodeMap& node_map, double& gamma_value); // Custom Gamma
+        static int reset_exposure(INodeMap& node_map); // Reset Exposure Time
+
+        int config_camera(INodeMap& node_map); // Everything From The Database File, In Order
+
+        static void setup_image_processor(ImageProcessor& processor); // Debayering Algorithm Of CAMERA_TYPE
+        static ImagePtr convert_image(const ImageProcessor& processor, const ImagePtr& image); // Convert To The Pixel Format Of CAMERA_TYPE
+
+        static void set_non_blocking_input(bool enable); // Set Non-Blocking Input
+        static int keyboard_input(); // Keyboard Input
+};
+
+// This function controls Sensor Shutter Mode
+inline int MONO_CAMERA::config_sensor_shutter_mode(INodeMap& node_map)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING SENSOR SHUTTER MODE ***" << endl << endl;
+
+    try
+    {
+        CEnumerationPtr ptr_sensor_shutter_mode = node_map.GetNode("SensorShutterMode");
+        if (IsReadable(ptr_sensor_shutter_mode) && IsWritable(ptr_sensor_shutter_mode))
+        {
+            CEnumEntryPtr ptr_sensor_shutter_mode_global = ptr_sensor_shutter_mode->GetEntryByName("Global");
+            if (IsReadable(ptr_sensor_shutter_mode_global))
+            {
+                ptr_sensor_shutter_mode->SetIntValue(ptr_sensor_shutter_mode_global->GetValue());
+                cout << "Sensor shutter mode set to Global" << endl;
+            }
+        }
+        else
+        {
+            cout << "Unable to set sensor shutter mode to Global" << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function controls Black Level Clamping Enable
+inline int MONO_CAMERA::config_black_level_clamping_enable(INodeMap& node_map)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING BLACK LEVEL CLAMPING ENABLE ***" << endl << endl;
+
+    try
+    {
+        CBooleanPtr ptr_black_level_clamping_enable = node_map.GetNode("BlackLevelClampingEnable");
+        if (IsReadable(ptr_black_level_clamping_enable) && IsWritable(ptr_black_level_clamping_enable))
+        {
+            ptr_black_level_clamping_enable->SetValue(true);
+            cout << "Black level clamping enabled" << endl << endl;
+        }
+        else
+        {
+            cout << "Unable to enable black level clamping" << endl << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+inline int MONO_CAMERA::config_sensor(INodeMap& node_map, CAMERA_VALUES&)
+{
+    return config_sensor_shutter_mode(node_map);
+}
+
+inline int MONO_CAMERA::config_image_processing(INodeMap& node_map, CAMERA_VALUES&)
+{
+    return config_black_level_clamping_enable(node_map);
+}
+
+// This function controls sharpening
+inline int COLOR_CAMERA::config_sharpening(INodeMap& node_map, double& sharpening)
+{
+    return config_float_feature(node_map, "SharpeningEnable", "Sharpening", "Sharpening", sharpening);
+}
+
+// This function controls saturation
+inline int COLOR_CAMERA::config_saturation(INodeMap& node_map, double& saturation)
+{
+    return config_float_feature(node_map, "SaturationEnable", "Saturation", "Saturation", saturation);
+}
+
+inline int COLOR_CAMERA::config_sensor(INodeMap&, CAMERA_VALUES&)
+{
+    return 0; // Nothing to set before the exposure
+}
+
+inline int COLOR_CAMERA::config_image_processing(INodeMap& node_map, CAMERA_VALUES& values)
+{
+    int result = 0;
+
+    result = result | config_sharpening(node_map, values.sharpening);
+    result = result | config_saturation(node_map, values.saturation);
+
+    return result;
+}
+
+// Function to load the content of a file into a vector of strings
+template <class CAMERA_TYPE>
+vector<string> CAMERA_CONTROL<CAMERA_TYPE>::load_from_file(const string& filename)
+{
+    vector<string> file_content;
+
+    try
+    {
+        ifstream file_in(filename);
+        string line;
+
+        while (getline(file_in, line))
+        {
+            file_content.push_back(line);
+        }
+        settings_source = filename;
+        return file_content;
+    }
+    catch (const exception& e)
+    {
+        cerr << "Error opening file: " << filename << e.what() << '\n';
+        return {};
+    }
+}
+
+// Function to parse the file content into the default and per-camera settings (see camera_config_file.h for the format)
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::get_values(const vector<string>& file_content)
+{
+    int result = config_file.parse(file_content, settings_source);
+
+    cout << "Settings defaults: " << describe_camera_profile(config_file.get_defaults()) << endl;
+    for (const CAMERA_PROFILE& camera : config_file.get_camera_sections())
+    {
+        cout << "Settings for camera " << camera.serial << ": " << describe_camera_profile(camera) << endl;
+    }
+
+    return result;
+}
+
+// Function to pick the settings of the camera by its serial number and check them against its limits before anything is set
+// (validate = false -> only pick them, e.g. when they come from a UserSet that was checked when it was saved)
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::select_camera(INodeMap& node_map, INodeMap& node_map_tl_device, INodeMap& stream_node_map, bool validate)
+{
+    string serial;
+    CStringPtr ptr_device_serial = node_map_tl_device.GetNode("DeviceSerialNumber");
+    if (IsReadable(ptr_device_serial))
+    {
+        serial = ptr_device_serial->GetValue().c_str();
+    }
+
+    profile = config_file.get_profile(serial);
+    if (!profile.has(PROFILE_PIXEL_FORMAT))
+    {
+        profile.pixel_format = CAMERA_TYPE::get_pixel_format_name();
+    }
+
+    values.exposure = profile.exposure;
+    values.gain = profile.gain;
+    values.gamma = profile.gamma;
+    values.sharpening = profile.sharpening;
+    values.saturation = profile.saturation;
+
+    cout << "Settings of camera " << serial << ": " << describe_camera_profile(profile) << endl;
+
+    return validate ? validate_camera_profile(node_map, stream_node_map, profile) : 0;
+}
+
+template <class CAMERA_TYPE>
+const CAMERA_VALUES& CAMERA_CONTROL<CAMERA_TYPE>::get_settings() const
+{
+    return values;
+}
+
+template <class CAMERA_TYPE>
+const CAMERA_PROFILE& CAMERA_CONTROL<CAMERA_TYPE>::get_profile() const
+{
+    return profile;
+}
+
+template <class CAMERA_TYPE>
+const CAMERA_CONFIG_FILE& CAMERA_CONTROL<CAMERA_TYPE>::get_config_file() const
+{
+    return config_file;
+}
+
+// This function prints out the device information of the camera from the transport layer
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::print_device_info(INodeMap& node_map)
+{
+    int result = 0;
+
+    cout << endl << "*** DEVICE INFORMATION ***" << endl << endl;
+
+    try
+    {
+        FeatureList_t features;
+        CCategoryPtr category = node_map.GetNode("DeviceInformation");
+        if (IsReadable(category))
+        {
+            category->GetFeatures(features);
+
+            FeatureList_t::const_iterator it;
+            for (it = features.begin(); it != features.end(); ++it)
+            {
+                CNodePtr feature_node = *it;
+                cout << feature_node->GetName() << " : ";
+                CValuePtr ptr_value = (CValuePtr)feature_node;
+                cout << (IsReadable(ptr_value) ? ptr_value->ToString() : "Node not readable");
+                cout << endl;
+            }
+        }
+        else
+        {
+            cout << "Device control information not readable" << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function configures the pixel format of CAMERA_TYPE
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_pixel_format(INodeMap& node_map)
+{
+    return config_pixel_format(node_map, CAMERA_TYPE::get_pixel_format_name());
+}
+
+// This function configures the pixel format the camera sends (e.g. BayerRG8 to debayer on the host), convert_image still converts to CAMERA_TYPE
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_pixel_format(INodeMap& node_map, const string& pixel_format_name)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING PIXEL FORMAT ***" << endl << endl;
+
+    try
+    {
+        CEnumerationPtr ptr_pixel_format = node_map.GetNode("PixelFormat");
+        if (!IsReadable(ptr_pixel_format) || !IsWritable(ptr_pixel_format))
+        {
+            cout << "Custom pixel format not readable or writable" << endl;
+            return -1;
+        }
+
+        CEnumEntryPtr ptr_pixel_format_custom = ptr_pixel_format->GetEntryByName(pixel_format_name.c_str());
+        if (IsReadable(ptr_pixel_format_custom))
+        {
+            ptr_pixel_format->SetIntValue(ptr_pixel_format_custom->GetValue());
+            cout << "Pixel format set to " << ptr_pixel_format->GetCurrentEntry()->GetSymbolic() << endl;
+        }
+        else
+        {
+            cout << "Pixel format " << pixel_format_name << " is not readable! Fix it!" << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function configures the camera to use a custom region of interest (ROI) -> width, height (offsets unchanged)
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_roi(INodeMap& node_map, int64_t width_value, int64_t height_value)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING ROI: HEIGHT, WIDTH ***" << endl << endl;
+
+    try
+    {
+        const char* names[2] = {"Width", "Height"};
+        const int64_t node_values[2] = {width_value, height_value};
+
+        for (int i = 0; i < 2; i++)
+        {
+            CIntegerPtr ptr_integer = node_map.GetNode(names[i]);
+            if (!IsReadable(ptr_integer) || !IsWritable(ptr_integer))
+            {
+                cout << names[i] << " not readable or writable" << endl;
+                result = -1;
+                continue;
+            }
+
+            if (node_values[i] >= ptr_integer->GetMin() && node_values[i] <= ptr_integer->GetMax())   // Ensure the value is within an acceptable range
+            {
+                ptr_integer->SetValue(node_values[i]);
+                cout << names[i] << " set to " << ptr_integer->GetValue() << endl;
+            }
+            else
+            {
+                cout << names[i] << " value out of range. Must be between " << ptr_integer->GetMin() << " and " << ptr_integer->GetMax() << endl;
+            }
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function configures the camera to use a custom region of interest (ROI) -> width, height, offset_x, offset_y
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_roi(INodeMap& node_map, int64_t width_value, int64_t height_value, int64_t x_offset_value, int64_t y_offset_value)
+{
+    // Size first: the offset range depends on it
+    int result = config_roi(node_map, width_value, height_value);
+
+    cout << endl << endl << "*** CONFIGURING ROI: OFFSET_X & OFFSET_Y ***" << endl << endl;
+
+    try
+    {
+        const char* names[2] = {"OffsetX", "OffsetY"};
+        const int64_t node_values[2] = {x_offset_value, y_offset_value};
+
+        for (int i = 0; i < 2; i++)
+        {
+            CIntegerPtr ptr_integer = node_map.GetNode(names[i]);
+            if (!IsReadable(ptr_integer) || !IsWritable(ptr_integer))
+            {
+                cout << names[i] << " not readable or writable" << endl;
+                result = -1;
+                continue;
+            }
+
+            if (node_values[i] >= ptr_integer->GetMin() && node_values[i] <= ptr_integer->GetMax())
+            {
+                ptr_integer->SetValue(node_values[i]);
+                cout << names[i] << " set to " << ptr_integer->GetValue() << endl;
+            }
+            else
+            {
+                cout << names[i] << " value out of range. Must be between " << ptr_integer->GetMin() << " and " << ptr_integer->GetMax() << endl;
+            }
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function configures a custom exposure time, returns 1 if automatic exposure could not be disabled (expected for some models)
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_exposure(INodeMap& node_map, double& exposure_value)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING EXPOSURE ***" << endl << endl;
+
+    try
+    {
+        double requested_value = exposure_value;
+        int status = set_float_setting(node_map, "ExposureAuto", nullptr, "ExposureTime", exposure_value); // Turn off automatic exposure, exposure time in microseconds
+        if (status < 0)
+        {
+            cout << "Unable to get or set exposure time. Aborting" << endl << endl;
+            return -1;
+        }
+        if (status == 1)
+        {
+            CEnumerationPtr ptr_auto_brightness = node_map.GetNode("autoBrightnessMode"); // Manual exposure needs auto brightness off
+            if (!IsReadable(ptr_auto_brightness) || !IsWritable(ptr_auto_brightness))
+            {
+                cout << "Unable to get or set exposure time. Aborting" << endl << endl;
+                return -1;
+            }
+            cout << "Unable to disable automatic exposure. Expected for some models" << endl;
+
+            result = 1;
+        }
+        else
+        {
+            cout << "Automatic exposure disabled" << endl;
+        }
+
+        // Report if the exposure value was outside the acceptable range
+        if (exposure_value < requested_value)
+        {
+            cout << "Exposure value too high. Set to maximum value" << endl;
+        }
+        else if (exposure_value > requested_value)
+        {
+            cout << "Exposure value too low. Set to minimum value" << endl;
+        }
+
+        cout << std::fixed << "Exposure time set to: " << exposure_value << " μs" << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function controls gain
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_gain(INodeMap& node_map, double& gain_value)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING GAIN ***" << endl << endl;
+
+    try
+    {
+        double requested_value = gain_value;
+        int status = set_float_setting(node_map, "GainAuto", nullptr, "Gain", gain_value); // Turn off automatic gain, gain in dB
+        if (status < 0)
+        {
+            cout << "Unable to get or set gain. Aborting" << endl;
+            return -1;
+        }
+        cout << (status == 1 ? "Unable to disable automatic gain" : "Automatic gain disabled") << endl;
+
+        // Report if the gain value was outside the acceptable range
+        if (gain_value < requested_value)
+        {
+            cout << "Gain value too high. Set to maximum value" << endl;
+        }
+        else if (gain_value > requested_value)
+        {
+            cout << "Gain value too low. Set to minimum value" << endl;
+        }
+
+        cout << "Gain set to: " << gain_value << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function controls gamma
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_gamma(INodeMap& node_map, double& gamma_value)
+{
+    return config_float_feature(node_map, "GammaEnable", "Gamma", "Gamma", gamma_value);
+}
+
+// This function returns the camera to its default state by re-enabling automatic exposure.
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::reset_exposure(INodeMap& node_map)
+{
+    int result = 0;
+
+    try
+    {
+        CEnumerationPtr ptr_exposure_auto = node_map.GetNode("ExposureAuto");
+        if (!IsReadable(ptr_exposure_auto) || !IsWritable(ptr_exposure_auto))
+        {
+            cout << "Reset exposure is not not readable or writable. Non-fatal error" << endl << endl;
+            return -1;
+        }
+
+        CEnumEntryPtr ptr_exposure_auto_continuous = ptr_exposure_auto->GetEntryByName("Continuous");
+        if (!IsReadable(ptr_exposure_auto_continuous))
+        {
+            cout << "Unable to enable automatic exposure (enum entry retrieval). Non-fatal error" << endl << endl;
+            return -1;
+        }
+
+        ptr_exposure_auto->SetIntValue(ptr_exposure_auto_continuous->GetValue());
+        cout << "Automatic exposure enabled" << endl << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function applies the settings of the current camera: sensor, exposure, frame rate, gain, image processing, gamma
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::config_camera(INodeMap& node_map)
+{
+    int result = 0;
+
+    result = result | CAMERA_TYPE::config_sensor(node_map, values); // Mono: Sensor Shutter Mode
+    result = result | config_exposure(node_map, values.exposure); // Exposure 33.0 [μs] to 30.0 [s]
+    if (profile.has(PROFILE_FRAME_RATE))
+    {
+        result = result | config_frame_rate(node_map, profile.frame_rate); // After the exposure, which limits it
+    }
+    result = result | config_gain(node_map, values.gain); // Gain 0.0 to 47.9943 [dB]
+    result = result | CAMERA_TYPE::config_image_processing(node_map, values); // Mono: Black Level Clamping, Color: Sharpening, Saturation
+    result = result | config_gamma(node_map, values.gamma); // Gamma, (0.1 to 4.0)
+
+    return result;
+}
+
+template <class CAMERA_TYPE>
+void CAMERA_CONTROL<CAMERA_TYPE>::setup_image_processor(ImageProcessor& processor)
+{
+    processor.SetColorProcessing(CAMERA_TYPE::get_color_processing());  // Set interpolation algorithm
+}
+
+template <class CAMERA_TYPE>
+ImagePtr CAMERA_CONTROL<CAMERA_TYPE>::convert_image(const ImageProcessor& processor, const ImagePtr& image)
+{
+    return processor.Convert(image, CAMERA_TYPE::get_pixel_format());
+}
+
+// Function to set terminal input mode (non-blocking)
+template <class CAMERA_TYPE>
+void CAMERA_CONTROL<CAMERA_TYPE>::set_non_blocking_input(bool enable)
+{
+    struct termios ttystate;
+    tcgetattr(STDIN_FILENO, &ttystate);
+
+    if (enable)
+    {
+        ttystate.c_lflag &= ~ICANON; // Disable canonical mode
+        ttystate.c_lflag &= ~ECHO;   // Disable echo
+        ttystate.c_cc[VMIN] = 1;
+    }
+    else
+    {
+        ttystate.c_lflag |= ICANON;  // Enable canonical mode
+        ttystate.c_lflag |= ECHO;    // Enable echo
+    }
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &ttystate);
+}
+
+// Function to check for keyboard input without blocking, the key stays in stdin for getchar()
+template <class CAMERA_TYPE>
+int CAMERA_CONTROL<CAMERA_TYPE>::keyboard_input()
+{
+    struct termios oldt, newt;
+    int ch;
+    int oldf;
+
+    tcgetattr(STDIN_FILENO, &oldt);
+    newt = oldt;
+    newt.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
+    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+
+    ch = getchar();
+
+    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
+    fcntl(STDIN_FILENO, F_SETFL, oldf);
+
+    if (ch != EOF)
+    {
+        ungetc(ch, stdin);
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif // CAMERA_CONTROL_H
@@ -0,0 +1,231 @@
+// Description: Per-camera recovery state machine, re-opening a dropped camera while the others keep streaming
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+
+#include "camera_recovery.h"
+
+using namespace std;
+
+/**
+ * Constructor for the CAMERA_RECOVERY class: 3 failed grabs in a row mark a camera as lost, a lost camera is tried
+ * every 2 s, one that arrived again every 500 ms.
+ */
+CAMERA_RECOVERY::CAMERA_RECOVERY()
+    : max_failed_grabs(3), retry_interval(2000), arrival_retry_interval(500)
+{
+}
+
+/**
+ * Sets when a camera counts as lost and how often it is re-opened.
+ * @param failed_grabs: Failed grabs in a row that mark a camera as lost (a removal event marks it at once).
+ * @param retry: Interval of the re-open attempts while no arrival event was seen.
+ * @param arrival_retry: Interval of the re-open attempts after an arrival event.
+ */
+void CAMERA_RECOVERY::set_limits(unsigned int failed_grabs, chrono::milliseconds retry, chrono::milliseconds arrival_retry)
+{
+    lock_guard<mutex> lock(links_mutex);
+    max_failed_grabs = failed_grabs > 0 ? failed_grabs : 1;
+    retry_interval = retry;
+    arrival_retry_interval = arrival_retry;
+}
+
+/**
+ * Adds a streaming camera.
+ * @param serial: The camera serial number, matched against the arrival/removal events.
+ * @return The index of the camera.
+ */
+size_t CAMERA_RECOVERY::add_camera(const string& serial)
+{
+    lock_guard<mutex> lock(links_mutex);
+    CAMERA_LINK link;
+    link.serial = serial;
+    link.state = CAMERA_LINK_STREAMING;
+    link.failed_grabs = 0;
+    link.grab_interval_ms = 0.0;
+    links.push_back(link);
+    return links.size() - 1;
+}
+
+/**
+ * Opens an incident for a camera that was streaming. Called with links_mutex held.
+ * @param link: The camera.
+ * @param cause: Why it is out.
+ * @param frames_lost: Frames already lost to it (the failed grabs).
+ */
+void CAMERA_RECOVERY::mark_lost(CAMERA_LINK& link, const string& cause, uint64_t frames_lost)
+{
+    link.state = CAMERA_LINK_LOST;
+    link.outage_start = chrono::steady_clock::now();
+    link.next_attempt = link.outage_start + retry_interval;
+    link.incident.serial = link.serial;
+    link.incident.cause = cause;
+    link.incident.outage_ms = 0.0;
+    link.incident.frames_lost = frames_lost;
+    link.incident.reopen_attempts = 0;
+    link.incident.recovered = false;
+}
+
+/**
+ * Device removal event: the camera is out from now on, the acquisition loop stops grabbing from it.
+ * @param serial: Serial number of the removed device (unknown serials are ignored).
+ */
+void CAMERA_RECOVERY::on_device_removal(const string& serial)
+{
+    lock_guard<mutex> lock(links_mutex);
+    for (CAMERA_LINK& link : links)
+    {
+        if (link.serial == serial)
+        {
+            if (link.state == CAMERA_LINK_STREAMING)
+            {
+                mark_lost(link, "removed", 0);
+            }
+            else
+            {
+                link.state = CAMERA_LINK_LOST;   // Arrived and gone again before it was re-opened
+                link.next_attempt = chrono::steady_clock::now() + retry_interval;
+            }
+        }
+    }
+}
+
+/**
+ * Device arrival event: a camera that is out gets re-opened by the next pass of the acquisition loop.
+ * @param serial: Serial number of the arrived device (unknown serials are ignored).
+ */
+void CAMERA_RECOVERY::on_device_arrival(const string& serial)
+{
+    lock_guard<mutex> lock(links_mutex);
+    for (CAMERA_LINK& link : links)
+    {
+        if (link.serial == serial && link.state != CAMERA_LINK_STREAMING)
+        {
+            link.state = CAMERA_LINK_ARRIVED;
+            link.next_attempt = chrono::steady_clock::now();
+        }
+    }
+}
+
+/**
+ * Returns the link state of a camera.
+ * @param index: Index from add_camera().
+ * @return The state, CAMERA_LINK_LOST for an unknown index.
+ */
+CAMERA_LINK_STATE CAMERA_RECOVERY::get_state(size_t index) const
+{
+    lock_guard<mutex> lock(links_mutex);
+    return index < links.size() ? links[index].state : CAMERA_LINK_LOST;
+}
+
+/**
+ * Records the result of a capture. Failed grabs in a row beyond the limit mark a camera as lost that never sent a
+ * removal event (stopped answering, stream stalled), so it is re-opened like a removed one. Successful ones keep the
+ * capture interval of the camera, which turns the outage into frames lost.
+ * @param index: Index from add_camera().
+ * @param success: Whether a frame arrived (incomplete frames count, the camera answered).
+ */
+void CAMERA_RECOVERY::on_grab(size_t index, bool success)
+{
+    lock_guard<mutex> lock(links_mutex);
+    if (index >= links.size() || links[index].state != CAMERA_LINK_STREAMING)
+    {
+        return;
+    }
+
+    CAMERA_LINK& link = links[index];
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (success)
+    {
+        if (link.failed_grabs == 0 && link.last_grab.time_since_epoch().count() != 0)
+        {
+            double interval_ms = chrono::duration<double, milli>(now - link.last_grab).count();
+            link.grab_interval_ms = link.grab_interval_ms > 0.0 ? link.grab_interval_ms + (interval_ms - link.grab_interval_ms) / 8.0 : interval_ms;
+        }
+        link.failed_grabs = 0;
+        link.last_grab = now;
+    }
+    else if (++link.failed_grabs >= max_failed_grabs)
+    {
+        mark_lost(link, "grab errors", link.failed_grabs);
+        link.failed_grabs = 0;
+        link.next_attempt = link.outage_start;  // Still enumerated, no arrival event will come
+    }
+}
+
+/**
+ * Checks if the acquisition loop should try to re-open a camera now.
+ * @param index: Index from add_camera().
+ * @return true if the camera is out and its next attempt is due.
+ */
+bool CAMERA_RECOVERY::is_reopen_due(size_t index) const
+{
+    lock_guard<mutex> lock(links_mutex);
+    return index < links.size() && links[index].state != CAMERA_LINK_STREAMING && chrono::steady_clock::now() >= links[index].next_attempt;
+}
+
+/**
+ * Records a re-open attempt.
+ * @param index: Index from add_camera().
+ * @param success: Whether the camera was opened, configured and started.
+ * @param incident: Receives the closed incident if the camera is back.
+ * @return true if the camera is streaming again.
+ */
+bool CAMERA_RECOVERY::on_reopen(size_t index, bool success, CAMERA_INCIDENT& incident)
+{
+    lock_guard<mutex> lock(links_mutex);
+    if (index >= links.size() || links[index].state == CAMERA_LINK_STREAMING)
+    {
+        return false;
+    }
+
+    CAMERA_LINK& link = links[index];
+    link.incident.reopen_attempts++;
+    if (!success)
+    {
+        link.next_attempt = chrono::steady_clock::now() + (link.state == CAMERA_LINK_ARRIVED ? arrival_retry_interval : retry_interval);
+        return false;
+    }
+
+    link.state = CAMERA_LINK_STREAMING;
+    link.failed_grabs = 0;
+    link.last_grab = chrono::steady_clock::time_point();   // The interval is measured again from the next capture
+    link.incident.outage_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - link.outage_start).count();
+    if (link.grab_interval_ms > 0.0)
+    {
+        link.incident.frames_lost += static_cast<uint64_t>(link.incident.outage_ms / link.grab_interval_ms);
+    }
+    link.incident.recovered = true;
+    incidents.push_back(link.incident);
+    incident = link.incident;
+    return true;
+}
+
+/**
+ * Returns every incident of the acquisition, for the report at the end.
+ * @return The closed incidents, then one per camera that is still out (recovered = false, outage up to now).
+ */
+vector<CAMERA_INCIDENT> CAMERA_RECOVERY::get_incidents() const
+{
+    lock_guard<mutex> lock(links_mutex);
+    vector<CAMERA_INCIDENT> all_incidents = incidents;
+    for (const CAMERA_LINK& link : links)
+    {
+        if (link.state != CAMERA_LINK_STREAMING)
+        {
+            CAMERA_INCIDENT open_incident = link.incident;
+            open_incident.outage_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - link.outage_start).count();
+            if (link.grab_interval_ms > 0.0)
+            {
+                open_incident.frames_lost += static_cast<uint64_t>(open_incident.outage_ms / link.grab_interval_ms);
+            }
+            all_incidents.push_back(open_incident);
+        }
+    }
+    return all_incidents;
+}
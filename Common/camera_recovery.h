@@ -0,0 +1,85 @@
+// camera_recovery.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef CAMERA_RECOVERY_H
+#define CAMERA_RECOVERY_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Link state of one camera in a multi camera acquisition
+enum CAMERA_LINK_STATE
+{
+    CAMERA_LINK_STREAMING,  // Grabbing frames
+    CAMERA_LINK_LOST,       // Removed or stopped answering, re-open tried now and then until it arrives again
+    CAMERA_LINK_ARRIVED     // Arrival event seen, re-open (Init + restore of its settings) is due
+};
+
+// One outage of a camera, from the removal (or the first failed grab) until the re-open succeeds
+struct CAMERA_INCIDENT
+{
+    string serial;
+    string cause;                   // "removed" or "grab errors"
+    double outage_ms;               // To the end of the re-open (Init + settings restore), the first frame comes one capture later
+    uint64_t frames_lost;           // Failed captures, plus the outage over the capture interval measured before it
+    unsigned int reopen_attempts;
+    bool recovered;                 // false -> still out when the acquisition stopped
+};
+
+// Recovery state machine of the cameras of one acquisition. Device arrival/removal events come from the Spinnaker
+// event thread, everything else from the acquisition loop, which re-opens only the cameras that are out while the
+// others keep streaming:
+//   STREAMING -(removal event or max_failed_grabs failed grabs in a row)-> LOST -(arrival event)-> ARRIVED
+//   LOST/ARRIVED -(re-open failed)-> LOST, next attempt after the retry interval (ARRIVED: arrival_retry_interval)
+//   LOST/ARRIVED -(re-open succeeded)-> STREAMING, the incident is closed and reported
+class CAMERA_RECOVERY
+{
+    private:
+        struct CAMERA_LINK
+        {
+            string serial;
+            CAMERA_LINK_STATE state;
+            unsigned int failed_grabs;      // In a row
+            chrono::steady_clock::time_point last_grab;
+            double grab_interval_ms;        // Moving average between successful captures, 0 -> not measured yet
+            chrono::steady_clock::time_point next_attempt;
+            CAMERA_INCIDENT incident;       // The open incident while not streaming
+            chrono::steady_clock::time_point outage_start;
+        };
+
+        mutable mutex links_mutex;
+        vector<CAMERA_LINK> links;
+        vector<CAMERA_INCIDENT> incidents;      // Closed ones
+
+        unsigned int max_failed_grabs;
+        chrono::milliseconds retry_interval;            // Re-open attempts of a lost camera, in case its arrival event is missed
+        chrono::milliseconds arrival_retry_interval;    // Re-open attempts after an arrival event (the device may still enumerate)
+
+        void mark_lost(CAMERA_LINK& link, const string& cause, uint64_t frames_lost);
+
+    public:
+        CAMERA_RECOVERY();
+
+        void set_limits(unsigned int failed_grabs, chrono::milliseconds retry, chrono::milliseconds arrival_retry);
+        size_t add_camera(const string& serial);    // Index of the camera in the calls below, in the order they are added
+
+        // Spinnaker event thread
+        void on_device_removal(const string& serial);
+        void on_device_arrival(const string& serial);
+
+        // Acquisition loop
+        CAMERA_LINK_STATE get_state(size_t index) const;
+        void on_grab(size_t index, bool success);   // Result of one capture
+        bool is_reopen_due(size_t index) const;
+        bool on_reopen(size_t index, bool success, CAMERA_INCIDENT& incident);  // True (and the closed incident) once the camera is back
+
+        vector<CAMERA_INCIDENT> get_incidents() const;  // Closed incidents, then the ones still open
+};
+
+#endif // CAMERA_RECOVERY_H
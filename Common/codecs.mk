@@ -0,0 +1,20 @@
+# Optional lossless compression libraries for frame_compressor.cpp (included by every Makefile that links
+# libcamera_common.a). A codec is compiled in when its header is found; CODEC_PREFIX adds another search root.
+CODEC_PREFIX ?= /usr/local
+CODEC_INCLUDE_DIRS = /usr/include ${CODEC_PREFIX}/include
+
+LZ4_HEADER = $(firstword $(wildcard $(addsuffix /lz4hc.h,${CODEC_INCLUDE_DIRS})))
+ZSTD_HEADER = $(firstword $(wildcard $(addsuffix /zstd.h,${CODEC_INCLUDE_DIRS})))
+
+CODEC_FLAGS =
+CODEC_LIBS =
+
+ifneq (${LZ4_HEADER},)
+CODEC_FLAGS += -D WITH_LZ4 -I$(dir ${LZ4_HEADER})
+CODEC_LIBS += -L${CODEC_PREFIX}/lib -llz4
+endif
+
+ifneq (${ZSTD_HEADER},)
+CODEC_FLAGS += -D WITH_ZSTD -I$(dir ${ZSTD_HEADER})
+CODEC_LIBS += -L${CODEC_PREFIX}/lib -lzstd
+endif
@@ -0,0 +1,109 @@
+// Description: Minimal "--key=value" command line parser shared by the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+
+#include "command_line.h"
+
+using namespace std;
+
+/**
+ * Constructor for the COMMAND_LINE class. Arguments that do not start with "--" are ignored.
+ * @param argc: Argument count from main.
+ * @param argv: Argument vector from main.
+ */
+COMMAND_LINE::COMMAND_LINE(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (argument.compare(0, 2, "--") != 0)
+        {
+            cerr << "Ignoring argument: " << argument << '\n';
+            continue;
+        }
+
+        size_t equal_position = argument.find('=');
+        if (equal_position == string::npos)
+        {
+            options[argument.substr(2)] = "";
+        }
+        else
+        {
+            options[argument.substr(2, equal_position - 2)] = argument.substr(equal_position + 1);
+        }
+    }
+}
+
+/**
+ * Checks if an option was given.
+ * @param key: Option name without the leading "--".
+ * @return true if present.
+ */
+bool COMMAND_LINE::has(const string& key) const
+{
+    return options.find(key) != options.end();
+}
+
+/**
+ * Returns an option as a string.
+ * @param key: Option name without the leading "--".
+ * @param default_value: Returned if the option is missing.
+ * @return The option value.
+ */
+string COMMAND_LINE::get_string(const string& key, const string& default_value) const
+{
+    map<string, string>::const_iterator it = options.find(key);
+    return it != options.end() ? it->second : default_value;
+}
+
+/**
+ * Returns an option as an integer.
+ * @param key: Option name without the leading "--".
+ * @param default_value: Returned if the option is missing or not a number.
+ * @return The option value.
+ */
+long long COMMAND_LINE::get_int(const string& key, long long default_value) const
+{
+    map<string, string>::const_iterator it = options.find(key);
+    if (it == options.end() || it->second.empty())
+    {
+        return default_value;
+    }
+
+    char* end = NULL;
+    long long value = strtoll(it->second.c_str(), &end, 10);
+    if (*end != '\0')
+    {
+        cerr << "Invalid integer for --" << key << ": " << it->second << '\n';
+        return default_value;
+    }
+    return value;
+}
+
+/**
+ * Returns an option as a floating point number.
+ * @param key: Option name without the leading "--".
+ * @param default_value: Returned if the option is missing or not a number.
+ * @return The option value.
+ */
+double COMMAND_LINE::get_double(const string& key, double default_value) const
+{
+    map<string, string>::const_iterator it = options.find(key);
+    if (it == options.end() || it->second.empty())
+    {
+        return default_value;
+    }
+
+    char* end = NULL;
+    double value = strtod(it->second.c_str(), &end);
+    if (*end != '\0')
+    {
+        cerr << "Invalid number for --" << key << ": " << it->second << '\n';
+        return default_value;
+    }
+    return value;
+}
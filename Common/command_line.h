@@ -0,0 +1,27 @@
+// command_line.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <map>
+#include <string>
+
+using namespace std;
+
+class COMMAND_LINE
+{
+    private:
+        map<string, string> options;   // "--key=value" -> options[key] = value, "--flag" -> options[flag] = ""
+
+    public:
+        COMMAND_LINE(int argc, char** argv);    // Constructor
+
+        bool has(const string& key) const;   // True if --key or --key=value was given
+        string get_string(const string& key, const string& default_value) const;
+        long long get_int(const string& key, long long default_value) const;
+        double get_double(const string& key, double default_value) const;
+};
+
+#endif // COMMAND_LINE_H
@@ -0,0 +1,122 @@
+// Description: Named pipe that delivers one-line control commands to the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "control_fifo.h"
+
+using namespace std;
+
+/**
+ * Constructor for the CONTROL_FIFO class.
+ */
+CONTROL_FIFO::CONTROL_FIFO() : fifo_fd(-1), running(false)
+{
+}
+
+/**
+ * Destructor for the CONTROL_FIFO class -> stops the reader thread.
+ */
+CONTROL_FIFO::~CONTROL_FIFO()
+{
+    stop();
+}
+
+/**
+ * Creates the FIFO if it does not exist and starts the reader thread.
+ * @param path: Path of the named pipe.
+ * @param handler: Called with every received line (without the newline), from the reader thread.
+ * @return 0 if successful, -1 otherwise.
+ */
+int CONTROL_FIFO::start(const string& path, function<void(const string&)> handler)
+{
+    if (mkfifo(path.c_str(), 0660) != 0 && errno != EEXIST)
+    {
+        cerr << "[Control] Unable to create FIFO " << path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    // O_RDWR keeps the FIFO open when writers come and go, so poll() does not spin on EOF
+    fifo_fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fifo_fd < 0)
+    {
+        cerr << "[Control] Unable to open FIFO " << path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    fifo_path = path;
+    command_handler = handler;
+    running = true;
+    reader_thread = thread(&CONTROL_FIFO::reader_loop, this);
+
+    cout << "[Control] Listening for commands on " << path << endl;
+    return 0;
+}
+
+/**
+ * Stops the reader thread and closes the FIFO (the FIFO itself is left in place).
+ */
+void CONTROL_FIFO::stop()
+{
+    running = false;
+    if (reader_thread.joinable())
+    {
+        reader_thread.join();
+    }
+
+    if (fifo_fd >= 0)
+    {
+        close(fifo_fd);
+        fifo_fd = -1;
+    }
+}
+
+/**
+ * Reader thread: splits the input into lines and passes them to the handler.
+ */
+void CONTROL_FIFO::reader_loop()
+{
+    string pending;
+    char buffer[256];
+
+    while (running)
+    {
+        struct pollfd poll_fd = {fifo_fd, POLLIN, 0};
+        if (poll(&poll_fd, 1, 200) <= 0)    // Wake up regularly to notice stop()
+        {
+            continue;
+        }
+
+        ssize_t bytes = read(fifo_fd, buffer, sizeof(buffer));
+        if (bytes <= 0)
+        {
+            continue;
+        }
+
+        pending.append(buffer, static_cast<size_t>(bytes));
+
+        size_t newline;
+        while ((newline = pending.find('\n')) != string::npos)
+        {
+            string line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (!line.empty())
+            {
+                command_handler(line);
+            }
+        }
+    }
+}
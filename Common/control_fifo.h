@@ -0,0 +1,37 @@
+// control_fifo.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef CONTROL_FIFO_H
+#define CONTROL_FIFO_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Local control channel: a named pipe that other processes write one-line commands to, e.g.
+//   echo trigger > /tmp/camera_control
+// Every line is passed to the handler on a background thread.
+class CONTROL_FIFO
+{
+    private:
+        string fifo_path;
+        int fifo_fd;
+        atomic<bool> running;
+        thread reader_thread;
+        function<void(const string&)> command_handler;
+
+        void reader_loop();
+
+    public:
+        CONTROL_FIFO();
+        ~CONTROL_FIFO();
+
+        int start(const string& path, function<void(const string&)> handler);  // Create the FIFO (if needed) and start reading
+        void stop();
+};
+
+#endif // CONTROL_FIFO_H
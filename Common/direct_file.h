@@ -0,0 +1,28 @@
+// direct_file.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef DIRECT_FILE_H
+#define DIRECT_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Creates (truncates) path for writing. With use_direct_io the file is switched to O_DIRECT after it was created;
+// if the filesystem refuses (tmpfs, some network filesystems) it stays buffered. Returns the fd or -1.
+int open_output_file(const string& path, bool use_direct_io, bool& direct_io_active);
+
+// Same as open_output_file, but never replaces a file: returns -1 with errno EEXIST if path exists (recordings
+// that must survive a restart into the same folder).
+int open_new_output_file(const string& path, bool use_direct_io, bool& direct_io_active);
+
+// pwrite until size bytes are written (handles EINTR and short writes). Returns 0 or -1.
+int write_all(int fd, const char* buffer, size_t size, uint64_t offset);
+
+// Buffered fallback: writes the range back and drops it from the page cache
+void drop_written_range(int fd, uint64_t offset, size_t size);
+
+#endif // DIRECT_FILE_H
@@ -0,0 +1,283 @@
+// Description: Crash-safe bounded on-disk image ring with an atomically replaced manifest
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "disk_ring.h"
+#include "trace_recorder.h"
+
+using namespace std;
+
+/**
+ * Flushes a file (or directory) to disk.
+ * @param path: The path to sync.
+ * @return 0 if successful, -1 otherwise.
+ */
+static int sync_path(const string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int result = fsync(fd);
+    close(fd);
+    return result;
+}
+
+/**
+ * Returns the directory part of a path prefix ("/data/images/" -> "/data/images", "img_" -> ".").
+ * @param prefix: The path prefix.
+ * @return The directory.
+ */
+static string directory_of(const string& prefix)
+{
+    size_t slash = prefix.find_last_of('/');
+    if (slash == string::npos)
+    {
+        return ".";
+    }
+    return slash == 0 ? "/" : prefix.substr(0, slash);
+}
+
+/**
+ * Constructor for the DISK_RING class.
+ */
+DISK_RING::DISK_RING() : slot_count(0), sync_files(true), manifest_version(0), written_manifest_version(0)
+{
+}
+
+/**
+ * Sets up the ring.
+ * @param folder: Path prefix for the slot files and the manifest.
+ * @param slots: Number of slots per stream.
+ * @param sync: fsync every frame and the directory before publishing it (survives power loss, not only crashes).
+ * @return 0 if successful, -1 otherwise.
+ */
+int DISK_RING::init(const string& folder, unsigned int slots, bool sync)
+{
+    if (slots == 0)
+    {
+        cerr << "[Disk ring] Slot count must be at least 1\n";
+        return -1;
+    }
+
+    folder_path = folder;
+    manifest_path = folder + "ring_manifest.txt";
+    slot_count = slots;
+    sync_files = sync;
+
+    cout << "[Disk ring] " << slot_count << " slots per camera/ROI, manifest " << manifest_path
+         << (sync_files ? " (fsync on commit)" : "") << endl;
+    return 0;
+}
+
+/**
+ * Returns the state of a stream, adding it on first use.
+ * @param stream_key: The stream.
+ * @return The stream state. ring_mutex must be held.
+ */
+DISK_RING::STREAM_STATE& DISK_RING::find_stream(const string& stream_key)
+{
+    for (auto& stream : streams)
+    {
+        if (stream.key == stream_key)
+        {
+            return stream;
+        }
+    }
+
+    STREAM_STATE stream;
+    stream.key = stream_key;
+    stream.next_sequence = 0;
+    stream.has_newest = false;
+    stream.slot_sequences.assign(slot_count, 0);
+    streams.push_back(stream);
+    return streams.back();
+}
+
+/**
+ * Picks the next slot for the stream.
+ * @param stream_key: The stream (camera/ROI) name, used in the file names.
+ * @param extension: File extension including the dot (".jpg", ".raw").
+ * @param frame_id: Camera frame ID (for the manifest).
+ * @param timestamp_ns: Camera timestamp (for the manifest).
+ * @return The entry with the temp and final paths.
+ */
+DISK_RING_ENTRY DISK_RING::begin_frame(const string& stream_key, const string& extension, uint64_t frame_id, uint64_t timestamp_ns)
+{
+    lock_guard<mutex> lock(ring_mutex);
+
+    STREAM_STATE& stream = find_stream(stream_key);
+
+    DISK_RING_ENTRY entry;
+    entry.stream_key = stream_key;
+    entry.sequence = stream.next_sequence++;
+    entry.slot = static_cast<unsigned int>(entry.sequence % slot_count);
+    entry.frame_id = frame_id;
+    entry.timestamp_ns = timestamp_ns;
+
+    string name = stream_key + "_Image_" + to_string(entry.slot);
+    entry.final_path = folder_path + name + extension;
+    // Hidden and unique per sequence, same directory so the rename is atomic. Keeps the extension for Image::Save.
+    entry.temp_path = folder_path + ".tmp_" + name + "_" + to_string(entry.sequence) + extension;
+
+    pending[entry.temp_path] = entry;
+    return entry;
+}
+
+/**
+ * Moves a completed frame into its slot and publishes it.
+ * @param temp_path: The temp path returned by begin_frame.
+ * @param success: Whether the frame was written completely.
+ * @return 0 if the frame was published, -1 otherwise (failed, or a newer frame of the slot was committed first).
+ */
+int DISK_RING::complete(const string& temp_path, bool success)
+{
+    DISK_RING_ENTRY entry;
+    {
+        lock_guard<mutex> lock(ring_mutex);
+
+        auto it = pending.find(temp_path);
+        if (it == pending.end())
+        {
+            return -1;  // Not a ring file
+        }
+
+        entry = it->second;
+        pending.erase(it);
+    }
+
+    TRACE_SCOPE trace_scope("ring_commit", "slot", entry.slot);
+
+    if (!success)
+    {
+        unlink(temp_path.c_str());  // The slot keeps its previous, complete frame
+        return -1;
+    }
+
+    // Without the lock: begin_frame on the capture thread does not wait for the disk
+    if (sync_files && sync_path(temp_path) != 0)
+    {
+        cerr << "[Disk ring] fsync failed for " << temp_path << ": " << strerror(errno) << endl;
+    }
+
+    uint64_t version;
+    string content;
+    {
+        lock_guard<mutex> lock(ring_mutex);
+
+        STREAM_STATE& stream = find_stream(entry.stream_key);
+        uint64_t& slot_sequence = stream.slot_sequences[entry.slot];
+        if (slot_sequence > entry.sequence)
+        {
+            // Frame sequence + slot_count (or later) of this slot completed first, keep it
+            unlink(temp_path.c_str());
+            return -1;
+        }
+
+        if (rename(temp_path.c_str(), entry.final_path.c_str()) != 0)
+        {
+            cerr << "[Disk ring] Unable to rename " << temp_path << ": " << strerror(errno) << endl;
+            unlink(temp_path.c_str());
+            return -1;
+        }
+        slot_sequence = entry.sequence + 1;
+
+        if (!stream.has_newest || entry.sequence > stream.newest.sequence)
+        {
+            stream.newest = entry;
+            stream.has_newest = true;
+        }
+
+        version = ++manifest_version;
+        content = format_manifest();
+    }
+
+    return write_manifest(version, content);
+}
+
+/**
+ * Formats the manifest with the newest complete frame of every stream.
+ * @return The manifest content. ring_mutex must be held.
+ */
+string DISK_RING::format_manifest()
+{
+    ostringstream content;
+    content << "version " << manifest_version << "\n";
+    content << "slots " << slot_count << "\n";
+    for (const auto& stream : streams)
+    {
+        if (stream.has_newest)
+        {
+            const DISK_RING_ENTRY& newest = stream.newest;
+            content << newest.stream_key << " " << newest.sequence << " " << newest.slot << " " << newest.frame_id << " "
+                    << newest.timestamp_ns << " " << newest.final_path << "\n";
+        }
+    }
+    return content.str();
+}
+
+/**
+ * Replaces the manifest (temp file + rename). A version older than the one already written is skipped.
+ * @param version: The manifest version of content.
+ * @param content: The manifest content.
+ * @return 0 if successful (or superseded), -1 otherwise.
+ */
+int DISK_RING::write_manifest(uint64_t version, const string& content)
+{
+    lock_guard<mutex> lock(manifest_mutex);
+
+    if (version <= written_manifest_version)
+    {
+        return 0;   // A commit that finished later already published a newer manifest
+    }
+
+    string temp_manifest = manifest_path + ".tmp";
+    {
+        ofstream file(temp_manifest.c_str(), ios::trunc);
+        if (!file)
+        {
+            cerr << "[Disk ring] Unable to write " << temp_manifest << endl;
+            return -1;
+        }
+        file << content;
+    }
+
+    if (sync_files)
+    {
+        sync_path(temp_manifest);
+    }
+
+    if (rename(temp_manifest.c_str(), manifest_path.c_str()) != 0)
+    {
+        cerr << "[Disk ring] Unable to publish the manifest: " << strerror(errno) << endl;
+        return -1;
+    }
+    written_manifest_version = version;
+
+    if (sync_files)
+    {
+        sync_path(directory_of(manifest_path));   // Make the renames themselves durable
+    }
+
+    return 0;
+}
+
+/**
+ * Returns the number of slots per stream.
+ */
+unsigned int DISK_RING::get_slot_count() const
+{
+    return slot_count;
+}
@@ -0,0 +1,83 @@
+// disk_ring.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef DISK_RING_H
+#define DISK_RING_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// One frame on its way into the ring
+struct DISK_RING_ENTRY
+{
+    string stream_key;      // e.g. Serial_<serial>_OffsetX_<x>
+    unsigned int slot;
+    uint64_t sequence;      // Frames committed to this stream before this one
+    uint64_t frame_id;
+    uint64_t timestamp_ns;
+    string temp_path;       // Where the frame is written
+    string final_path;      // Where it is renamed to once complete
+};
+
+// Bounded on-disk ring per stream (camera/ROI). Frames are written to a hidden temp file and renamed over the slot
+// file when complete, so a slot file is always either the previous or the new frame, never a partial one.
+// After every commit <folder>ring_manifest.txt is replaced (also atomically) with the newest complete frame per stream:
+//   version <n>
+//   slots <slot_count>
+//   <stream_key> <sequence> <slot> <frame_id> <timestamp_ns> <path>
+// Readers only need to re-read the manifest when its version (or mtime) changes.
+// Frames can complete out of order (several writer threads, io_uring): a frame that finishes after a newer frame of
+// the same slot was committed is dropped instead of renamed over it. The fsyncs run outside the lock begin_frame takes,
+// so the capture thread never waits for them.
+class DISK_RING
+{
+    private:
+        struct STREAM_STATE
+        {
+            string key;
+            uint64_t next_sequence;     // Assigned to the next begin_frame
+            bool has_newest;
+            DISK_RING_ENTRY newest;     // Newest committed frame
+            vector<uint64_t> slot_sequences;    // Sequence + 1 of the frame in each slot file (0 = none yet)
+        };
+
+        string folder_path;
+        string manifest_path;
+        unsigned int slot_count;
+        bool sync_files;
+
+        vector<STREAM_STATE> streams;
+        map<string, DISK_RING_ENTRY> pending;   // Keyed by temp path
+        uint64_t manifest_version;
+        mutex ring_mutex;           // Stream state and the renames, never held during an fsync
+
+        uint64_t written_manifest_version;
+        mutex manifest_mutex;       // Serializes the manifest writes and their fsyncs
+
+        STREAM_STATE& find_stream(const string& stream_key);
+        string format_manifest();   // ring_mutex must be held
+        int write_manifest(uint64_t version, const string& content);
+
+    public:
+        DISK_RING();
+
+        // folder_path is used as a prefix, like the capture tools do (include the trailing '/')
+        int init(const string& folder, unsigned int slots, bool sync);
+
+        // Picks the next slot of the stream and returns the paths to use. The frame must be finished with complete().
+        DISK_RING_ENTRY begin_frame(const string& stream_key, const string& extension, uint64_t frame_id, uint64_t timestamp_ns);
+
+        // Renames a written temp file into its slot and publishes it in the manifest (or removes it if success is false).
+        // Thread safe, can be called from a writer completion handler.
+        int complete(const string& temp_path, bool success);
+
+        unsigned int get_slot_count() const;
+};
+
+#endif // DISK_RING_H
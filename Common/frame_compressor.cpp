@@ -0,0 +1,820 @@
+// Description: Lossless tiled LZ4/zstd frame compression on a thread pool, and a sink stage that feeds the recorder
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+
+#ifdef WITH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef WITH_ZSTD
+#include <zstd.h>
+#endif
+
+#include "frame_compressor.h"
+
+using namespace std;
+
+// Tiles are never smaller than this, which bounds the size of the tile table
+static const size_t MIN_TILE_BYTES = 4096;
+static const size_t DEFAULT_TILE_BYTES = 64 * 1024;
+
+/**
+ * Returns the thread CPU time in nanoseconds.
+ * @return CPU time used by the calling thread.
+ */
+static uint64_t thread_cpu_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + static_cast<uint64_t>(now.tv_nsec);
+}
+
+/**
+ * Returns the worst case compressed size of a tile for a codec.
+ * @param codec: The codec.
+ * @param size: Raw tile size.
+ * @return Buffer size needed by the codec.
+ */
+static size_t codec_bound(COMPRESSION_CODEC codec, size_t size)
+{
+#ifdef WITH_LZ4
+    if (codec == COMPRESSION_LZ4)
+    {
+        return static_cast<size_t>(LZ4_compressBound(static_cast<int>(size)));
+    }
+#endif
+#ifdef WITH_ZSTD
+    if (codec == COMPRESSION_ZSTD)
+    {
+        return ZSTD_compressBound(size);
+    }
+#endif
+    (void)codec;
+    return size;
+}
+
+/**
+ * Splits 2 byte pixels into a plane of low bytes followed by a plane of high bytes. The high bytes of 10/12 bit
+ * data are nearly constant, which the codecs compress far better than interleaved bytes.
+ * @param source: Interleaved pixels.
+ * @param size: Bytes (even).
+ * @param destination: Byte planes.
+ */
+static void shuffle_bytes(const uint8_t* source, size_t size, uint8_t* destination)
+{
+    size_t pixels = size / 2;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        destination[i] = source[2 * i];
+        destination[pixels + i] = source[2 * i + 1];
+    }
+}
+
+/**
+ * Reverses shuffle_bytes().
+ * @param source: Byte planes.
+ * @param size: Bytes (even).
+ * @param destination: Interleaved pixels.
+ */
+static void unshuffle_bytes(const uint8_t* source, size_t size, uint8_t* destination)
+{
+    size_t pixels = size / 2;
+    for (size_t i = 0; i < pixels; i++)
+    {
+        destination[2 * i] = source[i];
+        destination[2 * i + 1] = source[pixels + i];
+    }
+}
+
+/**
+ * Returns the rows per tile for a frame.
+ * @param tile_rows: Configured rows per tile (0 = automatic).
+ * @param stride: Bytes per row.
+ * @return Rows per tile.
+ */
+static size_t rows_per_tile(unsigned int tile_rows, size_t stride)
+{
+    size_t rows = tile_rows > 0 ? tile_rows : max<size_t>(1, DEFAULT_TILE_BYTES / stride);
+    return max(rows, (MIN_TILE_BYTES + stride - 1) / stride);
+}
+
+/**
+ * Returns the default compressor configuration.
+ * @param codec: The codec.
+ * @param max_frame_bytes: The largest raw pixel payload.
+ * @return The configuration.
+ */
+COMPRESSION_CONFIG default_compression_config(COMPRESSION_CODEC codec, size_t max_frame_bytes)
+{
+    COMPRESSION_CONFIG config;
+    config.codec = codec;
+    config.level = codec == COMPRESSION_ZSTD ? 1 : 0;
+    config.threads = max(1u, min(4u, thread::hardware_concurrency()));
+    config.tile_rows = 0;
+    config.shuffle = true;
+    config.max_frame_bytes = max_frame_bytes;
+    return config;
+}
+
+/**
+ * Parses a codec name.
+ * @param name: none, lz4 or zstd.
+ * @param codec: The parsed codec.
+ * @return True if the name is known, false otherwise.
+ */
+bool parse_compression_codec(const string& name, COMPRESSION_CODEC& codec)
+{
+    if (name == "none")
+    {
+        codec = COMPRESSION_NONE;
+    }
+    else if (name == "lz4")
+    {
+        codec = COMPRESSION_LZ4;
+    }
+    else if (name == "zstd")
+    {
+        codec = COMPRESSION_ZSTD;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns the name of a codec.
+ * @param codec: The codec.
+ * @return The codec name.
+ */
+const char* get_compression_codec_name(COMPRESSION_CODEC codec)
+{
+    switch (codec)
+    {
+        case COMPRESSION_NONE: return "none";
+        case COMPRESSION_LZ4: return "lz4";
+        case COMPRESSION_ZSTD: return "zstd";
+    }
+    return "unknown";
+}
+
+/**
+ * Checks whether a codec was compiled in.
+ * @param codec: The codec.
+ * @return True if frames can be compressed with the codec.
+ */
+bool is_compression_codec_available(COMPRESSION_CODEC codec)
+{
+    switch (codec)
+    {
+        case COMPRESSION_NONE:
+            return true;
+        case COMPRESSION_LZ4:
+#ifdef WITH_LZ4
+            return true;
+#else
+            return false;
+#endif
+        case COMPRESSION_ZSTD:
+#ifdef WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+/**
+ * Returns the largest compressed block a frame can produce (tiles that do not shrink are stored).
+ * @param max_frame_bytes: Largest raw pixel payload.
+ * @return Block size in bytes.
+ */
+size_t get_max_compressed_frame_size(size_t max_frame_bytes)
+{
+    return sizeof(COMPRESSED_FRAME_INFO) + (max_frame_bytes / MIN_TILE_BYTES + 1) * sizeof(uint32_t) + max_frame_bytes;
+}
+
+/**
+ * Constructor for the FRAME_COMPRESSOR class.
+ */
+FRAME_COMPRESSOR::FRAME_COMPRESSOR()
+    : tile_capacity(0), tile_bound(0), max_tiles(0), frame_data(nullptr), frame_size(0), frame_tile_bytes(0),
+      frame_pixel_bytes(0), frame_tiles(0), next_tile(0), tiles_done(0), generation(0), cpu_ns(0), errors(0),
+      stopping(false), frames(0), raw_bytes(0), compressed_bytes(0), wall_ns(0)
+{
+}
+
+/**
+ * Destructor for the FRAME_COMPRESSOR class -> stops the workers and frees the codec contexts.
+ */
+FRAME_COMPRESSOR::~FRAME_COMPRESSOR()
+{
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+#ifdef WITH_ZSTD
+    for (void* context : codec_contexts)
+    {
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context));
+    }
+#endif
+}
+
+/**
+ * Checks the codec, allocates the per-worker state and starts the worker threads.
+ * @param compression_config: The compressor configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_COMPRESSOR::init(const COMPRESSION_CONFIG& compression_config)
+{
+    config = compression_config;
+    config.threads = max(1u, config.threads);
+
+    if (!is_compression_codec_available(config.codec))
+    {
+        cerr << "[Compressor] Built without " << get_compression_codec_name(config.codec) << " support\n";
+        return -1;
+    }
+
+    max_tiles = static_cast<unsigned int>(config.max_frame_bytes / MIN_TILE_BYTES + 1);
+    tile_output.resize(max_tiles);
+    tile_sizes.resize(max_tiles);
+    shuffle_buffers.resize(config.threads);
+    codec_contexts.assign(config.threads, nullptr);
+
+#ifdef WITH_ZSTD
+    if (config.codec == COMPRESSION_ZSTD)
+    {
+        for (unsigned int i = 0; i < config.threads; i++)
+        {
+            codec_contexts[i] = ZSTD_createCCtx();
+            if (codec_contexts[i] == nullptr)
+            {
+                cerr << "[Compressor] Unable to create a zstd context\n";
+                return -1;
+            }
+        }
+    }
+#endif
+
+    // The calling thread is worker 0
+    for (unsigned int i = 1; i < config.threads; i++)
+    {
+        workers.push_back(thread(&FRAME_COMPRESSOR::worker_loop, this, i));
+    }
+
+    return 0;
+}
+
+/**
+ * Returns the output buffer size compress() needs. Tiles that do not shrink are stored, so the block is never much
+ * larger than the raw frame.
+ * @return Bytes.
+ */
+size_t FRAME_COMPRESSOR::get_max_compressed_size() const
+{
+    return get_max_compressed_frame_size(config.max_frame_bytes);
+}
+
+/**
+ * Worker thread: compresses tiles whenever a new frame is handed out.
+ * @param worker: The worker index (selects the scratch buffer and codec context).
+ */
+void FRAME_COMPRESSOR::worker_loop(unsigned int worker)
+{
+    uint64_t seen_generation = 0;
+
+    while (true)
+    {
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            work_available.wait(lock, [this, seen_generation] { return stopping || generation != seen_generation; });
+            if (stopping)
+            {
+                return;
+            }
+            seen_generation = generation;
+        }
+
+        compress_tiles(worker);
+    }
+}
+
+/**
+ * Takes tiles of the current frame until none are left.
+ * @param worker: The worker index.
+ */
+void FRAME_COMPRESSOR::compress_tiles(unsigned int worker)
+{
+    unsigned int completed = 0;
+    uint64_t cpu_start = thread_cpu_ns();
+
+    while (true)
+    {
+        unsigned int tile = next_tile.fetch_add(1);
+        if (tile >= frame_tiles)
+        {
+            break;
+        }
+
+        size_t offset = tile * frame_tile_bytes;
+        size_t size = min(frame_tile_bytes, frame_size - offset);
+        tile_sizes[tile] = compress_tile(worker, frame_data + offset, size, tile_output[tile].data());
+        completed++;
+    }
+
+    if (completed > 0)
+    {
+        cpu_ns += thread_cpu_ns() - cpu_start;
+
+        lock_guard<mutex> lock(pool_mutex);
+        tiles_done += completed;
+        if (tiles_done == frame_tiles)
+        {
+            work_done.notify_all();
+        }
+    }
+}
+
+/**
+ * Compresses one tile. Tiles that do not shrink are stored as they are.
+ * @param worker: The worker index.
+ * @param source: The raw tile.
+ * @param size: Raw tile size.
+ * @param destination: At least tile_bound bytes.
+ * @return Entry for the tile table (size, with COMPRESSED_TILE_STORED if stored).
+ */
+uint32_t FRAME_COMPRESSOR::compress_tile(unsigned int worker, const uint8_t* source, size_t size, uint8_t* destination)
+{
+    const uint8_t* input = source;
+    if (frame_pixel_bytes == 2 && config.shuffle)
+    {
+        shuffle_bytes(source, size, shuffle_buffers[worker].data());
+        input = shuffle_buffers[worker].data();
+    }
+
+    size_t compressed = 0;
+
+#ifdef WITH_LZ4
+    if (config.codec == COMPRESSION_LZ4)
+    {
+        int result;
+        if (config.level > 1)
+        {
+            result = LZ4_compress_HC(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(destination),
+                                     static_cast<int>(size), static_cast<int>(tile_bound), config.level);
+        }
+        else
+        {
+            result = LZ4_compress_fast(reinterpret_cast<const char*>(input), reinterpret_cast<char*>(destination),
+                                       static_cast<int>(size), static_cast<int>(tile_bound), config.level < 0 ? -config.level : 1);
+        }
+        compressed = result > 0 ? static_cast<size_t>(result) : 0;
+    }
+#endif
+#ifdef WITH_ZSTD
+    if (config.codec == COMPRESSION_ZSTD)
+    {
+        size_t result = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(codec_contexts[worker]), destination, tile_bound,
+                                          input, size, config.level);
+        compressed = ZSTD_isError(result) ? 0 : result;
+    }
+#endif
+    (void)input;    // Unused when built without any codec
+
+    if (compressed == 0 || compressed >= size)
+    {
+        memcpy(destination, source, size);  // Stored tiles are never shuffled
+        return static_cast<uint32_t>(size) | COMPRESSED_TILE_STORED;
+    }
+
+    return static_cast<uint32_t>(compressed);
+}
+
+/**
+ * Compresses one frame, all tiles in parallel.
+ * @param header: The raw frame header.
+ * @param data: The raw pixels.
+ * @param compressed_header: The header to record in front of the compressed block.
+ * @param output: At least get_max_compressed_size() bytes.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_COMPRESSOR::compress(const FRAME_HEADER& header, const void* data, FRAME_HEADER& compressed_header, uint8_t* output)
+{
+    auto start_time = chrono::steady_clock::now();
+
+    if (header.data_size > config.max_frame_bytes || is_frame_compressed(header))
+    {
+        cerr << "[Compressor] Frame " << header.frame_id << " is too large or already compressed\n";
+        errors++;
+        return -1;
+    }
+
+    unsigned int bytes_per_pixel = frame_bytes_per_pixel(header.pixel_format);
+    size_t stride = header.stride > 0 ? header.stride : header.width * max(1u, bytes_per_pixel);
+    size_t tile_bytes = rows_per_tile(config.tile_rows, stride) * stride;
+    size_t size = header.data_size;
+    unsigned int tiles = size > 0 ? static_cast<unsigned int>((size + tile_bytes - 1) / tile_bytes) : 0;
+
+    // Buffers grow to the tile size of the first frame; the workers are idle here
+    if (tile_bytes > tile_capacity)
+    {
+        tile_capacity = tile_bytes;
+        tile_bound = codec_bound(config.codec, tile_capacity);
+        for (auto& buffer : tile_output)
+        {
+            buffer.resize(tile_bound);
+        }
+        for (auto& buffer : shuffle_buffers)
+        {
+            buffer.resize(tile_capacity);
+        }
+    }
+
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        frame_data = static_cast<const uint8_t*>(data);
+        frame_size = size;
+        frame_tile_bytes = tile_bytes;
+        frame_pixel_bytes = (size % 2 == 0 && tile_bytes % 2 == 0) ? bytes_per_pixel : 1;  // Shuffle needs whole pixels
+        frame_tiles = tiles;
+        tiles_done = 0;
+        next_tile = 0;
+        generation++;
+    }
+    work_available.notify_all();
+
+    compress_tiles(0);
+
+    {
+        unique_lock<mutex> lock(pool_mutex);
+        work_done.wait(lock, [this] { return tiles_done == frame_tiles; });
+    }
+
+    // Pack info, tile table and tiles
+    COMPRESSED_FRAME_INFO info;
+    memset(&info, 0, sizeof(info));
+    info.magic = COMPRESSED_FRAME_MAGIC;
+    info.codec = static_cast<uint8_t>(config.codec);
+    info.flags = (frame_pixel_bytes == 2 && config.shuffle) ? COMPRESSED_FRAME_SHUFFLED : 0;
+    info.level = static_cast<int16_t>(config.level);
+    info.tile_count = tiles;
+    info.tile_rows = static_cast<uint32_t>(tile_bytes / stride);
+    info.raw_size = size;
+
+    uint8_t* position = output;
+    memcpy(position, &info, sizeof(info));
+    position += sizeof(info);
+    memcpy(position, tile_sizes.data(), tiles * sizeof(uint32_t));
+    position += tiles * sizeof(uint32_t);
+
+    for (unsigned int tile = 0; tile < tiles; tile++)
+    {
+        size_t tile_size = tile_sizes[tile] & ~COMPRESSED_TILE_STORED;
+        memcpy(position, tile_output[tile].data(), tile_size);
+        position += tile_size;
+    }
+
+    compressed_header = header;
+    compressed_header.pixel_format = header.pixel_format | FRAME_COMPRESSED_FLAG;
+    compressed_header.data_size = static_cast<uint64_t>(position - output);
+
+    frames++;
+    raw_bytes += size;
+    compressed_bytes += compressed_header.data_size;
+    wall_ns += static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start_time).count());
+    return 0;
+}
+
+/**
+ * Restores the raw frame from a compressed block.
+ * @param compressed_header: The header in front of the block.
+ * @param block: The compressed block (or raw pixels if the frame is not compressed).
+ * @param header: The raw frame header.
+ * @param data: Receives the raw pixels.
+ * @return 0 if successful, -1 if the block is corrupt or the codec is not available.
+ */
+int FRAME_COMPRESSOR::decompress(const FRAME_HEADER& compressed_header, const void* block, FRAME_HEADER& header, vector<uint8_t>& data)
+{
+    const uint8_t* input = static_cast<const uint8_t*>(block);
+    header = compressed_header;
+
+    if (!is_frame_compressed(compressed_header))
+    {
+        data.assign(input, input + compressed_header.data_size);
+        return 0;
+    }
+
+    COMPRESSED_FRAME_INFO info;
+    if (compressed_header.data_size < sizeof(info))
+    {
+        return -1;
+    }
+    memcpy(&info, input, sizeof(info));
+
+    size_t table_end = sizeof(info) + static_cast<size_t>(info.tile_count) * sizeof(uint32_t);
+    if (info.magic != COMPRESSED_FRAME_MAGIC || table_end > compressed_header.data_size || info.tile_rows == 0 ||
+        !is_compression_codec_available(static_cast<COMPRESSION_CODEC>(info.codec)))
+    {
+        return -1;
+    }
+
+    header.pixel_format = compressed_header.pixel_format & ~FRAME_COMPRESSED_FLAG;
+
+    // The raw size comes from the file, so it must match the frame geometry before anything is allocated
+    unsigned int bytes_per_pixel = frame_bytes_per_pixel(header.pixel_format);
+    size_t row_bytes = static_cast<size_t>(header.width) * max(1u, bytes_per_pixel);
+    size_t stride = header.stride > 0 ? header.stride : row_bytes;
+    size_t tile_bytes = static_cast<size_t>(info.tile_rows) * stride;
+    if (header.width == 0 || header.height == 0 || stride < row_bytes || info.raw_size != stride * header.height)
+    {
+        return -1;
+    }
+
+    // Every byte of the frame has to come from a tile
+    if (info.tile_count != (info.raw_size + tile_bytes - 1) / tile_bytes)
+    {
+        return -1;
+    }
+
+    header.data_size = info.raw_size;
+    data.resize(info.raw_size);
+    bool shuffled = (info.flags & COMPRESSED_FRAME_SHUFFLED) != 0;
+    vector<uint8_t> planes(shuffled ? tile_bytes : 0);
+
+    const uint32_t* tile_sizes = reinterpret_cast<const uint32_t*>(input + sizeof(info));
+    size_t position = table_end;
+
+    for (uint32_t tile = 0; tile < info.tile_count; tile++)
+    {
+        size_t offset = tile * tile_bytes;
+        if (offset >= info.raw_size)
+        {
+            return -1;
+        }
+
+        size_t raw_tile_size = min(tile_bytes, static_cast<size_t>(info.raw_size) - offset);
+        size_t stored_size = tile_sizes[tile] & ~COMPRESSED_TILE_STORED;
+        if (position + stored_size > compressed_header.data_size)
+        {
+            return -1;
+        }
+
+        const uint8_t* source = input + position;
+        uint8_t* destination = data.data() + offset;
+        position += stored_size;
+
+        if (tile_sizes[tile] & COMPRESSED_TILE_STORED)
+        {
+            if (stored_size != raw_tile_size)
+            {
+                return -1;
+            }
+            memcpy(destination, source, raw_tile_size);
+            continue;
+        }
+
+        uint8_t* target = shuffled ? planes.data() : destination;
+        size_t restored = 0;
+
+#ifdef WITH_LZ4
+        if (info.codec == COMPRESSION_LZ4)
+        {
+            int result = LZ4_decompress_safe(reinterpret_cast<const char*>(source), reinterpret_cast<char*>(target),
+                                             static_cast<int>(stored_size), static_cast<int>(raw_tile_size));
+            restored = result > 0 ? static_cast<size_t>(result) : 0;
+        }
+#endif
+#ifdef WITH_ZSTD
+        if (info.codec == COMPRESSION_ZSTD)
+        {
+            size_t result = ZSTD_decompress(target, raw_tile_size, source, stored_size);
+            restored = ZSTD_isError(result) ? 0 : result;
+        }
+#endif
+        (void)target;
+
+        if (restored != raw_tile_size)
+        {
+            return -1;
+        }
+
+        if (shuffled)
+        {
+            unshuffle_bytes(planes.data(), raw_tile_size, destination);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Returns the compressor counters.
+ * @return The counters.
+ */
+COMPRESSION_STATS FRAME_COMPRESSOR::get_stats() const
+{
+    COMPRESSION_STATS stats;
+    stats.frames = frames;
+    stats.raw_bytes = raw_bytes;
+    stats.compressed_bytes = compressed_bytes;
+    stats.cpu_seconds = cpu_ns / 1e9;
+    stats.wall_seconds = wall_ns / 1e9;
+    stats.stalls = 0;
+    stats.errors = errors;
+    return stats;
+}
+
+/**
+ * Constructor for the COMPRESSION_STAGE class.
+ */
+COMPRESSION_STAGE::COMPRESSION_STAGE()
+    : downstream(nullptr), jobs_in_progress(0), stopping(false), stalls(0)
+{
+}
+
+/**
+ * Destructor for the COMPRESSION_STAGE class -> compresses what is queued and stops the stage thread.
+ */
+COMPRESSION_STAGE::~COMPRESSION_STAGE()
+{
+    if (stage_thread.joinable())
+    {
+        {
+            unique_lock<mutex> lock(stage_mutex);
+            jobs_done.wait(lock, [this] { return jobs.empty() && jobs_in_progress == 0; });
+            stopping = true;
+        }
+        job_available.notify_all();
+        stage_thread.join();
+    }
+}
+
+/**
+ * Starts the compressor and the stage thread.
+ * @param compression_config: The compressor configuration.
+ * @param next_sink: Receives the compressed frames.
+ * @param queue_frames: Raw frames that can wait for compression.
+ * @return 0 if successful, -1 otherwise.
+ */
+int COMPRESSION_STAGE::init(const COMPRESSION_CONFIG& compression_config, FRAME_SINK* next_sink, unsigned int queue_frames)
+{
+    downstream = next_sink;
+    if (downstream == nullptr || queue_frames == 0)
+    {
+        return -1;
+    }
+
+    if (compressor.init(compression_config) != 0 || input_buffers.init(queue_frames, max<size_t>(compression_config.max_frame_bytes, 1)) != 0)
+    {
+        return -1;
+    }
+
+    output_buffer.resize(compressor.get_max_compressed_size());
+    stage_thread = thread(&COMPRESSION_STAGE::stage_loop, this);
+
+    cout << "[Compressor] " << get_compression_codec_name(compression_config.codec) << " level " << compression_config.level
+         << ", " << max(1u, compression_config.threads) << " thread(s), " << queue_frames << " queued frames, feeding "
+         << downstream->get_sink_name() << "\n";
+    return 0;
+}
+
+/**
+ * Returns the largest frame the downstream sink will receive.
+ * @return Bytes.
+ */
+size_t COMPRESSION_STAGE::get_max_compressed_size() const
+{
+    return compressor.get_max_compressed_size();
+}
+
+/**
+ * Copies the frame into a queue buffer for the stage thread. Waits (and counts a stall) if every buffer is queued.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if successful, -1 otherwise.
+ */
+int COMPRESSION_STAGE::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    if (header.data_size > input_buffers.get_buffer_size())
+    {
+        cerr << "[Compressor] Frame " << header.frame_id << " is larger than the stage buffers\n";
+        return -1;
+    }
+
+    unsigned int buffer_index = 0;
+    if (!input_buffers.try_acquire(buffer_index))
+    {
+        stalls++;
+        buffer_index = input_buffers.acquire();
+    }
+
+    memcpy(input_buffers.get_buffer(buffer_index), data, header.data_size);
+
+    {
+        lock_guard<mutex> lock(stage_mutex);
+        STAGE_JOB job = {buffer_index, header};
+        jobs.push_back(job);
+    }
+    job_available.notify_one();
+    return 0;
+}
+
+/**
+ * Stage thread: compresses queued frames in order and hands them to the downstream sink.
+ */
+void COMPRESSION_STAGE::stage_loop()
+{
+    while (true)
+    {
+        STAGE_JOB job;
+        {
+            unique_lock<mutex> lock(stage_mutex);
+            job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+            {
+                return;
+            }
+            job = jobs.front();
+            jobs.pop_front();
+            jobs_in_progress++;
+        }
+
+        FRAME_HEADER compressed_header;
+        if (compressor.compress(job.header, input_buffers.get_buffer(job.buffer_index), compressed_header, output_buffer.data()) == 0)
+        {
+            downstream->consume_frame(compressed_header, output_buffer.data());
+        }
+        input_buffers.release(job.buffer_index);
+
+        {
+            lock_guard<mutex> lock(stage_mutex);
+            jobs_in_progress--;
+        }
+        jobs_done.notify_all();
+    }
+}
+
+/**
+ * Compresses everything that is queued, then flushes the downstream sink.
+ * @return The result of the downstream flush.
+ */
+int COMPRESSION_STAGE::flush()
+{
+    {
+        unique_lock<mutex> lock(stage_mutex);
+        jobs_done.wait(lock, [this] { return jobs.empty() && jobs_in_progress == 0; });
+    }
+
+    return downstream != nullptr ? downstream->flush() : 0;
+}
+
+/**
+ * Passes events on to the downstream sink.
+ * @param reason: The event reason.
+ */
+void COMPRESSION_STAGE::on_event(const string& reason)
+{
+    if (downstream != nullptr)
+    {
+        downstream->on_event(reason);
+    }
+}
+
+/**
+ * Returns the name of the sink for logging.
+ * @return The name of the sink.
+ */
+const char* COMPRESSION_STAGE::get_sink_name() const
+{
+    return "Compressor";
+}
+
+/**
+ * Returns the compressor counters (the stage thread may still be updating them).
+ * @return The counters.
+ */
+COMPRESSION_STATS COMPRESSION_STAGE::get_stats() const
+{
+    COMPRESSION_STATS stats = compressor.get_stats();
+    stats.stalls = stalls;
+    return stats;
+}
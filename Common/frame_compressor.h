@@ -0,0 +1,185 @@
+// frame_compressor.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_COMPRESSOR_H
+#define FRAME_COMPRESSOR_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const uint32_t COMPRESSED_FRAME_MAGIC = 0x504D4346;  // "FCMP"
+const uint8_t COMPRESSED_FRAME_SHUFFLED = 0x01;     // Multi-byte pixels were split into byte planes per tile
+const uint32_t COMPRESSED_TILE_STORED = 0x80000000; // Tile size flag: stored uncompressed (did not shrink)
+
+enum COMPRESSION_CODEC
+{
+    COMPRESSION_NONE = 0,
+    COMPRESSION_LZ4 = 1,    // Needs liblz4 (WITH_LZ4)
+    COMPRESSION_ZSTD = 2    // Needs libzstd (WITH_ZSTD)
+};
+
+// Compressed frame data (FRAME_HEADER.pixel_format has FRAME_COMPRESSED_FLAG, data_size is the block size):
+//   COMPRESSED_FRAME_INFO | uint32_t tile_sizes[tile_count] | tile 0 | tile 1 | ...
+// Tiles are horizontal strips of tile_rows rows (the last one may be shorter), so they decompress independently.
+struct COMPRESSED_FRAME_INFO
+{
+    uint32_t magic;         // COMPRESSED_FRAME_MAGIC
+    uint8_t codec;          // COMPRESSION_CODEC
+    uint8_t flags;          // COMPRESSED_FRAME_SHUFFLED
+    int16_t level;
+    uint32_t tile_count;
+    uint32_t tile_rows;
+    uint64_t raw_size;      // data_size of the decompressed frame
+    uint64_t reserved;
+};
+
+static_assert(sizeof(COMPRESSED_FRAME_INFO) == 32, "COMPRESSED_FRAME_INFO layout changed");
+
+// Struct to hold the compressor configuration
+struct COMPRESSION_CONFIG
+{
+    COMPRESSION_CODEC codec;
+    int level;                  // LZ4: <= 1 fast (negative = more acceleration), > 1 HC level. zstd: 1..19 (negative = fast modes)
+    unsigned int threads;       // Threads compressing tiles of the same frame (including the calling thread)
+    unsigned int tile_rows;     // Rows per tile, 0 = about 64 KiB per tile
+    bool shuffle;               // Split Mono16 pixels into high/low byte planes before compressing
+    size_t max_frame_bytes;     // Largest raw pixel payload
+};
+
+// Struct to hold the compressor counters
+struct COMPRESSION_STATS
+{
+    uint64_t frames;
+    uint64_t raw_bytes;
+    uint64_t compressed_bytes;  // Including COMPRESSED_FRAME_INFO and the tile table
+    double cpu_seconds;         // Thread CPU time spent in the codec, summed over all threads
+    double wall_seconds;        // Time spent in compress() (tiles run in parallel)
+    uint64_t stalls;            // COMPRESSION_STAGE only: consume_frame waited for a free buffer
+    uint64_t errors;
+};
+
+// Compresses frames as independent tiles on a small thread pool. compress() returns when the whole frame is done.
+class FRAME_COMPRESSOR
+{
+    private:
+        COMPRESSION_CONFIG config;
+        size_t tile_capacity;           // Raw bytes per tile at most
+        size_t tile_bound;              // Worst case compressed tile
+        unsigned int max_tiles;
+
+        vector<vector<uint8_t>> tile_output;    // Per tile
+        vector<vector<uint8_t>> shuffle_buffers;    // Per worker
+        vector<void*> codec_contexts;           // Per worker (zstd)
+        vector<uint32_t> tile_sizes;
+
+        // Current frame, shared with the workers
+        const uint8_t* frame_data;
+        size_t frame_size;
+        size_t frame_tile_bytes;
+        unsigned int frame_pixel_bytes;
+        unsigned int frame_tiles;
+        atomic<unsigned int> next_tile;
+        unsigned int tiles_done;
+        uint64_t generation;
+        atomic<uint64_t> cpu_ns;
+        atomic<uint64_t> errors;
+
+        vector<thread> workers;
+        bool stopping;
+        mutex pool_mutex;
+        condition_variable work_available;
+        condition_variable work_done;
+
+        atomic<uint64_t> frames;
+        atomic<uint64_t> raw_bytes;
+        atomic<uint64_t> compressed_bytes;
+        atomic<uint64_t> wall_ns;
+
+        void worker_loop(unsigned int worker);
+        void compress_tiles(unsigned int worker);   // Takes tiles until none are left
+        uint32_t compress_tile(unsigned int worker, const uint8_t* source, size_t size, uint8_t* destination);
+
+    public:
+        FRAME_COMPRESSOR();
+        ~FRAME_COMPRESSOR();
+
+        int init(const COMPRESSION_CONFIG& compression_config);    // Allocate the tile buffers and start the workers
+
+        size_t get_max_compressed_size() const;   // Output buffer size needed by compress()
+
+        // Compresses one frame into output (at least get_max_compressed_size() bytes). compressed_header is header with
+        // FRAME_COMPRESSED_FLAG set and data_size = block size.
+        int compress(const FRAME_HEADER& header, const void* data, FRAME_HEADER& compressed_header, uint8_t* output);
+
+        // Restores the raw frame from a compressed block. Uncompressed frames are copied as they are.
+        static int decompress(const FRAME_HEADER& compressed_header, const void* block, FRAME_HEADER& header, vector<uint8_t>& data);
+
+        COMPRESSION_STATS get_stats() const;
+};
+
+// Frame sink that compresses frames on its own thread and passes them on to another sink (e.g. the segment
+// recorder), so the acquisition loop only pays for one memcpy. Frames are forwarded in order.
+class COMPRESSION_STAGE : public FRAME_SINK
+{
+    private:
+        struct STAGE_JOB
+        {
+            unsigned int buffer_index;
+            FRAME_HEADER header;
+        };
+
+        FRAME_COMPRESSOR compressor;
+        FRAME_SINK* downstream;
+        ALIGNED_BUFFER_POOL input_buffers;
+        vector<uint8_t> output_buffer;
+
+        thread stage_thread;
+        deque<STAGE_JOB> jobs;
+        unsigned int jobs_in_progress;
+        bool stopping;
+        mutex stage_mutex;
+        condition_variable job_available;
+        condition_variable jobs_done;
+        atomic<uint64_t> stalls;
+
+        void stage_loop();
+
+    public:
+        COMPRESSION_STAGE();
+        ~COMPRESSION_STAGE();
+
+        // downstream must accept frames of up to get_max_compressed_size() bytes
+        int init(const COMPRESSION_CONFIG& compression_config, FRAME_SINK* next_sink, unsigned int queue_frames);
+
+        size_t get_max_compressed_size() const;
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        int flush();    // Compresses what is queued, then flushes the downstream sink
+        void on_event(const string& reason);
+        const char* get_sink_name() const;
+
+        COMPRESSION_STATS get_stats() const;
+};
+
+// Default configuration: LZ4 fast, one thread per core (at most 4), ~64 KiB tiles, Mono16 shuffle on
+COMPRESSION_CONFIG default_compression_config(COMPRESSION_CODEC codec, size_t max_frame_bytes);
+
+bool parse_compression_codec(const string& name, COMPRESSION_CODEC& codec);    // none | lz4 | zstd
+const char* get_compression_codec_name(COMPRESSION_CODEC codec);
+bool is_compression_codec_available(COMPRESSION_CODEC codec);   // False if the library was not found at build time
+size_t get_max_compressed_frame_size(size_t max_frame_bytes);   // Size sinks behind a COMPRESSION_STAGE with this
+
+#endif // FRAME_COMPRESSOR_H
@@ -0,0 +1,171 @@
+// Description: Integer factor area downscaling of 8 bit frames (Mono8, BGR8) for the preview windows
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "frame_downscale.h"
+
+using namespace std;
+
+/**
+ * Picks the downscale factor for a window: the largest one that keeps the frame at least as large as the window,
+ * so the window never has to scale it up.
+ * @param width: Frame width in pixels.
+ * @param height: Frame height in pixels.
+ * @param target_width: Window width in pixels.
+ * @param target_height: Window height in pixels.
+ * @return The factor, 1 (no downscaling) up to MAX_DOWNSCALE_FACTOR.
+ */
+unsigned int get_downscale_factor(size_t width, size_t height, size_t target_width, size_t target_height)
+{
+    if (target_width == 0 || target_height == 0)
+    {
+        return 1;
+    }
+
+    size_t factor = min(width / target_width, height / target_height);
+    return static_cast<unsigned int>(max<size_t>(1, min<size_t>(factor, MAX_DOWNSCALE_FACTOR)));
+}
+
+// 8 bytes widened to 8 16 bit sums: SSE2 on x86, NEON on the Jetson, through the GCC vector extensions
+typedef uint8_t DOWNSCALE_BYTES __attribute__((vector_size(8)));
+typedef uint16_t DOWNSCALE_SUMS __attribute__((vector_size(16)));
+
+// __builtin_convertvector needs GCC 9 (JetPack 4 ships GCC 7), older compilers widen lane by lane
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define DOWNSCALE_CONVERT_VECTOR 1
+#else
+#define DOWNSCALE_CONVERT_VECTOR 0
+#endif
+
+/**
+ * Adds one source row to the 16 bit column sums, 8 bytes per step.
+ * @param row: The source row.
+ * @param sums: The column sums, one per byte.
+ * @param count: Bytes to add.
+ */
+static void add_row_to_sums(const uint8_t* row, uint16_t* sums, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        DOWNSCALE_BYTES bytes;
+        DOWNSCALE_SUMS column;
+        memcpy(&bytes, row + i, sizeof(bytes));     // Unaligned loads, the rows start anywhere
+        memcpy(&column, sums + i, sizeof(column));
+#if DOWNSCALE_CONVERT_VECTOR
+        column += __builtin_convertvector(bytes, DOWNSCALE_SUMS);
+#else
+        DOWNSCALE_SUMS widened = {bytes[0], bytes[1], bytes[2], bytes[3], bytes[4], bytes[5], bytes[6], bytes[7]};
+        column += widened;
+#endif
+        memcpy(sums + i, &column, sizeof(column));
+    }
+    for (; i < count; i++)
+    {
+        sums[i] = static_cast<uint16_t>(sums[i] + row[i]);
+    }
+}
+
+/**
+ * Adds the column sums of each block and divides them by the block area.
+ * @param sums: Column sums of one block row.
+ * @param out: Receives destination_width pixels.
+ * @param destination_width: Blocks in the row.
+ * @param channels: Bytes per pixel, CHANNELS if it is not 0 (then the channel loop is unrolled).
+ * @param factor: Block size.
+ * @param rounding: Half the block area.
+ * @param reciprocal: 2^32 / block area, rounded up.
+ */
+template <size_t CHANNELS>
+static void average_blocks(const uint16_t* sums, uint8_t* out, size_t destination_width, size_t channels, unsigned int factor,
+                           uint32_t rounding, uint64_t reciprocal)
+{
+    if (CHANNELS != 0)
+    {
+        channels = CHANNELS;
+    }
+
+    for (size_t x = 0; x < destination_width; x++)
+    {
+        const uint16_t* block = sums + x * factor * channels;
+        for (size_t c = 0; c < channels; c++)
+        {
+            uint32_t total = 0;
+            for (unsigned int k = 0; k < factor; k++)
+            {
+                total += block[k * channels + c];
+            }
+            out[x * channels + c] = static_cast<uint8_t>(((total + rounding) * reciprocal) >> 32);
+        }
+    }
+}
+
+/**
+ * Averages every factor x factor block of an 8 bit frame with interleaved channels into one pixel. The rows of a
+ * block are first added into 16 bit column sums, 8 bytes per SIMD step, then each group of
+ * factor columns is added and divided once, so every source byte is read once. Pixels beyond the last complete
+ * block (width or height not a multiple of factor) are left out.
+ * @param source: The frame.
+ * @param width: Width in pixels.
+ * @param height: Height in pixels.
+ * @param stride: Bytes per source row.
+ * @param channels: Bytes per pixel (1 for Mono8, 3 for BGR8).
+ * @param factor: 1 to MAX_DOWNSCALE_FACTOR, 1 copies the frame.
+ * @param destination: Receives the downscaled frame, destination_width * channels bytes per row.
+ * @param destination_width: Receives width / factor.
+ * @param destination_height: Receives height / factor.
+ * @return 0 if successful, -1 if the arguments are invalid.
+ */
+int downscale_area(const uint8_t* source, size_t width, size_t height, size_t stride, size_t channels, unsigned int factor,
+                   vector<uint8_t>& destination, size_t& destination_width, size_t& destination_height)
+{
+    if (!source || channels == 0 || factor == 0 || factor > MAX_DOWNSCALE_FACTOR || stride < width * channels || width < factor || height < factor)
+    {
+        return -1;
+    }
+
+    destination_width = width / factor;
+    destination_height = height / factor;
+    const size_t row_bytes = destination_width * factor * channels;     // Source bytes of the complete blocks
+    const size_t destination_row_bytes = destination_width * channels;
+    destination.resize(destination_row_bytes * destination_height);
+
+    // (total + area / 2) / area as a multiply: exact for totals below 2^32 / area, here at most 16 * 16 * 255
+    const uint32_t area = factor * factor;
+    const uint32_t rounding = area / 2;
+    const uint64_t reciprocal = ((1ULL << 32) + area - 1) / area;
+
+    vector<uint16_t> column_sums(row_bytes);
+    for (size_t y = 0; y < destination_height; y++)
+    {
+        // Vertical: add the rows of the block byte by byte
+        const uint8_t* row = source + y * factor * stride;
+        uint16_t* sums = column_sums.data();
+        fill(column_sums.begin(), column_sums.end(), 0);
+        for (unsigned int r = 0; r < factor; r++, row += stride)
+        {
+            add_row_to_sums(row, sums, row_bytes);
+        }
+
+        // Horizontal: add factor pixels of each channel and divide by the block area
+        uint8_t* out = destination.data() + y * destination_row_bytes;
+        if (channels == 1)
+        {
+            average_blocks<1>(sums, out, destination_width, 1, factor, rounding, reciprocal);
+        }
+        else if (channels == 3)
+        {
+            average_blocks<3>(sums, out, destination_width, 3, factor, rounding, reciprocal);
+        }
+        else
+        {
+            average_blocks<0>(sums, out, destination_width, channels, factor, rounding, reciprocal);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,20 @@
+// frame_downscale.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_DOWNSCALE_H
+#define FRAME_DOWNSCALE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+const unsigned int MAX_DOWNSCALE_FACTOR = 16;   // 16 rows of 255 still fit the 16 bit column sums
+
+unsigned int get_downscale_factor(size_t width, size_t height, size_t target_width, size_t target_height);
+int downscale_area(const uint8_t* source, size_t width, size_t height, size_t stride, size_t channels, unsigned int factor,
+                   vector<uint8_t>& destination, size_t& destination_width, size_t& destination_height);
+
+#endif // FRAME_DOWNSCALE_H
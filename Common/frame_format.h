@@ -0,0 +1,125 @@
+// frame_format.h Header File -> Raw frame header shared by the writers, recorders and readers
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_FORMAT_H
+#define FRAME_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+using namespace std;
+
+const uint32_t FRAME_MAGIC = 0x4D525346;   // "FSRM" in little endian
+const uint16_t FRAME_VERSION = 1;
+
+// Pixel formats we actually produce. Kept independent of the Spinnaker enum so readers do not need the SDK
+enum FRAME_PIXEL_FORMAT
+{
+    FRAME_PIXEL_FORMAT_UNKNOWN = 0,
+    FRAME_PIXEL_FORMAT_MONO8 = 1,
+    FRAME_PIXEL_FORMAT_MONO16 = 2,
+    FRAME_PIXEL_FORMAT_BGR8 = 3,
+    FRAME_PIXEL_FORMAT_BAYER_RG8 = 4
+};
+
+// Set in pixel_format when the data is a compressed block (see frame_compressor.h) instead of raw pixels.
+// The low bits still hold the FRAME_PIXEL_FORMAT of the decompressed frame.
+const uint32_t FRAME_COMPRESSED_FLAG = 0x80000000;
+
+// Header written in front of every raw frame (.raw files, recordings, shared memory slots)
+struct FRAME_HEADER
+{
+    uint32_t magic;          // FRAME_MAGIC
+    uint16_t version;        // FRAME_VERSION
+    uint16_t header_size;    // sizeof(FRAME_HEADER), lets readers skip unknown trailing fields
+    uint32_t width;          // Pixels
+    uint32_t height;         // Pixels
+    uint32_t stride;         // Bytes per row
+    uint32_t pixel_format;   // FRAME_PIXEL_FORMAT
+    uint64_t frame_id;       // Camera frame ID (or a running counter)
+    uint64_t timestamp_ns;   // Camera timestamp in nanoseconds
+    uint64_t data_size;      // Bytes of pixel data following the header
+    int64_t offset_x;        // ROI OffsetX
+    int64_t offset_y;        // ROI OffsetY
+    char serial[16];         // Camera serial number, NUL terminated
+};
+
+static_assert(sizeof(FRAME_HEADER) == 80, "FRAME_HEADER layout changed, bump FRAME_VERSION");
+
+/**
+ * Initializes a frame header with the magic, version and geometry fields.
+ * @param header: The header to fill.
+ * @param width: Frame width in pixels.
+ * @param height: Frame height in pixels.
+ * @param stride: Bytes per row.
+ * @param pixel_format: One of FRAME_PIXEL_FORMAT.
+ * @param data_size: Number of pixel bytes following the header.
+ */
+inline void init_frame_header(FRAME_HEADER& header, uint32_t width, uint32_t height, uint32_t stride, uint32_t pixel_format, uint64_t data_size)
+{
+    memset(&header, 0, sizeof(header));
+    header.magic = FRAME_MAGIC;
+    header.version = FRAME_VERSION;
+    header.header_size = sizeof(FRAME_HEADER);
+    header.width = width;
+    header.height = height;
+    header.stride = stride;
+    header.pixel_format = pixel_format;
+    header.data_size = data_size;
+}
+
+/**
+ * Copies the camera serial number into the header (truncated to fit).
+ * @param header: The header to fill.
+ * @param serial: The camera serial number.
+ */
+inline void set_frame_serial(FRAME_HEADER& header, const string& serial)
+{
+    memset(header.serial, 0, sizeof(header.serial));
+    strncpy(header.serial, serial.c_str(), sizeof(header.serial) - 1);
+}
+
+/**
+ * Checks the magic and version of a header read back from disk or shared memory.
+ * @param header: The header to check.
+ * @return true if the header can be parsed by this build.
+ */
+inline bool is_frame_header_valid(const FRAME_HEADER& header)
+{
+    return header.magic == FRAME_MAGIC && header.version == FRAME_VERSION && header.header_size >= sizeof(FRAME_HEADER);
+}
+
+/**
+ * Checks whether the frame data is a compressed block.
+ * @param header: The frame header.
+ * @return true if the data has to be decompressed before use.
+ */
+inline bool is_frame_compressed(const FRAME_HEADER& header)
+{
+    return (header.pixel_format & FRAME_COMPRESSED_FLAG) != 0;
+}
+
+/**
+ * Returns the number of bytes per pixel for a frame pixel format.
+ * @param pixel_format: One of FRAME_PIXEL_FORMAT.
+ * @return Bytes per pixel, 0 for unknown formats.
+ */
+inline uint32_t frame_bytes_per_pixel(uint32_t pixel_format)
+{
+    switch (pixel_format & ~FRAME_COMPRESSED_FLAG)
+    {
+        case FRAME_PIXEL_FORMAT_MONO8:
+        case FRAME_PIXEL_FORMAT_BAYER_RG8:
+            return 1;
+        case FRAME_PIXEL_FORMAT_MONO16:
+            return 2;
+        case FRAME_PIXEL_FORMAT_BGR8:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+#endif // FRAME_FORMAT_H
@@ -0,0 +1,229 @@
+// Description: Frame pipeline shared by live capture and replay -> frame sinks, frame writer and the disk ring
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cstring>
+#include <string>
+
+#include "frame_pipeline.h"
+
+using namespace std;
+
+/**
+ * Constructor for the FRAME_PIPELINE class.
+ */
+FRAME_PIPELINE::FRAME_PIPELINE()
+    : frame_writer(nullptr), save_images(true), ring_slots(5), ring_sync(true), frames(0), sink_rejections(0), write_errors(0)
+{
+}
+
+/**
+ * Sets the asynchronous frame writer for the raw files.
+ * @param writer: The writer to use (not owned), or nullptr if the caller saves images itself.
+ */
+void FRAME_PIPELINE::set_frame_writer(FRAME_WRITER* writer)
+{
+    frame_writer = writer;
+
+    if (frame_writer)
+    {
+        // Completed raw files are renamed into their ring slot from the writer thread
+        DISK_RING* ring = &disk_ring;
+        frame_writer->set_completion_handler([ring](const string& path, bool success)
+        {
+            ring->complete(path, success);
+        });
+    }
+}
+
+/**
+ * Adds a consumer that receives every frame.
+ * @param sink: The sink to add (not owned). Flushed by flush().
+ */
+void FRAME_PIPELINE::add_frame_sink(FRAME_SINK* sink)
+{
+    if (sink)
+    {
+        frame_sinks.push_back(sink);
+    }
+}
+
+/**
+ * Enables or disables the per-frame files.
+ * @param enable: false -> frames only go to the frame sinks.
+ */
+void FRAME_PIPELINE::set_save_images(bool enable)
+{
+    save_images = enable;
+}
+
+/**
+ * Sets the on-disk ring options.
+ * @param slots: Number of files kept per camera/ROI.
+ * @param sync: fsync each frame and the directory before publishing it.
+ */
+void FRAME_PIPELINE::set_ring_options(unsigned int slots, bool sync)
+{
+    ring_slots = slots;
+    ring_sync = sync;
+}
+
+/**
+ * Returns whether per-frame files are written.
+ */
+bool FRAME_PIPELINE::is_saving_images() const
+{
+    return save_images;
+}
+
+/**
+ * Returns the number of frame sinks.
+ */
+size_t FRAME_PIPELINE::get_sink_count() const
+{
+    return frame_sinks.size();
+}
+
+/**
+ * Returns the disk ring, for callers that write the image files themselves.
+ */
+DISK_RING& FRAME_PIPELINE::get_disk_ring()
+{
+    return disk_ring;
+}
+
+/**
+ * Prepares the disk ring in the output folder if images are saved.
+ * @param folder_path: Prefix for the ring files (include the trailing '/').
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_PIPELINE::start(const string& folder_path)
+{
+    if (save_images && disk_ring.init(folder_path, ring_slots, ring_sync) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Hands the frame to the sinks first (they only copy it), then queues the raw file into the next ring slot.
+ * Without a frame writer, result.needs_image_save tells the caller to save the image into result.entry and
+ * finish it with get_disk_ring().complete().
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @param result: Receives what happened to the frame.
+ * @param outputs: FRAME_OUTPUT bits of the camera, e.g. only the sinks for a camera that is streamed but not saved.
+ * @return 0 if every sink and the writer accepted the frame, -1 otherwise.
+ */
+int FRAME_PIPELINE::process_frame(const FRAME_HEADER& header, const void* data, FRAME_PIPELINE_RESULT& result, unsigned int outputs)
+{
+    frames++;
+    result.sinks_rejected = 0;
+    result.queued = false;
+    result.needs_image_save = false;
+
+    if (outputs & FRAME_OUTPUT_SINKS)
+    {
+        for (FRAME_SINK* sink : frame_sinks)
+        {
+            if (sink->consume_frame(header, data) != 0)
+            {
+                result.sinks_rejected++;
+            }
+        }
+        sink_rejections += result.sinks_rejected;
+    }
+
+    if (!save_images || !(outputs & FRAME_OUTPUT_FILES))
+    {
+        return result.sinks_rejected == 0 ? 0 : -1;
+    }
+
+    string serial(header.serial, strnlen(header.serial, sizeof(header.serial)));
+    string stream_key = get_frame_stream_key(serial, header.offset_x);
+
+    if (!frame_writer)
+    {
+        result.needs_image_save = true;
+        result.entry = disk_ring.begin_frame(stream_key, ".jpg", header.frame_id, header.timestamp_ns);
+        return result.sinks_rejected == 0 ? 0 : -1;
+    }
+
+    // Queue the raw frame to the temp path, the writer's completion handler renames it into the slot
+    result.entry = disk_ring.begin_frame(stream_key, ".raw", header.frame_id, header.timestamp_ns);
+    if (frame_writer->write_frame(result.entry.temp_path, header, data) != 0)
+    {
+        disk_ring.complete(result.entry.temp_path, false);
+        write_errors++;
+        return -1;
+    }
+
+    result.queued = true;
+    return result.sinks_rejected == 0 ? 0 : -1;
+}
+
+/**
+ * Passes a user/control event (keypress, control command) to every sink.
+ * @param reason: The event reason.
+ */
+void FRAME_PIPELINE::on_event(const string& reason)
+{
+    for (FRAME_SINK* sink : frame_sinks)
+    {
+        sink->on_event(reason);
+    }
+}
+
+/**
+ * Waits until every queued frame is written and flushes the sinks. Call before tearing down the source.
+ * @return 0 if the writer and every sink finished without errors, -1 otherwise.
+ */
+int FRAME_PIPELINE::flush()
+{
+    int result = 0;
+
+    if (frame_writer)
+    {
+        result |= frame_writer->flush();
+        FRAME_WRITER_STATS stats = frame_writer->get_stats();
+        cout << "[Frame writer] " << frame_writer->get_name() << ": " << stats.frames_written << " frames, "
+             << stats.bytes_written << " bytes, " << stats.errors << " errors, " << stats.stalls << " stalls\n";
+    }
+
+    for (FRAME_SINK* sink : frame_sinks)
+    {
+        if (sink->flush() != 0)
+        {
+            cerr << "[Frame sink] " << sink->get_sink_name() << " reported errors\n";
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Returns a snapshot of the pipeline counters.
+ * @return The current statistics.
+ */
+FRAME_PIPELINE_STATS FRAME_PIPELINE::get_stats() const
+{
+    FRAME_PIPELINE_STATS stats;
+    stats.frames = frames.load();
+    stats.sink_rejections = sink_rejections.load();
+    stats.write_errors = write_errors.load();
+    return stats;
+}
+
+/**
+ * Builds the disk ring stream key of a camera/ROI.
+ * @param serial: The camera serial number.
+ * @param offset_x: The ROI OffsetX.
+ * @return Serial_<serial>_OffsetX_<offset_x>
+ */
+string get_frame_stream_key(const string& serial, int64_t offset_x)
+{
+    return "Serial_" + serial + "_OffsetX_" + to_string(offset_x);
+}
@@ -0,0 +1,89 @@
+// frame_pipeline.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include "disk_ring.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+#include "frame_writer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Where a frame goes, per camera (the "outputs" setting of the camera settings file)
+enum FRAME_OUTPUT : unsigned int
+{
+    FRAME_OUTPUT_SINKS = 1 << 0,    // The frame sinks (recorders, rings, stream, metrics)
+    FRAME_OUTPUT_FILES = 1 << 1,    // The per-frame files in the disk ring
+    FRAME_OUTPUT_ALL = FRAME_OUTPUT_SINKS | FRAME_OUTPUT_FILES
+};
+
+// What happened to one frame in FRAME_PIPELINE::process_frame
+struct FRAME_PIPELINE_RESULT
+{
+    unsigned int sinks_rejected;    // Sinks that returned an error
+    bool queued;                    // Raw file queued with the frame writer
+    bool needs_image_save;          // Images are saved but there is no frame writer -> caller saves the image itself
+    DISK_RING_ENTRY entry;          // Ring slot of the raw file (queued) or for the caller's image (needs_image_save)
+};
+
+// Struct to hold the pipeline counters
+struct FRAME_PIPELINE_STATS
+{
+    uint64_t frames;
+    uint64_t sink_rejections;
+    uint64_t write_errors;
+};
+
+// Everything that happens to a frame after it was grabbed and converted: the frame sinks get a copy, then the
+// frame is saved into the per camera/ROI disk ring through the frame writer. Used by the camera manager and by
+// the replay tool, so recorded frames go through exactly the same code as live ones.
+class FRAME_PIPELINE
+{
+    private:
+        FRAME_WRITER* frame_writer;     // Optional asynchronous writer for raw frames, not owned
+        vector<FRAME_SINK*> frame_sinks;    // Not owned
+        bool save_images;               // false -> only the frame sinks get the frames
+
+        DISK_RING disk_ring;
+        unsigned int ring_slots;
+        bool ring_sync;
+
+        atomic<uint64_t> frames;
+        atomic<uint64_t> sink_rejections;
+        atomic<uint64_t> write_errors;
+
+    public:
+        FRAME_PIPELINE();
+
+        void set_frame_writer(FRAME_WRITER* writer);    // Raw frames through the writer, completions go to the disk ring
+        void add_frame_sink(FRAME_SINK* sink);          // Pass every frame to an additional consumer
+        void set_save_images(bool enable);              // Enable/disable the per-frame files
+        void set_ring_options(unsigned int slots, bool sync);   // Slot files per camera/ROI and whether commits are fsynced
+
+        bool is_saving_images() const;
+        size_t get_sink_count() const;
+        DISK_RING& get_disk_ring();     // For callers that save images themselves (Image::Save)
+
+        int start(const string& folder_path);   // Prepares the disk ring (if images are saved)
+
+        // Feeds the sinks and queues the raw file. Returns 0 if the frame was queued everywhere it should go.
+        int process_frame(const FRAME_HEADER& header, const void* data, FRAME_PIPELINE_RESULT& result, unsigned int outputs = FRAME_OUTPUT_ALL);
+
+        void on_event(const string& reason);    // Passes a user/control event to every sink
+        int flush();    // Waits for the writer and flushes every sink, prints the writer counters
+
+        FRAME_PIPELINE_STATS get_stats() const;
+};
+
+// Disk ring stream key of a camera/ROI: Serial_<serial>_OffsetX_<offset_x>
+string get_frame_stream_key(const string& serial, int64_t offset_x);
+
+#endif // FRAME_PIPELINE_H
@@ -0,0 +1,586 @@
+// Description: Replays recorded frames through the frame pipeline in real time, at a fixed rate or as fast as possible
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aligned_buffer_pool.h"
+#include "frame_compressor.h"
+#include "frame_replay.h"
+
+using namespace std;
+
+/**
+ * Reads exactly size bytes at offset.
+ * @param fd: The file.
+ * @param buffer: Destination.
+ * @param size: Bytes to read.
+ * @param offset: File offset.
+ * @return 0 if successful, -1 otherwise (error or end of file).
+ */
+static int read_all(int fd, void* buffer, size_t size, uint64_t offset)
+{
+    char* destination = static_cast<char*>(buffer);
+    while (size > 0)
+    {
+        ssize_t result = pread(fd, destination, size, static_cast<off_t>(offset));
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return -1;
+        }
+        destination += result;
+        size -= static_cast<size_t>(result);
+        offset += static_cast<uint64_t>(result);
+    }
+    return 0;
+}
+
+/**
+ * Checks whether a file name ends with the extension.
+ * @param name: The file name.
+ * @param extension: e.g. ".rec".
+ * @return true if it does.
+ */
+static bool has_extension(const string& name, const string& extension)
+{
+    return name.size() > extension.size() && name.compare(name.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+/**
+ * Constructor for the RECORDING_SOURCE class.
+ */
+RECORDING_SOURCE::RECORDING_SOURCE()
+    : next_record(0), max_frame_bytes(0), open_file_index(-1), file_fd(-1)
+{
+}
+
+/**
+ * Destructor for the RECORDING_SOURCE class -> closes the open file.
+ */
+RECORDING_SOURCE::~RECORDING_SOURCE()
+{
+    if (file_fd >= 0)
+    {
+        close(file_fd);
+    }
+}
+
+/**
+ * Collects the recordings at path and indexes every record in them.
+ * @param path: A .rec or .raw file, or a folder containing them.
+ * @return 0 if at least one frame was found, -1 otherwise.
+ */
+int RECORDING_SOURCE::open_path(const string& path)
+{
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) != 0)
+    {
+        cerr << "[Replay] Unable to open " << path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    files.clear();
+    records.clear();
+    max_frame_bytes = 0;
+
+    if (S_ISDIR(path_stat.st_mode))
+    {
+        DIR* directory = opendir(path.c_str());
+        if (directory == nullptr)
+        {
+            cerr << "[Replay] Unable to list " << path << ": " << strerror(errno) << endl;
+            return -1;
+        }
+
+        string folder = path.back() == '/' ? path : path + "/";
+        while (struct dirent* entry = readdir(directory))
+        {
+            string name = entry->d_name;
+            if (name[0] != '.' && (has_extension(name, ".rec") || has_extension(name, ".raw")))
+            {
+                files.push_back(folder + name);
+            }
+        }
+        closedir(directory);
+        sort(files.begin(), files.end());
+    }
+    else
+    {
+        files.push_back(path);
+    }
+
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+        index_file(i);
+    }
+
+    if (records.empty())
+    {
+        cerr << "[Replay] No frames found in " << path << endl;
+        return -1;
+    }
+
+    cout << "[Replay] " << records.size() << " frames in " << files.size() << " file(s), largest " << max_frame_bytes << " bytes" << endl;
+    next_record = 0;
+    return 0;
+}
+
+/**
+ * Walks the records of one file (FRAME_HEADER + data, each padded to PAGE_ALIGNMENT) until the first invalid header.
+ * @param file_index: Index into files.
+ * @return 0 if the file could be read, -1 otherwise.
+ */
+int RECORDING_SOURCE::index_file(unsigned int file_index)
+{
+    int fd = open(files[file_index].c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        cerr << "[Replay] Unable to open " << files[file_index] << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    struct stat file_stat;
+    fstat(fd, &file_stat);
+    uint64_t file_size = static_cast<uint64_t>(file_stat.st_size);
+
+    uint64_t offset = 0;
+    FRAME_HEADER header;
+    while (offset + sizeof(FRAME_HEADER) <= file_size && read_all(fd, &header, sizeof(header), offset) == 0)
+    {
+        if (!is_frame_header_valid(header) || offset + sizeof(FRAME_HEADER) + header.data_size > file_size)
+        {
+            break;  // End of the recording (zeroed preallocation or a torn last record)
+        }
+
+        RECORD record = {file_index, offset, header.data_size, header.data_size};
+        if (is_frame_compressed(header))
+        {
+            COMPRESSED_FRAME_INFO info;
+            if (header.data_size < sizeof(info) || read_all(fd, &info, sizeof(info), offset + sizeof(FRAME_HEADER)) != 0 ||
+                info.magic != COMPRESSED_FRAME_MAGIC)
+            {
+                break;
+            }
+            record.raw_size = info.raw_size;
+        }
+
+        records.push_back(record);
+        max_frame_bytes = max<size_t>(max_frame_bytes, record.raw_size);
+        offset += align_up(sizeof(FRAME_HEADER) + header.data_size, PAGE_ALIGNMENT);
+    }
+
+    close(fd);
+    return 0;
+}
+
+/**
+ * Reads the next frame in recording order, decompressing it if needed.
+ * @param header: Receives the frame header.
+ * @param data: Receives the pixel data.
+ * @return 0 if a frame was read, -1 at the end or on a read error.
+ */
+int RECORDING_SOURCE::read_frame(FRAME_HEADER& header, vector<uint8_t>& data)
+{
+    if (next_record >= records.size())
+    {
+        return -1;
+    }
+
+    const RECORD& record = records[next_record++];
+    if (open_file_index != static_cast<int>(record.file))
+    {
+        if (file_fd >= 0)
+        {
+            close(file_fd);
+        }
+        file_fd = open(files[record.file].c_str(), O_RDONLY);
+        open_file_index = static_cast<int>(record.file);
+        if (file_fd < 0)
+        {
+            cerr << "[Replay] Unable to open " << files[record.file] << ": " << strerror(errno) << endl;
+            return -1;
+        }
+    }
+
+    FRAME_HEADER stored_header;
+    if (read_all(file_fd, &stored_header, sizeof(stored_header), record.offset) != 0)
+    {
+        return -1;
+    }
+
+    if (!is_frame_compressed(stored_header))
+    {
+        header = stored_header;
+        data.resize(record.data_size);
+        return read_all(file_fd, data.data(), data.size(), record.offset + sizeof(FRAME_HEADER));
+    }
+
+    block.resize(record.data_size);
+    if (read_all(file_fd, block.data(), block.size(), record.offset + sizeof(FRAME_HEADER)) != 0)
+    {
+        return -1;
+    }
+    return FRAME_COMPRESSOR::decompress(stored_header, block.data(), header, data);
+}
+
+/**
+ * Starts again from the first frame.
+ * @return 0
+ */
+int RECORDING_SOURCE::rewind()
+{
+    next_record = 0;
+    return 0;
+}
+
+/**
+ * Returns the largest (decompressed) frame in the recordings.
+ */
+size_t RECORDING_SOURCE::get_max_frame_bytes() const
+{
+    return max_frame_bytes;
+}
+
+/**
+ * Returns the source name for logging.
+ */
+const char* RECORDING_SOURCE::get_source_name() const
+{
+    return "recording";
+}
+
+/**
+ * Returns the number of frames found when the path was opened.
+ */
+size_t RECORDING_SOURCE::get_frame_count() const
+{
+    return records.size();
+}
+
+/**
+ * Constructor for the CAMERA_SOURCE class.
+ * @param camera_backend: The camera (not owned), already started.
+ * @param frame_timeout_ms: Timeout for each frame.
+ */
+CAMERA_SOURCE::CAMERA_SOURCE(CAMERA_BACKEND* camera_backend, unsigned int frame_timeout_ms)
+    : camera(camera_backend), timeout_ms(frame_timeout_ms)
+{
+}
+
+/**
+ * Waits for the next complete frame and copies it. Incomplete frames and timeouts are retried a few times.
+ * @param header: Receives the frame header.
+ * @param data: Receives the pixel data.
+ * @return 0 if a frame was read, -1 if the camera failed or kept timing out.
+ */
+int CAMERA_SOURCE::read_frame(FRAME_HEADER& header, vector<uint8_t>& data)
+{
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        CAMERA_FRAME frame;
+        int result = camera->next_frame(frame, timeout_ms);
+        if (result < 0)
+        {
+            return -1;
+        }
+        if (result > 0)
+        {
+            continue;
+        }
+
+        header = frame.header;
+        data.resize(frame.header.data_size);
+        memcpy(data.data(), frame.data, data.size());
+        camera->release_frame();
+        return 0;
+    }
+
+    cerr << "[Replay] No frame from " << camera->get_backend_name() << " camera " << camera->get_serial() << endl;
+    return -1;
+}
+
+/**
+ * A camera cannot be rewound, the next loop continues with the next frame.
+ * @return 0
+ */
+int CAMERA_SOURCE::rewind()
+{
+    return 0;
+}
+
+/**
+ * Returns the frame size for the camera's ROI and pixel format.
+ */
+size_t CAMERA_SOURCE::get_max_frame_bytes() const
+{
+    return camera->get_max_frame_bytes();
+}
+
+/**
+ * Returns the source name for logging.
+ */
+const char* CAMERA_SOURCE::get_source_name() const
+{
+    return camera->get_backend_name();
+}
+
+/**
+ * Constructor for the FRAME_REPLAY class.
+ */
+FRAME_REPLAY::FRAME_REPLAY()
+    : config(default_frame_replay_config())
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Checks and stores the replay configuration.
+ * @param replay_config: The configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_REPLAY::init(const FRAME_REPLAY_CONFIG& replay_config)
+{
+    if (replay_config.mode == REPLAY_FIXED_RATE && replay_config.frame_rate <= 0.0)
+    {
+        cerr << "[Replay] Fixed rate mode needs a frame rate above 0\n";
+        return -1;
+    }
+    if (replay_config.mode == REPLAY_REALTIME && replay_config.speed <= 0.0)
+    {
+        cerr << "[Replay] Speed must be above 0\n";
+        return -1;
+    }
+
+    config = replay_config;
+    return 0;
+}
+
+/**
+ * Replays the source through the pipeline. In the paced modes every frame waits for its due time: its camera
+ * timestamp relative to the first frame of the same camera (REPLAY_REALTIME) or n / frame_rate (REPLAY_FIXED_RATE).
+ * A frame that is already due is delivered at once and counted as late.
+ * @param source: Where the frames come from.
+ * @param pipeline: Where the frames go (started by the caller).
+ * @param running: Cleared by the caller to stop early.
+ * @return The result of the final pipeline flush, -1 if the source could not be read.
+ */
+int FRAME_REPLAY::run(FRAME_SOURCE& source, FRAME_PIPELINE& pipeline, atomic<bool>& running)
+{
+    memset(&stats, 0, sizeof(stats));
+
+    struct REPLAY_FRAME
+    {
+        FRAME_HEADER header;
+        vector<uint8_t> data;
+    };
+
+    vector<REPLAY_FRAME> preloaded;
+    if (config.preload)
+    {
+        source.rewind();
+        size_t total_bytes = 0;
+        REPLAY_FRAME frame;
+        while ((config.max_frames == 0 || preloaded.size() < config.max_frames) && source.read_frame(frame.header, frame.data) == 0)
+        {
+            total_bytes += frame.data.size();
+            preloaded.push_back(frame);
+        }
+        cout << "[Replay] Preloaded " << preloaded.size() << " frames (" << total_bytes / (1024 * 1024) << " MB)" << endl;
+        if (preloaded.empty())
+        {
+            return -1;
+        }
+    }
+
+    cout << "[Replay] " << get_replay_mode_name(config.mode) << " replay from " << source.get_source_name() << " started" << endl;
+
+    vector<double> process_us;
+    REPLAY_FRAME current;
+    FRAME_PIPELINE_RESULT frame_result;
+    bool done = false;
+
+    auto start_time = chrono::steady_clock::now();
+
+    for (unsigned int loop = 0; !done && running.load() && (config.loops == 0 || loop < config.loops); loop++)
+    {
+        source.rewind();
+
+        // REPLAY_REALTIME: due time of each camera's first frame and its timestamp (camera clocks are independent)
+        map<string, pair<chrono::steady_clock::time_point, uint64_t>> camera_clocks;
+        auto loop_start = chrono::steady_clock::now();
+        uint64_t loop_frames = 0;
+
+        while (running.load())
+        {
+            const REPLAY_FRAME* frame = &current;
+            if (config.preload)
+            {
+                if (loop_frames >= preloaded.size())
+                {
+                    break;
+                }
+                frame = &preloaded[loop_frames];
+            }
+            else if (source.read_frame(current.header, current.data) != 0)
+            {
+                break;
+            }
+
+            // Work out when the frame is due
+            bool paced = config.mode != REPLAY_FAST;
+            chrono::steady_clock::time_point due_time = chrono::steady_clock::now();
+            if (config.mode == REPLAY_FIXED_RATE)
+            {
+                due_time = loop_start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(loop_frames / config.frame_rate));
+            }
+            else if (config.mode == REPLAY_REALTIME)
+            {
+                string serial(frame->header.serial, strnlen(frame->header.serial, sizeof(frame->header.serial)));
+                auto clock = camera_clocks.find(serial);
+                if (clock == camera_clocks.end() || frame->header.timestamp_ns < clock->second.second)
+                {
+                    camera_clocks[serial] = make_pair(due_time, frame->header.timestamp_ns);
+                }
+                else
+                {
+                    double offset_seconds = (frame->header.timestamp_ns - clock->second.second) / 1e9 / config.speed;
+                    due_time = clock->second.first + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(offset_seconds));
+                }
+            }
+
+            if (paced)
+            {
+                auto now = chrono::steady_clock::now();
+                if (now < due_time)
+                {
+                    this_thread::sleep_until(due_time);
+                }
+                else
+                {
+                    double late_ms = chrono::duration<double, milli>(now - due_time).count();
+                    if (late_ms > 1.0)
+                    {
+                        stats.late_frames++;
+                        stats.max_late_ms = max(stats.max_late_ms, late_ms);
+                    }
+                }
+            }
+
+            auto process_start = chrono::steady_clock::now();
+            pipeline.process_frame(frame->header, frame->data.data(), frame_result);
+            process_us.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - process_start).count());
+
+            loop_frames++;
+            stats.frames++;
+            if (config.max_frames > 0 && stats.frames >= config.max_frames)
+            {
+                done = true;
+                break;
+            }
+        }
+
+        if (loop_frames == 0)
+        {
+            break;  // Nothing to replay
+        }
+        stats.loops++;
+    }
+
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    stats.frames_per_second = stats.seconds > 0.0 ? stats.frames / stats.seconds : 0.0;
+
+    if (!process_us.empty())
+    {
+        sort(process_us.begin(), process_us.end());
+        stats.process_p50_us = process_us[process_us.size() / 2];
+        stats.process_p99_us = process_us[min(process_us.size() - 1, process_us.size() * 99 / 100)];
+        stats.process_max_us = process_us.back();
+    }
+
+    return pipeline.flush();
+}
+
+/**
+ * Returns the results of the last run.
+ */
+FRAME_REPLAY_STATS FRAME_REPLAY::get_stats() const
+{
+    return stats;
+}
+
+/**
+ * Returns the default configuration: real time at recorded speed, one pass, no preload.
+ * @return The configuration.
+ */
+FRAME_REPLAY_CONFIG default_frame_replay_config()
+{
+    FRAME_REPLAY_CONFIG config;
+    config.mode = REPLAY_REALTIME;
+    config.speed = 1.0;
+    config.frame_rate = 30.0;
+    config.loops = 1;
+    config.max_frames = 0;
+    config.preload = false;
+    return config;
+}
+
+/**
+ * Parses a replay mode name.
+ * @param name: realtime, fast or fixed.
+ * @param mode: Receives the mode.
+ * @return true if the name is known.
+ */
+bool parse_replay_mode(const string& name, REPLAY_MODE& mode)
+{
+    if (name == "realtime")
+    {
+        mode = REPLAY_REALTIME;
+    }
+    else if (name == "fast")
+    {
+        mode = REPLAY_FAST;
+    }
+    else if (name == "fixed")
+    {
+        mode = REPLAY_FIXED_RATE;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Returns the name of a replay mode.
+ * @param mode: The mode.
+ * @return The name.
+ */
+const char* get_replay_mode_name(REPLAY_MODE mode)
+{
+    switch (mode)
+    {
+        case REPLAY_REALTIME:
+            return "realtime";
+        case REPLAY_FAST:
+            return "fast";
+        case REPLAY_FIXED_RATE:
+            return "fixed";
+    }
+    return "unknown";
+}
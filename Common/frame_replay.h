@@ -0,0 +1,144 @@
+// frame_replay.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_REPLAY_H
+#define FRAME_REPLAY_H
+
+#include "camera_backend.h"
+#include "frame_format.h"
+#include "frame_pipeline.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Produces frames for the replay (recordings, or anything else that can fill a FRAME_HEADER)
+class FRAME_SOURCE
+{
+    public:
+        virtual ~FRAME_SOURCE() {}
+
+        // Reads the next frame, data is resized to header.data_size. Returns -1 at the end (or on a read error).
+        virtual int read_frame(FRAME_HEADER& header, vector<uint8_t>& data) = 0;
+        virtual int rewind() = 0;                       // Start again from the first frame
+        virtual size_t get_max_frame_bytes() const = 0; // Largest frame the source will return
+        virtual const char* get_source_name() const = 0;
+};
+
+// Reads recorded frames: segment recordings and pre-trigger events (.rec), single frames (.raw), or a folder of
+// them (files in name order). Compressed records are decompressed. The record index is built once when opening.
+class RECORDING_SOURCE : public FRAME_SOURCE
+{
+    private:
+        struct RECORD
+        {
+            unsigned int file;
+            uint64_t offset;
+            uint64_t data_size;
+            uint64_t raw_size;          // After decompression
+        };
+
+        vector<string> files;
+        vector<RECORD> records;
+        size_t next_record;
+        size_t max_frame_bytes;
+        int open_file_index;
+        int file_fd;
+        vector<uint8_t> block;          // Compressed block being read
+
+        int index_file(unsigned int file_index);
+
+    public:
+        RECORDING_SOURCE();
+        ~RECORDING_SOURCE();
+
+        int open_path(const string& path);  // File or folder
+
+        int read_frame(FRAME_HEADER& header, vector<uint8_t>& data);
+        int rewind();
+        size_t get_max_frame_bytes() const;
+        const char* get_source_name() const;
+
+        size_t get_frame_count() const;
+};
+
+// Takes frames from a started CAMERA_BACKEND (e.g. SYNTHETIC_CAMERA), so the replay can drive the pipeline from a
+// camera. The camera paces itself, use REPLAY_FAST. read_frame copies the frame and releases it right away.
+class CAMERA_SOURCE : public FRAME_SOURCE
+{
+    private:
+        CAMERA_BACKEND* camera;
+        unsigned int timeout_ms;
+
+    public:
+        CAMERA_SOURCE(CAMERA_BACKEND* camera_backend, unsigned int frame_timeout_ms);
+
+        int read_frame(FRAME_HEADER& header, vector<uint8_t>& data);
+        int rewind();
+        size_t get_max_frame_bytes() const;
+        const char* get_source_name() const;
+};
+
+// How frames are paced
+enum REPLAY_MODE
+{
+    REPLAY_REALTIME = 0,    // Recorded camera timestamps (per camera), scaled by speed
+    REPLAY_FAST = 1,        // As fast as the pipeline takes them
+    REPLAY_FIXED_RATE = 2   // frame_rate frames per second
+};
+
+// Struct to hold the replay configuration
+struct FRAME_REPLAY_CONFIG
+{
+    REPLAY_MODE mode;
+    double speed;               // REPLAY_REALTIME: 2.0 = twice as fast as recorded
+    double frame_rate;          // REPLAY_FIXED_RATE
+    unsigned int loops;         // Passes over the source (0 = until stopped)
+    uint64_t max_frames;        // Stop after this many frames (0 = no limit)
+    bool preload;               // Read every frame into memory first, so disk reads are not measured
+};
+
+// Struct to hold the replay results
+struct FRAME_REPLAY_STATS
+{
+    uint64_t frames;
+    unsigned int loops;
+    double seconds;
+    double frames_per_second;
+    uint64_t late_frames;       // Paced modes: delivered more than 1 ms after their due time
+    double max_late_ms;
+    double process_p50_us;      // Time the pipeline took per frame (what a grab loop would be blocked)
+    double process_p99_us;
+    double process_max_us;
+};
+
+// Feeds frames from a source through a FRAME_PIPELINE like a camera would
+class FRAME_REPLAY
+{
+    private:
+        FRAME_REPLAY_CONFIG config;
+        FRAME_REPLAY_STATS stats;
+
+    public:
+        FRAME_REPLAY();
+
+        int init(const FRAME_REPLAY_CONFIG& replay_config);
+
+        // Replays until the source (and every loop) is done, max_frames is reached or running is cleared.
+        // The pipeline is flushed at the end.
+        int run(FRAME_SOURCE& source, FRAME_PIPELINE& pipeline, atomic<bool>& running);
+
+        FRAME_REPLAY_STATS get_stats() const;
+};
+
+// Default configuration: real time, one pass
+FRAME_REPLAY_CONFIG default_frame_replay_config();
+
+bool parse_replay_mode(const string& name, REPLAY_MODE& mode);  // realtime | fast | fixed
+const char* get_replay_mode_name(REPLAY_MODE mode);
+
+#endif // FRAME_REPLAY_H
@@ -0,0 +1,28 @@
+// frame_sink.h Header File -> Interface for everything that consumes captured frames
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_SINK_H
+#define FRAME_SINK_H
+
+#include "frame_format.h"
+
+#include <string>
+
+using namespace std;
+
+class FRAME_SINK
+{
+    public:
+        virtual ~FRAME_SINK() {}
+
+        // Called from the acquisition loop for every complete, converted frame.
+        // Must not keep the data pointer after returning (copy what is needed).
+        virtual int consume_frame(const FRAME_HEADER& header, const void* data) = 0;
+
+        virtual int flush() { return 0; }  // Called when acquisition stops
+        virtual void on_event(const string& reason) { (void)reason; }  // User/control event (keypress, control command)
+        virtual const char* get_sink_name() const = 0;  // Name for logging
+};
+
+#endif // FRAME_SINK_H
@@ -0,0 +1,892 @@
+// Description: Streams frames to local clients over TCP or a Unix domain socket with per-client drop policies
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+
+#include "frame_stream.h"
+
+using namespace std;
+
+// Struct to hold a parsed socket address
+struct STREAM_ADDRESS
+{
+    sockaddr_storage storage;
+    socklen_t length;
+    int family;
+    string unix_path;
+};
+
+/**
+ * Parses "port", "host:port" or "unix:/path". A bare port binds to the loopback interface.
+ * @param address: The address string.
+ * @param parsed: The parsed address.
+ * @return 0 if successful, -1 otherwise.
+ */
+static int parse_address(const string& address, STREAM_ADDRESS& parsed)
+{
+    memset(&parsed.storage, 0, sizeof(parsed.storage));
+
+    if (address.compare(0, 5, "unix:") == 0)
+    {
+        sockaddr_un* unix_address = reinterpret_cast<sockaddr_un*>(&parsed.storage);
+        parsed.unix_path = address.substr(5);
+        if (parsed.unix_path.empty() || parsed.unix_path.size() >= sizeof(unix_address->sun_path))
+        {
+            cerr << "[Stream] Invalid Unix socket path: " << parsed.unix_path << "\n";
+            return -1;
+        }
+
+        unix_address->sun_family = AF_UNIX;
+        strncpy(unix_address->sun_path, parsed.unix_path.c_str(), sizeof(unix_address->sun_path) - 1);
+        parsed.length = sizeof(sockaddr_un);
+        parsed.family = AF_UNIX;
+        return 0;
+    }
+
+    string host = "127.0.0.1";
+    string port = address;
+    size_t colon = address.rfind(':');
+    if (colon != string::npos)
+    {
+        host = address.substr(0, colon);
+        port = address.substr(colon + 1);
+    }
+
+    char* end = nullptr;
+    long port_number = strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || port_number <= 0 || port_number > 65535)
+    {
+        cerr << "[Stream] Invalid address: " << address << " (use port, host:port or unix:/path)\n";
+        return -1;
+    }
+
+    sockaddr_in* inet_address = reinterpret_cast<sockaddr_in*>(&parsed.storage);
+    inet_address->sin_family = AF_INET;
+    inet_address->sin_port = htons(static_cast<uint16_t>(port_number));
+    if (inet_pton(AF_INET, host.c_str(), &inet_address->sin_addr) != 1)
+    {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        addrinfo* resolved = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &resolved) != 0 || resolved == nullptr)
+        {
+            cerr << "[Stream] Unable to resolve " << host << "\n";
+            return -1;
+        }
+        inet_address->sin_addr = reinterpret_cast<sockaddr_in*>(resolved->ai_addr)->sin_addr;
+        freeaddrinfo(resolved);
+    }
+
+    parsed.length = sizeof(sockaddr_in);
+    parsed.family = AF_INET;
+    return 0;
+}
+
+/**
+ * Returns the default streaming server configuration.
+ * @param address: The listen address (empty = port 5600 on the loopback interface).
+ * @param max_frame_bytes: The largest pixel payload.
+ * @return The configuration.
+ */
+FRAME_STREAM_CONFIG default_frame_stream_config(const string& address, size_t max_frame_bytes)
+{
+    FRAME_STREAM_CONFIG config;
+    config.address = address.empty() ? "5600" : address;
+    config.max_frame_bytes = max_frame_bytes;
+    config.packet_count = 16;
+    config.max_clients = 8;
+    config.queue_depth = 4;
+    config.default_policy = STREAM_DROP_OLDEST;
+    return config;
+}
+
+/**
+ * Parses a drop policy name.
+ * @param name: oldest, newest, latest or disconnect.
+ * @param policy: The parsed policy.
+ * @return True if the name is known, false otherwise.
+ */
+bool parse_stream_drop_policy(const string& name, STREAM_DROP_POLICY& policy)
+{
+    if (name == "oldest")
+    {
+        policy = STREAM_DROP_OLDEST;
+    }
+    else if (name == "newest")
+    {
+        policy = STREAM_DROP_NEWEST;
+    }
+    else if (name == "latest")
+    {
+        policy = STREAM_LATEST_ONLY;
+    }
+    else if (name == "disconnect")
+    {
+        policy = STREAM_DISCONNECT;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns the name of a drop policy.
+ * @param policy: The policy.
+ * @return The policy name.
+ */
+const char* get_stream_drop_policy_name(STREAM_DROP_POLICY policy)
+{
+    switch (policy)
+    {
+        case STREAM_DROP_OLDEST: return "oldest";
+        case STREAM_DROP_NEWEST: return "newest";
+        case STREAM_LATEST_ONLY: return "latest";
+        case STREAM_DISCONNECT: return "disconnect";
+    }
+    return "unknown";
+}
+
+/**
+ * Constructor for the FRAME_STREAM_SERVER class.
+ */
+FRAME_STREAM_SERVER::FRAME_STREAM_SERVER()
+    : listen_fd(-1), wake_fd(-1), running(false), next_sequence(0), frames_offered(0), frames_sent(0), frames_dropped(0),
+      bytes_sent(0), clients_accepted(0), clients_dropped(0)
+{
+}
+
+/**
+ * Destructor for the FRAME_STREAM_SERVER class.
+ */
+FRAME_STREAM_SERVER::~FRAME_STREAM_SERVER()
+{
+    stop();
+}
+
+/**
+ * Binds the listening socket, allocates the shared frame buffers and starts the I/O thread.
+ * @param stream_config: The server configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_STREAM_SERVER::init(const FRAME_STREAM_CONFIG& stream_config)
+{
+    config = stream_config;
+    if (config.packet_count == 0 || config.max_clients == 0 || config.queue_depth == 0)
+    {
+        cerr << "[Stream] packet_count, max_clients and queue_depth must be at least 1\n";
+        return -1;
+    }
+
+    if (packets.init(config.packet_count, sizeof(FRAME_HEADER) + config.max_frame_bytes) != 0)
+    {
+        return -1;
+    }
+    packet_references.assign(config.packet_count, 0);
+    packet_sequence.assign(config.packet_count, 0);
+
+    if (open_listener() != 0)
+    {
+        return -1;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0)
+    {
+        cerr << "[Stream] eventfd failed: " << strerror(errno) << "\n";
+        return -1;
+    }
+
+    running = true;
+    io_thread = thread(&FRAME_STREAM_SERVER::io_loop, this);
+
+    cout << "[Stream] Serving frames on " << config.address << " (" << config.packet_count << " shared buffers, default policy "
+         << get_stream_drop_policy_name(config.default_policy) << ", queue " << config.queue_depth << ")\n";
+    return 0;
+}
+
+/**
+ * Creates the listening socket.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_STREAM_SERVER::open_listener()
+{
+    STREAM_ADDRESS address;
+    if (parse_address(config.address, address) != 0)
+    {
+        return -1;
+    }
+
+    listen_fd = socket(address.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        cerr << "[Stream] socket failed: " << strerror(errno) << "\n";
+        return -1;
+    }
+
+    if (address.family == AF_UNIX)
+    {
+        unlink(address.unix_path.c_str());  // Stale socket from a previous run
+        unix_path = address.unix_path;
+    }
+    else
+    {
+        int enable = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address.storage), address.length) != 0 ||
+        listen(listen_fd, static_cast<int>(config.max_clients)) != 0)
+    {
+        cerr << "[Stream] Unable to listen on " << config.address << ": " << strerror(errno) << "\n";
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Stops the I/O thread and closes every connection.
+ */
+void FRAME_STREAM_SERVER::stop()
+{
+    if (io_thread.joinable())
+    {
+        running = false;
+        uint64_t one = 1;
+        if (write(wake_fd, &one, sizeof(one)) < 0)
+        {
+            // The I/O thread also wakes up on its poll timeout
+        }
+        io_thread.join();
+    }
+
+    {
+        lock_guard<mutex> lock(server_mutex);
+        while (!clients.empty())
+        {
+            close_client_locked(clients.size() - 1);
+        }
+    }
+
+    if (listen_fd >= 0)
+    {
+        close(listen_fd);
+        listen_fd = -1;
+        if (!unix_path.empty())
+        {
+            unlink(unix_path.c_str());
+        }
+    }
+
+    if (wake_fd >= 0)
+    {
+        close(wake_fd);
+        wake_fd = -1;
+    }
+}
+
+/**
+ * Drops one reference to a packet and returns it to the pool when no client needs it anymore.
+ * @param packet: The packet index.
+ */
+void FRAME_STREAM_SERVER::release_packet_locked(unsigned int packet)
+{
+    if (--packet_references[packet] == 0)
+    {
+        packets.release(packet);
+    }
+}
+
+/**
+ * Queues a packet for a client, applying the client's drop policy if its queue is full.
+ * @param client: The client.
+ * @param packet: The packet index.
+ */
+void FRAME_STREAM_SERVER::queue_packet_locked(STREAM_CLIENT& client, unsigned int packet)
+{
+    if (client.disconnect)
+    {
+        return;
+    }
+
+    unsigned int depth = client.policy == STREAM_LATEST_ONLY ? 1 : client.queue_depth;
+
+    while (client.queue.size() >= depth)
+    {
+        if (client.policy == STREAM_DROP_NEWEST)
+        {
+            client.pending_drops++;
+            client.frames_dropped++;
+            frames_dropped++;
+            return;
+        }
+
+        if (client.policy == STREAM_DISCONNECT)
+        {
+            client.disconnect = true;
+            return;
+        }
+
+        // The dropped frame's own gap carries over to the next frame that is sent
+        client.pending_drops += client.queue.front().dropped_before + 1;
+        release_packet_locked(client.queue.front().packet);
+        client.queue.pop_front();
+        client.frames_dropped++;
+        frames_dropped++;
+    }
+
+    QUEUED_FRAME queued = {packet, client.pending_drops};
+    client.queue.push_back(queued);
+    client.pending_drops = 0;
+    packet_references[packet]++;
+}
+
+/**
+ * Copies the frame into a shared buffer and queues it for every connected client. Never blocks on a client.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_STREAM_SERVER::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    if (header.data_size > config.max_frame_bytes)
+    {
+        cerr << "[Stream] Frame " << header.frame_id << " (" << header.data_size << " bytes) is larger than the stream buffers\n";
+        return -1;
+    }
+
+    unsigned int packet = 0;
+    uint64_t sequence = 0;
+
+    {
+        lock_guard<mutex> lock(server_mutex);
+
+        bool has_ready_client = false;
+        for (const auto& client : clients)
+        {
+            has_ready_client = has_ready_client || (client->ready && !client->disconnect);
+        }
+
+        if (!has_ready_client)
+        {
+            return 0;   // Nobody is watching, skip the copy
+        }
+
+        frames_offered++;
+        sequence = next_sequence++;
+
+        if (!packets.try_acquire(packet))
+        {
+            // Every buffer is still queued somewhere: the frame is lost for all clients
+            for (auto& client : clients)
+            {
+                if (client->ready && !client->disconnect)
+                {
+                    client->pending_drops++;
+                    client->frames_dropped++;
+                    frames_dropped++;
+                }
+            }
+            return 0;
+        }
+
+        packet_references[packet] = 1;  // Held by this call until the frame is queued
+        packet_sequence[packet] = sequence;
+    }
+
+    char* buffer = packets.get_buffer(packet);
+    memcpy(buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(buffer + sizeof(FRAME_HEADER), data, header.data_size);
+
+    {
+        lock_guard<mutex> lock(server_mutex);
+        for (auto& client : clients)
+        {
+            if (client->ready)
+            {
+                queue_packet_locked(*client, packet);
+            }
+        }
+        release_packet_locked(packet);
+    }
+
+    uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0)
+    {
+        // Counter overflow is impossible here, and the I/O thread also wakes up on its poll timeout
+    }
+
+    return 0;
+}
+
+/**
+ * Accepts pending connections (up to max_clients).
+ */
+void FRAME_STREAM_SERVER::accept_clients()
+{
+    while (true)
+    {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        if (clients.size() >= config.max_clients)
+        {
+            cerr << "[Stream] Client limit (" << config.max_clients << ") reached, refusing connection\n";
+            close(fd);
+            continue;
+        }
+
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));  // Fails harmlessly on Unix sockets
+
+        unique_ptr<STREAM_CLIENT> client(new STREAM_CLIENT());
+        client->fd = fd;
+        client->ready = false;
+        client->policy = config.default_policy;
+        client->queue_depth = config.queue_depth;
+        client->pending_drops = 0;
+        client->disconnect = false;
+        client->hello_received = 0;
+        client->current_packet = -1;
+        client->sent_bytes = 0;
+        client->frames_sent = 0;
+        client->frames_dropped = 0;
+        client->name = "client " + to_string(clients_accepted.load());
+
+        clients_accepted++;
+
+        lock_guard<mutex> lock(server_mutex);
+        clients.push_back(move(client));
+    }
+}
+
+/**
+ * Reads the HELLO of a new client and applies its drop policy.
+ * @param client: The client.
+ * @return False if the client closed the connection or sent an invalid HELLO.
+ */
+bool FRAME_STREAM_SERVER::read_hello(STREAM_CLIENT& client)
+{
+    char* destination = reinterpret_cast<char*>(&client.hello) + client.hello_received;
+    ssize_t received = recv(client.fd, destination, sizeof(STREAM_HELLO) - client.hello_received, MSG_DONTWAIT);
+
+    if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        return false;
+    }
+
+    if (received < 0)
+    {
+        return true;
+    }
+
+    client.hello_received += static_cast<size_t>(received);
+    if (client.hello_received < sizeof(STREAM_HELLO))
+    {
+        return true;
+    }
+
+    if (client.hello.magic != STREAM_MAGIC || client.hello.version != STREAM_VERSION || client.hello.drop_policy > STREAM_DISCONNECT)
+    {
+        cerr << "[Stream] " << client.name << " sent an invalid HELLO\n";
+        return false;
+    }
+
+    lock_guard<mutex> lock(server_mutex);
+    client.policy = static_cast<STREAM_DROP_POLICY>(client.hello.drop_policy);
+    if (client.hello.queue_depth > 0)
+    {
+        client.queue_depth = min(client.hello.queue_depth, config.packet_count);
+    }
+    client.ready = true;
+
+    cout << "[Stream] " << client.name << " connected (policy " << get_stream_drop_policy_name(client.policy)
+         << ", queue " << client.queue_depth << ")\n";
+    return true;
+}
+
+/**
+ * Sends as much of the client's queue as the socket accepts without blocking.
+ * @param client: The client.
+ * @return False on a socket error.
+ */
+bool FRAME_STREAM_SERVER::send_pending(STREAM_CLIENT& client)
+{
+    while (true)
+    {
+        if (client.current_packet < 0)
+        {
+            lock_guard<mutex> lock(server_mutex);
+            if (client.queue.empty())
+            {
+                return true;
+            }
+
+            QUEUED_FRAME queued = client.queue.front();
+            unsigned int packet = queued.packet;
+            client.queue.pop_front();
+            client.current_packet = static_cast<int>(packet);
+            client.sent_bytes = 0;
+
+            const FRAME_HEADER* frame = reinterpret_cast<const FRAME_HEADER*>(packets.get_buffer(packet));
+            client.message.magic = STREAM_MAGIC;
+            client.message.version = STREAM_VERSION;
+            client.message.reserved = 0;
+            client.message.payload_size = static_cast<uint32_t>(sizeof(FRAME_HEADER) + frame->data_size);
+            client.message.dropped = queued.dropped_before;
+            client.message.sequence = packet_sequence[packet];
+        }
+
+        // Message header and frame go out in one sendmsg, straight from the shared buffer
+        size_t message_size = sizeof(STREAM_MESSAGE_HEADER);
+        size_t total_size = message_size + client.message.payload_size;
+        char* packet_data = packets.get_buffer(static_cast<unsigned int>(client.current_packet));
+
+        iovec parts[2];
+        int part_count = 0;
+        if (client.sent_bytes < message_size)
+        {
+            parts[part_count].iov_base = reinterpret_cast<char*>(&client.message) + client.sent_bytes;
+            parts[part_count].iov_len = message_size - client.sent_bytes;
+            part_count++;
+            parts[part_count].iov_base = packet_data;
+            parts[part_count].iov_len = client.message.payload_size;
+            part_count++;
+        }
+        else
+        {
+            size_t payload_offset = client.sent_bytes - message_size;
+            parts[part_count].iov_base = packet_data + payload_offset;
+            parts[part_count].iov_len = client.message.payload_size - payload_offset;
+            part_count++;
+        }
+
+        msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = parts;
+        message.msg_iovlen = part_count;
+
+        ssize_t sent = sendmsg(client.fd, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        client.sent_bytes += static_cast<size_t>(sent);
+        bytes_sent += static_cast<uint64_t>(sent);
+
+        if (client.sent_bytes < total_size)
+        {
+            return true;    // Socket buffer full, continue on POLLOUT
+        }
+
+        client.frames_sent++;
+        frames_sent++;
+
+        lock_guard<mutex> lock(server_mutex);
+        release_packet_locked(static_cast<unsigned int>(client.current_packet));
+        client.current_packet = -1;
+    }
+}
+
+/**
+ * Closes a client connection and releases its queued frames.
+ * @param index: The client index.
+ */
+void FRAME_STREAM_SERVER::close_client_locked(size_t index)
+{
+    STREAM_CLIENT& client = *clients[index];
+
+    for (const QUEUED_FRAME& queued : client.queue)
+    {
+        release_packet_locked(queued.packet);
+    }
+    if (client.current_packet >= 0)
+    {
+        release_packet_locked(static_cast<unsigned int>(client.current_packet));
+    }
+
+    if (client.ready)
+    {
+        cout << "[Stream] " << client.name << " disconnected (" << client.frames_sent << " frames sent, "
+             << client.frames_dropped << " dropped)\n";
+    }
+
+    close(client.fd);
+    clients.erase(clients.begin() + static_cast<long>(index));
+}
+
+/**
+ * I/O thread: accepts clients, reads their HELLO and sends queued frames whenever the sockets accept data.
+ */
+void FRAME_STREAM_SERVER::io_loop()
+{
+    vector<pollfd> poll_fds;
+
+    while (running)
+    {
+        poll_fds.clear();
+        poll_fds.push_back({wake_fd, POLLIN, 0});
+        poll_fds.push_back({listen_fd, POLLIN, 0});
+
+        {
+            lock_guard<mutex> lock(server_mutex);
+            for (const auto& client : clients)
+            {
+                short events = POLLIN;
+                if (client->current_packet >= 0 || !client->queue.empty())
+                {
+                    events |= POLLOUT;
+                }
+                poll_fds.push_back({client->fd, events, 0});
+            }
+        }
+
+        if (poll(poll_fds.data(), poll_fds.size(), 100) < 0 && errno != EINTR)
+        {
+            cerr << "[Stream] poll failed: " << strerror(errno) << "\n";
+            break;
+        }
+
+        if (poll_fds[0].revents & POLLIN)
+        {
+            uint64_t count = 0;
+            if (read(wake_fd, &count, sizeof(count)) < 0)
+            {
+                // Already drained
+            }
+        }
+
+        // Only this thread adds or removes clients, so the indices below still match poll_fds
+        size_t polled_clients = poll_fds.size() - 2;
+        for (size_t i = polled_clients; i-- > 0; )
+        {
+            STREAM_CLIENT& client = *clients[i];
+            short revents = poll_fds[i + 2].revents;
+            bool fell_behind = false;
+            {
+                lock_guard<mutex> lock(server_mutex);
+                fell_behind = client.disconnect;
+            }
+            bool keep = !fell_behind && (revents & (POLLERR | POLLNVAL)) == 0;
+
+            if (keep && (revents & (POLLIN | POLLHUP)))
+            {
+                if (!client.ready)
+                {
+                    keep = read_hello(client);
+                }
+                else
+                {
+                    char discard[64];
+                    ssize_t received = recv(client.fd, discard, sizeof(discard), MSG_DONTWAIT);
+                    keep = received > 0 || (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+                }
+            }
+
+            // Try to send even without POLLOUT: frames queued after the poll set was built go out right away
+            if (keep && client.ready)
+            {
+                keep = send_pending(client);
+            }
+
+            if (!keep)
+            {
+                if (fell_behind)
+                {
+                    cout << "[Stream] " << client.name << " fell behind, disconnecting (policy disconnect)\n";
+                }
+                clients_dropped++;
+                lock_guard<mutex> lock(server_mutex);
+                close_client_locked(i);
+            }
+        }
+
+        if (poll_fds[1].revents & POLLIN)
+        {
+            accept_clients();
+        }
+    }
+}
+
+/**
+ * Returns the number of connected clients.
+ * @return The number of clients.
+ */
+unsigned int FRAME_STREAM_SERVER::get_client_count()
+{
+    lock_guard<mutex> lock(server_mutex);
+    return static_cast<unsigned int>(clients.size());
+}
+
+/**
+ * Returns the name of the sink for logging.
+ * @return The name of the sink.
+ */
+const char* FRAME_STREAM_SERVER::get_sink_name() const
+{
+    return "Stream";
+}
+
+/**
+ * Returns the server counters.
+ * @return The counters.
+ */
+FRAME_STREAM_STATS FRAME_STREAM_SERVER::get_stats() const
+{
+    FRAME_STREAM_STATS stats;
+    stats.frames_offered = frames_offered;
+    stats.frames_sent = frames_sent;
+    stats.frames_dropped = frames_dropped;
+    stats.bytes_sent = bytes_sent;
+    stats.clients_accepted = clients_accepted;
+    stats.clients_dropped = clients_dropped;
+    return stats;
+}
+
+/**
+ * Constructor for the FRAME_STREAM_CLIENT class.
+ */
+FRAME_STREAM_CLIENT::FRAME_STREAM_CLIENT()
+    : socket_fd(-1)
+{
+}
+
+/**
+ * Destructor for the FRAME_STREAM_CLIENT class.
+ */
+FRAME_STREAM_CLIENT::~FRAME_STREAM_CLIENT()
+{
+    disconnect();
+}
+
+/**
+ * Connects to a streaming server and sends the HELLO.
+ * @param address: "port", "host:port" or "unix:/path".
+ * @param policy: What the server does when this client falls behind.
+ * @param queue_depth: Frames the server queues for this client (0 = server default).
+ * @return 0 if successful, -1 otherwise.
+ */
+int FRAME_STREAM_CLIENT::connect_to(const string& address, STREAM_DROP_POLICY policy, unsigned int queue_depth)
+{
+    disconnect();
+
+    STREAM_ADDRESS parsed;
+    if (parse_address(address, parsed) != 0)
+    {
+        return -1;
+    }
+
+    socket_fd = socket(parsed.family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0 || connect(socket_fd, reinterpret_cast<sockaddr*>(&parsed.storage), parsed.length) != 0)
+    {
+        disconnect();
+        return -1;
+    }
+
+    STREAM_HELLO hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.magic = STREAM_MAGIC;
+    hello.version = STREAM_VERSION;
+    hello.drop_policy = static_cast<uint16_t>(policy);
+    hello.queue_depth = queue_depth;
+
+    if (send(socket_fd, &hello, sizeof(hello), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(hello)))
+    {
+        disconnect();
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Closes the connection.
+ */
+void FRAME_STREAM_CLIENT::disconnect()
+{
+    if (socket_fd >= 0)
+    {
+        close(socket_fd);
+        socket_fd = -1;
+    }
+}
+
+/**
+ * Reads exactly size bytes.
+ * @param fd: The socket.
+ * @param buffer: The destination.
+ * @param size: The number of bytes.
+ * @return True if successful, false if the connection was closed.
+ */
+static bool receive_all(int fd, void* buffer, size_t size)
+{
+    char* destination = static_cast<char*>(buffer);
+    while (size > 0)
+    {
+        ssize_t received = recv(fd, destination, size, MSG_WAITALL);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            return false;
+        }
+        destination += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/**
+ * Waits for the next frame.
+ * @param message: The message header (sequence, frames dropped for this client).
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if successful, -1 if the connection was closed or the stream is corrupt.
+ */
+int FRAME_STREAM_CLIENT::receive(STREAM_MESSAGE_HEADER& message, FRAME_HEADER& header, vector<uint8_t>& data)
+{
+    if (socket_fd < 0 || !receive_all(socket_fd, &message, sizeof(message)))
+    {
+        return -1;
+    }
+
+    if (message.magic != STREAM_MAGIC || message.payload_size < sizeof(FRAME_HEADER) || !receive_all(socket_fd, &header, sizeof(header)))
+    {
+        return -1;
+    }
+
+    if (header.data_size != message.payload_size - sizeof(FRAME_HEADER))
+    {
+        return -1;
+    }
+
+    data.resize(header.data_size);
+    return receive_all(socket_fd, data.data(), data.size()) ? 0 : -1;
+}
@@ -0,0 +1,183 @@
+// frame_stream.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const uint32_t STREAM_MAGIC = 0x52545346;  // "FSTR"
+const uint16_t STREAM_VERSION = 1;
+
+// What the server does with a new frame when a client's queue is full
+enum STREAM_DROP_POLICY
+{
+    STREAM_DROP_OLDEST = 0,     // Discard the oldest queued frame (client sees the newest frames, with gaps)
+    STREAM_DROP_NEWEST = 1,     // Discard the new frame (client sees runs of consecutive frames)
+    STREAM_LATEST_ONLY = 2,     // Keep only the newest frame (viewers)
+    STREAM_DISCONNECT = 3       // Close the connection (clients that must not miss frames)
+};
+
+// Sent once by the client after connecting
+struct STREAM_HELLO
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t drop_policy;       // STREAM_DROP_POLICY
+    uint32_t queue_depth;       // Frames queued for this client before the policy applies (0 = server default)
+    uint32_t reserved;
+};
+
+static_assert(sizeof(STREAM_HELLO) == 16, "STREAM_HELLO layout changed");
+
+// Every frame on the wire: STREAM_MESSAGE_HEADER | FRAME_HEADER | pixel data (payload_size = 80 + data_size)
+struct STREAM_MESSAGE_HEADER
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t payload_size;
+    uint32_t dropped;           // Frames dropped for this client since the previous message
+    uint64_t sequence;          // Frames offered to the server so far (gaps show where frames were dropped)
+};
+
+static_assert(sizeof(STREAM_MESSAGE_HEADER) == 24, "STREAM_MESSAGE_HEADER layout changed");
+
+// Struct to hold the streaming server configuration
+struct FRAME_STREAM_CONFIG
+{
+    string address;             // "port", "host:port" or "unix:/path/to/socket"
+    size_t max_frame_bytes;     // Largest pixel payload
+    unsigned int packet_count;  // Frame buffers shared by all clients (memory = packet_count x frame size)
+    unsigned int max_clients;
+    unsigned int queue_depth;   // Default per-client queue depth
+    STREAM_DROP_POLICY default_policy;
+};
+
+// Struct to hold the streaming server counters
+struct FRAME_STREAM_STATS
+{
+    uint64_t frames_offered;    // consume_frame calls while a client was connected
+    uint64_t frames_sent;       // Summed over all clients
+    uint64_t frames_dropped;    // Summed over all clients
+    uint64_t bytes_sent;
+    uint64_t clients_accepted;
+    uint64_t clients_dropped;   // Disconnected by STREAM_DISCONNECT or a socket error
+};
+
+// Serves frames to local clients over TCP or a Unix domain socket. consume_frame copies the frame once into a
+// shared buffer and queues a reference for every client; one I/O thread sends with non-blocking sendmsg
+// (message header + frame as scatter-gather, straight from the shared buffer). The grab thread never waits for a
+// client: when a client's queue is full its drop policy decides what happens.
+class FRAME_STREAM_SERVER : public FRAME_SINK
+{
+    private:
+        struct QUEUED_FRAME
+        {
+            unsigned int packet;
+            uint32_t dropped_before;        // Frames dropped between the previous queued frame and this one
+        };
+
+        struct STREAM_CLIENT
+        {
+            int fd;
+            bool ready;                     // HELLO received
+            STREAM_DROP_POLICY policy;
+            unsigned int queue_depth;
+            deque<QUEUED_FRAME> queue;      // Protected by server_mutex
+            uint32_t pending_drops;         // Drops since the last queued frame
+            bool disconnect;                // Set by STREAM_DISCONNECT, closed by the I/O thread
+            uint64_t frames_dropped;
+
+            // Only touched by the I/O thread
+            STREAM_HELLO hello;
+            size_t hello_received;
+            int current_packet;             // Packet being sent (-1 = none)
+            STREAM_MESSAGE_HEADER message;
+            size_t sent_bytes;              // Of message + packet
+            uint64_t frames_sent;
+            string name;
+        };
+
+        FRAME_STREAM_CONFIG config;
+        ALIGNED_BUFFER_POOL packets;
+        vector<unsigned int> packet_references;     // Protected by server_mutex
+        vector<uint64_t> packet_sequence;
+
+        int listen_fd;
+        int wake_fd;                    // eventfd: new frames queued or stopping
+        string unix_path;
+        vector<unique_ptr<STREAM_CLIENT>> clients;   // Modified by the I/O thread under server_mutex
+        mutex server_mutex;
+        thread io_thread;
+        atomic<bool> running;
+
+        uint64_t next_sequence;
+        atomic<uint64_t> frames_offered;
+        atomic<uint64_t> frames_sent;
+        atomic<uint64_t> frames_dropped;
+        atomic<uint64_t> bytes_sent;
+        atomic<uint64_t> clients_accepted;
+        atomic<uint64_t> clients_dropped;
+
+        int open_listener();
+        void io_loop();
+        void accept_clients();
+        bool read_hello(STREAM_CLIENT& client);     // Returns false if the client closed or sent garbage
+        bool send_pending(STREAM_CLIENT& client);   // Returns false on a socket error
+        void release_packet_locked(unsigned int packet);   // server_mutex must be held
+        void queue_packet_locked(STREAM_CLIENT& client, unsigned int packet);
+        void close_client_locked(size_t index);
+
+    public:
+        FRAME_STREAM_SERVER();
+        ~FRAME_STREAM_SERVER();
+
+        int init(const FRAME_STREAM_CONFIG& stream_config);     // Bind, allocate the buffers and start the I/O thread
+        void stop();
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        const char* get_sink_name() const;
+
+        unsigned int get_client_count();
+        FRAME_STREAM_STATS get_stats() const;
+};
+
+// Blocking client for the streaming server (used by the bundled client and the benchmark)
+class FRAME_STREAM_CLIENT
+{
+    private:
+        int socket_fd;
+
+    public:
+        FRAME_STREAM_CLIENT();
+        ~FRAME_STREAM_CLIENT();
+
+        int connect_to(const string& address, STREAM_DROP_POLICY policy, unsigned int queue_depth);
+        void disconnect();
+
+        // Waits for the next frame. data is resized to the frame size. Returns -1 if the connection was closed.
+        int receive(STREAM_MESSAGE_HEADER& message, FRAME_HEADER& header, vector<uint8_t>& data);
+};
+
+// Default configuration: 16 shared buffers, 8 clients, 4 frames per client, drop oldest, port 5600 if address is empty
+FRAME_STREAM_CONFIG default_frame_stream_config(const string& address, size_t max_frame_bytes);
+
+bool parse_stream_drop_policy(const string& name, STREAM_DROP_POLICY& policy);  // oldest | newest | latest | disconnect
+const char* get_stream_drop_policy_name(STREAM_DROP_POLICY policy);
+
+#endif // FRAME_STREAM_H
@@ -0,0 +1,782 @@
+// Description: Asynchronous frame writers -> io_uring with registered buffers, and a pwrite thread pool fallback
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#include "frame_writer.h"
+#include "trace_recorder.h"
+
+using namespace std;
+
+const size_t FRAME_WRITER_ALIGNMENT = 4096;
+
+// Thin wrappers around the io_uring system calls (no liburing dependency)
+static int io_uring_setup(unsigned int entries, struct io_uring_params* params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(int ring_fd, unsigned int to_submit, unsigned int min_complete, unsigned int flags)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0));
+}
+
+static int io_uring_register(int ring_fd, unsigned int opcode, const void* arg, unsigned int nr_args)
+{
+    return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+/**
+ * Constructor for the FRAME_WRITER base class.
+ */
+FRAME_WRITER::FRAME_WRITER()
+    : frames_written(0), bytes_written(0), errors(0), stalls(0), frames_in_flight(0), slot_size(0)
+{
+}
+
+/**
+ * Destructor for the FRAME_WRITER base class.
+ */
+FRAME_WRITER::~FRAME_WRITER()
+{
+    release_slots();
+}
+
+/**
+ * Sets the handler called after every completed file.
+ * @param handler: Receives the path and whether the write succeeded. Runs on the writer thread.
+ */
+void FRAME_WRITER::set_completion_handler(function<void(const string& path, bool success)> handler)
+{
+    completion_handler = handler;
+}
+
+/**
+ * Calls the completion handler, if one is set.
+ * @param path: The completed file.
+ * @param success: false if the write failed.
+ */
+void FRAME_WRITER::notify_completion(const string& path, bool success)
+{
+    if (completion_handler)
+    {
+        completion_handler(path, success);
+    }
+}
+
+/**
+ * Allocates the page aligned staging buffers.
+ * @param slot_count: Number of staging buffers.
+ * @param size: Size of each staging buffer in bytes.
+ * @return 0 if successful, -1 if an allocation failed.
+ */
+int FRAME_WRITER::allocate_slots(unsigned int slot_count, size_t size)
+{
+    // Round up so every buffer stays page aligned
+    slot_size = (size + FRAME_WRITER_ALIGNMENT - 1) & ~(FRAME_WRITER_ALIGNMENT - 1);
+
+    slots.resize(slot_count);
+    for (unsigned int i = 0; i < slot_count; i++)
+    {
+        void* buffer = NULL;
+        if (posix_memalign(&buffer, FRAME_WRITER_ALIGNMENT, slot_size) != 0)
+        {
+            cerr << "[Frame writer] Unable to allocate staging buffer " << i << " (" << slot_size << " bytes)\n";
+            release_slots();
+            return -1;
+        }
+
+        slots[i].buffer = static_cast<char*>(buffer);
+        slots[i].length = 0;
+        slots[i].written = 0;
+        slots[i].fd = -1;
+        slots[i].path.reserve(256);
+        free_slots.push_back(i);
+    }
+
+    return 0;
+}
+
+/**
+ * Frees the staging buffers.
+ */
+void FRAME_WRITER::release_slots()
+{
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        free(slots[i].buffer);
+    }
+    slots.clear();
+    free_slots.clear();
+}
+
+/**
+ * Returns a snapshot of the writer counters.
+ * @return The current statistics.
+ */
+FRAME_WRITER_STATS FRAME_WRITER::get_stats() const
+{
+    FRAME_WRITER_STATS stats;
+    stats.frames_written = frames_written.load();
+    stats.bytes_written = bytes_written.load();
+    stats.errors = errors.load();
+    stats.stalls = stalls.load();
+    stats.frames_in_flight = frames_in_flight.load();
+    return stats;
+}
+
+/**
+ * Constructor for the URING_FRAME_WRITER class.
+ */
+URING_FRAME_WRITER::URING_FRAME_WRITER()
+    : ring_fd(-1), batch_size(1), pending_submissions(0), in_flight(0), use_fixed_buffers(false),
+      sq_ring_ptr(MAP_FAILED), sq_ring_size(0), sq_head(NULL), sq_tail(NULL), sq_ring_mask(NULL), sq_array(NULL),
+      sqes_ptr(MAP_FAILED), sqes_size(0),
+      cq_ring_ptr(MAP_FAILED), cq_ring_size(0), cq_head(NULL), cq_tail(NULL), cq_ring_mask(NULL), cqes_ptr(NULL)
+{
+}
+
+/**
+ * Destructor for the URING_FRAME_WRITER class -> waits for outstanding writes before tearing down the ring.
+ */
+URING_FRAME_WRITER::~URING_FRAME_WRITER()
+{
+    if (ring_fd >= 0)
+    {
+        flush();
+    }
+    release_ring();
+}
+
+/**
+ * Sets up the io_uring instance, maps the rings and registers the staging buffers.
+ * @param config: The writer configuration.
+ * @return 0 if successful, -1 if io_uring is not available.
+ */
+int URING_FRAME_WRITER::init(const FRAME_WRITER_CONFIG& config)
+{
+    if (config.slot_count == 0 || config.slot_size == 0)
+    {
+        cerr << "[Frame writer] slot_count and slot_size must be non-zero\n";
+        return -1;
+    }
+
+    batch_size = config.batch_size > 0 ? config.batch_size : 1;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring_fd = io_uring_setup(config.slot_count, &params);
+    if (ring_fd < 0)
+    {
+        cerr << "[Frame writer] io_uring_setup failed: " << strerror(errno) << endl;
+        return -1;
+    }
+
+    // Map the submission and completion rings (a single mapping on kernels with IORING_FEAT_SINGLE_MMAP)
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        sq_ring_size = max(sq_ring_size, cq_ring_size);
+        cq_ring_size = sq_ring_size;
+    }
+
+    sq_ring_ptr = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (sq_ring_ptr == MAP_FAILED)
+    {
+        cerr << "[Frame writer] Unable to map submission ring: " << strerror(errno) << endl;
+        release_ring();
+        return -1;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        cq_ring_ptr = sq_ring_ptr;
+    }
+    else
+    {
+        cq_ring_ptr = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring_ptr == MAP_FAILED)
+        {
+            cerr << "[Frame writer] Unable to map completion ring: " << strerror(errno) << endl;
+            release_ring();
+            return -1;
+        }
+    }
+
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ptr = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes_ptr == MAP_FAILED)
+    {
+        cerr << "[Frame writer] Unable to map submission entries: " << strerror(errno) << endl;
+        release_ring();
+        return -1;
+    }
+
+    char* sq_base = static_cast<char*>(sq_ring_ptr);
+    sq_head = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.tail);
+    sq_ring_mask = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned int*>(sq_base + params.sq_off.array);
+
+    char* cq_base = static_cast<char*>(cq_ring_ptr);
+    cq_head = reinterpret_cast<unsigned int*>(cq_base + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned int*>(cq_base + params.cq_off.tail);
+    cq_ring_mask = reinterpret_cast<unsigned int*>(cq_base + params.cq_off.ring_mask);
+    cqes_ptr = cq_base + params.cq_off.cqes;
+
+    // The ring may be larger than requested (power of two), but we never have more SQEs in flight than slots
+    if (allocate_slots(config.slot_count, config.slot_size) != 0)
+    {
+        release_ring();
+        return -1;
+    }
+
+    // Register the staging buffers so the kernel does not have to pin/unpin pages for every write
+    vector<struct iovec> iovecs(slots.size());
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        iovecs[i].iov_base = slots[i].buffer;
+        iovecs[i].iov_len = slot_size;
+    }
+
+    if (io_uring_register(ring_fd, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned int>(iovecs.size())) == 0)
+    {
+        use_fixed_buffers = true;
+    }
+    else
+    {
+        cerr << "[Frame writer] Buffer registration failed (" << strerror(errno) << "). Using unregistered writes.\n";
+        use_fixed_buffers = false;
+    }
+
+    cout << "[Frame writer] io_uring ready: " << slots.size() << " slots x " << slot_size << " bytes, batch " << batch_size
+         << (use_fixed_buffers ? ", registered buffers" : "") << endl;
+
+    return 0;
+}
+
+/**
+ * Unmaps the rings and closes the io_uring file descriptor.
+ */
+void URING_FRAME_WRITER::release_ring()
+{
+    if (sqes_ptr != MAP_FAILED)
+    {
+        munmap(sqes_ptr, sqes_size);
+        sqes_ptr = MAP_FAILED;
+    }
+    if (cq_ring_ptr != MAP_FAILED && cq_ring_ptr != sq_ring_ptr)
+    {
+        munmap(cq_ring_ptr, cq_ring_size);
+    }
+    cq_ring_ptr = MAP_FAILED;
+    if (sq_ring_ptr != MAP_FAILED)
+    {
+        munmap(sq_ring_ptr, sq_ring_size);
+        sq_ring_ptr = MAP_FAILED;
+    }
+    if (ring_fd >= 0)
+    {
+        close(ring_fd);
+        ring_fd = -1;
+    }
+}
+
+/**
+ * Prepares a write SQE for the remaining bytes of a slot. Does not call into the kernel.
+ * @param slot_index: Index of the slot to write.
+ */
+void URING_FRAME_WRITER::queue_write(unsigned int slot_index)
+{
+    FRAME_WRITER_SLOT& slot = slots[slot_index];
+
+    unsigned int tail = *sq_tail;
+    unsigned int index = tail & *sq_ring_mask;
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes_ptr) + index;
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = use_fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = slot.fd;
+    sqe->addr = reinterpret_cast<unsigned long>(slot.buffer + slot.written);
+    sqe->len = static_cast<unsigned int>(slot.length - slot.written);
+    sqe->off = slot.written;
+    sqe->buf_index = use_fixed_buffers ? static_cast<uint16_t>(slot_index) : 0;
+    sqe->user_data = slot_index;
+
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    pending_submissions++;
+}
+
+/**
+ * Passes the queued SQEs to the kernel and optionally waits for completions.
+ * @param wait_for: Number of completions to wait for (0 = do not wait).
+ * @return 0 if successful, -1 on error.
+ */
+int URING_FRAME_WRITER::submit(unsigned int wait_for)
+{
+    unsigned int flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    while (true)
+    {
+        int submitted = io_uring_enter(ring_fd, pending_submissions, wait_for, flags);
+        if (submitted >= 0)
+        {
+            pending_submissions -= min<unsigned int>(pending_submissions, static_cast<unsigned int>(submitted));
+            if (pending_submissions == 0 || wait_for > 0)
+            {
+                return 0;
+            }
+            continue;
+        }
+        if (errno == EINTR)
+        {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EBUSY)
+        {
+            // Completion queue is backed up -> drain it and try again
+            reap_completions();
+            continue;
+        }
+
+        cerr << "[Frame writer] io_uring_enter failed: " << strerror(errno) << endl;
+        return -1;
+    }
+}
+
+/**
+ * Processes finished writes: requeues short writes, closes files and returns slots to the free list.
+ */
+void URING_FRAME_WRITER::reap_completions()
+{
+    unsigned int head = *cq_head;
+    unsigned int tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+
+    while (head != tail)
+    {
+        const struct io_uring_cqe* cqe = static_cast<const struct io_uring_cqe*>(cqes_ptr) + (head & *cq_ring_mask);
+        unsigned int slot_index = static_cast<unsigned int>(cqe->user_data);
+        int res = cqe->res;
+        head++;
+
+        FRAME_WRITER_SLOT& slot = slots[slot_index];
+
+        bool success = false;
+
+        if (res < 0)
+        {
+            cerr << "[Frame writer] Write failed for " << slot.path << ": " << strerror(-res) << endl;
+            errors++;
+        }
+        else
+        {
+            slot.written += static_cast<size_t>(res);
+            if (res > 0 && slot.written < slot.length)
+            {
+                queue_write(slot_index);    // Short write -> submit the rest, slot stays in flight
+                continue;
+            }
+            if (slot.written < slot.length)
+            {
+                cerr << "[Frame writer] Zero-length write for " << slot.path << endl;
+                errors++;
+            }
+            else
+            {
+                frames_written++;
+                bytes_written += slot.length;
+                success = true;
+            }
+        }
+
+        close(slot.fd);
+        slot.fd = -1;
+        notify_completion(slot.path, success);
+        in_flight--;
+        frames_in_flight--;
+        free_slots.push_back(slot_index);
+    }
+
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copies the frame into a registered buffer and queues it. The io_uring_enter call is batched.
+ * @param path: Destination file path (created or truncated).
+ * @param header: The frame header, data_size must be set.
+ * @param data: The pixel data.
+ * @return 0 if the frame was queued, -1 otherwise.
+ */
+int URING_FRAME_WRITER::write_frame(const string& path, const FRAME_HEADER& header, const void* data)
+{
+    size_t total_size = sizeof(FRAME_HEADER) + header.data_size;
+
+    lock_guard<mutex> lock(writer_mutex);
+
+    if (total_size > slot_size)
+    {
+        cerr << "[Frame writer] Frame of " << total_size << " bytes does not fit in a " << slot_size << " byte slot\n";
+        errors++;
+        return -1;
+    }
+
+    reap_completions();
+
+    // All staging buffers are in flight -> push what we have and wait for at least one to finish
+    while (free_slots.empty())
+    {
+        stalls++;
+        if (submit(1) != 0)
+        {
+            errors++;
+            return -1;
+        }
+        reap_completions();
+    }
+
+    unsigned int slot_index = free_slots.back();
+    FRAME_WRITER_SLOT& slot = slots[slot_index];
+
+    slot.fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (slot.fd < 0)
+    {
+        cerr << "[Frame writer] Unable to open " << path << ": " << strerror(errno) << endl;
+        errors++;
+        return -1;
+    }
+
+    free_slots.pop_back();
+    memcpy(slot.buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(slot.buffer + sizeof(FRAME_HEADER), data, header.data_size);
+    slot.length = total_size;
+    slot.written = 0;
+    slot.path = path;
+
+    in_flight++;
+    frames_in_flight++;
+    queue_write(slot_index);
+
+    if (pending_submissions >= batch_size)
+    {
+        if (submit(0) != 0)
+        {
+            errors++;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Submits any partial batch and waits until every queued frame is on disk (page cache).
+ * @return 0 if successful, -1 if the ring failed.
+ */
+int URING_FRAME_WRITER::flush()
+{
+    lock_guard<mutex> lock(writer_mutex);
+
+    if (pending_submissions > 0 && submit(0) != 0)
+    {
+        return -1;
+    }
+
+    while (in_flight > 0)
+    {
+        if (submit(1) != 0)
+        {
+            return -1;
+        }
+        reap_completions();
+    }
+
+    return 0;
+}
+
+/**
+ * Returns the backend name.
+ */
+const char* URING_FRAME_WRITER::get_name() const
+{
+    return "io_uring";
+}
+
+/**
+ * Constructor for the PWRITE_FRAME_WRITER class.
+ */
+PWRITE_FRAME_WRITER::PWRITE_FRAME_WRITER()
+    : in_flight(0), stopping(false)
+{
+}
+
+/**
+ * Destructor for the PWRITE_FRAME_WRITER class -> drains the queue and joins the workers.
+ */
+PWRITE_FRAME_WRITER::~PWRITE_FRAME_WRITER()
+{
+    flush();
+
+    {
+        lock_guard<mutex> lock(writer_mutex);
+        stopping = true;
+    }
+    job_available.notify_all();
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+/**
+ * Allocates the staging buffers and starts the worker threads.
+ * @param config: The writer configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int PWRITE_FRAME_WRITER::init(const FRAME_WRITER_CONFIG& config)
+{
+    if (config.slot_count == 0 || config.slot_size == 0)
+    {
+        cerr << "[Frame writer] slot_count and slot_size must be non-zero\n";
+        return -1;
+    }
+
+    if (allocate_slots(config.slot_count, config.slot_size) != 0)
+    {
+        return -1;
+    }
+
+    unsigned int thread_count = config.thread_count > 0 ? config.thread_count : 2;
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        workers.push_back(thread(&PWRITE_FRAME_WRITER::worker_loop, this));
+    }
+
+    cout << "[Frame writer] pwrite pool ready: " << thread_count << " threads, " << slots.size() << " slots x " << slot_size << " bytes" << endl;
+
+    return 0;
+}
+
+/**
+ * Writes a single slot to its file.
+ * @param slot: The slot to write.
+ * @return 0 if successful, -1 otherwise.
+ */
+int PWRITE_FRAME_WRITER::write_slot(FRAME_WRITER_SLOT& slot)
+{
+    int fd = open(slot.path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        cerr << "[Frame writer] Unable to open " << slot.path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    slot.written = 0;
+    while (slot.written < slot.length)
+    {
+        ssize_t res = pwrite(fd, slot.buffer + slot.written, slot.length - slot.written, static_cast<off_t>(slot.written));
+        if (res < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (res <= 0)
+        {
+            cerr << "[Frame writer] Write failed for " << slot.path << ": " << strerror(errno) << endl;
+            close(fd);
+            return -1;
+        }
+        slot.written += static_cast<size_t>(res);
+    }
+
+    close(fd);
+    return 0;
+}
+
+/**
+ * Worker thread: takes queued slots and writes them until the writer is destroyed.
+ */
+void PWRITE_FRAME_WRITER::worker_loop()
+{
+    TRACE_RECORDER::set_thread_name("frame writer");
+
+    unique_lock<mutex> lock(writer_mutex);
+
+    while (true)
+    {
+        job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+        {
+            return; // stopping and nothing left to do
+        }
+
+        unsigned int slot_index = jobs.front();
+        jobs.pop_front();
+
+        lock.unlock();
+        trace_begin("pwrite", "bytes", static_cast<int64_t>(slots[slot_index].length));
+        int result = write_slot(slots[slot_index]);
+        trace_end("pwrite");
+        notify_completion(slots[slot_index].path, result == 0);
+        lock.lock();
+
+        if (result == 0)
+        {
+            frames_written++;
+            bytes_written += slots[slot_index].length;
+        }
+        else
+        {
+            errors++;
+        }
+
+        in_flight--;
+        frames_in_flight--;
+        free_slots.push_back(slot_index);
+        slot_available.notify_all();
+    }
+}
+
+/**
+ * Copies the frame into a staging buffer and hands it to the worker pool.
+ * @param path: Destination file path (created or truncated).
+ * @param header: The frame header, data_size must be set.
+ * @param data: The pixel data.
+ * @return 0 if the frame was queued, -1 otherwise.
+ */
+int PWRITE_FRAME_WRITER::write_frame(const string& path, const FRAME_HEADER& header, const void* data)
+{
+    size_t total_size = sizeof(FRAME_HEADER) + header.data_size;
+
+    unique_lock<mutex> lock(writer_mutex);
+
+    if (total_size > slot_size)
+    {
+        cerr << "[Frame writer] Frame of " << total_size << " bytes does not fit in a " << slot_size << " byte slot\n";
+        errors++;
+        return -1;
+    }
+
+    if (free_slots.empty())
+    {
+        stalls++;
+        slot_available.wait(lock, [this] { return !free_slots.empty(); });
+    }
+
+    unsigned int slot_index = free_slots.back();
+    free_slots.pop_back();
+    in_flight++;
+    frames_in_flight++;
+
+    // The copy happens outside the lock so workers can keep going
+    lock.unlock();
+    FRAME_WRITER_SLOT& slot = slots[slot_index];
+    memcpy(slot.buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(slot.buffer + sizeof(FRAME_HEADER), data, header.data_size);
+    slot.length = total_size;
+    slot.path = path;
+    lock.lock();
+
+    jobs.push_back(slot_index);
+    job_available.notify_one();
+
+    return 0;
+}
+
+/**
+ * Waits until the workers have written every queued frame.
+ * @return 0 (errors are reported through get_stats).
+ */
+int PWRITE_FRAME_WRITER::flush()
+{
+    unique_lock<mutex> lock(writer_mutex);
+    slot_available.wait(lock, [this] { return jobs.empty() && in_flight == 0; });
+    return 0;
+}
+
+/**
+ * Returns the backend name.
+ */
+const char* PWRITE_FRAME_WRITER::get_name() const
+{
+    return "pwrite";
+}
+
+/**
+ * Creates a frame writer for the requested backend, falling back to the pwrite pool when io_uring cannot be set up.
+ * @param config: The writer configuration.
+ * @return The writer, or an empty pointer if no backend could be initialized.
+ */
+unique_ptr<FRAME_WRITER> create_frame_writer(const FRAME_WRITER_CONFIG& config)
+{
+    if (config.backend == FRAME_WRITER_BACKEND_URING)
+    {
+        unique_ptr<URING_FRAME_WRITER> uring_writer(new URING_FRAME_WRITER());
+        if (uring_writer->init(config) == 0)
+        {
+            return unique_ptr<FRAME_WRITER>(uring_writer.release());
+        }
+        cerr << "[Frame writer] io_uring unavailable. Falling back to pwrite thread pool.\n";
+    }
+
+    unique_ptr<PWRITE_FRAME_WRITER> pwrite_writer(new PWRITE_FRAME_WRITER());
+    if (pwrite_writer->init(config) == 0)
+    {
+        return unique_ptr<FRAME_WRITER>(pwrite_writer.release());
+    }
+
+    return unique_ptr<FRAME_WRITER>();
+}
+
+/**
+ * Parses a backend name.
+ * @param name: "uring" or "pwrite".
+ * @param backend: Receives the parsed backend.
+ * @return true if the name is known.
+ */
+bool parse_frame_writer_backend(const string& name, FRAME_WRITER_BACKEND& backend)
+{
+    if (name == "uring" || name == "io_uring")
+    {
+        backend = FRAME_WRITER_BACKEND_URING;
+        return true;
+    }
+    if (name == "pwrite")
+    {
+        backend = FRAME_WRITER_BACKEND_PWRITE;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns a sensible default configuration for frames up to max_frame_bytes.
+ * @param backend: The requested backend.
+ * @param max_frame_bytes: Largest pixel payload that will be written.
+ * @return The configuration.
+ */
+FRAME_WRITER_CONFIG default_frame_writer_config(FRAME_WRITER_BACKEND backend, size_t max_frame_bytes)
+{
+    FRAME_WRITER_CONFIG config;
+    config.backend = backend;
+    config.slot_size = sizeof(FRAME_HEADER) + max_frame_bytes;
+    config.slot_count = 8;
+    config.batch_size = 4;
+    config.thread_count = 2;
+    return config;
+}
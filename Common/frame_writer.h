@@ -0,0 +1,177 @@
+// frame_writer.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include "frame_format.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Available writer backends
+enum FRAME_WRITER_BACKEND
+{
+    FRAME_WRITER_BACKEND_URING,    // io_uring with registered buffers and batched submission
+    FRAME_WRITER_BACKEND_PWRITE    // Thread pool doing open/pwrite/close
+};
+
+// Struct to hold the writer configuration
+struct FRAME_WRITER_CONFIG
+{
+    FRAME_WRITER_BACKEND backend;
+    size_t slot_size;            // Largest header + frame that can be queued, in bytes
+    unsigned int slot_count;     // Number of preallocated staging buffers (frames in flight)
+    unsigned int batch_size;     // io_uring: number of writes collected before io_uring_enter
+    unsigned int thread_count;   // pwrite: number of worker threads
+};
+
+// Struct to hold the writer counters
+struct FRAME_WRITER_STATS
+{
+    uint64_t frames_written;
+    uint64_t bytes_written;
+    uint64_t errors;
+    uint64_t stalls;    // Number of times write_frame had to wait for a free staging buffer
+    uint64_t frames_in_flight;  // Queued frames not yet written (queue depth)
+};
+
+// Staging buffer shared by both backends
+struct FRAME_WRITER_SLOT
+{
+    char* buffer;
+    size_t length;     // Bytes to write
+    size_t written;    // Bytes already written
+    int fd;
+    string path;
+};
+
+class FRAME_WRITER
+{
+    protected:
+        atomic<uint64_t> frames_written;
+        atomic<uint64_t> bytes_written;
+        atomic<uint64_t> errors;
+        atomic<uint64_t> stalls;
+        atomic<uint64_t> frames_in_flight;
+
+        size_t slot_size;
+        vector<FRAME_WRITER_SLOT> slots;
+        vector<unsigned int> free_slots;
+
+        int allocate_slots(unsigned int slot_count, size_t size);   // Allocate page aligned staging buffers
+        void release_slots();   // Free staging buffers
+
+        function<void(const string&, bool)> completion_handler;
+        void notify_completion(const string& path, bool success);  // Called once a file is closed
+
+    public:
+        FRAME_WRITER();
+        virtual ~FRAME_WRITER();
+
+        // Copies header + pixel data into a staging buffer and queues it for writing to path.
+        // Returns as soon as the copy is done; the file is written in the background.
+        virtual int write_frame(const string& path, const FRAME_HEADER& header, const void* data) = 0;
+
+        virtual int flush() = 0;    // Blocks until every queued frame has been written
+        virtual const char* get_name() const = 0;  // Backend name for logging
+
+        FRAME_WRITER_STATS get_stats() const;
+
+        // Called from the writer thread after each file is complete and closed (e.g. to rename it into place).
+        // Set before the first write_frame.
+        void set_completion_handler(function<void(const string& path, bool success)> handler);
+};
+
+class URING_FRAME_WRITER : public FRAME_WRITER
+{
+    private:
+        int ring_fd;
+        unsigned int batch_size;
+        unsigned int pending_submissions;   // SQEs queued but not yet passed to io_uring_enter
+        unsigned int in_flight;             // Slots owned by the kernel
+        bool use_fixed_buffers;
+
+        // Submission queue ring
+        void* sq_ring_ptr;
+        size_t sq_ring_size;
+        unsigned int* sq_head;
+        unsigned int* sq_tail;
+        unsigned int* sq_ring_mask;
+        unsigned int* sq_array;
+        void* sqes_ptr;
+        size_t sqes_size;
+
+        // Completion queue ring
+        void* cq_ring_ptr;
+        size_t cq_ring_size;
+        unsigned int* cq_head;
+        unsigned int* cq_tail;
+        unsigned int* cq_ring_mask;
+        void* cqes_ptr;
+
+        mutex writer_mutex;
+
+        void queue_write(unsigned int slot_index);  // Prepare a (fixed) write SQE for the slot
+        int submit(unsigned int wait_for);          // io_uring_enter
+        void reap_completions();                    // Handle finished writes
+        void release_ring();
+
+    public:
+        URING_FRAME_WRITER();
+        ~URING_FRAME_WRITER();
+
+        int init(const FRAME_WRITER_CONFIG& config);  // Set up the ring and register the staging buffers
+
+        int write_frame(const string& path, const FRAME_HEADER& header, const void* data);
+        int flush();
+        const char* get_name() const;
+};
+
+class PWRITE_FRAME_WRITER : public FRAME_WRITER
+{
+    private:
+        vector<thread> workers;
+        deque<unsigned int> jobs;   // Slot indices waiting for a worker
+        unsigned int in_flight;     // Slots taken by workers
+        bool stopping;
+
+        mutex writer_mutex;
+        condition_variable job_available;
+        condition_variable slot_available;
+
+        void worker_loop();
+        int write_slot(FRAME_WRITER_SLOT& slot);   // open/pwrite/close for a single slot
+
+    public:
+        PWRITE_FRAME_WRITER();
+        ~PWRITE_FRAME_WRITER();
+
+        int init(const FRAME_WRITER_CONFIG& config);  // Allocate staging buffers and start the workers
+
+        int write_frame(const string& path, const FRAME_HEADER& header, const void* data);
+        int flush();
+        const char* get_name() const;
+};
+
+// Creates the requested backend. Falls back to the pwrite pool if io_uring is not available.
+unique_ptr<FRAME_WRITER> create_frame_writer(const FRAME_WRITER_CONFIG& config);
+
+// Parses "uring" / "pwrite" into a backend. Returns false for unknown names.
+bool parse_frame_writer_backend(const string& name, FRAME_WRITER_BACKEND& backend);
+
+// Default configuration for frames up to max_frame_bytes
+FRAME_WRITER_CONFIG default_frame_writer_config(FRAME_WRITER_BACKEND backend, size_t max_frame_bytes);
+
+#endif // FRAME_WRITER_H
@@ -0,0 +1,1086 @@
+// infinity_capture.h Header File -> Capture loop, burst mode and options shared by the mono and color infinity tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef INFINITY_CAPTURE_H
+#define INFINITY_CAPTURE_H
+
+// Header only like camera_control.h, so libcamera_common.a still builds without the Spinnaker SDK.
+// The two infinity tools only differ in the camera policy and a few constants (INFINITY_CAPTURE_TOOL),
+// their main() passes those to INFINITY_CAPTURE<MONO_CAMERA/COLOR_CAMERA>::run.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <cmath>
+#include <chrono>	// for std::chrono::milliseconds
+#include <unistd.h>
+#include <thread>	// for std::this_thread::sleep_for
+#include <csignal>	// for signal handling
+
+#include "async_logger.h"
+#include "burst_arena.h"
+#include "camera_control.h"
+#include "command_line.h"
+#include "control_fifo.h"
+#include "frame_compressor.h"
+#include "frame_sink.h"
+#include "frame_stream.h"
+#include "frame_writer.h"
+#include "latency_histogram.h"
+#include "metrics_server.h"
+#include "pretrigger_ring.h"
+#include "segment_recorder.h"
+#include "settings_watcher.h"
+#include "shm_frame_ring.h"
+#include "spinnaker_frame.h"
+#include "spinnaker_user_set.h"
+#include "user_set_cache.h"
+#include "video_recorder.h"
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace Spinnaker::GenICam;
+using namespace std;
+
+// Struct to hold what differs between the infinity tools
+struct INFINITY_CAPTURE_TOOL
+{
+    const char* name; // Name of the latency report
+    const char* default_settings_path; // Settings file without --config
+    int64_t roi_width; // Region of interest used for the capture (also sizes the frame writer buffers)
+    int64_t roi_height;
+};
+
+// Capturing of pictures till the user stops the program, CAMERA_TYPE is MONO_CAMERA or COLOR_CAMERA
+template <class CAMERA_TYPE>
+class INFINITY_CAPTURE : public CAMERA_CONTROL<CAMERA_TYPE>
+{
+    private:
+        typedef CAMERA_CONTROL<CAMERA_TYPE> camera_control;
+
+        INFINITY_CAPTURE_TOOL tool; // Constants of the tool
+        FRAME_WRITER* frame_writer = nullptr; // Optional asynchronous raw frame writer (nullptr -> Image::Save as JPEG)
+        vector<FRAME_SINK*> frame_sinks; // Additional consumers of every frame (recorders, rings, ...)
+        bool save_images = true; // false -> frames only go to the frame sinks
+        LATENCY_MONITOR* latency_monitor = nullptr; // Optional per-stage latency histograms
+        METRICS_SERVER* metrics_server = nullptr; // Optional metrics endpoint (incomplete images, camera sensors)
+        SETTINGS_WATCHER* settings_watcher = nullptr; // Optional watch of the settings file, applied between frames
+        string user_set; // UserSet the configuration is saved into and loaded from at startup (empty -> every setting is written)
+        USER_SET_CACHE* user_set_cache = nullptr; // What was saved into the UserSet of each camera
+        BURST_CONFIG burst_config = {0, 0.0, 4, "", true}; // Burst mode (frame_count or seconds set -> burst instead of continuous capture)
+
+        static int acquire_images(CameraPtr pointer_cam, INodeMap& node_map, INodeMap& node_map_tl_device, FRAME_WRITER* frame_writer,
+                                  const vector<FRAME_SINK*>& frame_sinks, bool save_images, LATENCY_MONITOR* latency_monitor,
+                                  METRICS_SERVER* metrics_server, SETTINGS_WATCHER* settings_watcher, CAMERA_PROFILE profile); // Acquire And Save Images From The Camera
+        static int burst_images(CameraPtr pointer_cam, INodeMap& node_map, INodeMap& node_map_tl_device, const BURST_CONFIG& burst_config); // Burst Into RAM, Then Drain To Disk
+
+    public:
+        explicit INFINITY_CAPTURE(const INFINITY_CAPTURE_TOOL& tool) : tool(tool) {}
+
+        static int run(int argc, char** argv, const INFINITY_CAPTURE_TOOL& tool); // Main Function Of The Tool
+
+        int run_single_camera(CameraPtr pointer_cam);   // Main Function For Camera Configuration
+
+        void set_frame_writer(FRAME_WRITER* writer); // Set Frame Writer
+        void add_frame_sink(FRAME_SINK* sink); // Add Frame Sink
+        void set_save_images(bool enable); // Enable/Disable Per-Frame Files
+        void set_burst_config(const BURST_CONFIG& config); // Set Burst Mode
+        void set_latency_monitor(LATENCY_MONITOR* monitor); // Set Latency Monitor
+        void set_metrics_server(METRICS_SERVER* server); // Set Metrics Endpoint
+        void set_settings_watcher(SETTINGS_WATCHER* watcher); // Set Settings File Watch
+        void set_user_set(const string& name, USER_SET_CACHE* cache); // Set UserSet For Fast Startup
+};
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_frame_writer(FRAME_WRITER* writer) // Function to use an asynchronous raw frame writer instead of Image::Save
+{
+    frame_writer = writer;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::add_frame_sink(FRAME_SINK* sink) // Function to pass every captured frame to an additional consumer
+{
+    if (sink)
+    {
+        frame_sinks.push_back(sink);
+    }
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_save_images(bool enable) // Function to enable/disable the per-frame files
+{
+    save_images = enable;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_burst_config(const BURST_CONFIG& config) // Function to switch to burst mode
+{
+    burst_config = config;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_latency_monitor(LATENCY_MONITOR* monitor) // Function to record the per-stage latencies of the capture loop
+{
+    latency_monitor = monitor;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_metrics_server(METRICS_SERVER* server) // Function to report incomplete images and the camera sensors to the metrics endpoint
+{
+    metrics_server = server;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_settings_watcher(SETTINGS_WATCHER* watcher) // Function to apply changes of the settings file while the camera streams
+{
+    settings_watcher = watcher;
+}
+
+template <class CAMERA_TYPE>
+void INFINITY_CAPTURE<CAMERA_TYPE>::set_user_set(const string& name, USER_SET_CACHE* cache) // Function to save the configuration into a UserSet and load it at the next startups
+{
+    user_set = name;
+    user_set_cache = cache;
+}
+
+// This function acquires and saves images from the camera
+template <class CAMERA_TYPE>
+int INFINITY_CAPTURE<CAMERA_TYPE>::acquire_images(CameraPtr pointer_cam, INodeMap& node_map, INodeMap& node_map_tl_device, FRAME_WRITER* frame_writer,
+                                                 const vector<FRAME_SINK*>& all_frame_sinks, bool save_images_enabled, LATENCY_MONITOR* latency_monitor,
+                                                 METRICS_SERVER* metrics_server, SETTINGS_WATCHER* settings_watcher, CAMERA_PROFILE profile)
+{
+    camera_control::set_non_blocking_input(true); // Enable non-blocking mode
+
+    int result = 0;
+    int image_count = 0; // Image count of how many images have been acquired
+    bool running = true; // Running state of the camera
+
+
+    cout << endl << "*** IMAGE ACQUISITION ***" << endl << endl;
+
+    try
+    {
+        CEnumerationPtr ptr_acquisition_mode = node_map.GetNode("AcquisitionMode");  // Setting acquisition mode to continuous
+        if(!IsReadable(ptr_acquisition_mode) || !IsWritable(ptr_acquisition_mode))
+        {
+            cout << "Unable to get or set acquisition mode to continuous (node retrieval). Aborting." << endl;
+            return -1;
+        }
+
+        CEnumEntryPtr ptr_acquisition_mode_continuous = ptr_acquisition_mode->GetEntryByName("Continuous");
+        if (!IsReadable(ptr_acquisition_mode_continuous))
+        {
+            cout << "Unable to get acquisition mode to continuous (entry 'continuous' retrieval). Aborting..." << endl;
+            return -1;
+        }
+
+        const int64_t acquisition_mode_continuous = ptr_acquisition_mode_continuous->GetValue();
+
+        ptr_acquisition_mode->SetIntValue(acquisition_mode_continuous);
+
+        cout << "Acquisition mode set to continuous" << endl;
+
+        //Begin acquiring images
+        pointer_cam->BeginAcquisition();
+        auto acquisition_start_time = chrono::steady_clock::now(); // For the time to the first frame (cold start)
+        bool first_frame = true;
+
+        cout << "Acquiring images" << endl;
+
+        CFloatPtr ptr_exposure_time = node_map.GetNode("ExposureTime"); // Get the value of exposure time to set an appropriate timeout for GetNextImage
+        if(!IsReadable(ptr_exposure_time))
+        {
+            cout << "Unable to get or set exposure time. Aborting" << endl;
+            return -1;
+        }
+
+        uint64_t timeout = static_cast<uint64_t>(ptr_exposure_time->GetValue() / 1000 + 1000);
+
+        ImageProcessor processor;   // Create image processor instance for post processing images
+
+        camera_control::setup_image_processor(processor);  // Set interpolation algorithm of the camera type
+
+        string device_serial; // Serial number for the raw frame headers
+        CStringPtr ptr_device_serial = node_map_tl_device.GetNode("DeviceSerialNumber");
+        if (IsReadable(ptr_device_serial))
+        {
+            device_serial = ptr_device_serial->GetValue().c_str();
+        }
+
+        // Per camera outputs of the settings file: the frame sinks and/or the per-frame files (a reload of the file can change them)
+        vector<FRAME_SINK*> frame_sinks = (profile.outputs & FRAME_OUTPUT_SINKS) ? all_frame_sinks : vector<FRAME_SINK*>();
+        bool save_images = save_images_enabled && (profile.outputs & FRAME_OUTPUT_FILES);
+
+        // Change of the settings file written to the camera, until the first frame taken with it arrives
+        SETTINGS_CHANGE settings_change = {false, "", 0};
+        CAMERA_CONFIG_FILE updated_file;
+
+        // Frames are counted by the metrics endpoint as a frame sink, the loop adds incomplete images and the sensors (about once per second)
+        CAMERA_METRICS* camera_metrics = metrics_server ? metrics_server->get_camera(device_serial) : nullptr;
+        auto sensor_time = chrono::steady_clock::now() - chrono::seconds(1);
+
+        // Camera clock -> host clock, for the latencies that start at the image timestamp (re-latched every 10 s against drift)
+        int64_t camera_clock_offset_ns = 0;
+        bool has_camera_clock = latency_monitor && get_camera_clock_offset(node_map, camera_clock_offset_ns) == 0;
+        auto camera_clock_time = chrono::steady_clock::now();
+        if (latency_monitor && !has_camera_clock)
+        {
+            cout << "Camera has no TimestampLatch, exposure_to_arrival and end_to_end latencies are not measured" << endl;
+        }
+
+        auto start_time_image = chrono::steady_clock::now(); // Start the time for image  data
+
+        while(running)  // Continue recording until the user stops it
+        {
+            auto start_time = chrono::steady_clock::now(); // Start time for image acquisition
+            try
+            {
+                // Retrive next received image and ensure image completion
+                // Timeout value is set to [exposure time + 1000] ms to ensure that the image has enough time to arrive
+                uint64_t grab_start_ns = latency_now_ns();
+                ImagePtr p_result_image_pointer = pointer_cam->GetNextImage(timeout);
+                uint64_t arrival_ns = latency_now_ns();
+
+                if (first_frame)
+                {
+                    log_info(log_tag("Startup"), "First frame {} ms after BeginAcquisition",
+                             chrono::duration<double, milli>(chrono::steady_clock::now() - acquisition_start_time).count());
+                    first_frame = false;
+                }
+
+                if (settings_change_took_effect(settings_change, p_result_image_pointer->GetTimeStamp()))
+                {
+                    log_info(log_tag("Reload"), "{} took effect at frame {} (image {})", settings_change.description, p_result_image_pointer->GetFrameID(), image_count);
+                    settings_change.pending = false;
+                }
+
+                // Exposure timestamp on the host clock (0 -> unknown)
+                uint64_t frame_time_ns = has_camera_clock ? p_result_image_pointer->GetTimeStamp() + camera_clock_offset_ns : 0;
+                if (latency_monitor)
+                {
+                    latency_monitor->record(LATENCY_GRAB_WAIT, arrival_ns - grab_start_ns);
+                    if (frame_time_ns > 0 && arrival_ns > frame_time_ns)
+                    {
+                        latency_monitor->record(LATENCY_EXPOSURE_TO_ARRIVAL, arrival_ns - frame_time_ns);
+                    }
+                }
+
+                if (p_result_image_pointer->IsIncomplete())
+                {
+                    log_warning(log_tag("Capture"), "Image incomplete with image status {}", static_cast<int>(p_result_image_pointer->GetImageStatus()));
+                    if (camera_metrics)
+                    {
+                        camera_metrics->record_incomplete();
+                    }
+                }
+                else
+                {
+                    // Convert image to custom color processing algorithm
+                    ImagePtr converted_image = camera_control::convert_image(processor, p_result_image_pointer);
+                    uint64_t conversion_end_ns = latency_now_ns();
+                    if (latency_monitor)
+                    {
+                        latency_monitor->record(LATENCY_CONVERSION, conversion_end_ns - arrival_ns);
+                    }
+                    
+                    auto current_time_image = chrono::steady_clock::now(); // Current time for image data
+                    auto elapsed_time_image = chrono::duration_cast<chrono::seconds>(current_time_image - start_time_image); // Calculate elapsed time for image data
+                    
+                    int minutes = elapsed_time_image.count() / 60; // Calculate minutes
+                    int seconds = elapsed_time_image.count() % 60; // Calculate seconds
+
+                    size_t width = p_result_image_pointer->GetWidth();
+                    size_t height = p_result_image_pointer->GetHeight();
+
+                    log_info(log_tag("Capture"), "Grabbed image {}, width = {}, height = {}", image_count, width, height);
+
+                    // Define the folder path to save images
+                    string folder_path = "/folder/path/to/save/images"; // Folder path to save images
+                    
+                    ostringstream filename; // Create a unique filename
+
+                    filename << folder_path << "image_" << image_count + 1 << "_"<< minutes << ":" << seconds; // Prefix with folder path and image count
+
+                    FRAME_HEADER header;
+                    fill_frame_header(header, converted_image, device_serial, 0, 0);
+
+                    uint64_t write_start_ns = latency_now_ns();
+                    for (FRAME_SINK* sink : frame_sinks) // Hand the frame to the sinks, they only copy it
+                    {
+                        if (sink->consume_frame(header, converted_image->GetData()) != 0)
+                        {
+                            log_warning(log_tag("Capture"), "{} rejected image {}", sink->get_sink_name(), image_count);
+                        }
+                    }
+                    uint64_t write_ns = latency_now_ns() - write_start_ns;
+
+                    if (!save_images)
+                    {
+                        log_info(log_tag("Capture"), "Image passed to {} sink(s)", frame_sinks.size());
+                    }
+                    else if (frame_writer)
+                    {
+                        // Queue the raw frame, the writer copies it so the image can be released right away
+                        filename << ".raw";
+
+                        uint64_t handoff_start_ns = latency_now_ns();
+                        int write_result = frame_writer->write_frame(filename.str(), header, converted_image->GetData());
+                        write_ns += latency_now_ns() - handoff_start_ns;
+
+                        if (write_result == 0)
+                        {
+                            log_info(log_tag("Capture"), "Image queued at {}", filename.str());
+                        }
+                    }
+                    else
+                    {
+                        filename << ".jpg";
+
+                        uint64_t encode_start_ns = latency_now_ns();
+                        converted_image->Save(filename.str().c_str());
+                        if (latency_monitor)
+                        {
+                            latency_monitor->record(LATENCY_ENCODE, latency_now_ns() - encode_start_ns);
+                        }
+
+                        log_info(log_tag("Capture"), "Image saved at {}", filename.str());
+                    }
+
+                    if (latency_monitor)
+                    {
+                        if (!frame_sinks.empty() || frame_writer)
+                        {
+                            latency_monitor->record(LATENCY_WRITE, write_ns);
+                        }
+
+                        uint64_t done_ns = latency_now_ns();
+                        if (frame_time_ns > 0 && done_ns > frame_time_ns)
+                        {
+                            latency_monitor->record(LATENCY_END_TO_END, done_ns - frame_time_ns);
+                        }
+                    }
+
+                    image_count++; // Increment image count
+
+                    if (camera_control::keyboard_input()) // Check if the user has pressed a key
+                    {
+                        char key = getchar();
+                        if(key == 'q' || key == 'Q') // If the user presses 'q', exit the loop
+                        {
+                            running = false;
+                        }
+                        else if (key == 't' || key == 'T') // If the user presses 't', trigger an event for the frame sinks
+                        {
+                            for (FRAME_SINK* sink : frame_sinks)
+                            {
+                                sink->on_event("keypress");
+                            }
+                        }
+                    }
+                }
+                p_result_image_pointer->Release();  // Release image
+
+            }
+            catch (Spinnaker::Exception& e)
+            {
+                log_error(log_tag("Capture"), "Error: {}", e.what());
+                result = -1;
+            }
+
+            auto end_time = chrono::steady_clock::now(); // End time for image acquisition
+
+            if (has_camera_clock && end_time - camera_clock_time > chrono::seconds(10))
+            {
+                get_camera_clock_offset(node_map, camera_clock_offset_ns);
+                camera_clock_time = end_time;
+            }
+
+            // Settings file changed -> write the differences between two frames, the acquisition keeps running
+            if (settings_watcher && settings_watcher->take_update(updated_file))
+            {
+                try
+                {
+                    uint32_t changes = reload_camera_profile(node_map, pointer_cam->GetTLStreamNodeMap(), updated_file.get_profile(profile.serial),
+                                                             profile, PROFILE_LIVE_FIELDS, settings_change);
+                    if (changes & PROFILE_EXPOSURE)
+                    {
+                        timeout = static_cast<uint64_t>(ptr_exposure_time->GetValue() / 1000 + 1000);
+                    }
+                    if (changes & PROFILE_OUTPUTS)
+                    {
+                        frame_sinks = (profile.outputs & FRAME_OUTPUT_SINKS) ? all_frame_sinks : vector<FRAME_SINK*>();
+                        save_images = save_images_enabled && (profile.outputs & FRAME_OUTPUT_FILES);
+                    }
+                }
+                catch (Spinnaker::Exception& e)
+                {
+                    log_error(log_tag("Reload"), "Error: {}", e.what());
+                }
+            }
+
+            if (camera_metrics && end_time - sensor_time >= chrono::seconds(1))
+            {
+                double temperature_c = 0.0;
+                double link_throughput = 0.0;
+                read_device_sensors(node_map, temperature_c, link_throughput);
+                camera_metrics->set_sensors(temperature_c, link_throughput);
+                sensor_time = end_time;
+            }
+
+            chrono::duration<double> elapsed_seconds = end_time - start_time; // Calculate elapsed time
+            int delay_time = (1000 - static_cast<int>(elapsed_seconds.count() * 1000)) / 2; // Calculate delay time
+
+            log_debug(log_tag("Capture"), "Elapsed time: {} seconds, delay time: {} milliseconds", elapsed_seconds.count(), delay_time);
+
+            if (delay_time > 0)
+            {
+                this_thread::sleep_for(chrono::milliseconds(delay_time)); // Wait for the remaining time
+            }
+        }
+        pointer_cam->EndAcquisition();  // End acquisition
+        camera_control::set_non_blocking_input(false);   // Set input to blocking mode
+
+        if (frame_writer)
+        {
+            result = result | frame_writer->flush(); // Wait for the queued frames to reach the disk
+        }
+
+        for (FRAME_SINK* sink : frame_sinks)
+        {
+            result = result | sink->flush(); // Wait for the sinks to finish (e.g. recorder writes)
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function captures a burst straight into a preallocated arena at sensor rate and drains it to disk afterwards
+template <class CAMERA_TYPE>
+int INFINITY_CAPTURE<CAMERA_TYPE>::burst_images(CameraPtr pointer_cam, INodeMap& node_map, INodeMap& node_map_tl_device, const BURST_CONFIG& burst_config)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** BURST ACQUISITION ***" << endl << endl;
+
+    try
+    {
+        CEnumerationPtr ptr_acquisition_mode = node_map.GetNode("AcquisitionMode");  // Setting acquisition mode to continuous
+        if(!IsReadable(ptr_acquisition_mode) || !IsWritable(ptr_acquisition_mode))
+        {
+            cout << "Unable to get or set acquisition mode to continuous (node retrieval). Aborting." << endl;
+            return -1;
+        }
+
+        CEnumEntryPtr ptr_acquisition_mode_continuous = ptr_acquisition_mode->GetEntryByName("Continuous");
+        if (!IsReadable(ptr_acquisition_mode_continuous))
+        {
+            cout << "Unable to get acquisition mode to continuous (entry 'continuous' retrieval). Aborting..." << endl;
+            return -1;
+        }
+
+        ptr_acquisition_mode->SetIntValue(ptr_acquisition_mode_continuous->GetValue());
+
+        // Size the arena: a fixed frame count, or the duration at the camera's resulting frame rate
+        CFloatPtr ptr_frame_rate = node_map.GetNode("AcquisitionResultingFrameRate");
+        double frame_rate = IsReadable(ptr_frame_rate) ? ptr_frame_rate->GetValue() : 0.0;
+
+        unsigned int frame_capacity = burst_config.frame_count;
+        if (burst_config.seconds > 0.0)
+        {
+            if (frame_rate <= 0.0)
+            {
+                cout << "Unable to read the frame rate to size a " << burst_config.seconds << " s burst. Use --burst-frames. Aborting." << endl;
+                return -1;
+            }
+            frame_capacity = static_cast<unsigned int>(ceil(burst_config.seconds * frame_rate)) + 1;
+        }
+
+        cout << "Camera frame rate: " << frame_rate << " fps, burst of up to " << frame_capacity << " frames" << endl;
+
+        // Slots sized for the raw frames the camera sends (the burst stores them unconverted, e.g. Mono16 or BayerRG8)
+        size_t frame_bytes = 0;
+        CIntegerPtr ptr_payload_size = node_map.GetNode("PayloadSize");
+        CIntegerPtr ptr_width = node_map.GetNode("Width");
+        CIntegerPtr ptr_height = node_map.GetNode("Height");
+        if (IsReadable(ptr_payload_size))
+        {
+            frame_bytes = static_cast<size_t>(ptr_payload_size->GetValue());
+        }
+        else if (IsReadable(ptr_width) && IsReadable(ptr_height))
+        {
+            frame_bytes = static_cast<size_t>(ptr_width->GetValue() * ptr_height->GetValue()) * max<size_t>(CAMERA_TYPE::get_bytes_per_pixel(), 2); // Up to 16 bit raw
+        }
+        else
+        {
+            cout << "Unable to read the frame size to size the burst arena. Aborting." << endl;
+            return -1;
+        }
+
+        BURST_ARENA arena;
+        if (arena.init(frame_capacity, frame_bytes) != 0)
+        {
+            return -1;
+        }
+
+        // Oldest first: the host queues every frame instead of silently replacing unread ones
+        CEnumerationPtr ptr_buffer_handling = pointer_cam->GetTLStreamNodeMap().GetNode("StreamBufferHandlingMode");
+        if (IsReadable(ptr_buffer_handling) && IsWritable(ptr_buffer_handling))
+        {
+            CEnumEntryPtr ptr_oldest_first = ptr_buffer_handling->GetEntryByName("OldestFirst");
+            if (IsReadable(ptr_oldest_first))
+            {
+                ptr_buffer_handling->SetIntValue(ptr_oldest_first->GetValue());
+            }
+        }
+
+        CFloatPtr ptr_exposure_time = node_map.GetNode("ExposureTime"); // Timeout for GetNextImage
+        uint64_t timeout = IsReadable(ptr_exposure_time) ? static_cast<uint64_t>(ptr_exposure_time->GetValue() / 1000 + 1000) : 1000;
+
+        string device_serial; // Serial number for the frame headers and file names
+        CStringPtr ptr_device_serial = node_map_tl_device.GetNode("DeviceSerialNumber");
+        if (IsReadable(ptr_device_serial))
+        {
+            device_serial = ptr_device_serial->GetValue().c_str();
+        }
+
+        pointer_cam->BeginAcquisition();
+        auto start_time = chrono::steady_clock::now();
+
+        // No conversion, no printing, no pacing: only copy the frames as the camera delivers them
+        while (!arena.is_full())
+        {
+            if (burst_config.seconds > 0.0 &&
+                chrono::duration<double>(chrono::steady_clock::now() - start_time).count() >= burst_config.seconds)
+            {
+                break;
+            }
+
+            try
+            {
+                ImagePtr p_result_image_pointer = pointer_cam->GetNextImage(timeout);
+                if (p_result_image_pointer->IsIncomplete())
+                {
+                    arena.add_dropped(1);
+                }
+                else
+                {
+                    FRAME_HEADER header;
+                    fill_frame_header(header, p_result_image_pointer, device_serial, 0, 0);
+                    if (arena.consume_frame(header, p_result_image_pointer->GetData()) != 0) // Not full (checked above) -> larger than a slot
+                    {
+                        cout << "Burst stopped: frame of " << header.data_size << " bytes does not fit the " << frame_bytes << " byte arena slots" << endl;
+                        p_result_image_pointer->Release();
+                        result = -1;
+                        break;
+                    }
+                }
+                p_result_image_pointer->Release();
+            }
+            catch (Spinnaker::Exception& e)
+            {
+                cout << "Burst stopped early: " << e.what() << endl; // Keep what was captured so far
+                result = -1;
+                break;
+            }
+        }
+
+        pointer_cam->EndAcquisition();
+
+        cout << "Burst finished: " << arena.get_frame_count() << " frames in RAM" << endl;
+
+        result = result | arena.drain(burst_config.folder_path, burst_config.drain_threads, burst_config.use_direct_io);
+        print_burst_report(arena.get_report());
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function acts as the main function for the camera configuration
+template <class CAMERA_TYPE>
+int INFINITY_CAPTURE<CAMERA_TYPE>::run_single_camera(CameraPtr pointer_cam)
+{
+    int result = 0;
+
+    try
+    {   
+        INodeMap& node_map_tl_device = pointer_cam->GetTLDeviceNodeMap();   // Retrieve TL device nodemap and print device information
+
+        auto startup_time = chrono::steady_clock::now(); // Cold start: Init, configuration, then the first frame in acquire_images
+
+        cout << "Initialize camera \n" << endl;
+        pointer_cam->Init();    // Initialize camera
+        auto init_end_time = chrono::steady_clock::now();
+
+        INodeMap& node_map = pointer_cam->GetNodeMap();  // Retrieve GenICam nodemap
+
+        cout << "Running print device info function" << endl;
+        result = result | camera_control::print_device_info(node_map_tl_device);          // Calling out print_defice_info function and checking if it returns 0
+
+        cout << "Checking camera settings" << endl;
+        this->select_camera(node_map, node_map_tl_device, pointer_cam->GetTLStreamNodeMap(), false); // Settings of this serial
+
+        // The same settings were saved into the UserSet the camera boots into -> one UserSetLoad instead of every node write
+        const string tool_settings = string("infinity capture, ") + CAMERA_TYPE::get_pixel_format_name() + ", roi " + to_string(tool.roi_width) + "x" + to_string(tool.roi_height);
+        uint64_t settings_hash = hash_camera_profile(this->get_profile(), tool_settings);
+        // The hash only says what this host saved, so the loaded values are spot-checked before the configuration is skipped
+        bool from_user_set = !user_set.empty() && user_set_cache && user_set_cache->matches(this->get_profile().serial, user_set, settings_hash) &&
+                             is_user_set_default(node_map, user_set) && load_user_set(node_map, user_set) == 0 &&
+                             check_loaded_profile(node_map, this->get_profile()) == 0;
+
+        if (from_user_set)
+        {
+            cout << "Settings unchanged since they were saved into " << user_set << ", skipping the configuration" << endl;
+        }
+        else if (validate_camera_profile(node_map, pointer_cam->GetTLStreamNodeMap(), this->get_profile()) != 0) // Against the camera limits
+        {
+            cout << "Camera settings do not fit this camera. Skipping it" << endl << endl;
+            pointer_cam->DeInit();
+            return -1;
+        }
+        else
+        {
+            cout << "Running pixel format function" << endl;
+            result = result | camera_control::config_pixel_format(node_map, this->get_profile().pixel_format); // Pixel Format
+
+            cout << "Running camera settings" << endl;
+            if (this->get_profile().has(PROFILE_ROIS))
+            {
+                const ROI_SETTINGS& roi = this->get_profile().rois[0]; // First roi of the settings file
+                result = result | camera_control::config_roi(node_map, roi.width, roi.height, roi.offset_x, roi.offset_y);
+            }
+            else
+            {
+                result = result | camera_control::config_roi(node_map, tool.roi_width, tool.roi_height); // Width, Height[pixels]
+            }
+            result = result | this->config_camera(node_map); // Exposure, gain, gamma and the sensor specific settings from the settings file
+
+            if (!user_set.empty() && result == 0 && save_user_set(node_map, user_set) == 0 && user_set_cache) // Next startups load it instead
+            {
+                user_set_cache->store(this->get_profile().serial, user_set, settings_hash);
+            }
+        }
+        result = result | config_stream_buffers(pointer_cam->GetTLStreamNodeMap(), this->get_profile()); // Buffer count and handling mode, if given (host side, not in the UserSet)
+
+        auto config_end_time = chrono::steady_clock::now();
+        log_info(log_tag("Startup"), "Init {} ms, configuration {} ms ({})",
+                 chrono::duration<double, milli>(init_end_time - startup_time).count(),
+                 chrono::duration<double, milli>(config_end_time - init_end_time).count(),
+                 from_user_set ? "loaded " + user_set : "every setting written");
+
+        cout << "Running acquire images function \n" << endl;
+        if (burst_config.frame_count > 0 || burst_config.seconds > 0.0)
+        {
+            result = result | burst_images(pointer_cam, node_map, node_map_tl_device, burst_config); // Burst into RAM instead of the continuous capture
+        }
+        else
+        {
+            result = result | acquire_images(pointer_cam, node_map, node_map_tl_device, frame_writer, frame_sinks, save_images, latency_monitor,
+                                             metrics_server, settings_watcher, this->get_profile()); // Calling out acquire_images function and checking if it returns 0
+        }
+        
+        if (result == 0)
+        {
+            cout << "Running reset exposure function" << endl;
+            result = result | camera_control::reset_exposure(node_map);  // Calling out reset_exposure function and checking if it returns 0
+        }
+        else
+        {
+            cout << "Skipping exposure reset" << endl << endl;
+        }
+
+        cout << "Deinitialize camera \n" << endl;
+        pointer_cam->DeInit();  // Deinitialize camera
+    }
+
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+// This function is the main function of the infinity capture tools: options and frame sinks, then every camera in turn
+template <class CAMERA_TYPE>
+int INFINITY_CAPTURE<CAMERA_TYPE>::run(int argc, char** argv, const INFINITY_CAPTURE_TOOL& tool)
+{
+    int result = 0;
+
+    SystemPtr system = System::GetInstance(); // Retrieve singleton reference to system object
+
+    CameraList camera_list = system->GetCameras(); // Retrieve list of cameras from the system
+
+    unsigned int num_cameras = camera_list.GetSize();
+
+    cout << "Number of cameras detected: " << num_cameras << endl << endl;
+
+    if (num_cameras == 0)   // Finish if there are no cameras
+    {
+        camera_list.Clear();    // Release camera list before releasing system
+        system->ReleaseInstance();  // Release system
+
+        cout << "Not enough cameras!" << endl;
+        cout << "Done! Press Enter to exit" << endl;
+        getchar();
+
+        return -1;
+    }
+
+    INFINITY_CAPTURE<CAMERA_TYPE> camera_config(tool); // Create camera instance because we are using class functions and not static functions
+
+    COMMAND_LINE command_line(argc, argv);
+
+    // --config=<file> -> camera settings: [defaults] and [camera <serial>] sections (see Common/camera_config_file.h)
+    string settings_path = command_line.get_string("config", tool.default_settings_path);
+    vector<string> file_content = camera_config.load_from_file(settings_path);
+    if (camera_config.get_values(file_content) != 0) // Extract values from the file content, before anything is allocated
+    {
+        cout << "Invalid camera settings file" << endl;
+        camera_list.Clear();
+        system->ReleaseInstance();
+        return -1;
+    }
+
+    // Largest frame of any camera: the ROIs of the settings file or the ROI of the tool
+    size_t frame_bytes = static_cast<size_t>(max(tool.roi_width * tool.roi_height, camera_config.get_config_file().get_max_roi_pixels())) * CAMERA_TYPE::get_bytes_per_pixel();
+
+    // --record=<folder> -> additionally record every frame into preallocated O_DIRECT segment files (--segment-mb=<size>)
+    string record_path = command_line.get_string("record", "");
+    // --pretrigger=<folder> -> keep the last --pre-seconds in RAM and only save frames around events ('t' key, --control FIFO, --image-trigger)
+    string pretrigger_path = command_line.get_string("pretrigger", "");
+    // --video=<folder> -> record into rotating AVI files per camera/ROI instead of a file per frame (--video-seconds=<n>)
+    string video_path = command_line.get_string("video", "");
+    // --writer=jpeg (default, Image::Save) | uring | pwrite -> raw frames through the asynchronous frame writer | none
+    string writer_name = command_line.get_string("writer", record_path.empty() && pretrigger_path.empty() && video_path.empty() ? "jpeg" : "none");
+    unique_ptr<FRAME_WRITER> frame_writer;
+    unique_ptr<SEGMENT_RECORDER> segment_recorder;
+    unique_ptr<COMPRESSION_STAGE> compression_stage;   // Feeds segment_recorder, so it is destroyed first
+    unique_ptr<PRETRIGGER_RING> pretrigger_ring;
+    unique_ptr<VIDEO_RECORDER> video_recorder;
+    unique_ptr<SHM_FRAME_PUBLISHER> shm_publisher;
+    unique_ptr<FRAME_STREAM_SERVER> stream_server;
+    CONTROL_FIFO control_fifo;
+    SETTINGS_WATCHER settings_watcher;
+    USER_SET_CACHE user_set_cache;
+
+    camera_config.set_save_images(writer_name != "none");
+
+    if (writer_name != "jpeg" && writer_name != "none")
+    {
+        FRAME_WRITER_BACKEND writer_backend;
+        if (!parse_frame_writer_backend(writer_name, writer_backend))
+        {
+            cerr << "Unknown writer: " << writer_name << ". Use jpeg, uring, pwrite or none.\n";
+            camera_list.Clear();
+            system->ReleaseInstance();
+            return -1;
+        }
+
+        frame_writer = create_frame_writer(default_frame_writer_config(writer_backend, frame_bytes));
+        if (!frame_writer)
+        {
+            cerr << "Failed to create frame writer. Exiting.\n";
+            camera_list.Clear();
+            system->ReleaseInstance();
+            return -1;
+        }
+        camera_config.set_frame_writer(frame_writer.get());
+    }
+
+    if (!record_path.empty())
+    {
+        size_t record_frame_bytes = frame_bytes;
+        // --compress=lz4|zstd -> compress the recorded frames losslessly (--compress-level=<n>, --compress-threads=<n>)
+        string codec_name = command_line.get_string("compress", "none");
+        COMPRESSION_CODEC compression_codec = COMPRESSION_NONE;
+        if (!parse_compression_codec(codec_name, compression_codec))
+        {
+            cerr << "Unknown codec: " << codec_name << ". Use none, lz4 or zstd.\n";
+            camera_list.Clear();
+            system->ReleaseInstance();
+            return -1;
+        }
+        if (!is_compression_codec_available(compression_codec))
+        {
+            cerr << "Built without " << codec_name << " (library not found at build time).\n";
+            camera_list.Clear();
+            system->ReleaseInstance();
+            return -1;
+        }
+
+        SEGMENT_RECORDER_CONFIG recorder_config = default_segment_recorder_config(record_path, compression_codec == COMPRESSION_NONE ?
+                                                                                  record_frame_bytes : get_max_compressed_frame_size(record_frame_bytes));
+        recorder_config.segment_size = static_cast<uint64_t>(command_line.get_int("segment-mb", 1024)) * 1024 * 1024;
+
+        segment_recorder.reset(new SEGMENT_RECORDER());
+        if (segment_recorder->init(recorder_config) == 0)
+        {
+            FRAME_SINK* record_sink = segment_recorder.get();
+            if (compression_codec != COMPRESSION_NONE)
+            {
+                COMPRESSION_CONFIG compression_config = default_compression_config(compression_codec, record_frame_bytes);
+                compression_config.level = static_cast<int>(command_line.get_int("compress-level", compression_config.level));
+                compression_config.threads = static_cast<unsigned int>(max(1LL, command_line.get_int("compress-threads", compression_config.threads)));
+
+                compression_stage.reset(new COMPRESSION_STAGE());
+                if (compression_stage->init(compression_config, segment_recorder.get(), recorder_config.buffer_count) == 0)
+                {
+                    record_sink = compression_stage.get();
+                }
+                else
+                {
+                    cout << "Unable to start the compression stage, recording uncompressed" << endl;
+                    compression_stage.reset();
+                }
+            }
+            camera_config.add_frame_sink(record_sink);
+        }
+        else
+        {
+            cout << "Unable to start the segment recorder, recording disabled" << endl;
+            segment_recorder.reset();
+        }
+    }
+
+    if (!video_path.empty())
+    {
+        VIDEO_RECORDER_CONFIG video_config = default_video_recorder_config(video_path, frame_bytes);
+        video_config.segment_seconds = command_line.get_double("video-seconds", video_config.segment_seconds);
+
+        video_recorder.reset(new VIDEO_RECORDER());
+        if (video_recorder->init(video_config) == 0)
+        {
+            camera_config.add_frame_sink(video_recorder.get());
+        }
+        else
+        {
+            cout << "Unable to start the video recorder, video recording disabled" << endl;
+            video_recorder.reset();
+        }
+    }
+
+    // --shm=<name> -> publish every frame to a shared memory ring (--shm-slots=<n>) for local viewers/processing
+    if (command_line.has("shm"))
+    {
+        string shm_name = command_line.get_string("shm", "/spinnaker_frames");
+        if (shm_name.empty())
+        {
+            shm_name = "/spinnaker_frames";
+        }
+        else if (shm_name[0] != '/')
+        {
+            shm_name = "/" + shm_name;
+        }
+
+        shm_publisher.reset(new SHM_FRAME_PUBLISHER());
+        unsigned int shm_slots = static_cast<unsigned int>(max(1LL, command_line.get_int("shm-slots", 8)));
+        if (shm_publisher->init(shm_name, shm_slots, frame_bytes) == 0)
+        {
+            camera_config.add_frame_sink(shm_publisher.get());
+        }
+        else
+        {
+            cout << "Unable to create the shared memory ring, publishing disabled" << endl;
+            shm_publisher.reset();
+        }
+    }
+
+    // --stream=<port|host:port|unix:/path> -> serve frames to local clients (FrameStreamClient), --stream-buffers=<n>
+    if (command_line.has("stream"))
+    {
+        FRAME_STREAM_CONFIG stream_config = default_frame_stream_config(command_line.get_string("stream", "5600"), frame_bytes);
+        stream_config.packet_count = static_cast<unsigned int>(max(1LL, command_line.get_int("stream-buffers", stream_config.packet_count)));
+
+        stream_server.reset(new FRAME_STREAM_SERVER());
+        if (stream_server->init(stream_config) == 0)
+        {
+            camera_config.add_frame_sink(stream_server.get());
+        }
+        else
+        {
+            cout << "Unable to start the frame stream server, streaming disabled" << endl;
+            stream_server.reset();
+        }
+    }
+
+    // --burst-frames=<n> | --burst-seconds=<s> -> capture into RAM at sensor rate, then drain to --burst-dir with --drain-threads
+    if (command_line.has("burst-frames") || command_line.has("burst-seconds"))
+    {
+        BURST_CONFIG burst_config;
+        burst_config.frame_count = static_cast<unsigned int>(command_line.get_int("burst-frames", 0));
+        burst_config.seconds = command_line.get_double("burst-seconds", 0.0);
+        burst_config.drain_threads = static_cast<unsigned int>(command_line.get_int("drain-threads", 4));
+        burst_config.folder_path = command_line.get_string("burst-dir", "/folder/path/to/save/images");
+        burst_config.use_direct_io = true;
+        camera_config.set_burst_config(burst_config);
+    }
+
+    if (!pretrigger_path.empty())
+    {
+        PRETRIGGER_RING_CONFIG ring_config = default_pretrigger_ring_config(pretrigger_path, frame_bytes);
+        ring_config.pre_seconds = command_line.get_double("pre-seconds", ring_config.pre_seconds);
+        ring_config.post_seconds = command_line.get_double("post-seconds", ring_config.post_seconds);
+        ring_config.frame_rate = command_line.get_double("ring-fps", 2.0); // The capture loop paces itself to about 2 fps
+        ring_config.image_trigger_threshold = command_line.get_double("image-trigger", 0.0);
+        ring_config.max_streams = num_cameras;
+
+        pretrigger_ring.reset(new PRETRIGGER_RING());
+        if (pretrigger_ring->init(ring_config) == 0)
+        {
+            camera_config.add_frame_sink(pretrigger_ring.get());
+
+            if (command_line.has("control"))
+            {
+                PRETRIGGER_RING* ring = pretrigger_ring.get();
+                control_fifo.start(command_line.get_string("control", ""), [ring](const string& command)
+                {
+                    if (command.compare(0, 7, "trigger") == 0)
+                    {
+                        ring->trigger("control command");
+                    }
+                    else
+                    {
+                        cout << "Unknown control command: " << command << endl;
+                    }
+                });
+            }
+        }
+        else
+        {
+            cout << "Unable to start the pre-trigger ring, event recording disabled" << endl;
+            pretrigger_ring.reset();
+        }
+    }
+
+    // --latency=<seconds> -> print p50/p99/p999/max per stage every <seconds> (0 -> only at exit)
+    LATENCY_MONITOR latency_monitor;
+    latency_monitor.start(tool.name, command_line.get_double("latency", 10.0));
+    camera_config.set_latency_monitor(&latency_monitor);
+
+    // --metrics=<port> -> Prometheus metrics (fps, drops, queue depth, temperature, link throughput) on http://127.0.0.1:<port>/metrics
+    METRICS_SERVER metrics_server;
+    if (command_line.has("metrics"))
+    {
+        metrics_server.set_frame_writer(frame_writer.get());
+        if (metrics_server.init(static_cast<unsigned int>(command_line.get_int("metrics", 9100))) == 0)
+        {
+            camera_config.add_frame_sink(&metrics_server);
+            camera_config.set_metrics_server(&metrics_server);
+        }
+        else
+        {
+            cout << "Unable to start the metrics endpoint, metrics disabled" << endl;
+        }
+    }
+
+    // --log=<file> -> per-frame messages through the asynchronous logger into a file instead of the console, --log-level=debug|info|warning|error
+    LOG_CONFIG log_config = default_log_config();
+    log_config.path = command_line.get_string("log", "");
+    if (!parse_log_level(command_line.get_string("log-level", "info"), log_config.min_level))
+    {
+        cout << "Unknown log level, using info" << endl;
+    }
+    if (ASYNC_LOGGER::start(log_config) != 0)
+    {
+        cout << "Unable to open the log file, logging to the console" << endl;
+    }
+
+    // --user-set[=UserSet1] -> save the configuration into the camera's UserSet and boot into it, later startups only load it (--user-set-cache=<file>)
+    if (command_line.has("user-set"))
+    {
+        user_set_cache.load(command_line.get_string("user-set-cache", settings_path + ".userset"));
+        string user_set_name = command_line.get_string("user-set", "");
+        camera_config.set_user_set(user_set_name.empty() ? "UserSet1" : user_set_name, &user_set_cache);
+    }
+
+    // --watch-config -> apply changes of the settings file to the streaming camera between frames (exposure, gain, gamma, frame rate, outputs)
+    if (command_line.has("watch-config"))
+    {
+        if (settings_watcher.start(settings_path) == 0)
+        {
+            camera_config.set_settings_watcher(&settings_watcher);
+        }
+        else
+        {
+            cout << "Unable to watch the settings file, changes need a restart" << endl;
+        }
+    }
+
+    for (unsigned int i = 0; i < num_cameras; i++)  // Run configuration on each camera
+    {
+        cout << "Running configuration for camera " << i << "..." << endl;
+
+        result = result | camera_config.run_single_camera(camera_list.GetByIndex(i));
+
+        cout << "Camera " << i << " configuration complete" << endl;
+    }
+
+    if (video_recorder)
+    {
+        VIDEO_RECORDER_STATS stats = video_recorder->get_stats();
+        cout << "Video: " << stats.frames_recorded << " frames in " << stats.segments_opened << " file(s), "
+             << stats.stalls << " stalls, " << stats.errors << " errors" << endl;
+    }
+
+    if (compression_stage)
+    {
+        COMPRESSION_STATS stats = compression_stage->get_stats();
+        cout << "Compression: " << stats.frames << " frames, ratio "
+             << (stats.compressed_bytes > 0 ? static_cast<double>(stats.raw_bytes) / stats.compressed_bytes : 0.0) << ", "
+             << (stats.cpu_seconds > 0.0 ? stats.raw_bytes / stats.cpu_seconds / (1024.0 * 1024.0) : 0.0) << " MB/s per core, "
+             << stats.stalls << " stalls" << endl;
+    }
+
+    if (stream_server)
+    {
+        FRAME_STREAM_STATS stats = stream_server->get_stats();
+        cout << "Frame stream: " << stats.clients_accepted << " client(s), " << stats.frames_sent << " frames sent, "
+             << stats.frames_dropped << " dropped for slow clients" << endl;
+        stream_server->stop();
+    }
+
+    if (shm_publisher)
+    {
+        cout << "Shared memory ring: " << shm_publisher->get_published_count() << " frames published" << endl;
+    }
+
+    if (pretrigger_ring)
+    {
+        control_fifo.stop();
+        PRETRIGGER_RING_STATS stats = pretrigger_ring->get_stats();
+        cout << "Pre-trigger ring: " << stats.events << " event(s), " << stats.frames_buffered << " frames buffered, "
+             << stats.frames_flushed << " saved, " << stats.frames_dropped << " dropped" << endl;
+    }
+
+    settings_watcher.stop();
+    latency_monitor.stop(); // Percentiles of the whole run
+    ASYNC_LOGGER::stop();   // Write the queued messages
+
+    camera_list.Clear();    // Release camera list before releasing system
+
+    system->ReleaseInstance();  // Release system
+
+    cout << "Done! Press Enter to exit" << endl;
+    getchar();
+
+    return result;
+}
+
+#endif // INFINITY_CAPTURE_H
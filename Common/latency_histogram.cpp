@@ -0,0 +1,315 @@
+// Description: Lock-free latency histograms per acquisition stage with periodic percentile reports
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "latency_histogram.h"
+
+using namespace std;
+
+/**
+ * Returns the name of a stage as printed in the reports.
+ * @param stage: The stage.
+ * @return The name.
+ */
+const char* get_latency_stage_name(LATENCY_STAGE stage)
+{
+    switch (stage)
+    {
+        case LATENCY_EXPOSURE_TO_ARRIVAL:
+            return "exposure_to_arrival";
+        case LATENCY_GRAB_WAIT:
+            return "grab_wait";
+        case LATENCY_CONVERSION:
+            return "conversion";
+        case LATENCY_ENCODE:
+            return "encode";
+        case LATENCY_WRITE:
+            return "write";
+        case LATENCY_DISPLAY:
+            return "display";
+        case LATENCY_END_TO_END:
+            return "end_to_end";
+        default:
+            return "unknown";
+    }
+}
+
+/**
+ * Constructor for the LATENCY_HISTOGRAM class.
+ */
+LATENCY_HISTOGRAM::LATENCY_HISTOGRAM() : total_ns(0), max_value_ns(0)
+{
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        counts[i].store(0, memory_order_relaxed);
+    }
+}
+
+/**
+ * Copies the bucket counts (a consistent enough view while the histogram is written: each count is read once).
+ * @param destination: Receives BUCKET_COUNT counts.
+ */
+void LATENCY_HISTOGRAM::copy_counts(vector<uint64_t>& destination) const
+{
+    destination.resize(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        destination[i] = counts[i].load(memory_order_relaxed);
+    }
+}
+
+uint64_t LATENCY_HISTOGRAM::get_sum() const
+{
+    return total_ns.load(memory_order_relaxed);
+}
+
+uint64_t LATENCY_HISTOGRAM::get_max() const
+{
+    return max_value_ns.load(memory_order_relaxed);
+}
+
+/**
+ * Returns the highest value that is counted in a bucket, so percentiles are never reported too low.
+ * @param index: The bucket index.
+ * @return The value in nanoseconds.
+ */
+uint64_t LATENCY_HISTOGRAM::get_bucket_value(size_t index)
+{
+    const size_t sub_bucket_count = static_cast<size_t>(1) << SUB_BUCKET_BITS;
+    if (index < sub_bucket_count)
+    {
+        return index;
+    }
+
+    size_t shift = (index >> (SUB_BUCKET_BITS - 1)) - 1;
+    uint64_t sub_bucket = index - (shift << (SUB_BUCKET_BITS - 1));
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+/**
+ * Computes count, mean and percentiles from bucket counts.
+ * @param bucket_counts: Counts per bucket.
+ * @param sum_ns: Sum of the recorded values (for the mean).
+ * @param max_ns: Exact maximum if known, 0 -> the highest value of the last non-empty bucket.
+ * @return The summary.
+ */
+LATENCY_SUMMARY LATENCY_HISTOGRAM::summarize(const vector<uint64_t>& bucket_counts, uint64_t sum_ns, uint64_t max_ns)
+{
+    LATENCY_SUMMARY summary = {0, 0.0, 0, 0, 0, 0};
+
+    for (uint64_t count : bucket_counts)
+    {
+        summary.count += count;
+    }
+    if (summary.count == 0)
+    {
+        return summary;
+    }
+
+    summary.mean_ns = static_cast<double>(sum_ns) / summary.count;
+
+    // Rank of each percentile, rounded up so p999 of 100 samples is the largest one
+    const double percents[3] = {50.0, 99.0, 99.9};
+    uint64_t* results[3] = {&summary.p50_ns, &summary.p99_ns, &summary.p999_ns};
+    uint64_t ranks[3];
+    for (int p = 0; p < 3; p++)
+    {
+        ranks[p] = static_cast<uint64_t>(percents[p] / 100.0 * summary.count + 0.999999);
+        if (ranks[p] == 0)
+        {
+            ranks[p] = 1;
+        }
+    }
+
+    uint64_t seen = 0;
+    int p = 0;
+    size_t last_bucket = 0;
+    for (size_t i = 0; i < bucket_counts.size(); i++)
+    {
+        if (bucket_counts[i] == 0)
+        {
+            continue;
+        }
+        seen += bucket_counts[i];
+        last_bucket = i;
+        while (p < 3 && seen >= ranks[p])
+        {
+            *results[p] = get_bucket_value(i);
+            p++;
+        }
+    }
+
+    summary.max_ns = max_ns > 0 ? max_ns : get_bucket_value(last_bucket);
+
+    // The bucket value rounds up, the exact maximum caps it
+    for (int q = 0; q < 3; q++)
+    {
+        if (*results[q] > summary.max_ns)
+        {
+            *results[q] = summary.max_ns;
+        }
+    }
+    return summary;
+}
+
+/**
+ * Constructor for the LATENCY_MONITOR class.
+ */
+LATENCY_MONITOR::LATENCY_MONITOR() : interval_seconds(0.0), running(false)
+{
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++)
+    {
+        reported_counts[i].assign(LATENCY_HISTOGRAM::BUCKET_COUNT, 0);
+        reported_sum_ns[i] = 0;
+    }
+}
+
+/**
+ * Destructor for the LATENCY_MONITOR class -> stops the report thread (prints the final report if it was started).
+ */
+LATENCY_MONITOR::~LATENCY_MONITOR()
+{
+    stop();
+}
+
+/**
+ * Starts the periodic reports.
+ * @param name: Printed in front of every report (e.g. the camera serial).
+ * @param report_interval_seconds: Seconds between reports, 0 -> only the report at stop().
+ * @return 0 if successful, -1 otherwise.
+ */
+int LATENCY_MONITOR::start(const string& name, double report_interval_seconds)
+{
+    if (running)
+    {
+        return -1;
+    }
+
+    monitor_name = name;
+    interval_seconds = report_interval_seconds;
+    start_time = chrono::steady_clock::now();
+    report_time = start_time;
+    running = true;
+
+    if (interval_seconds > 0.0)
+    {
+        report_thread = thread(&LATENCY_MONITOR::report_loop, this);
+    }
+    return 0;
+}
+
+/**
+ * Stops the periodic reports and prints the percentiles since start.
+ */
+void LATENCY_MONITOR::stop()
+{
+    {
+        lock_guard<mutex> lock(report_mutex);
+        if (!running)
+        {
+            return;
+        }
+        running = false;
+    }
+    report_condition.notify_all();
+
+    if (report_thread.joinable())
+    {
+        report_thread.join();
+    }
+
+    print_report(cout, false);
+}
+
+/**
+ * Returns the percentiles of a stage since start.
+ * @param stage: The stage.
+ * @return The summary.
+ */
+LATENCY_SUMMARY LATENCY_MONITOR::get_summary(LATENCY_STAGE stage) const
+{
+    vector<uint64_t> counts;
+    histograms[stage].copy_counts(counts);
+    return LATENCY_HISTOGRAM::summarize(counts, histograms[stage].get_sum(), histograms[stage].get_max());
+}
+
+/**
+ * Background thread: prints the percentiles of the last interval every interval_seconds.
+ */
+void LATENCY_MONITOR::report_loop()
+{
+    unique_lock<mutex> lock(report_mutex);
+    while (running)
+    {
+        if (report_condition.wait_for(lock, chrono::duration<double>(interval_seconds), [this] { return !running; }))
+        {
+            break;
+        }
+        lock.unlock();
+        print_report(cout, true);
+        lock.lock();
+    }
+}
+
+/**
+ * Prints one line per stage with samples: count, mean, p50, p99, p999 and max in microseconds.
+ * @param out: The stream.
+ * @param interval_only: true -> only what was recorded since the last periodic report, false -> since start.
+ */
+void LATENCY_MONITOR::print_report(ostream& out, bool interval_only)
+{
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    double seconds = chrono::duration<double>(now - (interval_only ? report_time : start_time)).count();
+
+    ostringstream report;   // One write, so the report is not interleaved with the acquisition output
+    report << fixed << setprecision(1);
+    report << "[Latency] " << monitor_name << (interval_only ? ", last " : ", total ") << seconds << " s (us):" << endl;
+    report << "  " << left << setw(22) << "stage" << right << setw(10) << "count" << setw(11) << "mean" << setw(11) << "p50"
+           << setw(11) << "p99" << setw(11) << "p999" << setw(11) << "max" << endl;
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        vector<uint64_t> counts;
+        histograms[stage].copy_counts(counts);
+
+        LATENCY_SUMMARY summary;
+        if (interval_only)
+        {
+            // Difference to the last report; the max of the interval is the upper end of its last bucket
+            uint64_t sum_ns = histograms[stage].get_sum();
+            vector<uint64_t> interval_counts(counts.size());
+            for (size_t i = 0; i < counts.size(); i++)
+            {
+                interval_counts[i] = counts[i] - reported_counts[stage][i];
+            }
+            summary = LATENCY_HISTOGRAM::summarize(interval_counts, sum_ns - reported_sum_ns[stage], 0);
+            reported_counts[stage].swap(counts);
+            reported_sum_ns[stage] = sum_ns;
+        }
+        else
+        {
+            summary = get_summary(static_cast<LATENCY_STAGE>(stage));
+        }
+
+        if (summary.count == 0)
+        {
+            continue;
+        }
+
+        report << "  " << left << setw(22) << get_latency_stage_name(static_cast<LATENCY_STAGE>(stage)) << right << setw(10) << summary.count
+               << setw(11) << summary.mean_ns / 1000.0 << setw(11) << summary.p50_ns / 1000.0 << setw(11) << summary.p99_ns / 1000.0
+               << setw(11) << summary.p999_ns / 1000.0 << setw(11) << summary.max_ns / 1000.0 << endl;
+    }
+
+    if (interval_only)
+    {
+        report_time = now;
+    }
+    out << report.str() << flush;
+}
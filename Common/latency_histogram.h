@@ -0,0 +1,164 @@
+// latency_histogram.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Stages of the acquisition loop that get a histogram
+enum LATENCY_STAGE
+{
+    LATENCY_EXPOSURE_TO_ARRIVAL = 0,    // Camera timestamp of the frame -> GetNextImage returned (needs the camera clock offset)
+    LATENCY_GRAB_WAIT,                  // Time blocked in GetNextImage
+    LATENCY_CONVERSION,                 // ImageProcessor::Convert
+    LATENCY_ENCODE,                     // Image::Save (JPEG encoding including the file write)
+    LATENCY_WRITE,                      // Frame sinks and frame writer handoff
+    LATENCY_DISPLAY,                    // GetNextImage returned -> frame shown in the preview window (trackbar tools)
+    LATENCY_END_TO_END,                 // Camera timestamp -> frame saved or handed off (needs the camera clock offset)
+    LATENCY_STAGE_COUNT
+};
+
+// Percentiles of a histogram (or of the part recorded since the last report)
+struct LATENCY_SUMMARY
+{
+    uint64_t count;
+    double mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+// HDR style histogram of nanosecond values: 128 linear steps per power of two (below 1 % error) from 1 ns to 2^42 ns (73 min).
+// Recording is a bit scan and a few relaxed loads/stores, no locks or read-modify-write instructions, so every histogram
+// has exactly one writing thread. Any thread may read it while it is written.
+class LATENCY_HISTOGRAM
+{
+    public:
+        static const unsigned int SUB_BUCKET_BITS = 7;
+        static const unsigned int MAX_MAGNITUDE = 42;   // Larger values are counted in the last bucket
+        static const size_t BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) << (SUB_BUCKET_BITS - 1);
+
+    private:
+        atomic<uint64_t> counts[BUCKET_COUNT];
+        atomic<uint64_t> total_ns;
+        atomic<uint64_t> max_value_ns;
+
+    public:
+        LATENCY_HISTOGRAM();
+
+        inline void record(uint64_t value_ns);
+        void copy_counts(vector<uint64_t>& destination) const;
+        uint64_t get_sum() const;
+        uint64_t get_max() const;
+
+        static inline size_t get_bucket_index(uint64_t value_ns);
+        static uint64_t get_bucket_value(size_t index);     // Highest value counted in a bucket
+        static LATENCY_SUMMARY summarize(const vector<uint64_t>& bucket_counts, uint64_t sum_ns, uint64_t max_ns);
+};
+
+// One histogram per LATENCY_STAGE, reported every interval_seconds (percentiles of that interval) and on stop() (since start).
+// record() is called from the acquisition loop, the reports come from a background thread.
+class LATENCY_MONITOR
+{
+    private:
+        LATENCY_HISTOGRAM histograms[LATENCY_STAGE_COUNT];
+        vector<uint64_t> reported_counts[LATENCY_STAGE_COUNT];  // Counts at the last periodic report
+        uint64_t reported_sum_ns[LATENCY_STAGE_COUNT];
+        string monitor_name;
+        double interval_seconds;
+        chrono::steady_clock::time_point start_time;
+        chrono::steady_clock::time_point report_time;
+
+        mutex report_mutex;
+        condition_variable report_condition;
+        bool running;
+        thread report_thread;
+
+        void report_loop();
+        void print_report(ostream& out, bool interval_only);
+
+    public:
+        LATENCY_MONITOR();
+        ~LATENCY_MONITOR();
+
+        int start(const string& name, double report_interval_seconds);     // 0 -> only the report at stop()
+        void stop();                                                        // Prints the percentiles since start
+
+        inline void record(LATENCY_STAGE stage, uint64_t value_ns);
+        LATENCY_SUMMARY get_summary(LATENCY_STAGE stage) const;             // Since start
+};
+
+const char* get_latency_stage_name(LATENCY_STAGE stage);
+
+/**
+ * Current time of the host clock the latencies are measured with.
+ * @return steady_clock time in nanoseconds.
+ */
+inline uint64_t latency_now_ns()
+{
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Maps a value to its bucket.
+ * @param value_ns: The value.
+ * @return The bucket index, values beyond the range go to the last bucket.
+ */
+inline size_t LATENCY_HISTOGRAM::get_bucket_index(uint64_t value_ns)
+{
+    const uint64_t sub_bucket_count = 1ULL << SUB_BUCKET_BITS;
+    if (value_ns < sub_bucket_count)
+    {
+        return static_cast<size_t>(value_ns);   // Exact below 128 ns
+    }
+
+    unsigned int magnitude = 63 - __builtin_clzll(value_ns);
+    if (magnitude >= MAX_MAGNITUDE)
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    // Keep the top SUB_BUCKET_BITS bits: [64, 127] after the shift, each power of two adds 64 buckets
+    unsigned int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    return (static_cast<size_t>(shift) << (SUB_BUCKET_BITS - 1)) + static_cast<size_t>(value_ns >> shift);
+}
+
+/**
+ * Records one value. Only to be called from the thread that owns the histogram.
+ * @param value_ns: The latency in nanoseconds.
+ */
+inline void LATENCY_HISTOGRAM::record(uint64_t value_ns)
+{
+    atomic<uint64_t>& count = counts[get_bucket_index(value_ns)];
+    count.store(count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    total_ns.store(total_ns.load(memory_order_relaxed) + value_ns, memory_order_relaxed);
+    if (value_ns > max_value_ns.load(memory_order_relaxed))
+    {
+        max_value_ns.store(value_ns, memory_order_relaxed);
+    }
+}
+
+/**
+ * Records one value for a stage. Only to be called from the acquisition thread.
+ * @param stage: The stage.
+ * @param value_ns: The latency in nanoseconds.
+ */
+inline void LATENCY_MONITOR::record(LATENCY_STAGE stage, uint64_t value_ns)
+{
+    histograms[stage].record(value_ns);
+}
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,146 @@
+// latest_value_slot.h Header File -> Single slot handoff between two threads where only the newest value counts
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef LATEST_VALUE_SLOT_H
+#define LATEST_VALUE_SLOT_H
+
+// Header only because it is a template.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+using namespace std;
+
+// One value passed from a producer thread to a consumer thread. A value that was not taken yet is replaced by the next
+// publish() and handed back to the producer (e.g. to release a camera buffer), so the consumer never works on a stale
+// value and the producer never waits for it.
+template <typename T>
+class LATEST_VALUE_SLOT
+{
+    private:
+        mutable mutex slot_mutex;
+        condition_variable slot_condition;
+        T value;
+        bool full;
+        bool closed;
+        uint64_t published_count;
+        uint64_t replaced_count;
+
+    public:
+        LATEST_VALUE_SLOT() : value(), full(false), closed(false), published_count(0), replaced_count(0) {}
+
+        bool publish(T& new_value);     // true if a value was replaced, new_value then holds it
+        bool take(T& taken_value);      // Waits for a value, false once closed and empty
+        bool take(T& taken_value, chrono::milliseconds timeout);    // false on timeout, or closed and empty
+        void close();                   // Wakes the consumer, values left can still be taken
+
+        uint64_t get_published_count() const;
+        uint64_t get_replaced_count() const;    // Values that were never taken
+};
+
+/**
+ * Puts a value into the slot.
+ * @param new_value: The value, swapped with the one in the slot.
+ * @return true if the slot held a value that was not taken (new_value holds it now), false otherwise.
+ */
+template <typename T>
+bool LATEST_VALUE_SLOT<T>::publish(T& new_value)
+{
+    bool replaced;
+    {
+        lock_guard<mutex> lock(slot_mutex);
+        swap(value, new_value);
+        replaced = full;
+        full = true;
+        published_count++;
+        if (replaced)
+        {
+            replaced_count++;
+        }
+    }
+    slot_condition.notify_one();
+    return replaced;
+}
+
+/**
+ * Takes the value, waiting until there is one.
+ * @param taken_value: Receives the value.
+ * @return true if a value was taken, false if the slot was closed and is empty.
+ */
+template <typename T>
+bool LATEST_VALUE_SLOT<T>::take(T& taken_value)
+{
+    unique_lock<mutex> lock(slot_mutex);
+    slot_condition.wait(lock, [this] { return full || closed; });
+    if (!full)
+    {
+        return false;
+    }
+
+    swap(taken_value, value);
+    value = T();    // Do not keep the previous value of taken_value alive in the slot
+    full = false;
+    return true;
+}
+
+/**
+ * Takes the value, waiting at most timeout for one.
+ * @param taken_value: Receives the value.
+ * @param timeout: How long to wait, 0 -> only check.
+ * @return true if a value was taken, false on timeout or if the slot was closed and is empty.
+ */
+template <typename T>
+bool LATEST_VALUE_SLOT<T>::take(T& taken_value, chrono::milliseconds timeout)
+{
+    unique_lock<mutex> lock(slot_mutex);
+    if (!slot_condition.wait_for(lock, timeout, [this] { return full || closed; }) || !full)
+    {
+        return false;
+    }
+
+    swap(taken_value, value);
+    value = T();
+    full = false;
+    return true;
+}
+
+/**
+ * Closes the slot: a waiting consumer wakes up, take() returns false once the last value is taken.
+ */
+template <typename T>
+void LATEST_VALUE_SLOT<T>::close()
+{
+    {
+        lock_guard<mutex> lock(slot_mutex);
+        closed = true;
+    }
+    slot_condition.notify_all();
+}
+
+/**
+ * Returns how many values were published.
+ * @return The count since construction.
+ */
+template <typename T>
+uint64_t LATEST_VALUE_SLOT<T>::get_published_count() const
+{
+    lock_guard<mutex> lock(slot_mutex);
+    return published_count;
+}
+
+/**
+ * Returns how many values were replaced before they were taken.
+ * @return The count since construction.
+ */
+template <typename T>
+uint64_t LATEST_VALUE_SLOT<T>::get_replaced_count() const
+{
+    lock_guard<mutex> lock(slot_mutex);
+    return replaced_count;
+}
+
+#endif // LATEST_VALUE_SLOT_H
@@ -0,0 +1,459 @@
+// Description: Local HTTP endpoint with per-camera and writer metrics in the Prometheus text format
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "latency_histogram.h"
+#include "metrics_server.h"
+
+using namespace std;
+
+/**
+ * Constructor for the CAMERA_METRICS class.
+ */
+CAMERA_METRICS::CAMERA_METRICS()
+    : has_frame_id(false), last_frame_id(0), window_start_ns(0), window_frames(0), frames(0), bytes(0), incomplete(0), dropped(0),
+      frames_per_second(0.0), fps_time_ns(0), temperature_c(numeric_limits<double>::quiet_NaN()),
+      link_throughput(numeric_limits<double>::quiet_NaN())
+{
+    serial[0] = '\0';
+}
+
+/**
+ * Counts a complete frame, a frame ID that skips ahead counts the missing ones as dropped.
+ * @param frame_id: Camera frame ID. A smaller ID than the last one is an acquisition restart, not a drop.
+ * @param data_size: Bytes of pixel data.
+ */
+void CAMERA_METRICS::record_frame(uint64_t frame_id, uint64_t data_size)
+{
+    // Single writer -> plain load/store instead of read-modify-write
+    if (has_frame_id && frame_id > last_frame_id + 1)
+    {
+        dropped.store(dropped.load(memory_order_relaxed) + (frame_id - last_frame_id - 1), memory_order_relaxed);
+    }
+    has_frame_id = true;
+    last_frame_id = frame_id;
+
+    frames.store(frames.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    bytes.store(bytes.load(memory_order_relaxed) + data_size, memory_order_relaxed);
+
+    uint64_t now_ns = latency_now_ns();
+    if (window_start_ns == 0)
+    {
+        window_start_ns = now_ns;
+    }
+    window_frames++;
+
+    if (now_ns - window_start_ns >= 1000000000ULL)
+    {
+        frames_per_second.store(window_frames * 1e9 / (now_ns - window_start_ns), memory_order_relaxed);
+        fps_time_ns.store(now_ns, memory_order_relaxed);
+        window_start_ns = now_ns;
+        window_frames = 0;
+    }
+}
+
+void CAMERA_METRICS::record_incomplete()
+{
+    incomplete.store(incomplete.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/**
+ * Publishes the camera sensor readings.
+ * @param temperature: DeviceTemperature in degrees Celsius, NaN if the camera has no such node.
+ * @param throughput: DeviceLinkCurrentThroughput in bytes/s, NaN if the camera has no such node.
+ */
+void CAMERA_METRICS::set_sensors(double temperature, double throughput)
+{
+    temperature_c.store(temperature, memory_order_relaxed);
+    link_throughput.store(throughput, memory_order_relaxed);
+}
+
+/**
+ * Constructor for the METRICS_SERVER class.
+ */
+METRICS_SERVER::METRICS_SERVER()
+    : camera_count(0), frame_writer(nullptr), frame_pipeline(nullptr), listen_fd(-1), running(false), scrapes(0),
+      write_bytes_per_second(0.0)
+{
+}
+
+/**
+ * Destructor for the METRICS_SERVER class -> stops the HTTP thread.
+ */
+METRICS_SERVER::~METRICS_SERVER()
+{
+    stop();
+}
+
+/**
+ * Binds the loopback interface and starts the HTTP thread.
+ * @param port: TCP port, e.g. 9100.
+ * @return 0 if successful, -1 otherwise.
+ */
+int METRICS_SERVER::init(unsigned int port)
+{
+    if (running.load() || port == 0 || port > 65535)
+    {
+        cerr << "[Metrics] Invalid port " << port << " (or already started)\n";
+        return -1;
+    }
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0)
+    {
+        cerr << "[Metrics] socket failed: " << strerror(errno) << "\n";
+        return -1;
+    }
+
+    int enable = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // Local scrapes only
+
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_fd, 8) != 0)
+    {
+        cerr << "[Metrics] Unable to listen on 127.0.0.1:" << port << ": " << strerror(errno) << "\n";
+        close(listen_fd);
+        listen_fd = -1;
+        return -1;
+    }
+
+    running.store(true);
+    server_thread = thread(&METRICS_SERVER::server_loop, this);
+
+    cout << "[Metrics] Serving http://127.0.0.1:" << port << "/metrics" << endl;
+    return 0;
+}
+
+/**
+ * Stops the HTTP thread and closes the socket.
+ */
+void METRICS_SERVER::stop()
+{
+    if (!running.exchange(false))
+    {
+        return;
+    }
+
+    if (server_thread.joinable())
+    {
+        server_thread.join();   // Wakes up on its poll timeout
+    }
+
+    close(listen_fd);
+    listen_fd = -1;
+}
+
+void METRICS_SERVER::set_frame_writer(const FRAME_WRITER* writer)
+{
+    frame_writer = writer;
+}
+
+void METRICS_SERVER::set_frame_pipeline(const FRAME_PIPELINE* pipeline)
+{
+    frame_pipeline = pipeline;
+}
+
+/**
+ * Looks up a published camera.
+ * @param serial: The serial number (not necessarily NUL terminated).
+ * @param length: Maximum characters to compare.
+ * @return The camera, nullptr if it is not registered.
+ */
+CAMERA_METRICS* METRICS_SERVER::find_camera(const char* serial, size_t length)
+{
+    size_t count = camera_count.load(memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strncmp(cameras[i].serial, serial, length) == 0)
+        {
+            return &cameras[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the metrics of a camera, registering the serial on first use.
+ * @param serial: The camera serial number.
+ * @return The camera, nullptr if MAX_CAMERAS serials are registered already.
+ */
+CAMERA_METRICS* METRICS_SERVER::get_camera(const string& serial)
+{
+    CAMERA_METRICS* camera = find_camera(serial.c_str(), sizeof(cameras[0].serial));
+    if (camera)
+    {
+        return camera;
+    }
+
+    lock_guard<mutex> lock(register_mutex);
+    camera = find_camera(serial.c_str(), sizeof(cameras[0].serial));   // Registered by another acquisition thread meanwhile
+    if (camera)
+    {
+        return camera;
+    }
+
+    size_t count = camera_count.load(memory_order_relaxed);
+    if (count >= MAX_CAMERAS)
+    {
+        return nullptr;
+    }
+
+    strncpy(cameras[count].serial, serial.c_str(), sizeof(cameras[count].serial) - 1);
+    cameras[count].serial[sizeof(cameras[count].serial) - 1] = '\0';
+    camera_count.store(count + 1, memory_order_release);
+    return &cameras[count];
+}
+
+/**
+ * Counts the frame for its camera (only the header is read).
+ * @param header: The frame header.
+ * @param data: The pixel data (unused).
+ * @return 0 (a full camera table is not an error of the frame).
+ */
+int METRICS_SERVER::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    (void)data;
+
+    CAMERA_METRICS* camera = find_camera(header.serial, sizeof(header.serial));
+    if (!camera)
+    {
+        camera = get_camera(string(header.serial, strnlen(header.serial, sizeof(header.serial))));
+    }
+    if (camera)
+    {
+        camera->record_frame(header.frame_id, header.data_size);
+    }
+    return 0;
+}
+
+const char* METRICS_SERVER::get_sink_name() const
+{
+    return "metrics";
+}
+
+/**
+ * Appends the HELP and TYPE lines of a metric.
+ */
+static void write_metric_info(ostringstream& page, const char* name, const char* type, const char* help)
+{
+    page << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+}
+
+/**
+ * Renders every metric in the Prometheus text exposition format (version 0.0.4).
+ * @return The page.
+ */
+string METRICS_SERVER::render()
+{
+    ostringstream page;
+    page.precision(10);
+
+    size_t count = camera_count.load(memory_order_acquire);
+    uint64_t now_ns = latency_now_ns();
+
+    // One block per metric with a sample per camera
+    struct CAMERA_METRIC
+    {
+        const char* name;
+        const char* type;
+        const char* help;
+    };
+    const CAMERA_METRIC camera_metrics[] =
+    {
+        {"camera_frames_total", "counter", "Complete frames captured."},
+        {"camera_frame_bytes_total", "counter", "Pixel data of the complete frames in bytes."},
+        {"camera_incomplete_frames_total", "counter", "Incomplete images reported by the camera."},
+        {"camera_dropped_frames_total", "counter", "Frames missing from the camera frame ID sequence."},
+        {"camera_frames_per_second", "gauge", "Complete frames per second over the last second."},
+        {"camera_device_temperature_celsius", "gauge", "DeviceTemperature of the camera."},
+        {"camera_link_throughput_bytes_per_second", "gauge", "DeviceLinkCurrentThroughput of the camera."}
+    };
+
+    for (size_t m = 0; m < sizeof(camera_metrics) / sizeof(camera_metrics[0]); m++)
+    {
+        write_metric_info(page, camera_metrics[m].name, camera_metrics[m].type, camera_metrics[m].help);
+        for (size_t i = 0; i < count; i++)
+        {
+            const CAMERA_METRICS& camera = cameras[i];
+            const string label = string(camera_metrics[m].name) + "{serial=\"" + camera.serial + "\"} ";
+
+            // Counters as integers (a double would round them above 2^53 and print them in exponent notation)
+            double value = 0.0;
+            switch (m)
+            {
+                case 0: page << label << camera.frames.load(memory_order_relaxed) << "\n"; continue;
+                case 1: page << label << camera.bytes.load(memory_order_relaxed) << "\n"; continue;
+                case 2: page << label << camera.incomplete.load(memory_order_relaxed) << "\n"; continue;
+                case 3: page << label << camera.dropped.load(memory_order_relaxed) << "\n"; continue;
+                case 4:
+                {
+                    uint64_t fps_time_ns = camera.fps_time_ns.load(memory_order_relaxed);
+                    value = (fps_time_ns != 0 && now_ns - fps_time_ns < 2000000000ULL) ? camera.frames_per_second.load(memory_order_relaxed) : 0.0;
+                    break;
+                }
+                case 5: value = camera.temperature_c.load(memory_order_relaxed); break;
+                default: value = camera.link_throughput.load(memory_order_relaxed); break;
+            }
+
+            if (!std::isnan(value))     // Node not available on this camera -> no sample
+            {
+                page << label << value << "\n";
+            }
+        }
+    }
+
+    if (frame_writer)
+    {
+        FRAME_WRITER_STATS stats = frame_writer->get_stats();
+
+        write_metric_info(page, "frame_writer_frames_written_total", "counter", "Frames written by the frame writer.");
+        page << "frame_writer_frames_written_total " << stats.frames_written << "\n";
+        write_metric_info(page, "frame_writer_bytes_written_total", "counter", "Bytes written by the frame writer.");
+        page << "frame_writer_bytes_written_total " << stats.bytes_written << "\n";
+        write_metric_info(page, "frame_writer_errors_total", "counter", "Frames the frame writer failed to queue or write.");
+        page << "frame_writer_errors_total " << stats.errors << "\n";
+        write_metric_info(page, "frame_writer_stalls_total", "counter", "Times the capture waited for a free staging buffer.");
+        page << "frame_writer_stalls_total " << stats.stalls << "\n";
+        write_metric_info(page, "frame_writer_queue_depth", "gauge", "Frames queued and not yet written.");
+        page << "frame_writer_queue_depth " << stats.frames_in_flight << "\n";
+        write_metric_info(page, "frame_writer_bytes_per_second", "gauge", "Write throughput between the last two samples (about 1 s apart).");
+        page << "frame_writer_bytes_per_second " << write_bytes_per_second << "\n";
+    }
+
+    if (frame_pipeline)
+    {
+        FRAME_PIPELINE_STATS stats = frame_pipeline->get_stats();
+
+        write_metric_info(page, "frame_pipeline_frames_total", "counter", "Frames passed through the capture pipeline.");
+        page << "frame_pipeline_frames_total " << stats.frames << "\n";
+        write_metric_info(page, "frame_pipeline_sink_rejections_total", "counter", "Frames rejected by a frame sink (full queue, error).");
+        page << "frame_pipeline_sink_rejections_total " << stats.sink_rejections << "\n";
+        write_metric_info(page, "frame_pipeline_write_errors_total", "counter", "Frames that could not be queued for writing.");
+        page << "frame_pipeline_write_errors_total " << stats.write_errors << "\n";
+    }
+
+    write_metric_info(page, "metrics_scrapes_total", "counter", "Requests served by this endpoint.");
+    page << "metrics_scrapes_total " << scrapes.load(memory_order_relaxed) << "\n";
+
+    return page.str();
+}
+
+/**
+ * Reads one request and answers it. The socket has send/receive timeouts, so a stuck client only delays other scrapes.
+ * @param client_fd: The accepted connection (closed by the caller).
+ */
+void METRICS_SERVER::handle_client(int client_fd)
+{
+    timeval timeout = {1, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    // The request line is all that matters, read until the end of the headers
+    string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == string::npos && request.size() < 8192)
+    {
+        ssize_t received = recv(client_fd, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    string status = "200 OK";
+    string content_type = "text/plain; version=0.0.4; charset=utf-8";
+    string body;
+
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0)
+    {
+        scrapes++;
+        body = render();
+    }
+    else if (request.compare(0, 6, "GET / ") == 0)
+    {
+        content_type = "text/plain; charset=utf-8";
+        body = "Metrics at /metrics\n";
+    }
+    else
+    {
+        status = "404 Not Found";
+        content_type = "text/plain; charset=utf-8";
+        body = "Not found\n";
+    }
+
+    string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type + "\r\nContent-Length: " + to_string(body.size()) +
+                      "\r\nConnection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size())
+    {
+        ssize_t result = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (result <= 0)
+        {
+            return;
+        }
+        sent += static_cast<size_t>(result);
+    }
+}
+
+/**
+ * HTTP thread: serves one connection at a time and samples the write throughput about once per second.
+ */
+void METRICS_SERVER::server_loop()
+{
+    uint64_t sample_ns = latency_now_ns();
+    uint64_t sample_bytes = frame_writer ? frame_writer->get_stats().bytes_written : 0;
+
+    while (running.load())
+    {
+        pollfd listen_poll = {listen_fd, POLLIN, 0};
+        int ready = poll(&listen_poll, 1, 200);
+
+        uint64_t now_ns = latency_now_ns();
+        if (frame_writer && now_ns - sample_ns >= 1000000000ULL)
+        {
+            uint64_t bytes = frame_writer->get_stats().bytes_written;
+            write_bytes_per_second = (bytes - sample_bytes) * 1e9 / (now_ns - sample_ns);
+            sample_bytes = bytes;
+            sample_ns = now_ns;
+        }
+
+        if (ready < 0 && errno != EINTR)
+        {
+            cerr << "[Metrics] poll failed: " << strerror(errno) << "\n";
+            return;
+        }
+        if (ready <= 0 || !(listen_poll.revents & POLLIN))
+        {
+            continue;
+        }
+
+        int client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd < 0)
+        {
+            continue;
+        }
+        handle_client(client_fd);
+        close(client_fd);
+    }
+}
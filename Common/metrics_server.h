@@ -0,0 +1,93 @@
+// metrics_server.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "frame_format.h"
+#include "frame_pipeline.h"
+#include "frame_sink.h"
+#include "frame_writer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Counters and gauges of one camera. Written by the acquisition thread of that camera, read by the scrape.
+class CAMERA_METRICS
+{
+    private:
+        // Only touched by the acquisition thread
+        bool has_frame_id;
+        uint64_t last_frame_id;
+        uint64_t window_start_ns;
+        uint64_t window_frames;
+
+    public:
+        char serial[16];                        // NUL terminated, set before the camera is published to the scrape
+        atomic<uint64_t> frames;                // Complete frames
+        atomic<uint64_t> bytes;                 // Pixel data of the complete frames
+        atomic<uint64_t> incomplete;            // Incomplete images reported by the camera
+        atomic<uint64_t> dropped;               // Gaps in the camera frame IDs
+        atomic<double> frames_per_second;       // Over the last second
+        atomic<uint64_t> fps_time_ns;           // When frames_per_second was updated, older than 2 s -> reported as 0
+        atomic<double> temperature_c;           // DeviceTemperature, NaN -> not available
+        atomic<double> link_throughput;         // DeviceLinkCurrentThroughput in bytes/s, NaN -> not available
+
+        CAMERA_METRICS();
+
+        void record_frame(uint64_t frame_id, uint64_t data_size);   // Called for every complete frame
+        void record_incomplete();
+        void set_sensors(double temperature, double throughput);    // Sampled from the camera about once per second
+};
+
+// Local scrape endpoint in the Prometheus text format: GET /metrics on 127.0.0.1:<port> (curl http://127.0.0.1:9100/metrics).
+// Added as a frame sink it counts frames, bytes and frame ID gaps per camera serial; incomplete images and the camera
+// sensors are reported by the capture loop. The HTTP thread only reads atomics and the lock-free get_stats() of the
+// writer and the pipeline, so a scrape (or a stuck client) never waits on, or makes wait, the acquisition.
+class METRICS_SERVER : public FRAME_SINK
+{
+    public:
+        static const size_t MAX_CAMERAS = 8;
+
+    private:
+        CAMERA_METRICS cameras[MAX_CAMERAS];
+        atomic<size_t> camera_count;            // Published with release once a camera's serial is set
+        mutex register_mutex;                   // Between acquisition threads registering cameras, never taken by the scrape
+
+        const FRAME_WRITER* frame_writer;       // Optional, not owned
+        const FRAME_PIPELINE* frame_pipeline;   // Optional, not owned
+
+        int listen_fd;
+        atomic<bool> running;
+        thread server_thread;
+        atomic<uint64_t> scrapes;
+        double write_bytes_per_second;          // Only touched by the HTTP thread
+
+        CAMERA_METRICS* find_camera(const char* serial, size_t length);
+        void server_loop();
+        void handle_client(int client_fd);
+        string render();    // The metrics page
+
+    public:
+        METRICS_SERVER();
+        ~METRICS_SERVER();
+
+        int init(unsigned int port);    // Bind 127.0.0.1:<port> and start the HTTP thread
+        void stop();
+
+        void set_frame_writer(const FRAME_WRITER* writer);      // Queue depth and write throughput
+        void set_frame_pipeline(const FRAME_PIPELINE* pipeline);
+
+        CAMERA_METRICS* get_camera(const string& serial);   // Registers the serial on first use, nullptr if MAX_CAMERAS are in use
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        const char* get_sink_name() const;
+};
+
+#endif // METRICS_SERVER_H
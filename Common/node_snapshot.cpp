@@ -0,0 +1,163 @@
+// Description: Snapshot of the configured camera nodes on disk, restored in one pass after a reconnect
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "node_snapshot.h"
+
+using namespace std;
+
+/**
+ * Returns the nodes a snapshot holds, in the order they are written back. A node comes after the nodes that change
+ * its range or make it writable: the shutter mode before the exposure, pixel format and binning before the ROI size,
+ * the size before the offsets, Auto/Enable switches before their values, the exposure before the frame rate.
+ * A write that still fails because of an order the camera does not follow is retried after the others.
+ * @return The node names.
+ */
+const vector<string>& get_snapshot_node_names()
+{
+    static const vector<string> node_names =
+    {
+        "SensorShutterMode",
+        "PixelFormat",
+        "BinningHorizontal", "BinningVertical",
+        "DecimationHorizontal", "DecimationVertical",
+        "Width", "Height", "OffsetX", "OffsetY",
+        "AcquisitionMode",
+        "ExposureAuto", "ExposureTime",
+        "AcquisitionFrameRateEnable", "AcquisitionFrameRate",
+        "GainAuto", "Gain",
+        "BlackLevelClampingEnable",
+        "SharpeningEnable", "Sharpening",
+        "SaturationEnable", "Saturation",
+        "GammaEnable", "Gamma",
+        "Stream.StreamBufferHandlingMode",
+        "Stream.StreamBufferCountMode", "Stream.StreamBufferCountManual"
+    };
+    return node_names;
+}
+
+/**
+ * Returns the snapshot file of a camera.
+ * @param directory: The snapshot directory.
+ * @param serial: The camera serial number.
+ * @return <directory>/<serial>.snapshot
+ */
+string get_node_snapshot_path(const string& directory, const string& serial)
+{
+    return directory + (directory.empty() || directory[directory.size() - 1] == '/' ? "" : "/") + serial + ".snapshot";
+}
+
+/**
+ * Constructor for the NODE_SNAPSHOT class, starts empty.
+ */
+NODE_SNAPSHOT::NODE_SNAPSHOT() : settings_hash(0)
+{
+}
+
+/**
+ * Writes the snapshot: a "serial" and a "hash" line, then "Node = value" lines in restore order.
+ * @param path: The snapshot file, replaced atomically.
+ * @return 0 if successful, -1 otherwise.
+ */
+int NODE_SNAPSHOT::save(const string& path) const
+{
+    string temp_path = path + ".tmp";
+    {
+        ofstream file_out(temp_path, ios::trunc);
+        if (!file_out)
+        {
+            cerr << "[Snapshot] Unable to write " << temp_path << endl;
+            return -1;
+        }
+
+        file_out << "# Node snapshot written by the capture tools, restored in this order" << endl;
+        file_out << "serial = " << serial << endl;
+        file_out << "hash = " << hex << settings_hash << dec << endl;
+        for (const NODE_VALUE& node : values)
+        {
+            file_out << node.name << " = " << node.value << endl;
+        }
+        if (!file_out)
+        {
+            cerr << "[Snapshot] Unable to write " << temp_path << endl;
+            return -1;
+        }
+    }
+
+    if (rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        cerr << "[Snapshot] Unable to replace " << path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Reads a snapshot written by save().
+ * @param path: The snapshot file.
+ * @return 0 if successful, -1 if the file is missing or malformed.
+ */
+int NODE_SNAPSHOT::load(const string& path)
+{
+    serial.clear();
+    settings_hash = 0;
+    values.clear();
+
+    ifstream file_in(path);
+    if (!file_in)
+    {
+        return -1;
+    }
+
+    string line;
+    int line_number = 0;
+    bool has_hash = false;
+    while (getline(file_in, line))
+    {
+        line_number++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        size_t separator = line.find(" = ");
+        if (separator == string::npos)
+        {
+            cerr << "[Snapshot] " << path << ":" << line_number << ": Expected Node = value" << endl;
+            return -1;
+        }
+
+        NODE_VALUE node = {line.substr(0, separator), line.substr(separator + 3)};
+        if (node.name == "serial")
+        {
+            serial = node.value;
+        }
+        else if (node.name == "hash")
+        {
+            istringstream hash_text(node.value);
+            has_hash = static_cast<bool>(hash_text >> hex >> settings_hash);
+        }
+        else
+        {
+            values.push_back(node);
+        }
+    }
+
+    if (serial.empty() || !has_hash)
+    {
+        cerr << "[Snapshot] " << path << ": Missing serial or hash" << endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+// node_snapshot.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef NODE_SNAPSHOT_H
+#define NODE_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Struct to hold the value of one node in text form (enumerations by their symbolic name)
+struct NODE_VALUE
+{
+    string name;        // Node name, "Stream." prefix for the TL stream node map
+    string value;
+};
+
+// The configured state of one camera, written to disk after the configuration so a reconnect (or the next start with
+// the same settings) restores it in one pass instead of running every configuration step again. The nodes are kept
+// in the order they have to be written in, see get_snapshot_node_names().
+class NODE_SNAPSHOT
+{
+    public:
+        string serial;
+        uint64_t settings_hash;     // hash_camera_profile() the snapshot was taken with, a different one makes it stale
+        vector<NODE_VALUE> values;
+
+        NODE_SNAPSHOT();
+
+        int save(const string& path) const;    // Temp file + rename
+        int load(const string& path);           // -1 if missing or malformed
+};
+
+const vector<string>& get_snapshot_node_names();     // The nodes a snapshot holds, in dependency order
+string get_node_snapshot_path(const string& directory, const string& serial);
+
+#endif // NODE_SNAPSHOT_H
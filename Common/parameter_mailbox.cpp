@@ -0,0 +1,221 @@
+// Description: Mailbox of the newest slider values and the camera control thread that applies them at a bounded rate
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "parameter_mailbox.h"
+
+using namespace std;
+
+/**
+ * Constructor for the PARAMETER_MAILBOX class.
+ * @param parameter_count: Number of parameters, posted by their index.
+ */
+PARAMETER_MAILBOX::PARAMETER_MAILBOX(size_t parameter_count) : closed(false)
+{
+    SLOT empty_slot = {false, 0.0, 0, 0};
+    slots.assign(parameter_count, empty_slot);
+}
+
+/**
+ * Stores the newest value of a parameter, replacing one that was not taken yet.
+ * @param parameter: The parameter index.
+ * @param value: The value.
+ */
+void PARAMETER_MAILBOX::post(size_t parameter, double value)
+{
+    {
+        lock_guard<mutex> lock(slots_mutex);
+        if (closed || parameter >= slots.size())
+        {
+            return;
+        }
+
+        SLOT& slot = slots[parameter];
+        if (!slot.pending)
+        {
+            slot.pending = true;
+            slot.first_post_ns = latency_now_ns();
+            slot.posts = 0;
+        }
+        slot.value = value;
+        slot.posts++;
+    }
+    post_condition.notify_one();
+}
+
+/**
+ * Waits for posts and takes every parameter posted since the last call.
+ * @param updates: Receives one update per posted parameter, in parameter order.
+ * @return true if there are updates, false if the mailbox was closed and nothing is left.
+ */
+bool PARAMETER_MAILBOX::wait_and_take(vector<PARAMETER_UPDATE>& updates)
+{
+    updates.clear();
+
+    unique_lock<mutex> lock(slots_mutex);
+    post_condition.wait(lock, [this]
+    {
+        if (closed)
+        {
+            return true;
+        }
+        for (const SLOT& slot : slots)
+        {
+            if (slot.pending)
+            {
+                return true;
+            }
+        }
+        return false;
+    });
+
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        if (slots[i].pending)
+        {
+            PARAMETER_UPDATE update = {i, slots[i].value, slots[i].first_post_ns, slots[i].posts};
+            updates.push_back(update);
+            slots[i].pending = false;
+        }
+    }
+
+    return !updates.empty();
+}
+
+/**
+ * Closes the mailbox: the waiting thread takes what is still posted, then wait_and_take() returns false.
+ */
+void PARAMETER_MAILBOX::close()
+{
+    {
+        lock_guard<mutex> lock(slots_mutex);
+        closed = true;
+    }
+    post_condition.notify_all();
+}
+
+/**
+ * Constructor for the PARAMETER_CONTROL class.
+ * @param names: Name of each parameter for the printed values, the index is the parameter.
+ */
+PARAMETER_CONTROL::PARAMETER_CONTROL(const vector<string>& names)
+    : mailbox(names.size()), parameter_names(names), min_interval(0), post_count(0), apply_count(0), error_count(0)
+{
+}
+
+/**
+ * Destructor for the PARAMETER_CONTROL class -> stops the control thread.
+ */
+PARAMETER_CONTROL::~PARAMETER_CONTROL()
+{
+    stop();
+}
+
+/**
+ * Starts the control thread.
+ * @param apply: Writes one parameter to the camera (called on the control thread only).
+ * @param max_rate_hz: Camera writes per second at most, <= 0 -> every update as soon as it is posted.
+ * @return 0 if successful, -1 if already started.
+ */
+int PARAMETER_CONTROL::start(PARAMETER_APPLY_FUNCTION apply, double max_rate_hz)
+{
+    if (control_thread.joinable())
+    {
+        return -1;
+    }
+
+    apply_function = apply;
+    min_interval = chrono::nanoseconds(max_rate_hz > 0.0 ? static_cast<int64_t>(1e9 / max_rate_hz) : 0);
+    control_thread = thread(&PARAMETER_CONTROL::control_loop, this);
+    return 0;
+}
+
+/**
+ * Posts a slider value. Returns at once, the camera is written by the control thread.
+ * @param parameter: The parameter index.
+ * @param value: The value.
+ */
+void PARAMETER_CONTROL::post(size_t parameter, double value)
+{
+    post_count.fetch_add(1, memory_order_relaxed);
+    mailbox.post(parameter, value);
+}
+
+/**
+ * Applies the updates as they are posted. After each round the thread waits for the rest of the interval, so the
+ * posts of a fast drag collect in the mailbox and only the newest value of each parameter is written.
+ */
+void PARAMETER_CONTROL::control_loop()
+{
+    vector<PARAMETER_UPDATE> updates;
+    while (mailbox.wait_and_take(updates))
+    {
+        chrono::steady_clock::time_point round_start = chrono::steady_clock::now();
+
+        for (const PARAMETER_UPDATE& update : updates)
+        {
+            double value = update.value;
+            int result = apply_function(update.parameter, value);
+            uint64_t latency_ns = latency_now_ns() - update.first_post_ns;
+            apply_latency.record(latency_ns);
+            apply_count.fetch_add(1, memory_order_relaxed);
+
+            ostringstream line;     // One write, so it is not interleaved with the acquisition output
+            line << (update.parameter < parameter_names.size() ? parameter_names[update.parameter] : "Parameter") << ": " << value
+                 << fixed << setprecision(1) << " (applied " << latency_ns / 1e6 << " ms after the slider moved, "
+                 << update.posts << " move(s))" << (result < 0 ? ", camera rejected it" : "") << endl;
+            cout << line.str();
+
+            if (result < 0)
+            {
+                error_count.fetch_add(1, memory_order_relaxed);
+            }
+        }
+
+        this_thread::sleep_until(round_start + min_interval);
+    }
+}
+
+/**
+ * Stops the control thread after it applied what is still posted, and prints the apply latency.
+ */
+void PARAMETER_CONTROL::stop()
+{
+    if (!control_thread.joinable())
+    {
+        return;
+    }
+
+    mailbox.close();
+    control_thread.join();
+
+    LATENCY_SUMMARY summary = get_apply_latency();
+    if (summary.count > 0)
+    {
+        ostringstream report;   // Own stream, the format flags of cout are left alone
+        report << fixed << setprecision(1) << "[Control] " << post_count.load() << " slider moves, " << apply_count.load()
+               << " camera writes, apply latency p50 " << summary.p50_ns / 1e6 << " ms, p99 " << summary.p99_ns / 1e6
+               << " ms, max " << summary.max_ns / 1e6 << " ms, " << error_count.load() << " rejected" << endl;
+        cout << report.str();
+    }
+}
+
+/**
+ * Returns the apply latency since start.
+ * @return Percentiles from the first post of an update to the end of its node writes.
+ */
+LATENCY_SUMMARY PARAMETER_CONTROL::get_apply_latency() const
+{
+    vector<uint64_t> counts;
+    apply_latency.copy_counts(counts);
+    return LATENCY_HISTOGRAM::summarize(counts, apply_latency.get_sum(), apply_latency.get_max());
+}
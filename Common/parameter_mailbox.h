@@ -0,0 +1,90 @@
+// parameter_mailbox.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef PARAMETER_MAILBOX_H
+#define PARAMETER_MAILBOX_H
+
+#include "latency_histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Newest value of one parameter, with how long it waited and how many posts it replaces
+struct PARAMETER_UPDATE
+{
+    size_t parameter;
+    double value;
+    uint64_t first_post_ns;     // First post since the last take, the apply latency is measured from it
+    uint32_t posts;             // Posts coalesced into this update
+};
+
+// Newest value of each parameter. post() only stores the value (one short lock, never waits for the camera), take()
+// returns every parameter posted since the last take once, so a slider dragged over 50 positions is one update.
+class PARAMETER_MAILBOX
+{
+    private:
+        struct SLOT
+        {
+            bool pending;
+            double value;
+            uint64_t first_post_ns;
+            uint32_t posts;
+        };
+
+        mutex slots_mutex;
+        condition_variable post_condition;
+        vector<SLOT> slots;
+        bool closed;
+
+    public:
+        explicit PARAMETER_MAILBOX(size_t parameter_count);
+
+        void post(size_t parameter, double value);
+        bool wait_and_take(vector<PARAMETER_UPDATE>& updates);  // Blocks until a post, false once closed and empty
+        void close();   // Wakes the waiting thread, later posts are dropped
+};
+
+// Function that writes a parameter to the camera, value receives what the camera accepted (clamped), < 0 -> rejected
+typedef function<int(size_t parameter, double& value)> PARAMETER_APPLY_FUNCTION;
+
+// Camera control thread of the trackbar tools. The UI thread posts slider values and goes back to drawing; this thread
+// writes them to the camera at most max_rate_hz times per second (the posts in between are coalesced) and measures
+// the apply latency, from the first post of an update to the end of its node writes.
+class PARAMETER_CONTROL
+{
+    private:
+        PARAMETER_MAILBOX mailbox;
+        vector<string> parameter_names;     // For the printed values, e.g. "Exposure [us]"
+        PARAMETER_APPLY_FUNCTION apply_function;
+        chrono::nanoseconds min_interval;
+        thread control_thread;
+
+        LATENCY_HISTOGRAM apply_latency;    // Written by the control thread only
+        atomic<uint64_t> post_count;
+        atomic<uint64_t> apply_count;
+        atomic<uint64_t> error_count;
+
+        void control_loop();
+
+    public:
+        explicit PARAMETER_CONTROL(const vector<string>& names);
+        ~PARAMETER_CONTROL();
+
+        int start(PARAMETER_APPLY_FUNCTION apply, double max_rate_hz);
+        void post(size_t parameter, double value);  // From the trackbar callbacks
+        void stop();    // Applies what is still posted, prints the latency report
+
+        LATENCY_SUMMARY get_apply_latency() const;
+};
+
+#endif // PARAMETER_MAILBOX_H
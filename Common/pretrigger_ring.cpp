@@ -0,0 +1,590 @@
+// Description: In-memory pre-trigger ring per camera/ROI, written to disk only around events
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cmath>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "direct_file.h"
+#include "pretrigger_ring.h"
+
+using namespace std;
+
+/**
+ * Constructor for the PRETRIGGER_RING class.
+ */
+PRETRIGGER_RING::PRETRIGGER_RING()
+    : slots_per_stream(0), pre_frames(0), post_frames(0), next_event_id(1), jobs_in_progress(0), stopping(false),
+      frames_buffered(0), frames_flushed(0), frames_dropped(0), bytes_flushed(0), events(0)
+{
+}
+
+/**
+ * Destructor for the PRETRIGGER_RING class -> finishes active events and stops the flush thread.
+ */
+PRETRIGGER_RING::~PRETRIGGER_RING()
+{
+    if (flush_thread.joinable())
+    {
+        flush();
+
+        {
+            lock_guard<mutex> lock(ring_mutex);
+            stopping = true;
+        }
+        job_available.notify_all();
+        flush_thread.join();
+    }
+}
+
+/**
+ * Sizes the ring from the configured window and frame rate and allocates the memory for every stream up front.
+ * @param ring_config: The ring configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int PRETRIGGER_RING::init(const PRETRIGGER_RING_CONFIG& ring_config)
+{
+    config = ring_config;
+
+    if (config.frame_rate <= 0.0 || config.max_streams == 0)
+    {
+        cerr << "[Pre-trigger] Invalid frame rate or stream count\n";
+        return -1;
+    }
+
+    pre_frames = static_cast<unsigned int>(ceil(config.pre_seconds * config.frame_rate));
+    post_frames = static_cast<unsigned int>(ceil(config.post_seconds * config.frame_rate));
+
+    // Room for a full event plus a little headroom for the flush thread to catch up
+    slots_per_stream = pre_frames + post_frames + 2;
+
+    size_t record_size = align_up(sizeof(FRAME_HEADER) + config.max_frame_bytes, PAGE_ALIGNMENT);
+    if (slot_memory.init(slots_per_stream * config.max_streams, record_size) != 0)
+    {
+        return -1;
+    }
+
+    streams.reserve(config.max_streams);
+    next_event_id = find_next_event_id();
+
+    flush_thread = thread(&PRETRIGGER_RING::flush_loop, this);
+
+    cout << "[Pre-trigger] " << config.pre_seconds << " s before / " << config.post_seconds << " s after at "
+         << config.frame_rate << " fps: " << slots_per_stream << " slots x " << config.max_streams << " stream(s), "
+         << (static_cast<double>(record_size) * slots_per_stream * config.max_streams) / (1024.0 * 1024.0) << " MB" << endl;
+
+    return 0;
+}
+
+/**
+ * Finds the first event ID after the event files of earlier runs, so a restart into the same folder keeps them.
+ * @return The highest event_<id>_*.rec in the folder plus 1, or 1 if there is none.
+ */
+unsigned int PRETRIGGER_RING::find_next_event_id() const
+{
+    unsigned int next_id = 1;
+
+    DIR* directory = opendir(config.folder_path.empty() ? "." : config.folder_path.c_str());
+    if (directory == nullptr)
+    {
+        return next_id;     // The event files report the error when they are created
+    }
+
+    while (struct dirent* entry = readdir(directory))
+    {
+        unsigned int id = 0;
+        if (sscanf(entry->d_name, "event_%u_", &id) == 1 && id >= next_id)
+        {
+            next_id = id + 1;
+        }
+    }
+    closedir(directory);
+
+    if (next_id > 1)
+    {
+        cout << "[Pre-trigger] " << config.folder_path << " has earlier events, continuing at event " << next_id << endl;
+    }
+
+    return next_id;
+}
+
+/**
+ * Returns the stream for the frame's camera/ROI, assigning one of the preallocated streams on first use.
+ * @param header: The frame header (serial and offset_x identify the stream).
+ * @return The stream index, or -1 if every stream is taken. ring_mutex must be held.
+ */
+int PRETRIGGER_RING::find_stream(const FRAME_HEADER& header)
+{
+    char serial[sizeof(header.serial) + 1] = {0};
+    memcpy(serial, header.serial, sizeof(header.serial));
+
+    string key = (serial[0] ? string(serial) : string("camera")) + "_X" + to_string(header.offset_x);
+
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        if (streams[i].key == key)
+        {
+            return static_cast<int>(i);
+        }
+    }
+
+    if (streams.size() >= config.max_streams)
+    {
+        return -1;
+    }
+
+    unsigned int stream_index = static_cast<unsigned int>(streams.size());
+
+    RING_STREAM stream;
+    stream.key = key;
+    stream.head = 0;
+    stream.has_mean = false;
+    stream.last_mean = 0.0;
+    stream.event_id = 0;
+    stream.post_remaining = 0;
+    stream.event_dropped = 0;
+    stream.event_fd = -1;
+    stream.event_offset = 0;
+    stream.event_direct_io = false;
+    stream.event_frames = 0;
+    stream.first_frame_id = 0;
+    stream.last_frame_id = 0;
+
+    stream.slots.resize(slots_per_stream);
+    for (unsigned int i = 0; i < slots_per_stream; i++)
+    {
+        RING_SLOT& slot = stream.slots[i];
+        slot.buffer = slot_memory.get_buffer(stream_index * slots_per_stream + i);
+        slot.record_size = 0;
+        slot.frame_id = 0;
+        slot.filled = false;
+        slot.pinned = false;
+    }
+
+    // A stream that shows up during an event (e.g. the second ROI of a camera) joins it for the rest of the window
+    for (const RING_STREAM& active : streams)
+    {
+        if (active.event_id != 0)
+        {
+            stream.event_id = active.event_id;
+            stream.event_reason = active.event_reason;
+            stream.post_remaining = active.post_remaining;
+            break;
+        }
+    }
+
+    streams.push_back(stream);
+    cout << "[Pre-trigger] Buffering stream " << key << (stream.event_id != 0 ? " (joins the active event)" : "") << endl;
+
+    return static_cast<int>(stream_index);
+}
+
+/**
+ * Average brightness of a sparse pixel sample, used by the image trigger.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return The mean in percent of full scale.
+ */
+double PRETRIGGER_RING::sample_mean(const FRAME_HEADER& header, const void* data)
+{
+    const size_t step = 61; // Odd step so the sample does not line up with Bayer/BGR patterns
+    double sum = 0.0;
+    size_t count = 0;
+
+    if (header.pixel_format == FRAME_PIXEL_FORMAT_MONO16)
+    {
+        const uint16_t* pixels = static_cast<const uint16_t*>(data);
+        size_t total = header.data_size / 2;
+        for (size_t i = 0; i < total; i += step, count++)
+        {
+            sum += pixels[i];
+        }
+        return count ? sum / count / 65535.0 * 100.0 : 0.0;
+    }
+
+    const uint8_t* pixels = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < header.data_size; i += step, count++)
+    {
+        sum += pixels[i];
+    }
+    return count ? sum / count / 255.0 * 100.0 : 0.0;
+}
+
+/**
+ * Copies the frame into the next ring slot. Only memory is touched unless an event is active.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if the frame was buffered (or dropped because the ring is pinned), -1 on errors.
+ */
+int PRETRIGGER_RING::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    size_t payload_size = sizeof(FRAME_HEADER) + header.data_size;
+    size_t record_size = align_up(payload_size, PAGE_ALIGNMENT);
+
+    if (record_size > slot_memory.get_buffer_size())
+    {
+        cerr << "[Pre-trigger] Frame of " << header.data_size << " bytes exceeds the configured maximum\n";
+        return -1;
+    }
+
+    unique_lock<mutex> lock(ring_mutex);
+
+    int stream_index = find_stream(header);
+    if (stream_index < 0)
+    {
+        cerr << "[Pre-trigger] More than " << config.max_streams << " streams, frame ignored\n";
+        return -1;
+    }
+
+    RING_STREAM& stream = streams[stream_index];
+    unsigned int slot_index = stream.head;
+    RING_SLOT& slot = stream.slots[slot_index];
+
+    if (slot.pinned)
+    {
+        // Every slot is still waiting for the flush thread, the disk is not keeping up with the event
+        frames_dropped++;
+        if (stream.event_id != 0)
+        {
+            stream.event_dropped++;
+            if (--stream.post_remaining == 0) // A dropped frame still uses up the post-event window, else the event never ends
+            {
+                end_event_locked(static_cast<unsigned int>(stream_index));
+                lock.unlock();
+                job_available.notify_one();
+            }
+        }
+        return 0;
+    }
+
+    slot.filled = false;    // Claimed: trigger() will not pin it while it is being copied
+    lock.unlock();
+
+    memcpy(slot.buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(slot.buffer + sizeof(FRAME_HEADER), data, header.data_size);
+    memset(slot.buffer + payload_size, 0, record_size - payload_size);
+
+    double mean = config.image_trigger_threshold > 0.0 ? sample_mean(header, data) : 0.0;
+
+    lock.lock();
+
+    slot.record_size = record_size;
+    slot.frame_id = header.frame_id;
+    slot.filled = true;
+    stream.head = (stream.head + 1) % slots_per_stream;
+    frames_buffered++;
+
+    bool image_trigger = false;
+    if (config.image_trigger_threshold > 0.0)
+    {
+        image_trigger = stream.has_mean && fabs(mean - stream.last_mean) > config.image_trigger_threshold;
+        stream.last_mean = mean;
+        stream.has_mean = true;
+    }
+
+    if (stream.event_id != 0)
+    {
+        // Post-event frame
+        slot.pinned = true;
+        FLUSH_JOB job = {static_cast<unsigned int>(stream_index), slot_index, stream.event_id, false, 0, string()};
+        jobs.push_back(job);
+
+        if (image_trigger)
+        {
+            stream.post_remaining = post_frames; // Keep recording while the scene keeps changing
+        }
+        else if (--stream.post_remaining == 0)
+        {
+            end_event_locked(static_cast<unsigned int>(stream_index));
+        }
+    }
+    else if (image_trigger)
+    {
+        ostringstream reason;
+        reason << "image change on " << stream.key << " (frame " << header.frame_id << ")";
+        trigger_locked(reason.str());
+    }
+
+    lock.unlock();
+    job_available.notify_one();
+
+    return 0;
+}
+
+/**
+ * Starts an event on every stream (or extends the post-event window of an active one).
+ * @param reason: Logged with the event.
+ */
+void PRETRIGGER_RING::trigger_locked(const string& reason)
+{
+    unsigned int event_id = next_event_id;
+    bool started = false;
+
+    for (unsigned int s = 0; s < streams.size(); s++)
+    {
+        RING_STREAM& stream = streams[s];
+
+        if (stream.event_id != 0)
+        {
+            stream.post_remaining = post_frames;
+            continue;
+        }
+
+        // Walk back from the newest frame and pin up to pre_frames complete frames
+        vector<unsigned int> pre_slots;
+        unsigned int index = stream.head;
+        for (unsigned int i = 0; i < slots_per_stream && pre_slots.size() < pre_frames + 1; i++)
+        {
+            index = (index + slots_per_stream - 1) % slots_per_stream;
+            RING_SLOT& slot = stream.slots[index];
+            if (!slot.filled || slot.pinned)
+            {
+                break;
+            }
+            pre_slots.push_back(index);
+        }
+
+        stream.event_id = event_id;
+        stream.event_reason = reason;
+        stream.event_dropped = 0;
+        stream.post_remaining = post_frames;
+        started = true;
+
+        for (auto it = pre_slots.rbegin(); it != pre_slots.rend(); ++it)
+        {
+            stream.slots[*it].pinned = true;
+            FLUSH_JOB job = {s, *it, event_id, false, 0, string()};
+            jobs.push_back(job);
+        }
+
+        if (post_frames == 0)
+        {
+            end_event_locked(s);
+        }
+    }
+
+    if (started)
+    {
+        next_event_id++;
+        events++;
+        cout << "[Pre-trigger] Event " << event_id << ": " << reason << endl;
+    }
+}
+
+/**
+ * Queues the end marker for the stream's active event.
+ * @param stream_index: The stream.
+ */
+void PRETRIGGER_RING::end_event_locked(unsigned int stream_index)
+{
+    RING_STREAM& stream = streams[stream_index];
+    FLUSH_JOB job = {stream_index, 0, stream.event_id, true, stream.event_dropped, stream.event_reason};
+    jobs.push_back(job);
+    stream.event_id = 0;
+    stream.post_remaining = 0;
+}
+
+/**
+ * Starts an event: the buffered frames and the next post_seconds of frames are written to disk.
+ * @param reason: Logged with the event (e.g. "keypress", "control command").
+ */
+void PRETRIGGER_RING::trigger(const string& reason)
+{
+    {
+        lock_guard<mutex> lock(ring_mutex);
+        trigger_locked(reason);
+    }
+    job_available.notify_one();
+}
+
+/**
+ * Frame sink event hook -> trigger.
+ * @param reason: Logged with the event.
+ */
+void PRETRIGGER_RING::on_event(const string& reason)
+{
+    trigger(reason);
+}
+
+/**
+ * Writes one queued slot to its event file (or closes the file for an end marker). Runs on the flush thread.
+ * @param job: The job to process.
+ */
+void PRETRIGGER_RING::write_job(const FLUSH_JOB& job)
+{
+    // The stream vector only grows before the first event of a stream, but never reallocates (reserved in init)
+    RING_STREAM& stream = streams[job.stream_index];
+
+    if (job.end_of_event)
+    {
+        if (stream.event_fd >= 0)
+        {
+            if (ftruncate(stream.event_fd, static_cast<off_t>(stream.event_offset)) != 0)
+            {
+                cerr << "[Pre-trigger] Unable to trim event file: " << strerror(errno) << endl;
+            }
+            close(stream.event_fd);
+            stream.event_fd = -1;
+
+            double flush_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - stream.event_start).count();
+
+            ostringstream line;     // Own stream, the format flags of cout are left alone
+            line << "[Pre-trigger] Event " << job.event_id << " " << stream.key << " saved: " << stream.event_frames
+                 << " frames (ID " << stream.first_frame_id << " to " << stream.last_frame_id << "), "
+                 << job.dropped << " dropped, " << fixed << setprecision(1) << flush_ms << " ms (" << job.reason << ")" << endl;
+            cout << line.str();
+        }
+        return;
+    }
+
+    RING_SLOT& slot = stream.slots[job.slot_index];
+
+    if (stream.event_fd < 0)
+    {
+        ostringstream path;
+        path << config.folder_path;
+        if (!config.folder_path.empty() && config.folder_path.back() != '/')
+        {
+            path << '/';
+        }
+        path << "event_" << setw(4) << setfill('0') << job.event_id << "_" << stream.key << ".rec";
+
+        stream.event_fd = open_new_output_file(path.str(), config.use_direct_io, stream.event_direct_io);
+        if (stream.event_fd < 0 && errno == EEXIST)
+        {
+            cerr << "[Pre-trigger] " << path.str() << " already exists, event " << job.event_id << " of " << stream.key << " not saved\n";
+        }
+        stream.event_offset = 0;
+        stream.event_frames = 0;
+        stream.first_frame_id = slot.frame_id;
+        stream.event_start = chrono::steady_clock::now();
+
+        if (stream.event_fd >= 0)
+        {
+            // A full event is known in advance, reserve it in one go
+            uint64_t event_bytes = static_cast<uint64_t>(slot_memory.get_buffer_size()) * (pre_frames + post_frames + 1);
+            if (fallocate(stream.event_fd, 0, 0, static_cast<off_t>(event_bytes)) != 0)
+            {
+                cerr << "[Pre-trigger] fallocate failed: " << strerror(errno) << endl;
+            }
+        }
+    }
+
+    if (stream.event_fd >= 0 && write_all(stream.event_fd, slot.buffer, slot.record_size, stream.event_offset) == 0)
+    {
+        if (!stream.event_direct_io)
+        {
+            drop_written_range(stream.event_fd, stream.event_offset, slot.record_size);
+        }
+
+        stream.event_offset += slot.record_size;
+        stream.event_frames++;
+        stream.last_frame_id = slot.frame_id;
+        frames_flushed++;
+        bytes_flushed += slot.record_size;
+    }
+
+    lock_guard<mutex> lock(ring_mutex);
+    slot.pinned = false;
+}
+
+/**
+ * Flush thread: writes pinned slots to the event files in order.
+ */
+void PRETRIGGER_RING::flush_loop()
+{
+    unique_lock<mutex> lock(ring_mutex);
+
+    while (true)
+    {
+        job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+        {
+            return;
+        }
+
+        FLUSH_JOB job = jobs.front();
+        jobs.pop_front();
+        jobs_in_progress++;
+        lock.unlock();
+
+        write_job(job);
+
+        lock.lock();
+        jobs_in_progress--;
+        jobs_done.notify_all();
+    }
+}
+
+/**
+ * Ends every active event (the post-event window is cut short) and waits for the event files.
+ * @return 0.
+ */
+int PRETRIGGER_RING::flush()
+{
+    unique_lock<mutex> lock(ring_mutex);
+
+    for (unsigned int s = 0; s < streams.size(); s++)
+    {
+        if (streams[s].event_id != 0)
+        {
+            end_event_locked(s);
+        }
+    }
+    job_available.notify_one();
+
+    jobs_done.wait(lock, [this] { return jobs.empty() && jobs_in_progress == 0; });
+    return 0;
+}
+
+/**
+ * Returns the sink name.
+ */
+const char* PRETRIGGER_RING::get_sink_name() const
+{
+    return "pre-trigger ring";
+}
+
+/**
+ * Returns a snapshot of the ring counters.
+ * @return The current statistics.
+ */
+PRETRIGGER_RING_STATS PRETRIGGER_RING::get_stats() const
+{
+    PRETRIGGER_RING_STATS stats;
+    stats.frames_buffered = frames_buffered.load();
+    stats.frames_flushed = frames_flushed.load();
+    stats.frames_dropped = frames_dropped.load();
+    stats.bytes_flushed = bytes_flushed.load();
+    stats.events = events.load();
+    return stats;
+}
+
+/**
+ * Returns the default configuration: 5 s before and after the event at 10 fps, image trigger off, O_DIRECT.
+ * @param folder_path: Where the event files are written.
+ * @param max_frame_bytes: Largest pixel payload.
+ * @return The configuration.
+ */
+PRETRIGGER_RING_CONFIG default_pretrigger_ring_config(const string& folder_path, size_t max_frame_bytes)
+{
+    PRETRIGGER_RING_CONFIG config;
+    config.folder_path = folder_path;
+    config.pre_seconds = 5.0;
+    config.post_seconds = 5.0;
+    config.frame_rate = 10.0;
+    config.max_frame_bytes = max_frame_bytes;
+    config.max_streams = 4;
+    config.image_trigger_threshold = 0.0;
+    config.use_direct_io = true;
+    return config;
+}
@@ -0,0 +1,146 @@
+// pretrigger_ring.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef PRETRIGGER_RING_H
+#define PRETRIGGER_RING_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Struct to hold the pre-trigger ring configuration
+struct PRETRIGGER_RING_CONFIG
+{
+    string folder_path;              // Where the event files are written
+    double pre_seconds;              // Frames kept before the event
+    double post_seconds;             // Frames saved after the event
+    double frame_rate;               // Expected frame rate, sizes the ring
+    size_t max_frame_bytes;          // Largest pixel payload
+    unsigned int max_streams;        // Camera/ROI streams (memory for all of them is allocated in init)
+    double image_trigger_threshold;  // Mean brightness change between frames (percent of full scale) that triggers an event, 0 = off
+    bool use_direct_io;
+};
+
+// Struct to hold the pre-trigger ring counters
+struct PRETRIGGER_RING_STATS
+{
+    uint64_t frames_buffered;   // Frames copied into the ring
+    uint64_t frames_flushed;    // Frames written to event files
+    uint64_t frames_dropped;    // Frames lost because every slot was still waiting to be written
+    uint64_t bytes_flushed;
+    uint64_t events;
+};
+
+// Keeps the last pre_seconds of frames per camera/ROI in preallocated memory. Nothing touches the disk until an
+// event: then the buffered frames plus the next post_seconds of frames are written to
+// <folder>/event_<id>_<serial>_X<offset_x>.rec (same record layout as the segment recorder). The event IDs continue
+// after the event files already in the folder, an existing file is never overwritten.
+class PRETRIGGER_RING : public FRAME_SINK
+{
+    private:
+        struct RING_SLOT
+        {
+            char* buffer;
+            size_t record_size;
+            uint64_t frame_id;
+            bool filled;    // Holds a complete frame
+            bool pinned;    // Queued for an event file, must not be overwritten
+        };
+
+        struct RING_STREAM
+        {
+            string key;                 // <serial>_X<offset_x>
+            vector<RING_SLOT> slots;
+            unsigned int head;          // Next slot to fill
+            bool has_mean;
+            double last_mean;           // Image trigger: mean of the previous frame
+
+            unsigned int event_id;      // Active event (0 = none)
+            unsigned int post_remaining;
+            string event_reason;
+            uint64_t event_dropped;
+
+            // Only touched by the flush thread
+            int event_fd;
+            uint64_t event_offset;
+            bool event_direct_io;
+            unsigned int event_frames;
+            uint64_t first_frame_id;
+            uint64_t last_frame_id;
+            chrono::steady_clock::time_point event_start;
+        };
+
+        struct FLUSH_JOB
+        {
+            unsigned int stream_index;
+            unsigned int slot_index;
+            unsigned int event_id;
+            bool end_of_event;
+            uint64_t dropped;   // End marker: frames dropped during the event
+            string reason;      // End marker: what triggered the event
+        };
+
+        PRETRIGGER_RING_CONFIG config;
+        ALIGNED_BUFFER_POOL slot_memory;
+        unsigned int slots_per_stream;
+        unsigned int pre_frames;
+        unsigned int post_frames;
+
+        vector<RING_STREAM> streams;
+        unsigned int next_event_id;
+
+        thread flush_thread;
+        deque<FLUSH_JOB> jobs;
+        unsigned int jobs_in_progress;
+        bool stopping;
+        mutex ring_mutex;
+        condition_variable job_available;
+        condition_variable jobs_done;
+
+        atomic<uint64_t> frames_buffered;
+        atomic<uint64_t> frames_flushed;
+        atomic<uint64_t> frames_dropped;
+        atomic<uint64_t> bytes_flushed;
+        atomic<uint64_t> events;
+
+        int find_stream(const FRAME_HEADER& header);        // Returns -1 if max_streams is exceeded
+        unsigned int find_next_event_id() const;            // After the event files already in the folder
+        void trigger_locked(const string& reason);          // ring_mutex must be held
+        void end_event_locked(unsigned int stream_index);   // ring_mutex must be held
+        void flush_loop();
+        void write_job(const FLUSH_JOB& job);
+        static double sample_mean(const FRAME_HEADER& header, const void* data);  // Percent of full scale
+
+    public:
+        PRETRIGGER_RING();
+        ~PRETRIGGER_RING();
+
+        int init(const PRETRIGGER_RING_CONFIG& ring_config);    // Allocate every slot and start the flush thread
+
+        void trigger(const string& reason);    // Save the buffered frames and the next post_seconds of frames
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        int flush();    // Ends active events (post-event window cut short) and waits for the files
+        void on_event(const string& reason);
+        const char* get_sink_name() const;
+
+        PRETRIGGER_RING_STATS get_stats() const;
+};
+
+// Default configuration: 5 s before, 5 s after at 10 fps, image trigger off
+PRETRIGGER_RING_CONFIG default_pretrigger_ring_config(const string& folder_path, size_t max_frame_bytes);
+
+#endif // PRETRIGGER_RING_H
@@ -0,0 +1,323 @@
+// Description: Records frames with O_DIRECT into preallocated, page aligned segment files
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "direct_file.h"
+#include "segment_recorder.h"
+
+using namespace std;
+
+/**
+ * Constructor for the SEGMENT_RECORDER class.
+ */
+SEGMENT_RECORDER::SEGMENT_RECORDER()
+    : jobs_in_progress(0), stopping(false), segment_fd(-1), segment_index(0), segment_offset(0), direct_io_active(false),
+      frames_recorded(0), bytes_recorded(0), segments_opened(0), stalls(0), errors(0), max_write_us(0)
+{
+}
+
+/**
+ * Destructor for the SEGMENT_RECORDER class -> writes what is queued, stops the writer and closes the segment.
+ */
+SEGMENT_RECORDER::~SEGMENT_RECORDER()
+{
+    if (writer_thread.joinable())
+    {
+        flush();
+
+        {
+            lock_guard<mutex> lock(recorder_mutex);
+            stopping = true;
+        }
+        job_available.notify_all();
+        writer_thread.join();
+    }
+
+    close_segment();
+}
+
+/**
+ * Allocates the staging buffers and starts the writer thread. The first segment is created right away so
+ * configuration errors show up before acquisition starts.
+ * @param recorder_config: The recorder configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SEGMENT_RECORDER::init(const SEGMENT_RECORDER_CONFIG& recorder_config)
+{
+    config = recorder_config;
+    config.segment_size = align_up(config.segment_size, PAGE_ALIGNMENT);
+
+    size_t max_record_size = align_up(sizeof(FRAME_HEADER) + config.max_frame_bytes, PAGE_ALIGNMENT);
+    if (max_record_size > config.segment_size)
+    {
+        cerr << "[Recorder] Segment size " << config.segment_size << " is smaller than one frame record (" << max_record_size << ")\n";
+        return -1;
+    }
+
+    if (buffer_pool.init(config.buffer_count, max_record_size) != 0)
+    {
+        return -1;
+    }
+
+    if (open_segment() != 0)
+    {
+        return -1;
+    }
+
+    writer_thread = thread(&SEGMENT_RECORDER::writer_loop, this);
+
+    cout << "[Recorder] Recording to " << config.folder_path << " (" << config.segment_size / (1024 * 1024) << " MB segments, "
+         << config.buffer_count << " x " << max_record_size << " byte buffers, "
+         << (direct_io_active ? "O_DIRECT" : "buffered") << ")" << endl;
+
+    return 0;
+}
+
+/**
+ * Creates the next segment file and preallocates its full size.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SEGMENT_RECORDER::open_segment()
+{
+    // Never truncate a segment of an earlier run (or of an earlier attempt of this one): skip the indices in use
+    ostringstream path;
+    unsigned int first_index = segment_index;
+    while (true)
+    {
+        path.str("");
+        path << config.folder_path;
+        if (!config.folder_path.empty() && config.folder_path.back() != '/')
+        {
+            path << '/';
+        }
+        path << config.prefix << "_" << setw(6) << setfill('0') << segment_index << ".rec";
+
+        segment_fd = open_new_output_file(path.str(), config.use_direct_io, direct_io_active);
+        if (segment_fd >= 0)
+        {
+            break;
+        }
+        if (errno != EEXIST || segment_index == UINT_MAX)
+        {
+            return -1;
+        }
+        segment_index++;
+    }
+
+    if (segment_index != first_index && segments_opened == 0)
+    {
+        cout << "[Recorder] " << config.folder_path << " has earlier segments, continuing at " << path.str() << endl;
+    }
+
+    // Reserve the blocks now so the writes never have to allocate (and the filesystem keeps the file contiguous)
+    if (fallocate(segment_fd, 0, 0, static_cast<off_t>(config.segment_size)) != 0)
+    {
+        cerr << "[Recorder] fallocate failed for " << path.str() << " (" << strerror(errno) << "). Continuing without preallocation.\n";
+    }
+
+    segment_offset = 0;
+    segment_index++;
+    segments_opened++;
+
+    return 0;
+}
+
+/**
+ * Trims the preallocated but unused tail of the current segment and closes it.
+ */
+void SEGMENT_RECORDER::close_segment()
+{
+    if (segment_fd < 0)
+    {
+        return;
+    }
+
+    if (ftruncate(segment_fd, static_cast<off_t>(segment_offset)) != 0)
+    {
+        cerr << "[Recorder] Unable to trim segment: " << strerror(errno) << endl;
+    }
+
+    close(segment_fd);
+    segment_fd = -1;
+}
+
+/**
+ * Writes one padded record at the current segment offset, rolling over to a new segment when full.
+ * @param buffer: Page aligned record.
+ * @param record_size: Record size, a multiple of PAGE_ALIGNMENT.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SEGMENT_RECORDER::write_record(const char* buffer, size_t record_size)
+{
+    if (segment_offset + record_size > config.segment_size)
+    {
+        close_segment();
+        if (open_segment() != 0)
+        {
+            return -1;
+        }
+    }
+
+    if (write_all(segment_fd, buffer, record_size, segment_offset) != 0)
+    {
+        return -1;
+    }
+
+    if (!direct_io_active)
+    {
+        drop_written_range(segment_fd, segment_offset, record_size);
+    }
+
+    segment_offset += record_size;
+    return 0;
+}
+
+/**
+ * Writer thread: writes queued records in order until the recorder is destroyed.
+ */
+void SEGMENT_RECORDER::writer_loop()
+{
+    unique_lock<mutex> lock(recorder_mutex);
+
+    while (true)
+    {
+        job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+        {
+            return; // stopping and nothing left to do
+        }
+
+        WRITE_JOB job = jobs.front();
+        jobs.pop_front();
+        jobs_in_progress++;
+        lock.unlock();
+
+        auto start_time = chrono::steady_clock::now();
+        int result = write_record(buffer_pool.get_buffer(job.buffer_index), job.record_size);
+        uint64_t write_us = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start_time).count());
+
+        if (result == 0)
+        {
+            frames_recorded++;
+            bytes_recorded += job.record_size;
+            if (write_us > max_write_us.load())
+            {
+                max_write_us.store(write_us);
+            }
+        }
+        else
+        {
+            errors++;
+        }
+
+        buffer_pool.release(job.buffer_index);
+
+        lock.lock();
+        jobs_in_progress--;
+        jobs_done.notify_all();
+    }
+}
+
+/**
+ * Copies the frame into an aligned staging buffer and queues it for the writer thread.
+ * @param header: The frame header, data_size must be set.
+ * @param data: The pixel data.
+ * @return 0 if the frame was queued, -1 otherwise.
+ */
+int SEGMENT_RECORDER::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    size_t payload_size = sizeof(FRAME_HEADER) + header.data_size;
+    size_t record_size = align_up(payload_size, PAGE_ALIGNMENT);
+
+    if (record_size > buffer_pool.get_buffer_size())
+    {
+        cerr << "[Recorder] Frame of " << header.data_size << " bytes exceeds the configured maximum\n";
+        errors++;
+        return -1;
+    }
+
+    unsigned int buffer_index;
+    if (!buffer_pool.try_acquire(buffer_index))
+    {
+        stalls++;
+        buffer_index = buffer_pool.acquire();
+    }
+
+    char* buffer = buffer_pool.get_buffer(buffer_index);
+    memcpy(buffer, &header, sizeof(FRAME_HEADER));
+    memcpy(buffer + sizeof(FRAME_HEADER), data, header.data_size);
+    memset(buffer + payload_size, 0, record_size - payload_size);  // Zero the padding, never write stale memory
+
+    {
+        lock_guard<mutex> lock(recorder_mutex);
+        WRITE_JOB job = {buffer_index, record_size};
+        jobs.push_back(job);
+    }
+    job_available.notify_one();
+
+    return 0;
+}
+
+/**
+ * Waits until every queued frame has been written.
+ * @return 0 if no write failed so far, -1 otherwise.
+ */
+int SEGMENT_RECORDER::flush()
+{
+    unique_lock<mutex> lock(recorder_mutex);
+    jobs_done.wait(lock, [this] { return jobs.empty() && jobs_in_progress == 0; });
+    return errors.load() == 0 ? 0 : -1;
+}
+
+/**
+ * Returns the sink name.
+ */
+const char* SEGMENT_RECORDER::get_sink_name() const
+{
+    return "segment recorder";
+}
+
+/**
+ * Returns a snapshot of the recorder counters.
+ * @return The current statistics.
+ */
+SEGMENT_RECORDER_STATS SEGMENT_RECORDER::get_stats() const
+{
+    SEGMENT_RECORDER_STATS stats;
+    stats.frames_recorded = frames_recorded.load();
+    stats.bytes_recorded = bytes_recorded.load();
+    stats.segments_opened = segments_opened.load();
+    stats.stalls = stalls.load();
+    stats.errors = errors.load();
+    stats.max_write_ms = max_write_us.load() / 1000.0;
+    return stats;
+}
+
+/**
+ * Returns a sensible default configuration: 1 GB segments, 16 staging buffers, O_DIRECT.
+ * @param folder_path: Where the segments are created.
+ * @param max_frame_bytes: Largest pixel payload that will be recorded.
+ * @return The configuration.
+ */
+SEGMENT_RECORDER_CONFIG default_segment_recorder_config(const string& folder_path, size_t max_frame_bytes)
+{
+    SEGMENT_RECORDER_CONFIG config;
+    config.folder_path = folder_path;
+    config.prefix = "segment";
+    config.segment_size = 1024ULL * 1024 * 1024;
+    config.buffer_count = 16;
+    config.max_frame_bytes = max_frame_bytes;
+    config.use_direct_io = true;
+    return config;
+}
@@ -0,0 +1,100 @@
+// segment_recorder.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SEGMENT_RECORDER_H
+#define SEGMENT_RECORDER_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Struct to hold the recorder configuration
+struct SEGMENT_RECORDER_CONFIG
+{
+    string folder_path;        // Where the segment files are created
+    string prefix;             // Segment file prefix -> <prefix>_<index>.rec
+    uint64_t segment_size;     // Bytes preallocated per segment file
+    unsigned int buffer_count; // Aligned staging buffers (frames that can be queued)
+    size_t max_frame_bytes;    // Largest pixel payload that will be recorded
+    bool use_direct_io;        // O_DIRECT (falls back to buffered + DONTNEED if the filesystem refuses)
+};
+
+// Struct to hold the recorder counters
+struct SEGMENT_RECORDER_STATS
+{
+    uint64_t frames_recorded;
+    uint64_t bytes_recorded;     // Including header and alignment padding
+    uint64_t segments_opened;
+    uint64_t stalls;             // consume_frame had to wait for a staging buffer
+    uint64_t errors;
+    double max_write_ms;         // Slowest single write
+};
+
+// Records frames into preallocated segment files. Every record is FRAME_HEADER + pixels, padded to PAGE_ALIGNMENT,
+// so each frame starts on a page boundary and the writes can bypass the page cache.
+class SEGMENT_RECORDER : public FRAME_SINK
+{
+    private:
+        struct WRITE_JOB
+        {
+            unsigned int buffer_index;
+            size_t record_size;
+        };
+
+        SEGMENT_RECORDER_CONFIG config;
+        ALIGNED_BUFFER_POOL buffer_pool;
+
+        thread writer_thread;
+        deque<WRITE_JOB> jobs;
+        unsigned int jobs_in_progress;
+        bool stopping;
+        mutex recorder_mutex;
+        condition_variable job_available;
+        condition_variable jobs_done;
+
+        // Only touched by the writer thread
+        int segment_fd;
+        unsigned int segment_index;
+        uint64_t segment_offset;
+        bool direct_io_active;
+
+        atomic<uint64_t> frames_recorded;
+        atomic<uint64_t> bytes_recorded;
+        atomic<uint64_t> segments_opened;
+        atomic<uint64_t> stalls;
+        atomic<uint64_t> errors;
+        atomic<uint64_t> max_write_us;
+
+        void writer_loop();
+        int open_segment();     // Create + fallocate the next segment
+        void close_segment();   // Trim the unused preallocation and close
+        int write_record(const char* buffer, size_t record_size);
+
+    public:
+        SEGMENT_RECORDER();
+        ~SEGMENT_RECORDER();
+
+        int init(const SEGMENT_RECORDER_CONFIG& recorder_config);   // Allocate the buffers and start the writer thread
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        int flush();
+        const char* get_sink_name() const;
+
+        SEGMENT_RECORDER_STATS get_stats() const;
+};
+
+// Default configuration for frames up to max_frame_bytes
+SEGMENT_RECORDER_CONFIG default_segment_recorder_config(const string& folder_path, size_t max_frame_bytes);
+
+#endif // SEGMENT_RECORDER_H
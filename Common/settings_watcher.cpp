@@ -0,0 +1,188 @@
+// Description: inotify watch of the camera settings file, re-parsed in the background while the cameras stream
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "settings_watcher.h"
+#include "async_logger.h"
+
+using namespace std;
+
+/**
+ * Constructor for the SETTINGS_WATCHER class.
+ */
+SETTINGS_WATCHER::SETTINGS_WATCHER()
+    : inotify_fd(-1), running(false), has_update(false), reload_count(0), rejected_count(0)
+{
+}
+
+/**
+ * Destructor for the SETTINGS_WATCHER class -> stops the watcher thread.
+ */
+SETTINGS_WATCHER::~SETTINGS_WATCHER()
+{
+    stop();
+}
+
+/**
+ * Starts watching the settings file. The directory is watched rather than the file, because editors replace the
+ * file (write a temp file, rename it over the old one) and a watch on the old inode would stop at the first save.
+ * @param path: The settings file.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SETTINGS_WATCHER::start(const string& path)
+{
+    size_t slash = path.rfind('/');
+    string directory = slash == string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    file_name = slash == string::npos ? path : path.substr(slash + 1);
+    file_path = path;
+
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0)
+    {
+        cerr << "[Reload] Unable to start inotify: " << strerror(errno) << endl;
+        return -1;
+    }
+
+    if (inotify_add_watch(inotify_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        cerr << "[Reload] Unable to watch " << directory << ": " << strerror(errno) << endl;
+        close(inotify_fd);
+        inotify_fd = -1;
+        return -1;
+    }
+
+    running = true;
+    watcher_thread = thread(&SETTINGS_WATCHER::watcher_loop, this);
+
+    cout << "[Reload] Watching " << file_path << " for changes" << endl;
+    return 0;
+}
+
+/**
+ * Stops the watcher thread. A version that was read but not taken is dropped.
+ */
+void SETTINGS_WATCHER::stop()
+{
+    running = false;
+    if (watcher_thread.joinable())
+    {
+        watcher_thread.join();
+    }
+
+    if (inotify_fd >= 0)
+    {
+        close(inotify_fd);
+        inotify_fd = -1;
+    }
+}
+
+/**
+ * Watcher thread: waits for a write or rename of the file, lets the burst of events of one save settle, then re-parses it.
+ */
+void SETTINGS_WATCHER::watcher_loop()
+{
+    // Events are variable length, aligned like the kernel writes them
+    alignas(struct inotify_event) char buffer[4096];
+
+    while (running)
+    {
+        struct pollfd poll_fd = {inotify_fd, POLLIN, 0};
+        if (poll(&poll_fd, 1, 200) <= 0)    // Wake up regularly to notice stop()
+        {
+            continue;
+        }
+
+        bool changed = false;
+        ssize_t bytes;
+        while ((bytes = read(inotify_fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (char* position = buffer; position < buffer + bytes; )
+            {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(position);
+                if (event->len > 0 && file_name == event->name)
+                {
+                    changed = true;
+                }
+                position += sizeof(struct inotify_event) + event->len;
+            }
+        }
+
+        if (changed)
+        {
+            // An editor may write the file in several steps, parse it once they are done
+            this_thread::sleep_for(chrono::milliseconds(50));
+            while (read(inotify_fd, buffer, sizeof(buffer)) > 0)
+            {
+            }
+            reload();
+        }
+    }
+}
+
+/**
+ * Parses the file and keeps it for take_update() if every line is valid.
+ */
+void SETTINGS_WATCHER::reload()
+{
+    CAMERA_CONFIG_FILE config_file;
+    if (config_file.load(file_path) != 0)
+    {
+        rejected_count++;
+        log_error(log_tag("Reload"), "{} has errors, the cameras keep their current settings", file_path);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(update_mutex);
+        update = config_file;
+        has_update = true;
+    }
+    reload_count++;
+
+    log_info(log_tag("Reload"), "{} changed, applying it between the next frames", file_path);
+}
+
+/**
+ * Takes the newest valid version of the file, if it changed since the last call. Called by the capture loop between frames.
+ * @param config: Receives the new version.
+ * @return true if there was a new version.
+ */
+bool SETTINGS_WATCHER::take_update(CAMERA_CONFIG_FILE& config)
+{
+    if (!has_update.load(memory_order_acquire))
+    {
+        return false;
+    }
+
+    lock_guard<mutex> lock(update_mutex);
+    config = update;
+    has_update = false;
+    return true;
+}
+
+/**
+ * Returns how often the file was re-read since start.
+ * @return The number of valid versions read.
+ */
+uint64_t SETTINGS_WATCHER::get_reload_count() const
+{
+    return reload_count.load();
+}
+
+/**
+ * Returns how often a changed file was ignored since start.
+ * @return The number of versions with errors.
+ */
+uint64_t SETTINGS_WATCHER::get_rejected_count() const
+{
+    return rejected_count.load();
+}
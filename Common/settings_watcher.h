@@ -0,0 +1,73 @@
+// settings_watcher.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SETTINGS_WATCHER_H
+#define SETTINGS_WATCHER_H
+
+#include "camera_config_file.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// A settings change written to a streaming camera, waiting for the first frame taken with it
+struct SETTINGS_CHANGE
+{
+    bool pending;
+    string description;             // The new values, for the log
+    uint64_t written_timestamp_ns;  // Camera clock right after the write, 0 -> unknown, the next frame counts
+};
+
+/**
+ * Checks if a frame is the first one taken with a pending change. Frames exposed before the write can still be queued
+ * in the stream buffers, so the frame timestamp is compared with the camera clock latched right after the write.
+ * @param change: The pending change.
+ * @param frame_timestamp_ns: Camera timestamp of the frame.
+ * @return true if the frame was taken after the write.
+ */
+inline bool settings_change_took_effect(const SETTINGS_CHANGE& change, uint64_t frame_timestamp_ns)
+{
+    return change.pending && frame_timestamp_ns >= change.written_timestamp_ns;
+}
+
+// Watches the camera settings file with inotify while the cameras stream. A background thread re-parses the file after
+// every write (editors that save to a temp file and rename it included) and keeps the newest valid version; a file
+// with errors is reported and ignored, so the cameras keep their settings. The capture loop picks the new version up
+// between frames with take_update(), which is a single atomic load while nothing changed.
+class SETTINGS_WATCHER
+{
+    private:
+        string file_path;
+        string file_name;   // Without the directory, to match the inotify events
+        int inotify_fd;
+        atomic<bool> running;
+        thread watcher_thread;
+
+        mutex update_mutex;
+        CAMERA_CONFIG_FILE update;      // Newest valid version, not yet taken
+        atomic<bool> has_update;
+
+        atomic<uint64_t> reload_count;
+        atomic<uint64_t> rejected_count;
+
+        void watcher_loop();
+        void reload();
+
+    public:
+        SETTINGS_WATCHER();
+        ~SETTINGS_WATCHER();
+
+        int start(const string& path);  // Watch the directory of the file and start the watcher thread
+        void stop();
+
+        bool take_update(CAMERA_CONFIG_FILE& config);   // True (and the new version in config) if the file changed since the last call
+        uint64_t get_reload_count() const;      // Valid versions read
+        uint64_t get_rejected_count() const;    // Versions with errors, ignored
+};
+
+#endif // SETTINGS_WATCHER_H
@@ -0,0 +1,421 @@
+// Description: Latest-frame ring in POSIX shared memory (seqlock slots, futex wakeups) and its zero-copy reader
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "aligned_buffer_pool.h"
+#include "shm_frame_ring.h"
+
+using namespace std;
+
+// Slots start on the first page after the ring header
+static const size_t SHM_SLOTS_OFFSET = PAGE_ALIGNMENT;
+
+/**
+ * Constructor for the SHM_FRAME_PUBLISHER class.
+ */
+SHM_FRAME_PUBLISHER::SHM_FRAME_PUBLISHER()
+    : shm_fd(-1), mapping(nullptr), mapping_size(0), ring(nullptr)
+{
+}
+
+/**
+ * Destructor for the SHM_FRAME_PUBLISHER class -> unmaps and removes the shared memory object.
+ */
+SHM_FRAME_PUBLISHER::~SHM_FRAME_PUBLISHER()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mapping_size);
+    }
+
+    if (shm_fd >= 0)
+    {
+        close(shm_fd);
+        shm_unlink(shm_name.c_str());   // Readers that still have it mapped keep their mapping
+    }
+}
+
+/**
+ * Creates the shared memory object and lays out the ring. An old object with the same name is replaced.
+ * @param name: The shm object name, e.g. "/spinnaker_frames".
+ * @param slot_count: The number of frames kept in the ring.
+ * @param max_frame_bytes: The largest pixel payload.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SHM_FRAME_PUBLISHER::init(const string& name, unsigned int slot_count, size_t max_frame_bytes)
+{
+    if (name.empty() || name[0] != '/' || slot_count == 0)
+    {
+        cerr << "[SHM] Invalid ring name '" << name << "' or slot count " << slot_count << "\n";
+        return -1;
+    }
+
+    shm_name = name;
+    shm_unlink(shm_name.c_str());
+
+    shm_fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (shm_fd < 0)
+    {
+        cerr << "[SHM] shm_open " << shm_name << " failed: " << strerror(errno) << "\n";
+        return -1;
+    }
+
+    size_t slot_stride = align_up(sizeof(SHM_SLOT_HEADER) + max_frame_bytes, PAGE_ALIGNMENT);
+    mapping_size = SHM_SLOTS_OFFSET + slot_stride * slot_count;
+
+    if (ftruncate(shm_fd, static_cast<off_t>(mapping_size)) != 0)
+    {
+        cerr << "[SHM] Could not size " << shm_name << " to " << mapping_size << " bytes: " << strerror(errno) << "\n";
+        return -1;
+    }
+
+    void* address = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    if (address == MAP_FAILED)
+    {
+        cerr << "[SHM] mmap " << shm_name << " failed: " << strerror(errno) << "\n";
+        mapping_size = 0;
+        return -1;
+    }
+
+    // Touch every page now so the first frames do not pay for page faults
+    mapping = static_cast<uint8_t*>(address);
+    memset(mapping, 0, mapping_size);
+
+    ring = reinterpret_cast<SHM_RING_HEADER*>(mapping);
+    ring->version = SHM_RING_VERSION;
+    ring->slot_count = slot_count;
+    ring->slot_stride = slot_stride;
+    ring->data_capacity = slot_stride - sizeof(SHM_SLOT_HEADER);
+    ring->writer_pid = static_cast<uint32_t>(getpid());
+
+    // Readers check the magic last, so they never see a half initialized header
+    __atomic_store_n(&ring->magic, SHM_RING_MAGIC, __ATOMIC_RELEASE);
+
+    cout << "[SHM] Publishing frames to " << shm_name << " (" << slot_count << " x " << slot_stride << " byte slots)\n";
+    return 0;
+}
+
+/**
+ * Copies a frame into the next slot and wakes the readers. Never waits for readers: a reader that is still
+ * looking at the slot notices the overwrite through the slot sequence.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SHM_FRAME_PUBLISHER::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    if (ring == nullptr)
+    {
+        return -1;
+    }
+
+    if (header.data_size > ring->data_capacity)
+    {
+        cerr << "[SHM] Frame " << header.frame_id << " (" << header.data_size << " bytes) does not fit a slot\n";
+        return -1;
+    }
+
+    uint64_t index = ring->write_index;     // Only this process writes it
+    unsigned int slot_number = static_cast<unsigned int>(index % ring->slot_count);
+    uint8_t* slot_address = mapping + SHM_SLOTS_OFFSET + slot_number * ring->slot_stride;
+    SHM_SLOT_HEADER* slot = reinterpret_cast<SHM_SLOT_HEADER*>(slot_address);
+
+    // Seqlock write: odd sequence, copy, even sequence
+    uint64_t sequence = slot->sequence;
+    __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    slot->frame_index = index;
+    slot->frame = header;
+    memcpy(slot_address + sizeof(SHM_SLOT_HEADER), data, header.data_size);
+    slot->publish_time_ns = latency_now_ns();
+
+    __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->write_index, index + 1, __ATOMIC_RELEASE);
+
+    // Shared (not FUTEX_PRIVATE) wake so readers in other processes are woken
+    __atomic_add_fetch(&ring->futex_word, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &ring->futex_word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+
+    return 0;
+}
+
+/**
+ * Returns the name of the sink for logging.
+ * @return The name of the sink.
+ */
+const char* SHM_FRAME_PUBLISHER::get_sink_name() const
+{
+    return "SHM";
+}
+
+/**
+ * Returns the number of frames published so far.
+ * @return The number of frames published.
+ */
+uint64_t SHM_FRAME_PUBLISHER::get_published_count() const
+{
+    return ring != nullptr ? __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE) : 0;
+}
+
+/**
+ * Constructor for the SHM_FRAME_READER class.
+ */
+SHM_FRAME_READER::SHM_FRAME_READER()
+    : shm_fd(-1), mapping(nullptr), mapping_size(0), ring(nullptr)
+{
+}
+
+/**
+ * Destructor for the SHM_FRAME_READER class.
+ */
+SHM_FRAME_READER::~SHM_FRAME_READER()
+{
+    close_ring();
+}
+
+/**
+ * Maps an existing ring read-only and checks its layout.
+ * @param name: The shm object name used by the publisher.
+ * @return 0 if successful, -1 otherwise.
+ */
+int SHM_FRAME_READER::open_ring(const string& name)
+{
+    close_ring();
+
+    shm_fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (shm_fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(shm_fd, &info) != 0 || static_cast<size_t>(info.st_size) < SHM_SLOTS_OFFSET)
+    {
+        close_ring();
+        return -1;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, shm_fd, 0);
+    if (address == MAP_FAILED)
+    {
+        cerr << "[SHM] mmap " << name << " failed: " << strerror(errno) << "\n";
+        close_ring();
+        return -1;
+    }
+
+    mapping = static_cast<const uint8_t*>(address);
+    mapping_size = static_cast<size_t>(info.st_size);
+    ring = reinterpret_cast<SHM_RING_HEADER*>(const_cast<uint8_t*>(mapping));
+
+    if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != SHM_RING_MAGIC || ring->version != SHM_RING_VERSION ||
+        ring->slot_count == 0 || SHM_SLOTS_OFFSET + ring->slot_stride * ring->slot_count > mapping_size)
+    {
+        cerr << "[SHM] " << name << " is not a frame ring (or was created by a different version)\n";
+        close_ring();
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Unmaps the ring.
+ */
+void SHM_FRAME_READER::close_ring()
+{
+    if (mapping != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(mapping), mapping_size);
+    }
+
+    if (shm_fd >= 0)
+    {
+        close(shm_fd);
+    }
+
+    shm_fd = -1;
+    mapping = nullptr;
+    mapping_size = 0;
+    ring = nullptr;
+}
+
+/**
+ * Returns a slot header.
+ * @param slot: The slot number.
+ * @return Pointer to the slot header in shared memory.
+ */
+const SHM_SLOT_HEADER* SHM_FRAME_READER::get_slot(unsigned int slot) const
+{
+    return reinterpret_cast<const SHM_SLOT_HEADER*>(mapping + SHM_SLOTS_OFFSET + slot * ring->slot_stride);
+}
+
+/**
+ * Returns the number of frames published so far.
+ * @return The number of frames published.
+ */
+uint64_t SHM_FRAME_READER::get_write_index() const
+{
+    return ring != nullptr ? __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE) : 0;
+}
+
+/**
+ * Sleeps on the ring futex until a frame newer than last_index is published.
+ * @param last_index: The write index the caller has already seen.
+ * @param timeout_ms: The longest time to wait.
+ * @return True if a new frame is available, false on timeout.
+ */
+bool SHM_FRAME_READER::wait_for_frame(uint64_t last_index, int timeout_ms)
+{
+    if (ring == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t deadline = latency_now_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ULL;
+
+    while (true)
+    {
+        // Read the futex word before the index: a publish in between changes the word and FUTEX_WAIT returns at once
+        uint32_t word = __atomic_load_n(&ring->futex_word, __ATOMIC_ACQUIRE);
+        if (get_write_index() > last_index)
+        {
+            return true;
+        }
+
+        uint64_t now = latency_now_ns();
+        if (now >= deadline)
+        {
+            return false;
+        }
+
+        struct timespec timeout;
+        timeout.tv_sec = static_cast<time_t>((deadline - now) / 1000000000ULL);
+        timeout.tv_nsec = static_cast<long>((deadline - now) % 1000000000ULL);
+        syscall(SYS_futex, &ring->futex_word, FUTEX_WAIT, word, &timeout, nullptr, 0);
+    }
+}
+
+/**
+ * Finds the newest stable frame, optionally filtered by camera serial and ROI offset. The returned view points
+ * into shared memory; check is_view_valid() after reading the data.
+ * @param view: The view to fill.
+ * @param serial: Only frames from this camera (empty = any camera).
+ * @param offset_x: Only frames with this ROI offset (-1 = any offset).
+ * @return True if a frame was found, false otherwise.
+ */
+bool SHM_FRAME_READER::get_latest(SHM_FRAME_VIEW& view, const string& serial, int64_t offset_x) const
+{
+    if (ring == nullptr)
+    {
+        return false;
+    }
+
+    uint64_t write_index = get_write_index();
+    uint64_t slot_count = ring->slot_count;
+
+    // Walk back from the newest frame; slots being written (odd) or already reused for a newer frame are skipped
+    for (uint64_t back = 1; back <= slot_count && back <= write_index; ++back)
+    {
+        uint64_t frame_index = write_index - back;
+        unsigned int slot_number = static_cast<unsigned int>(frame_index % slot_count);
+        const SHM_SLOT_HEADER* slot = get_slot(slot_number);
+
+        uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if ((sequence & 1) != 0 || slot->frame_index != frame_index)
+        {
+            continue;
+        }
+
+        if (!serial.empty() && strncmp(slot->frame.serial, serial.c_str(), sizeof(slot->frame.serial)) != 0)
+        {
+            continue;
+        }
+
+        if (offset_x >= 0 && static_cast<int64_t>(slot->frame.offset_x) != offset_x)
+        {
+            continue;
+        }
+
+        view.header = &slot->frame;
+        view.data = reinterpret_cast<const uint8_t*>(slot) + sizeof(SHM_SLOT_HEADER);
+        view.frame_index = frame_index;
+        view.publish_time_ns = slot->publish_time_ns;
+        view.sequence = sequence;
+        view.slot = slot_number;
+
+        // The filter fields were read without the lock, make sure they belonged to this frame
+        if (is_view_valid(view))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Checks that the writer has not started overwriting the slot since the view was taken.
+ * @param view: The view returned by get_latest().
+ * @return True if the data read through the view is consistent, false otherwise.
+ */
+bool SHM_FRAME_READER::is_view_valid(const SHM_FRAME_VIEW& view) const
+{
+    if (ring == nullptr)
+    {
+        return false;
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&get_slot(view.slot)->sequence, __ATOMIC_RELAXED) == view.sequence;
+}
+
+/**
+ * Copies the newest frame out of shared memory, retrying if the writer overwrote it during the copy.
+ * @param header: The frame header of the copied frame.
+ * @param data: Receives the pixel data (resized as needed).
+ * @param serial: Only frames from this camera (empty = any camera).
+ * @param offset_x: Only frames with this ROI offset (-1 = any offset).
+ * @return True if a frame was copied, false otherwise.
+ */
+bool SHM_FRAME_READER::copy_latest(FRAME_HEADER& header, vector<uint8_t>& data, const string& serial, int64_t offset_x) const
+{
+    const int max_attempts = 8;
+
+    for (int attempt = 0; attempt < max_attempts; ++attempt)
+    {
+        SHM_FRAME_VIEW view;
+        if (!get_latest(view, serial, offset_x))
+        {
+            return false;
+        }
+
+        header = *view.header;
+        if (header.data_size > ring->data_capacity)
+        {
+            continue;   // Torn header, the sequence check below would fail anyway
+        }
+
+        data.resize(header.data_size);
+        memcpy(data.data(), view.data, header.data_size);
+
+        if (is_view_valid(view))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,120 @@
+// shm_frame_ring.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SHM_FRAME_RING_H
+#define SHM_FRAME_RING_H
+
+#include "frame_format.h"
+#include "frame_sink.h"
+#include "latency_histogram.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const uint32_t SHM_RING_MAGIC = 0x52485346;  // "FSHR"
+const uint32_t SHM_RING_VERSION = 1;
+
+// Shared memory layout (one POSIX shm object, e.g. /dev/shm/spinnaker_frames):
+//   SHM_RING_HEADER | slot 0 | slot 1 | ... each slot = SHM_SLOT_HEADER + pixel data, slot_stride bytes apart
+// Counters are accessed with __atomic builtins so the layout stays plain data shared by both processes.
+struct SHM_RING_HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t futex_word;        // Incremented on every publish, readers can FUTEX_WAIT on it
+    uint64_t slot_stride;       // Bytes between slots (page aligned)
+    uint64_t data_capacity;     // Largest pixel payload per slot
+    uint64_t write_index;       // Frames published so far; the newest is in slot (write_index - 1) % slot_count
+    uint32_t writer_pid;
+    uint8_t reserved[28];
+};
+
+static_assert(sizeof(SHM_RING_HEADER) == 72, "SHM_RING_HEADER layout changed");
+
+// Per-slot header. sequence is a seqlock: odd while the writer is copying, even when the slot is stable.
+struct SHM_SLOT_HEADER
+{
+    uint64_t sequence;
+    uint64_t frame_index;       // Publish counter of the frame in this slot
+    uint64_t publish_time_ns;   // latency_now_ns() when the frame was published (steady_clock = CLOCK_MONOTONIC on Linux, so other processes can compare)
+    uint64_t reserved;
+    FRAME_HEADER frame;         // Serial, ROI offset, camera timestamp, dimensions, stride, pixel format
+    uint8_t padding[16];        // Pixel data starts 128 bytes into the slot
+};
+
+static_assert(sizeof(SHM_SLOT_HEADER) == 128, "SHM_SLOT_HEADER layout changed");
+
+// Struct to hold a zero-copy view of a slot
+struct SHM_FRAME_VIEW
+{
+    const FRAME_HEADER* header;     // Points into shared memory
+    const uint8_t* data;            // Points into shared memory
+    uint64_t frame_index;
+    uint64_t publish_time_ns;
+    uint64_t sequence;              // Seqlock value when the view was taken
+    unsigned int slot;
+};
+
+// Writer side: publishes every frame into the next slot. Never blocks on readers.
+class SHM_FRAME_PUBLISHER : public FRAME_SINK
+{
+    private:
+        string shm_name;
+        int shm_fd;
+        uint8_t* mapping;
+        size_t mapping_size;
+        SHM_RING_HEADER* ring;
+
+    public:
+        SHM_FRAME_PUBLISHER();
+        ~SHM_FRAME_PUBLISHER();
+
+        // Creates (or replaces) the shm object. name must start with '/', e.g. "/spinnaker_frames".
+        int init(const string& name, unsigned int slot_count, size_t max_frame_bytes);
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        const char* get_sink_name() const;
+
+        uint64_t get_published_count() const;
+};
+
+// Reader side: maps the ring read-only. Views are zero-copy; check is_view_valid() after using the data.
+class SHM_FRAME_READER
+{
+    private:
+        int shm_fd;
+        const uint8_t* mapping;
+        size_t mapping_size;
+        SHM_RING_HEADER* ring;
+
+        const SHM_SLOT_HEADER* get_slot(unsigned int slot) const;
+
+    public:
+        SHM_FRAME_READER();
+        ~SHM_FRAME_READER();
+
+        int open_ring(const string& name);  // Returns -1 if the publisher has not created the ring yet
+        void close_ring();
+
+        uint64_t get_write_index() const;   // Frames published so far
+
+        // Blocks until more than last_index frames were published (futex, no polling). Returns false on timeout.
+        bool wait_for_frame(uint64_t last_index, int timeout_ms);
+
+        // Newest stable frame (optionally only from the given serial / offset_x). Returns false if none.
+        bool get_latest(SHM_FRAME_VIEW& view, const string& serial = "", int64_t offset_x = -1) const;
+
+        // True if the writer has not touched the slot since the view was taken (call after reading the data)
+        bool is_view_valid(const SHM_FRAME_VIEW& view) const;
+
+        // Copies the newest frame, retrying if the writer overwrote it during the copy
+        bool copy_latest(FRAME_HEADER& header, vector<uint8_t>& data, const string& serial = "", int64_t offset_x = -1) const;
+};
+
+#endif // SHM_FRAME_RING_H
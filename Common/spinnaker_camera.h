@@ -0,0 +1,494 @@
+// spinnaker_camera.h Header File -> CAMERA_BACKEND for a Spinnaker camera
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_CAMERA_H
+#define SPINNAKER_CAMERA_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "camera_backend.h"
+#include "spinnaker_frame.h"
+#include "spinnaker_profile.h"
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace Spinnaker::GenICam;
+using namespace std;
+
+class SPINNAKER_CAMERA : public CAMERA_BACKEND
+{
+    private:
+        CameraPtr camera;
+        INodeMap* node_map;
+        ImageProcessor processor;
+        ImagePtr image;             // Frame handed out by next_frame, until release_frame
+        ImagePtr converted_image;
+        uint32_t pixel_format;
+        string serial;
+        bool acquiring;
+
+        static int set_enum_node(INodeMap& nodes, const char* name, const char* entry);
+        static int set_int_node(INodeMap& nodes, const char* name, int64_t value);
+        static int64_t get_int_node(INodeMap& nodes, const char* name);
+
+    public:
+        explicit SPINNAKER_CAMERA(CameraPtr camera_pointer);
+        ~SPINNAKER_CAMERA();
+
+        int init();
+        int deinit();
+
+        int set_pixel_format(uint32_t format);
+        int set_roi(int64_t width, int64_t height, int64_t offset_x, int64_t offset_y);
+        int set_exposure(double exposure_us);
+        int set_gain(double gain_db);
+        int set_gamma(double gamma);
+
+        int start();
+        int stop();
+
+        int next_frame(CAMERA_FRAME& frame, unsigned int timeout_ms);
+        void release_frame();
+
+        string get_serial() const;
+        size_t get_max_frame_bytes() const;
+        const char* get_backend_name() const;
+};
+
+/**
+ * Constructor for the SPINNAKER_CAMERA class.
+ * @param camera_pointer: The camera from the Spinnaker camera list.
+ */
+inline SPINNAKER_CAMERA::SPINNAKER_CAMERA(CameraPtr camera_pointer)
+    : camera(camera_pointer), node_map(nullptr), pixel_format(FRAME_PIXEL_FORMAT_MONO8), acquiring(false)
+{
+    processor.SetColorProcessing(SPINNAKER_COLOR_PROCESSING_ALGORITHM_HQ_LINEAR);
+}
+
+/**
+ * Destructor for the SPINNAKER_CAMERA class, stops acquisition and deinitializes the camera.
+ */
+inline SPINNAKER_CAMERA::~SPINNAKER_CAMERA()
+{
+    deinit();
+}
+
+/**
+ * Selects an enumeration entry by name.
+ * @param nodes: The node map.
+ * @param name: The enumeration node.
+ * @param entry: The entry.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_enum_node(INodeMap& nodes, const char* name, const char* entry)
+{
+    CEnumerationPtr ptr_enumeration = nodes.GetNode(name);
+    if (!IsReadable(ptr_enumeration) || !IsWritable(ptr_enumeration))
+    {
+        return -1;
+    }
+
+    CEnumEntryPtr ptr_entry = ptr_enumeration->GetEntryByName(entry);
+    if (!IsReadable(ptr_entry))
+    {
+        return -1;
+    }
+
+    ptr_enumeration->SetIntValue(ptr_entry->GetValue());
+    return 0;
+}
+
+/**
+ * Sets an integer node, clamped to its range and rounded down to its increment.
+ * @param nodes: The node map.
+ * @param name: The node.
+ * @param value: The value.
+ * @return 0 if successful, -1 if the node is not writable.
+ */
+inline int SPINNAKER_CAMERA::set_int_node(INodeMap& nodes, const char* name, int64_t value)
+{
+    CIntegerPtr ptr_integer = nodes.GetNode(name);
+    if (!IsReadable(ptr_integer) || !IsWritable(ptr_integer))
+    {
+        cerr << "[Camera] Unable to set " << name << endl;
+        return -1;
+    }
+
+    int64_t minimum = ptr_integer->GetMin();
+    int64_t increment = max<int64_t>(1, ptr_integer->GetInc());
+    value = min(max(value, minimum), ptr_integer->GetMax());
+    ptr_integer->SetValue(value - (value - minimum) % increment);
+    return 0;
+}
+
+/**
+ * Reads an integer node.
+ * @param nodes: The node map.
+ * @param name: The node.
+ * @return The value, 0 if the node is not readable.
+ */
+inline int64_t SPINNAKER_CAMERA::get_int_node(INodeMap& nodes, const char* name)
+{
+    CIntegerPtr ptr_integer = nodes.GetNode(name);
+    return IsReadable(ptr_integer) ? ptr_integer->GetValue() : 0;
+}
+
+/**
+ * Initializes the camera, reads the serial number and selects continuous acquisition with oldest first buffering.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::init()
+{
+    try
+    {
+        camera->Init();
+        node_map = &camera->GetNodeMap();
+
+        CStringPtr ptr_device_serial = camera->GetTLDeviceNodeMap().GetNode("DeviceSerialNumber");
+        if (IsReadable(ptr_device_serial))
+        {
+            serial = string(ptr_device_serial->GetValue());
+        }
+
+        if (set_enum_node(*node_map, "AcquisitionMode", "Continuous") != 0)
+        {
+            cerr << "[Camera] " << serial << ": unable to set AcquisitionMode to Continuous\n";
+            return -1;
+        }
+        set_enum_node(camera->GetTLStreamNodeMap(), "StreamBufferHandlingMode", "OldestFirst");
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] Init failed: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Stops acquisition and deinitializes the camera.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::deinit()
+{
+    if (!node_map)
+    {
+        return 0;
+    }
+
+    int result = stop();
+    try
+    {
+        camera->DeInit();
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": DeInit failed: " << e.what() << endl;
+        result = -1;
+    }
+    node_map = nullptr;
+    return result;
+}
+
+/**
+ * Selects the pixel format. If the camera cannot deliver BGR8 itself it sends BayerRG8 and next_frame converts.
+ * @param format: One of FRAME_PIXEL_FORMAT.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_pixel_format(uint32_t format)
+{
+    const char* names[] = { "", "Mono8", "Mono16", "BGR8", "BayerRG8" };
+    if (!node_map || acquiring || format == FRAME_PIXEL_FORMAT_UNKNOWN || format > FRAME_PIXEL_FORMAT_BAYER_RG8)
+    {
+        return -1;
+    }
+
+    try
+    {
+        if (set_enum_node(*node_map, "PixelFormat", names[format]) != 0 &&
+            (format != FRAME_PIXEL_FORMAT_BGR8 || set_enum_node(*node_map, "PixelFormat", "BayerRG8") != 0))
+        {
+            cerr << "[Camera] " << serial << ": pixel format " << names[format] << " not available\n";
+            return -1;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        return -1;
+    }
+
+    pixel_format = format;
+    return 0;
+}
+
+/**
+ * Sets the ROI. The offsets are cleared first so the new width/height are not limited by the old offsets.
+ * @param width: Width in pixels.
+ * @param height: Height in pixels.
+ * @param offset_x: OffsetX.
+ * @param offset_y: OffsetY.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_roi(int64_t width, int64_t height, int64_t offset_x, int64_t offset_y)
+{
+    if (!node_map || acquiring)
+    {
+        return -1;
+    }
+
+    int result = 0;
+    try
+    {
+        result |= set_int_node(*node_map, "OffsetX", 0);
+        result |= set_int_node(*node_map, "OffsetY", 0);
+        result |= set_int_node(*node_map, "Width", width);
+        result |= set_int_node(*node_map, "Height", height);
+        result |= set_int_node(*node_map, "OffsetX", offset_x);
+        result |= set_int_node(*node_map, "OffsetY", offset_y);
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        result = -1;
+    }
+    return result;
+}
+
+/**
+ * Turns off automatic exposure and sets the exposure time.
+ * @param exposure_us: Exposure time in microseconds.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_exposure(double exposure_us)
+{
+    if (!node_map)
+    {
+        return -1;
+    }
+
+    try
+    {
+        if (set_float_setting(*node_map, "ExposureAuto", nullptr, "ExposureTime", exposure_us) < 0)
+        {
+            cerr << "[Camera] Unable to set ExposureTime" << endl;
+            return -1;
+        }
+        return 0;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        return -1;
+    }
+}
+
+/**
+ * Turns off automatic gain and sets the gain.
+ * @param gain_db: Gain in dB.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_gain(double gain_db)
+{
+    if (!node_map)
+    {
+        return -1;
+    }
+
+    try
+    {
+        if (set_float_setting(*node_map, "GainAuto", nullptr, "Gain", gain_db) < 0)
+        {
+            cerr << "[Camera] Unable to set Gain" << endl;
+            return -1;
+        }
+        return 0;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        return -1;
+    }
+}
+
+/**
+ * Enables gamma correction and sets the gamma.
+ * @param gamma: The gamma.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::set_gamma(double gamma)
+{
+    if (!node_map)
+    {
+        return -1;
+    }
+
+    try
+    {
+        if (set_float_setting(*node_map, nullptr, "GammaEnable", "Gamma", gamma) < 0)
+        {
+            cerr << "[Camera] Unable to set Gamma" << endl;
+            return -1;
+        }
+        return 0;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        return -1;
+    }
+}
+
+/**
+ * Begins acquisition.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::start()
+{
+    if (!node_map)
+    {
+        return -1;
+    }
+
+    try
+    {
+        camera->BeginAcquisition();
+        acquiring = true;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": BeginAcquisition failed: " << e.what() << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Ends acquisition (releases a frame that is still held).
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int SPINNAKER_CAMERA::stop()
+{
+    if (!acquiring)
+    {
+        return 0;
+    }
+
+    release_frame();
+    acquiring = false;
+    try
+    {
+        camera->EndAcquisition();
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cerr << "[Camera] " << serial << ": EndAcquisition failed: " << e.what() << endl;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Waits for the next image and converts it to the selected pixel format if the camera delivers another one.
+ * @param frame: Receives the frame (valid until release_frame()).
+ * @param timeout_ms: Longest wait.
+ * @return 0 with a frame, 1 on a timeout or an incomplete image, -1 on an error.
+ */
+inline int SPINNAKER_CAMERA::next_frame(CAMERA_FRAME& frame, unsigned int timeout_ms)
+{
+    if (!acquiring)
+    {
+        return -1;
+    }
+
+    release_frame();
+    try
+    {
+        image = camera->GetNextImage(timeout_ms);
+        if (image->IsIncomplete())
+        {
+            release_frame();
+            return 1;
+        }
+
+        converted_image = to_frame_pixel_format(image->GetPixelFormat()) == pixel_format ? image :
+                          processor.Convert(image, pixel_format == FRAME_PIXEL_FORMAT_BGR8 ? PixelFormat_BGR8 :
+                                                   pixel_format == FRAME_PIXEL_FORMAT_MONO16 ? PixelFormat_Mono16 : PixelFormat_Mono8);
+
+        fill_frame_header(frame.header, converted_image, serial, get_int_node(*node_map, "OffsetX"), get_int_node(*node_map, "OffsetY"));
+        frame.header.frame_id = image->GetFrameID();        // Not carried over by Convert
+        frame.header.timestamp_ns = image->GetTimeStamp();
+        frame.data = converted_image->GetData();
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        release_frame();
+        if (e.GetError() == SPINNAKER_ERR_TIMEOUT)
+        {
+            return 1;
+        }
+        cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Gives the image buffer back to the camera.
+ */
+inline void SPINNAKER_CAMERA::release_frame()
+{
+    if (image)
+    {
+        try
+        {
+            image->Release();
+        }
+        catch (Spinnaker::Exception& e)
+        {
+            cerr << "[Camera] " << serial << ": " << e.what() << endl;
+        }
+    }
+    image = nullptr;
+    converted_image = nullptr;
+}
+
+/**
+ * Returns the camera serial number.
+ */
+inline string SPINNAKER_CAMERA::get_serial() const
+{
+    return serial;
+}
+
+/**
+ * Returns the frame size for the current ROI and pixel format.
+ */
+inline size_t SPINNAKER_CAMERA::get_max_frame_bytes() const
+{
+    if (!node_map)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(get_int_node(*node_map, "Width") * get_int_node(*node_map, "Height")) * frame_bytes_per_pixel(pixel_format);
+}
+
+/**
+ * Returns the backend name for logging.
+ */
+inline const char* SPINNAKER_CAMERA::get_backend_name() const
+{
+    return "spinnaker";
+}
+
+#endif // SPINNAKER_CAMERA_H
@@ -0,0 +1,123 @@
+// spinnaker_frame.h Header File -> Helpers to describe Spinnaker images with a FRAME_HEADER
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_FRAME_H
+#define SPINNAKER_FRAME_H
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "frame_format.h"
+
+#include <chrono>
+#include <limits>
+#include <string>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace std;
+
+/**
+ * Maps a Spinnaker pixel format to the frame pixel format.
+ * @param pixel_format: The Spinnaker pixel format.
+ * @return The matching FRAME_PIXEL_FORMAT, FRAME_PIXEL_FORMAT_UNKNOWN if not supported.
+ */
+inline uint32_t to_frame_pixel_format(PixelFormatEnums pixel_format)
+{
+    switch (pixel_format)
+    {
+        case PixelFormat_Mono8:
+            return FRAME_PIXEL_FORMAT_MONO8;
+        case PixelFormat_Mono16:
+            return FRAME_PIXEL_FORMAT_MONO16;
+        case PixelFormat_BGR8:
+            return FRAME_PIXEL_FORMAT_BGR8;
+        case PixelFormat_BayerRG8:
+            return FRAME_PIXEL_FORMAT_BAYER_RG8;
+        default:
+            return FRAME_PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
+/**
+ * Fills a frame header from a (converted) Spinnaker image.
+ * @param header: The header to fill.
+ * @param image: The image holding the pixel data.
+ * @param device_serial: The camera serial number.
+ * @param offset_x: The ROI OffsetX the image was captured with.
+ * @param offset_y: The ROI OffsetY the image was captured with.
+ */
+inline void fill_frame_header(FRAME_HEADER& header, const ImagePtr& image, const string& device_serial, int64_t offset_x, int64_t offset_y)
+{
+    init_frame_header(
+        header,
+        static_cast<uint32_t>(image->GetWidth()),
+        static_cast<uint32_t>(image->GetHeight()),
+        static_cast<uint32_t>(image->GetStride()),
+        to_frame_pixel_format(image->GetPixelFormat()),
+        image->GetImageSize()
+    );
+    header.frame_id = image->GetFrameID();
+    header.timestamp_ns = image->GetTimeStamp();
+    header.offset_x = offset_x;
+    header.offset_y = offset_y;
+    set_frame_serial(header, device_serial);
+}
+
+/**
+ * Latches the camera clock and returns how far it is from the host steady_clock, so image timestamps can be compared with host times.
+ * The uncertainty is half the latch round trip (tens of microseconds on USB3); the clocks drift, so call it again now and then.
+ * @param node_map: The camera node map.
+ * @param offset_ns: Receives host steady_clock ns - camera timestamp ns.
+ * @return 0 if successful, -1 if the camera has no TimestampLatch.
+ */
+inline int get_camera_clock_offset(INodeMap& node_map, int64_t& offset_ns)
+{
+    CCommandPtr ptr_timestamp_latch = node_map.GetNode("TimestampLatch");
+    CIntegerPtr ptr_timestamp_latch_value = node_map.GetNode("TimestampLatchValue");
+    if (!IsWritable(ptr_timestamp_latch) || !IsReadable(ptr_timestamp_latch_value))
+    {
+        return -1;
+    }
+
+    int64_t before_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    ptr_timestamp_latch->Execute();
+    int64_t after_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+
+    offset_ns = before_ns + (after_ns - before_ns) / 2 - ptr_timestamp_latch_value->GetValue();
+    return 0;
+}
+
+/**
+ * Reads the camera temperature and the current link throughput. Two register reads, so sample it about once per second.
+ * @param node_map: The camera node map.
+ * @param temperature_c: Receives DeviceTemperature in degrees Celsius, NaN if not readable.
+ * @param link_throughput: Receives DeviceLinkCurrentThroughput in bytes/s, NaN if not readable.
+ */
+inline void read_device_sensors(INodeMap& node_map, double& temperature_c, double& link_throughput)
+{
+    temperature_c = numeric_limits<double>::quiet_NaN();
+    link_throughput = numeric_limits<double>::quiet_NaN();
+
+    try
+    {
+        CFloatPtr ptr_temperature = node_map.GetNode("DeviceTemperature");
+        if (IsReadable(ptr_temperature))
+        {
+            temperature_c = ptr_temperature->GetValue();
+        }
+
+        CIntegerPtr ptr_throughput = node_map.GetNode("DeviceLinkCurrentThroughput");
+        if (IsReadable(ptr_throughput))
+        {
+            link_throughput = static_cast<double>(ptr_throughput->GetValue());
+        }
+    }
+    catch (const Spinnaker::Exception&)
+    {
+        // Unreadable in the current state -> reported as not available
+    }
+}
+
+#endif // SPINNAKER_FRAME_H
@@ -0,0 +1,454 @@
+// spinnaker_preview.h Header File -> Grab and convert threads feeding a live preview window with the newest frame
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_PREVIEW_H
+#define SPINNAKER_PREVIEW_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "frame_downscale.h"
+#include "latency_histogram.h"
+#include "latest_value_slot.h"
+#include "spinnaker_frame.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace std;
+
+const unsigned int PREVIEW_MAX_GRAB_ERRORS = 10;   // Consecutive failed grabs (not timeouts) before the preview gives up
+
+// Frame on its way to the preview window
+struct PREVIEW_FRAME
+{
+    ImagePtr image;             // Raw image from GetNextImage, after the convert thread the converted image (none if downscaled)
+    vector<uint8_t> pixels;     // Downscaled frame
+    const uint8_t* data;        // Pixels to show: the converted image or pixels
+    size_t width;
+    size_t height;
+    size_t stride;              // Bytes per row
+    uint64_t frame_id;
+    uint64_t arrival_ns;        // GetNextImage returned (latency_now_ns)
+    uint64_t frame_time_ns;     // Camera timestamp on the host clock, 0 if the camera has no TimestampLatch
+};
+
+// Live preview of one camera in three stages, so none of them waits for another:
+//   grab thread:    GetNextImage, hands the raw image to the convert thread (a raw image it did not take yet is
+//                   released back to the stream, so the camera buffers never back up behind the window)
+//   convert thread: area downscale to the window size (before the conversion if the camera already sends the pixel
+//                   format of CAMERA_TYPE), ImageProcessor::Convert to CAMERA_TYPE's pixel format, and on request
+//                   one frame at full resolution
+//   display:        the caller's UI thread takes the newest converted frame, a frame it did not show yet is dropped
+// A GetNextImage timeout is just no frame. Other grab errors back off, and after PREVIEW_MAX_GRAB_ERRORS in a row
+// (camera unplugged) the grab thread stops and is_grabbing() tells the UI loop to quit.
+// The latencies go into a LATENCY_MONITOR (grab_wait, exposure_to_arrival, conversion, display, end_to_end), each stage
+// is recorded by one thread.
+template <class CAMERA_TYPE>
+class SPINNAKER_PREVIEW
+{
+    private:
+        CameraPtr camera;
+        INodeMap* node_map;
+        uint64_t grab_timeout_ms;
+
+        LATEST_VALUE_SLOT<PREVIEW_FRAME> grabbed_frames;    // Grab thread -> convert thread
+        LATEST_VALUE_SLOT<PREVIEW_FRAME> converted_frames;  // Convert thread -> display
+        LATEST_VALUE_SLOT<PREVIEW_FRAME> full_frames;       // Convert thread -> caller, after request_full_frame()
+        LATENCY_MONITOR latency_monitor;
+
+        size_t window_width;
+        size_t window_height;
+        unsigned int downscale_factor;      // 0 -> from the frame and window size
+        atomic<bool> full_frame_requested;
+
+        atomic<bool> running;
+        atomic<bool> failed;
+        atomic<uint64_t> incomplete_count;
+        uint64_t shown_count;   // Display thread only
+        chrono::steady_clock::time_point start_time;
+
+        thread grab_thread;
+        thread convert_thread;
+
+        void grab_loop();
+        void convert_loop();
+        int prepare_frame(const ImageProcessor& processor, PREVIEW_FRAME& frame, bool& reported_size);
+
+    public:
+        SPINNAKER_PREVIEW();
+        ~SPINNAKER_PREVIEW();
+
+        void set_downscale(size_t width, size_t height, unsigned int factor);  // Before start(), factor 0 -> fit the window
+        int start(CameraPtr camera_pointer, INodeMap& camera_node_map, uint64_t timeout_ms, double report_interval_seconds);
+        bool is_grabbing() const;   // false once the grab thread gave up, the UI loop should quit
+        bool take_frame(PREVIEW_FRAME& frame, chrono::milliseconds timeout);   // Newest converted frame, false if none arrived
+        void frame_shown(const PREVIEW_FRAME& frame);                          // After the window painted it
+        void request_full_frame();                                             // Next frame also at full resolution
+        bool take_full_frame(PREVIEW_FRAME& frame, chrono::milliseconds timeout);   // Its converted image, false if not there yet
+        int stop();     // Joins the threads (before EndAcquisition), prints the frame counts and latencies
+};
+
+/**
+ * Constructor for the SPINNAKER_PREVIEW class.
+ */
+template <class CAMERA_TYPE>
+SPINNAKER_PREVIEW<CAMERA_TYPE>::SPINNAKER_PREVIEW()
+    : node_map(nullptr), grab_timeout_ms(1000), window_width(0), window_height(0), downscale_factor(1), full_frame_requested(false),
+      running(false), failed(false), incomplete_count(0), shown_count(0)
+{
+}
+
+/**
+ * Destructor for the SPINNAKER_PREVIEW class -> stops the threads if stop() was not called.
+ */
+template <class CAMERA_TYPE>
+SPINNAKER_PREVIEW<CAMERA_TYPE>::~SPINNAKER_PREVIEW()
+{
+    stop();
+}
+
+/**
+ * Sets the size of the preview window. Frames larger than it are area downscaled by an integer factor in the convert
+ * thread, so the conversion and the window handle fewer pixels.
+ * @param width: Window width in pixels.
+ * @param height: Window height in pixels.
+ * @param factor: Downscale factor (1 -> full resolution), 0 -> the largest one that still fills the window.
+ */
+template <class CAMERA_TYPE>
+void SPINNAKER_PREVIEW<CAMERA_TYPE>::set_downscale(size_t width, size_t height, unsigned int factor)
+{
+    window_width = width;
+    window_height = height;
+    downscale_factor = min(factor, MAX_DOWNSCALE_FACTOR);
+}
+
+/**
+ * Starts the grab and convert threads. The camera must be acquiring.
+ * @param camera_pointer: The camera.
+ * @param camera_node_map: Its node map, for the camera clock offset.
+ * @param timeout_ms: GetNextImage timeout.
+ * @param report_interval_seconds: Latency report interval, 0 -> only at stop().
+ * @return 0 if successful, -1 if already started.
+ */
+template <class CAMERA_TYPE>
+int SPINNAKER_PREVIEW<CAMERA_TYPE>::start(CameraPtr camera_pointer, INodeMap& camera_node_map, uint64_t timeout_ms, double report_interval_seconds)
+{
+    if (grab_thread.joinable())
+    {
+        return -1;
+    }
+
+    camera = camera_pointer;
+    node_map = &camera_node_map;
+    grab_timeout_ms = timeout_ms;
+    start_time = chrono::steady_clock::now();
+
+    latency_monitor.start("Preview", report_interval_seconds);
+    running = true;
+    convert_thread = thread(&SPINNAKER_PREVIEW::convert_loop, this);
+    grab_thread = thread(&SPINNAKER_PREVIEW::grab_loop, this);
+    return 0;
+}
+
+/**
+ * Grab thread: takes every frame off the stream as soon as it arrives.
+ */
+template <class CAMERA_TYPE>
+void SPINNAKER_PREVIEW<CAMERA_TYPE>::grab_loop()
+{
+    // Camera clock -> host clock, for the latencies that start at the image timestamp (re-latched every 10 s against drift)
+    int64_t camera_clock_offset_ns = 0;
+    bool has_camera_clock = get_camera_clock_offset(*node_map, camera_clock_offset_ns) == 0;
+    chrono::steady_clock::time_point camera_clock_time = chrono::steady_clock::now();
+    if (!has_camera_clock)
+    {
+        cout << "Camera has no TimestampLatch, exposure_to_arrival and end_to_end latencies are not measured" << endl;
+    }
+
+    unsigned int grab_errors = 0;  // In a row
+    while (running)
+    {
+        try
+        {
+            uint64_t grab_start_ns = latency_now_ns();
+            ImagePtr p_result_image_pointer = camera->GetNextImage(grab_timeout_ms);
+            uint64_t arrival_ns = latency_now_ns();
+            latency_monitor.record(LATENCY_GRAB_WAIT, arrival_ns - grab_start_ns);
+
+            if (p_result_image_pointer->IsIncomplete())
+            {
+                cout << "Image incomplete with image status " << p_result_image_pointer->GetImageStatus() << endl;
+                p_result_image_pointer->Release();
+                incomplete_count++;
+            }
+            else
+            {
+                PREVIEW_FRAME frame;
+                frame.image = p_result_image_pointer;
+                frame.frame_id = p_result_image_pointer->GetFrameID();
+                frame.arrival_ns = arrival_ns;
+                frame.frame_time_ns = has_camera_clock ? p_result_image_pointer->GetTimeStamp() + camera_clock_offset_ns : 0;
+                if (has_camera_clock)
+                {
+                    latency_monitor.record(LATENCY_EXPOSURE_TO_ARRIVAL, arrival_ns - frame.frame_time_ns);
+                }
+
+                if (grabbed_frames.publish(frame))
+                {
+                    frame.image->Release();     // The convert thread is still busy with an older frame, this one is stale
+                }
+            }
+            grab_errors = 0;
+        }
+        catch (Spinnaker::Exception& e)
+        {
+            if (e.GetError() != SPINNAKER_ERR_TIMEOUT)  // A timeout is no frame, not an error
+            {
+                grab_errors++;
+                cout << "Error: " << e.what() << endl;
+                if (grab_errors >= PREVIEW_MAX_GRAB_ERRORS)
+                {
+                    cout << "[Preview] " << grab_errors << " grab errors in a row, stopping the preview" << endl;
+                    failed = true;
+                    running = false;
+                    break;
+                }
+                this_thread::sleep_for(chrono::milliseconds(10 << min(grab_errors, 6u)));  // 20 ms .. 640 ms
+            }
+        }
+
+        if (has_camera_clock && chrono::steady_clock::now() - camera_clock_time > chrono::seconds(10))
+        {
+            get_camera_clock_offset(*node_map, camera_clock_offset_ns);
+            camera_clock_time = chrono::steady_clock::now();
+        }
+    }
+
+    grabbed_frames.close();
+}
+
+/**
+ * Convert thread: prepares the newest raw frame for the window and releases it, until the grab thread is done.
+ */
+template <class CAMERA_TYPE>
+void SPINNAKER_PREVIEW<CAMERA_TYPE>::convert_loop()
+{
+    ImageProcessor processor;   // Create image processor instance for post processing images
+    processor.SetColorProcessing(CAMERA_TYPE::get_color_processing());
+
+    bool reported_size = false;
+    PREVIEW_FRAME frame;
+    while (grabbed_frames.take(frame))
+    {
+        try
+        {
+            uint64_t conversion_start_ns = latency_now_ns();
+            int result = prepare_frame(processor, frame, reported_size);
+            latency_monitor.record(LATENCY_CONVERSION, latency_now_ns() - conversion_start_ns);
+
+            if (result == 0)
+            {
+                converted_frames.publish(frame);    // Replaces a frame the window did not show yet
+            }
+            else
+            {
+                failed = true;
+            }
+        }
+        catch (Spinnaker::Exception& e)
+        {
+            cout << "Error: " << e.what() << endl;
+            failed = true;
+        }
+    }
+
+    converted_frames.close();
+    full_frames.close();
+}
+
+/**
+ * Turns a raw frame into the frame the window shows, and releases the raw image.
+ * @param processor: The image processor of the convert thread.
+ * @param frame: The raw frame, receives the preview frame.
+ * @param reported_size: Set once the preview size was printed.
+ * @return 0 if successful, -1 if the frame could not be downscaled.
+ */
+template <class CAMERA_TYPE>
+int SPINNAKER_PREVIEW<CAMERA_TYPE>::prepare_frame(const ImageProcessor& processor, PREVIEW_FRAME& frame, bool& reported_size)
+{
+    ImagePtr raw_image = frame.image;
+    size_t width = raw_image->GetWidth();
+    size_t height = raw_image->GetHeight();
+    size_t bytes_per_pixel = CAMERA_TYPE::get_bytes_per_pixel();
+    unsigned int factor = downscale_factor != 0 ? downscale_factor : get_downscale_factor(width, height, window_width, window_height);
+    bool downscale_raw = factor > 1 && raw_image->GetPixelFormat() == CAMERA_TYPE::get_pixel_format();
+
+    if (!reported_size)
+    {
+        cout << "[Preview] " << width << "x" << height << " frames shown at " << width / factor << "x" << height / factor;
+        if (factor > 1)
+        {
+            cout << " (1/" << factor << " area downscale " << (downscale_raw ? "instead of the conversion" : "after the conversion") << ")";
+        }
+        cout << endl;
+        reported_size = true;
+    }
+
+    int result = 0;
+    try
+    {
+        // Full resolution on request: converted like the preview would be without downscaling
+        if (full_frame_requested.exchange(false))
+        {
+            PREVIEW_FRAME full_frame;
+            full_frame.image = processor.Convert(raw_image, CAMERA_TYPE::get_pixel_format());
+            full_frame.data = static_cast<const uint8_t*>(full_frame.image->GetData());
+            full_frame.width = width;
+            full_frame.height = height;
+            full_frame.stride = full_frame.image->GetStride();
+            full_frame.frame_id = frame.frame_id;
+            full_frame.arrival_ns = frame.arrival_ns;
+            full_frame.frame_time_ns = frame.frame_time_ns;
+            full_frames.publish(full_frame);
+        }
+
+        if (downscale_raw)
+        {
+            // The camera already sends the display format: average the raw buffer, there is nothing left to convert
+            result = downscale_area(static_cast<const uint8_t*>(raw_image->GetData()), width, height, raw_image->GetStride(), bytes_per_pixel,
+                                    factor, frame.pixels, frame.width, frame.height);
+            frame.image = ImagePtr();
+        }
+        else
+        {
+            ImagePtr converted_image = processor.Convert(raw_image, CAMERA_TYPE::get_pixel_format());
+            if (factor > 1)
+            {
+                result = downscale_area(static_cast<const uint8_t*>(converted_image->GetData()), width, height, converted_image->GetStride(),
+                                        bytes_per_pixel, factor, frame.pixels, frame.width, frame.height);
+                frame.image = ImagePtr();
+            }
+            else
+            {
+                frame.image = converted_image;
+                frame.width = width;
+                frame.height = height;
+                frame.stride = converted_image->GetStride();
+                frame.data = static_cast<const uint8_t*>(converted_image->GetData());
+            }
+        }
+    }
+    catch (const Spinnaker::Exception&)
+    {
+        raw_image->Release();   // Give the stream buffer back to the camera even if the conversion failed
+        throw;
+    }
+    raw_image->Release();
+
+    if (factor > 1)
+    {
+        frame.stride = frame.width * bytes_per_pixel;
+        frame.data = frame.pixels.data();
+    }
+    return result;
+}
+
+/**
+ * Tells if the grab thread still runs. Called from the UI thread, which should quit once it returns false.
+ * @return false after stop() or after the grab thread gave up on repeated errors.
+ */
+template <class CAMERA_TYPE>
+bool SPINNAKER_PREVIEW<CAMERA_TYPE>::is_grabbing() const
+{
+    return running;
+}
+
+/**
+ * Takes the newest converted frame. Called from the UI thread only.
+ * @param frame: Receives the frame, its image holds the pixel data until the next call.
+ * @param timeout: How long to wait for a frame.
+ * @return true if there is a frame that was not taken yet, false otherwise.
+ */
+template <class CAMERA_TYPE>
+bool SPINNAKER_PREVIEW<CAMERA_TYPE>::take_frame(PREVIEW_FRAME& frame, chrono::milliseconds timeout)
+{
+    return converted_frames.take(frame, timeout);
+}
+
+/**
+ * Records the latency of a frame the window painted. Called from the UI thread only.
+ * @param frame: The frame from take_frame().
+ */
+template <class CAMERA_TYPE>
+void SPINNAKER_PREVIEW<CAMERA_TYPE>::frame_shown(const PREVIEW_FRAME& frame)
+{
+    uint64_t shown_ns = latency_now_ns();
+    latency_monitor.record(LATENCY_DISPLAY, shown_ns - frame.arrival_ns);
+    if (frame.frame_time_ns != 0)
+    {
+        latency_monitor.record(LATENCY_END_TO_END, shown_ns - frame.frame_time_ns);
+    }
+    shown_count++;
+}
+
+/**
+ * Asks the convert thread to also convert the next frame at full resolution, for take_full_frame().
+ */
+template <class CAMERA_TYPE>
+void SPINNAKER_PREVIEW<CAMERA_TYPE>::request_full_frame()
+{
+    full_frame_requested = true;
+}
+
+/**
+ * Takes the full resolution frame requested with request_full_frame(). Called from the UI thread only.
+ * @param frame: Receives the frame, its image holds the converted full resolution image.
+ * @param timeout: How long to wait for it.
+ * @return true if there is one, false otherwise.
+ */
+template <class CAMERA_TYPE>
+bool SPINNAKER_PREVIEW<CAMERA_TYPE>::take_full_frame(PREVIEW_FRAME& frame, chrono::milliseconds timeout)
+{
+    return full_frames.take(frame, timeout);
+}
+
+/**
+ * Stops the threads. The grab thread finishes its GetNextImage first (at most the timeout), so call it before EndAcquisition.
+ * @return 0 if every conversion succeeded and the grab thread did not give up, -1 otherwise.
+ */
+template <class CAMERA_TYPE>
+int SPINNAKER_PREVIEW<CAMERA_TYPE>::stop()
+{
+    if (!grab_thread.joinable())
+    {
+        return failed ? -1 : 0;
+    }
+
+    running = false;
+    grab_thread.join();
+    convert_thread.join();  // Ends after the last grabbed frame
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+    ostringstream report;
+    report << fixed << setprecision(1) << "[Preview] " << grabbed_frames.get_published_count() << " frames grabbed ("
+           << incomplete_count.load() << " incomplete), " << grabbed_frames.get_replaced_count() << " skipped before conversion, "
+           << converted_frames.get_replaced_count() << " skipped before display, " << shown_count << " shown ("
+           << (seconds > 0.0 ? shown_count / seconds : 0.0) << " fps)" << endl;
+    cout << report.str();
+    latency_monitor.stop();
+
+    return failed ? -1 : 0;
+}
+
+#endif // SPINNAKER_PREVIEW_H
@@ -0,0 +1,664 @@
+// spinnaker_profile.h Header File -> Checks a CAMERA_PROFILE against the limits of a camera and applies the stream settings
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_PROFILE_H
+#define SPINNAKER_PROFILE_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "async_logger.h"
+#include "camera_config_file.h"
+#include "settings_watcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace std;
+
+/**
+ * Checks a float setting against the range of its node.
+ * @param node_map: The node map.
+ * @param node_name: The float node, e.g. "ExposureTime".
+ * @param key: The key in the settings file, for the message.
+ * @param value: The value from the file.
+ * @param errors: Receives a message if the value cannot be set.
+ */
+inline void check_profile_float(INodeMap& node_map, const char* node_name, const char* key, double value, vector<string>& errors)
+{
+    CFloatPtr ptr_value = node_map.GetNode(node_name);
+    if (!IsReadable(ptr_value))
+    {
+        errors.push_back(string(key) + ": the camera has no readable " + node_name);
+        return;
+    }
+
+    if (value < ptr_value->GetMin() || value > ptr_value->GetMax())
+    {
+        ostringstream message;
+        message << key << " " << value << " is outside " << ptr_value->GetMin() << " to " << ptr_value->GetMax();
+        errors.push_back(message.str());
+    }
+}
+
+/**
+ * Checks one ROI axis: the size against its minimum, increment and the sensor size, the offset against its increment.
+ * @param node_map: The node map.
+ * @param axis: "X" or "Y".
+ * @param offset: The offset from the file.
+ * @param size: The width or height from the file.
+ * @param roi_index: Position of the roi line in its section, for the message.
+ * @param errors: Receives a message for every problem.
+ */
+inline void check_profile_roi_axis(INodeMap& node_map, const string& axis, int64_t offset, int64_t size, size_t roi_index, vector<string>& errors)
+{
+    const string size_name = axis == "X" ? "Width" : "Height";
+    CIntegerPtr ptr_size = node_map.GetNode(size_name.c_str());
+    CIntegerPtr ptr_size_max = node_map.GetNode((size_name + "Max").c_str());
+    CIntegerPtr ptr_offset = node_map.GetNode(("Offset" + axis).c_str());
+    if (!IsReadable(ptr_size) || !IsReadable(ptr_size_max) || !IsReadable(ptr_offset))
+    {
+        errors.push_back("roi " + to_string(roi_index + 1) + ": the camera has no readable " + size_name + "/Offset" + axis);
+        return;
+    }
+
+    ostringstream message;
+    int64_t sensor_size = ptr_size_max->GetValue();     // The full sensor at the current binning
+    int64_t size_inc = ptr_size->GetInc() > 0 ? ptr_size->GetInc() : 1;
+    int64_t offset_inc = ptr_offset->GetInc() > 0 ? ptr_offset->GetInc() : 1;
+
+    if (size < ptr_size->GetMin() || (size - ptr_size->GetMin()) % size_inc != 0)
+    {
+        message << "roi " << roi_index + 1 << ": " << size_name << " " << size << " must be " << ptr_size->GetMin() << " or more in steps of " << size_inc;
+    }
+    else if (offset % offset_inc != 0)
+    {
+        message << "roi " << roi_index + 1 << ": Offset" << axis << " " << offset << " must be a multiple of " << offset_inc;
+    }
+    else if (offset + size > sensor_size)
+    {
+        message << "roi " << roi_index + 1 << ": Offset" << axis << " + " << size_name << " = " << offset + size << " is larger than the sensor (" << sensor_size << ")";
+    }
+
+    if (!message.str().empty())
+    {
+        errors.push_back(message.str());
+    }
+}
+
+/**
+ * Checks the given settings of a profile against the limits the camera reports, before anything is written to it,
+ * so a value the camera cannot take stops the tool at startup instead of failing (or being clamped) mid-acquisition.
+ * The exposure and frame rate limits are the ones of the current camera state (pixel format, ROI, frame rate).
+ * @param node_map: The camera node map.
+ * @param stream_node_map: The TL stream node map (buffer count and handling mode).
+ * @param profile: The camera's profile.
+ * @return 0 if every setting fits, -1 otherwise (every problem is printed).
+ */
+inline int validate_camera_profile(INodeMap& node_map, INodeMap& stream_node_map, const CAMERA_PROFILE& profile)
+{
+    vector<string> errors;
+
+    try
+    {
+        if (profile.has(PROFILE_PIXEL_FORMAT))
+        {
+            CEnumerationPtr ptr_pixel_format = node_map.GetNode("PixelFormat");
+            if (!IsReadable(ptr_pixel_format) || !IsReadable(ptr_pixel_format->GetEntryByName(profile.pixel_format.c_str())))
+            {
+                errors.push_back("pixel_format " + profile.pixel_format + " is not supported by the camera");
+            }
+        }
+
+        if (profile.has(PROFILE_EXPOSURE))
+        {
+            check_profile_float(node_map, "ExposureTime", "exposure", profile.exposure, errors);
+        }
+        if (profile.has(PROFILE_GAIN))
+        {
+            check_profile_float(node_map, "Gain", "gain", profile.gain, errors);
+        }
+        if (profile.has(PROFILE_GAMMA))
+        {
+            check_profile_float(node_map, "Gamma", "gamma", profile.gamma, errors);
+        }
+        if (profile.has(PROFILE_SHARPENING))
+        {
+            check_profile_float(node_map, "Sharpening", "sharpening", profile.sharpening, errors);
+        }
+        if (profile.has(PROFILE_SATURATION))
+        {
+            check_profile_float(node_map, "Saturation", "saturation", profile.saturation, errors);
+        }
+        if (profile.has(PROFILE_FRAME_RATE) && profile.frame_rate > 0.0)
+        {
+            check_profile_float(node_map, "AcquisitionFrameRate", "frame_rate", profile.frame_rate, errors);
+        }
+
+        for (size_t i = 0; i < profile.rois.size(); i++)
+        {
+            check_profile_roi_axis(node_map, "X", profile.rois[i].offset_x, profile.rois[i].width, i, errors);
+            check_profile_roi_axis(node_map, "Y", profile.rois[i].offset_y, profile.rois[i].height, i, errors);
+        }
+
+        if (profile.has(PROFILE_BUFFER_HANDLING))
+        {
+            CEnumerationPtr ptr_handling = stream_node_map.GetNode("StreamBufferHandlingMode");
+            if (!IsReadable(ptr_handling) || !IsReadable(ptr_handling->GetEntryByName(profile.buffer_handling.c_str())))
+            {
+                errors.push_back("buffer_handling " + profile.buffer_handling + " is not supported by the stream");
+            }
+        }
+
+        if (profile.has(PROFILE_BUFFER_COUNT))
+        {
+            CIntegerPtr ptr_count = stream_node_map.GetNode("StreamBufferCountManual");
+            if (!IsReadable(ptr_count))
+            {
+                errors.push_back("buffer_count: the stream has no readable StreamBufferCountManual");
+            }
+            else if (static_cast<int64_t>(profile.buffer_count) < ptr_count->GetMin() || static_cast<int64_t>(profile.buffer_count) > ptr_count->GetMax())
+            {
+                errors.push_back("buffer_count " + to_string(profile.buffer_count) + " is outside " + to_string(ptr_count->GetMin()) + " to " + to_string(ptr_count->GetMax()));
+            }
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        errors.push_back(string("unable to read the camera limits: ") + e.what());
+    }
+
+    for (const string& error : errors)
+    {
+        cerr << "[Config] Camera " << profile.serial << ": " << error << endl;
+    }
+
+    return errors.empty() ? 0 : -1;
+}
+
+/**
+ * Compares a float setting with the value the camera holds.
+ * @param node_map: The node map.
+ * @param node_name: The float node, e.g. "ExposureTime".
+ * @param value: The value from the file.
+ * @param mismatches: Receives a message if the camera holds another value.
+ */
+inline void compare_profile_float(INodeMap& node_map, const char* node_name, double value, vector<string>& mismatches)
+{
+    CFloatPtr ptr_value = node_map.GetNode(node_name);
+    if (!IsReadable(ptr_value))
+    {
+        mismatches.push_back(string(node_name) + " is not readable");
+        return;
+    }
+
+    double live = ptr_value->GetValue();
+    double tolerance = max(0.01 * fabs(value), 0.01);   // 1 %, the camera rounds to its own steps
+    if (fabs(live - value) > tolerance)
+    {
+        ostringstream message;
+        message << node_name << " " << live << " instead of " << value;
+        mismatches.push_back(message.str());
+    }
+}
+
+/**
+ * Spot-checks a loaded UserSet against the profile it was saved from: the pixel format, exposure, gain and gamma.
+ * The settings hash only says what the host saved, the camera may have been reconfigured (or its UserSet overwritten) since.
+ * @param node_map: The camera node map, right after UserSetLoad.
+ * @param profile: The camera's profile.
+ * @return 0 if the camera holds the given settings, -1 otherwise (the differences are printed).
+ */
+inline int check_loaded_profile(INodeMap& node_map, const CAMERA_PROFILE& profile)
+{
+    vector<string> mismatches;
+
+    try
+    {
+        if (profile.has(PROFILE_PIXEL_FORMAT))
+        {
+            CEnumerationPtr ptr_pixel_format = node_map.GetNode("PixelFormat");
+            string live = IsReadable(ptr_pixel_format) ? string(ptr_pixel_format->GetCurrentEntry()->GetSymbolic().c_str()) : "unreadable";
+            if (live != profile.pixel_format)
+            {
+                mismatches.push_back("PixelFormat " + live + " instead of " + profile.pixel_format);
+            }
+        }
+
+        if (profile.has(PROFILE_EXPOSURE))
+        {
+            compare_profile_float(node_map, "ExposureTime", profile.exposure, mismatches);
+        }
+        if (profile.has(PROFILE_GAIN))
+        {
+            compare_profile_float(node_map, "Gain", profile.gain, mismatches);
+        }
+        if (profile.has(PROFILE_GAMMA))
+        {
+            compare_profile_float(node_map, "Gamma", profile.gamma, mismatches);
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        mismatches.push_back(string("unable to read the settings: ") + e.what());
+    }
+
+    for (const string& mismatch : mismatches)
+    {
+        cerr << "[Config] Camera " << profile.serial << ", loaded UserSet: " << mismatch << endl;
+    }
+
+    return mismatches.empty() ? 0 : -1;
+}
+
+/**
+ * Sets a fixed frame rate, or lets the camera run as fast as the exposure allows.
+ * @param node_map: The camera node map.
+ * @param frame_rate: [fps], 0 -> AcquisitionFrameRateEnable off.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int config_frame_rate(INodeMap& node_map, double frame_rate)
+{
+    try
+    {
+        CBooleanPtr ptr_enable = node_map.GetNode("AcquisitionFrameRateEnable");
+        if (!IsWritable(ptr_enable))
+        {
+            cout << "Unable to enable or disable the frame rate control" << endl;
+            return -1;
+        }
+        ptr_enable->SetValue(frame_rate > 0.0);
+
+        if (frame_rate > 0.0)
+        {
+            CFloatPtr ptr_frame_rate = node_map.GetNode("AcquisitionFrameRate");
+            if (!IsWritable(ptr_frame_rate))
+            {
+                cout << "Unable to set the frame rate" << endl;
+                return -1;
+            }
+            ptr_frame_rate->SetValue(frame_rate);
+            cout << "Frame rate set to: " << ptr_frame_rate->GetValue() << " fps" << endl;
+        }
+        else
+        {
+            cout << "Frame rate control disabled (free running)" << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Sets the stream buffer handling mode and the number of buffers the driver keeps, if the profile gives them.
+ * Must be called before BeginAcquisition().
+ * @param stream_node_map: The TL stream node map.
+ * @param profile: The camera's profile.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int config_stream_buffers(INodeMap& stream_node_map, const CAMERA_PROFILE& profile)
+{
+    try
+    {
+        if (profile.has(PROFILE_BUFFER_HANDLING))
+        {
+            CEnumerationPtr ptr_handling = stream_node_map.GetNode("StreamBufferHandlingMode");
+            CEnumEntryPtr ptr_mode = IsWritable(ptr_handling) ? ptr_handling->GetEntryByName(profile.buffer_handling.c_str()) : CEnumEntryPtr();
+            if (!IsReadable(ptr_mode))
+            {
+                cout << "Unable to set the buffer handling mode to " << profile.buffer_handling << endl;
+                return -1;
+            }
+            ptr_handling->SetIntValue(ptr_mode->GetValue());
+            cout << "Buffer handling mode set to " << profile.buffer_handling << endl;
+        }
+
+        if (profile.has(PROFILE_BUFFER_COUNT))
+        {
+            CEnumerationPtr ptr_count_mode = stream_node_map.GetNode("StreamBufferCountMode");
+            CEnumEntryPtr ptr_manual = IsWritable(ptr_count_mode) ? ptr_count_mode->GetEntryByName("Manual") : CEnumEntryPtr();
+            CIntegerPtr ptr_count = stream_node_map.GetNode("StreamBufferCountManual");
+            if (!IsReadable(ptr_manual))
+            {
+                cout << "Unable to set the buffer count mode to Manual" << endl;
+                return -1;
+            }
+            ptr_count_mode->SetIntValue(ptr_manual->GetValue());
+
+            if (!IsWritable(ptr_count))
+            {
+                cout << "Unable to set the buffer count" << endl;
+                return -1;
+            }
+            ptr_count->SetValue(profile.buffer_count);
+            cout << "Buffer count set to " << ptr_count->GetValue() << endl;
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Writes one float setting, turning its auto mode off or its enable on first, clamped to the range of the node.
+ * Every float node write goes through here: CAMERA_CONTROL, CAMERA_MANAGER and SPINNAKER_CAMERA at startup,
+ * set_live_float() while the camera streams.
+ * @param node_map: The camera node map.
+ * @param auto_name: Enumeration set to Off first (e.g. "ExposureAuto"), nullptr if there is none.
+ * @param enable_name: Boolean set to true first (e.g. "GammaEnable"), nullptr if there is none.
+ * @param value_name: The float node.
+ * @param value: The new value, receives the clamped value that was written.
+ * @return 0 if successful, 1 if the value was written but the auto mode or the enable could not be switched,
+ *         -1 if the float node is not writable (nothing was written).
+ */
+inline int set_float_setting(INodeMap& node_map, const char* auto_name, const char* enable_name, const char* value_name, double& value)
+{
+    CFloatPtr ptr_value = node_map.GetNode(value_name);
+    if (!IsReadable(ptr_value))
+    {
+        return -1;
+    }
+
+    int result = 0;
+    if (auto_name)
+    {
+        CEnumerationPtr ptr_auto = node_map.GetNode(auto_name);
+        CEnumEntryPtr ptr_off = IsWritable(ptr_auto) ? ptr_auto->GetEntryByName("Off") : CEnumEntryPtr();
+        if (!IsReadable(ptr_off))
+        {
+            result = 1;
+        }
+        else if (ptr_auto->GetIntValue() != ptr_off->GetValue())
+        {
+            ptr_auto->SetIntValue(ptr_off->GetValue());
+        }
+    }
+    if (enable_name)
+    {
+        CBooleanPtr ptr_enable = node_map.GetNode(enable_name);
+        if (!IsWritable(ptr_enable))
+        {
+            result = 1;
+        }
+        else if (!ptr_enable->GetValue())
+        {
+            ptr_enable->SetValue(true);
+        }
+    }
+
+    if (!IsWritable(ptr_value)) // Checked after the auto mode, which can lock the value
+    {
+        return -1;
+    }
+    if (value > ptr_value->GetMax())
+    {
+        value = ptr_value->GetMax();
+    }
+    else if (value < ptr_value->GetMin())
+    {
+        value = ptr_value->GetMin();
+    }
+    ptr_value->SetValue(value);
+    return result;
+}
+
+/**
+ * Writes one float setting while the camera streams, turning its auto mode off or its enable on first.
+ * The value was checked by validate_camera_profile(), so set_float_setting() does not need to clamp it.
+ * @param node_map: The camera node map.
+ * @param auto_name: Enumeration set to Off first (e.g. "ExposureAuto"), nullptr if there is none.
+ * @param enable_name: Boolean set to true first (e.g. "GammaEnable"), nullptr if there is none.
+ * @param value_name: The float node.
+ * @param value: The new value.
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int set_live_float(INodeMap& node_map, const char* auto_name, const char* enable_name, const char* value_name, double value)
+{
+    if (set_float_setting(node_map, auto_name, enable_name, value_name, value) < 0)
+    {
+        log_error(log_tag("Reload"), "{} is not writable while the camera streams", value_name);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Writes the changed settings a streaming camera takes between two frames (PROFILE_LIVE_FIELDS without the outputs,
+ * which are not camera settings). The exposure comes before the frame rate, as at startup.
+ * @param node_map: The camera node map.
+ * @param profile: The new settings, checked against the camera with validate_camera_profile().
+ * @param changes: CAMERA_PROFILE_FIELD bits to write, from compare_camera_profiles().
+ * @return 0 if every setting was written, -1 otherwise.
+ */
+inline int apply_live_profile_changes(INodeMap& node_map, const CAMERA_PROFILE& profile, uint32_t changes)
+{
+    int result = 0;
+
+    try
+    {
+        if (changes & PROFILE_EXPOSURE)
+        {
+            result |= set_live_float(node_map, "ExposureAuto", nullptr, "ExposureTime", profile.exposure);
+        }
+        if (changes & PROFILE_FRAME_RATE)
+        {
+            CBooleanPtr ptr_enable = node_map.GetNode("AcquisitionFrameRateEnable");
+            if (IsWritable(ptr_enable))
+            {
+                ptr_enable->SetValue(profile.frame_rate > 0.0);
+                if (profile.frame_rate > 0.0)
+                {
+                    result |= set_live_float(node_map, nullptr, nullptr, "AcquisitionFrameRate", profile.frame_rate);
+                }
+            }
+            else
+            {
+                log_error(log_tag("Reload"), "AcquisitionFrameRateEnable is not writable while the camera streams");
+                result = -1;
+            }
+        }
+        if (changes & PROFILE_GAIN)
+        {
+            result |= set_live_float(node_map, "GainAuto", nullptr, "Gain", profile.gain);
+        }
+        if (changes & PROFILE_SHARPENING)
+        {
+            result |= set_live_float(node_map, nullptr, "SharpeningEnable", "Sharpening", profile.sharpening);
+        }
+        if (changes & PROFILE_SATURATION)
+        {
+            result |= set_live_float(node_map, nullptr, "SaturationEnable", "Saturation", profile.saturation);
+        }
+        if (changes & PROFILE_GAMMA)
+        {
+            result |= set_live_float(node_map, nullptr, "GammaEnable", "Gamma", profile.gamma);
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        log_error(log_tag("Reload"), "Error applying the settings: {}", e.what());
+        result = -1;
+    }
+
+    return result;
+}
+
+/**
+ * Latches the camera clock, to find the first frame exposed after a settings write (see settings_change_took_effect()).
+ * @param node_map: The camera node map.
+ * @return The camera timestamp in nanoseconds, 0 if the camera has no TimestampLatch.
+ */
+inline uint64_t latch_camera_timestamp(INodeMap& node_map)
+{
+    try
+    {
+        CCommandPtr ptr_timestamp_latch = node_map.GetNode("TimestampLatch");
+        CIntegerPtr ptr_timestamp_latch_value = node_map.GetNode("TimestampLatchValue");
+        if (IsWritable(ptr_timestamp_latch) && IsReadable(ptr_timestamp_latch_value))
+        {
+            ptr_timestamp_latch->Execute();
+            return static_cast<uint64_t>(ptr_timestamp_latch_value->GetValue());
+        }
+    }
+    catch (Spinnaker::Exception&)
+    {
+        // No latch -> the next frame counts
+    }
+
+    return 0;
+}
+
+/**
+ * Applies a new version of the settings file to a running camera between two frames: compares the camera's new
+ * profile with the one it runs with, checks the changed settings against the camera limits and writes them.
+ * Settings outside applicable_fields are reported and left as they are; a change that does not fit the camera
+ * is rejected as a whole, so the camera never runs with half of an edit.
+ * @param node_map: The camera node map.
+ * @param stream_node_map: The TL stream node map.
+ * @param updated: The camera's profile from the new version of the file (CAMERA_CONFIG_FILE::get_profile()).
+ * @param profile: The settings the camera runs with, receives the applied changes.
+ * @param applicable_fields: CAMERA_PROFILE_FIELD bits that can change in the current state, PROFILE_LIVE_FIELDS while
+ *                           streaming; the pixel format and the stream buffers only with the acquisition stopped.
+ *                           The ROIs are only copied into profile, the capture loop applies them.
+ * @param change: Receives the pending change, to log the first frame taken with it.
+ * @return CAMERA_PROFILE_FIELD bits of the settings that were applied, 0 if none.
+ */
+inline uint32_t reload_camera_profile(INodeMap& node_map, INodeMap& stream_node_map, const CAMERA_PROFILE& updated, CAMERA_PROFILE& profile,
+                                      uint32_t applicable_fields, SETTINGS_CHANGE& change)
+{
+    uint32_t changes = compare_camera_profiles(profile, updated);
+
+    if (changes & ~applicable_fields)
+    {
+        CAMERA_PROFILE skipped = updated;
+        skipped.fields = changes & ~applicable_fields;
+        log_warning(log_tag("Reload"), "Camera {}: {} needs a restart, not applied", profile.serial, describe_camera_profile(skipped));
+    }
+
+    changes &= applicable_fields;
+    if (changes == 0)
+    {
+        return 0;
+    }
+
+    // Only the changed settings are checked and written
+    CAMERA_PROFILE checked = updated;
+    checked.fields = changes;
+    if (!(changes & PROFILE_ROIS))
+    {
+        checked.rois.clear();
+    }
+
+    if (validate_camera_profile(node_map, stream_node_map, checked) != 0)
+    {
+        log_error(log_tag("Reload"), "Camera {}: the change does not fit the camera, it keeps its current settings", profile.serial);
+        return 0;
+    }
+
+    int result = apply_live_profile_changes(node_map, checked, changes & PROFILE_LIVE_FIELDS);
+
+    try
+    {
+        if (changes & PROFILE_PIXEL_FORMAT)
+        {
+            CEnumerationPtr ptr_pixel_format = node_map.GetNode("PixelFormat");
+            CEnumEntryPtr ptr_entry = IsWritable(ptr_pixel_format) ? ptr_pixel_format->GetEntryByName(checked.pixel_format.c_str()) : CEnumEntryPtr();
+            if (IsReadable(ptr_entry))
+            {
+                ptr_pixel_format->SetIntValue(ptr_entry->GetValue());
+            }
+            else
+            {
+                result = -1;
+            }
+        }
+        if (changes & (PROFILE_BUFFER_COUNT | PROFILE_BUFFER_HANDLING))
+        {
+            result |= config_stream_buffers(stream_node_map, checked);
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        log_error(log_tag("Reload"), "Error applying the settings: {}", e.what());
+        result = -1;
+    }
+
+    if (result != 0)
+    {
+        log_error(log_tag("Reload"), "Camera {}: not every setting of the change could be written", profile.serial);
+    }
+
+    // The camera runs with the new values from here on
+    if (changes & PROFILE_EXPOSURE)
+    {
+        profile.exposure = updated.exposure;
+    }
+    if (changes & PROFILE_GAIN)
+    {
+        profile.gain = updated.gain;
+    }
+    if (changes & PROFILE_GAMMA)
+    {
+        profile.gamma = updated.gamma;
+    }
+    if (changes & PROFILE_SHARPENING)
+    {
+        profile.sharpening = updated.sharpening;
+    }
+    if (changes & PROFILE_SATURATION)
+    {
+        profile.saturation = updated.saturation;
+    }
+    if (changes & PROFILE_PIXEL_FORMAT)
+    {
+        profile.pixel_format = updated.pixel_format;
+    }
+    if (changes & PROFILE_FRAME_RATE)
+    {
+        profile.frame_rate = updated.frame_rate;
+    }
+    if (changes & PROFILE_ROIS)
+    {
+        profile.rois = updated.rois;
+    }
+    if (changes & PROFILE_BUFFER_COUNT)
+    {
+        profile.buffer_count = updated.buffer_count;
+    }
+    if (changes & PROFILE_BUFFER_HANDLING)
+    {
+        profile.buffer_handling = updated.buffer_handling;
+    }
+    if (changes & PROFILE_OUTPUTS)
+    {
+        profile.outputs = updated.outputs;
+    }
+    profile.fields |= changes;
+
+    change.pending = true;
+    change.description = describe_camera_profile(checked);
+    change.written_timestamp_ns = latch_camera_timestamp(node_map);
+
+    log_info(log_tag("Reload"), "Camera {}: {} written, waiting for the first frame taken with it", profile.serial, change.description);
+    return changes;
+}
+
+#endif // SPINNAKER_PROFILE_H
@@ -0,0 +1,221 @@
+// spinnaker_snapshot.h Header File -> Taking a NODE_SNAPSHOT of a configured camera and writing it back in one pass
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_SNAPSHOT_H
+#define SPINNAKER_SNAPSHOT_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include "node_snapshot.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace std;
+
+/**
+ * Reads a node as text: enumerations by their symbolic name, floats with full precision.
+ * @param node_map: The node map holding the node.
+ * @param name: The node name.
+ * @param value: Receives the value.
+ * @return true if the node exists, is readable and of a type a snapshot holds.
+ */
+inline bool read_snapshot_node(INodeMap& node_map, const string& name, string& value)
+{
+    CNodePtr ptr_node = node_map.GetNode(name.c_str());
+    if (!IsReadable(ptr_node))
+    {
+        return false;
+    }
+
+    ostringstream text;
+    switch (ptr_node->GetPrincipalInterfaceType())
+    {
+        case intfIEnumeration:
+        {
+            CEnumerationPtr ptr_enumeration = ptr_node;
+            text << ptr_enumeration->GetCurrentEntry()->GetSymbolic().c_str();
+            break;
+        }
+        case intfIFloat:
+        {
+            CFloatPtr ptr_float = ptr_node;
+            text.precision(17);
+            text << ptr_float->GetValue();
+            break;
+        }
+        case intfIInteger:
+        {
+            CIntegerPtr ptr_integer = ptr_node;
+            text << ptr_integer->GetValue();
+            break;
+        }
+        case intfIBoolean:
+        {
+            CBooleanPtr ptr_boolean = ptr_node;
+            text << (ptr_boolean->GetValue() ? "true" : "false");
+            break;
+        }
+        default:
+            return false;
+    }
+
+    value = text.str();
+    return true;
+}
+
+/**
+ * Writes a node from text, unless it already has the value.
+ * @param node_map: The node map holding the node.
+ * @param name: The node name.
+ * @param value: The value as read_snapshot_node() wrote it.
+ * @param written: Incremented if the node was written.
+ * @return true if the node has the value now, false if it is not writable (yet) or rejected the value.
+ */
+inline bool write_snapshot_node(INodeMap& node_map, const string& name, const string& value, unsigned int& written)
+{
+    string current;
+    if (read_snapshot_node(node_map, name, current) && current == value)
+    {
+        return true;    // Nothing to write, e.g. after a reconnect without a power cycle
+    }
+
+    try
+    {
+        CNodePtr ptr_node = node_map.GetNode(name.c_str());
+        if (!IsWritable(ptr_node))
+        {
+            return false;
+        }
+
+        switch (ptr_node->GetPrincipalInterfaceType())
+        {
+            case intfIEnumeration:
+            {
+                CEnumerationPtr ptr_enumeration = ptr_node;
+                CEnumEntryPtr ptr_entry = ptr_enumeration->GetEntryByName(value.c_str());
+                if (!IsReadable(ptr_entry))
+                {
+                    return false;
+                }
+                ptr_enumeration->SetIntValue(ptr_entry->GetValue());
+                break;
+            }
+            case intfIFloat:
+            {
+                CFloatPtr ptr_float = ptr_node;
+                ptr_float->SetValue(stod(value));
+                break;
+            }
+            case intfIInteger:
+            {
+                CIntegerPtr ptr_integer = ptr_node;
+                ptr_integer->SetValue(stoll(value));
+                break;
+            }
+            case intfIBoolean:
+            {
+                CBooleanPtr ptr_boolean = ptr_node;
+                ptr_boolean->SetValue(value == "true");
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    catch (Spinnaker::Exception&)
+    {
+        return false;   // Out of range in the current state, retried after the other nodes
+    }
+    catch (const std::exception&)
+    {
+        return false;   // Malformed number in the file
+    }
+
+    written++;
+    return true;
+}
+
+/**
+ * Takes a snapshot of the configured camera. Nodes the camera does not have, or cannot read, are left out.
+ * @param node_map: The camera node map.
+ * @param stream_node_map: The TL stream node map ("Stream." nodes).
+ * @param serial: The camera serial number.
+ * @param settings_hash: hash_camera_profile() of the settings the camera was configured with.
+ * @param snapshot: Receives the snapshot.
+ * @return 0 if successful, -1 if the camera could not be read.
+ */
+inline int take_node_snapshot(INodeMap& node_map, INodeMap& stream_node_map, const string& serial, uint64_t settings_hash, NODE_SNAPSHOT& snapshot)
+{
+    snapshot.serial = serial;
+    snapshot.settings_hash = settings_hash;
+    snapshot.values.clear();
+
+    try
+    {
+        for (const string& name : get_snapshot_node_names())
+        {
+            bool is_stream = name.compare(0, 7, "Stream.") == 0;
+            NODE_VALUE node = {name, ""};
+            if (read_snapshot_node(is_stream ? stream_node_map : node_map, is_stream ? name.substr(7) : name, node.value))
+            {
+                snapshot.values.push_back(node);
+            }
+        }
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Writes a snapshot back in one pass, in its order, skipping the nodes that already have their value. Writes that
+ * fail because a node is not writable or out of range yet are retried once after the others.
+ * Acquisition must be stopped (pixel format, ROI and stream buffers).
+ * @param node_map: The camera node map.
+ * @param stream_node_map: The TL stream node map.
+ * @param snapshot: The snapshot.
+ * @param written: Receives the number of nodes written.
+ * @return 0 if every node has its value, -1 otherwise (the failed nodes are printed).
+ */
+inline int restore_node_snapshot(INodeMap& node_map, INodeMap& stream_node_map, const NODE_SNAPSHOT& snapshot, unsigned int& written)
+{
+    vector<const NODE_VALUE*> deferred;
+    written = 0;
+
+    for (const NODE_VALUE& node : snapshot.values)
+    {
+        bool is_stream = node.name.compare(0, 7, "Stream.") == 0;
+        if (!write_snapshot_node(is_stream ? stream_node_map : node_map, is_stream ? node.name.substr(7) : node.name, node.value, written))
+        {
+            deferred.push_back(&node);
+        }
+    }
+
+    int result = 0;
+    for (const NODE_VALUE* node : deferred)
+    {
+        bool is_stream = node->name.compare(0, 7, "Stream.") == 0;
+        if (!write_snapshot_node(is_stream ? stream_node_map : node_map, is_stream ? node->name.substr(7) : node->name, node->value, written))
+        {
+            cout << "Unable to restore " << node->name << " = " << node->value << endl;
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+#endif // SPINNAKER_SNAPSHOT_H
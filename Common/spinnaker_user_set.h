@@ -0,0 +1,150 @@
+// spinnaker_user_set.h Header File -> Saving the configuration into a camera UserSet and loading it back at startup
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SPINNAKER_USER_SET_H
+#define SPINNAKER_USER_SET_H
+
+// Header only like spinnaker_frame.h, so libcamera_common.a still builds without the Spinnaker SDK.
+
+#include "Spinnaker.h"
+#include "SpinGenApi/SpinnakerGenApi.h"
+
+#include <iostream>
+#include <string>
+
+using namespace Spinnaker;
+using namespace Spinnaker::GenApi;
+using namespace std;
+
+/**
+ * Returns the node that selects the UserSet the camera loads at power up: UserSetDefault on current firmware,
+ * UserSetDefaultSelector on older cameras.
+ * @param node_map: The camera node map.
+ * @return The enumeration node, invalid if the camera has neither.
+ */
+inline CEnumerationPtr get_user_set_default_node(INodeMap& node_map)
+{
+    CEnumerationPtr ptr_default = node_map.GetNode("UserSetDefault");
+    if (!IsReadable(ptr_default))
+    {
+        ptr_default = node_map.GetNode("UserSetDefaultSelector");
+    }
+    return ptr_default;
+}
+
+/**
+ * Checks if the camera boots into the given UserSet.
+ * @param node_map: The camera node map.
+ * @param user_set: The UserSet, e.g. "UserSet1".
+ * @return true if it is the power up default.
+ */
+inline bool is_user_set_default(INodeMap& node_map, const string& user_set)
+{
+    try
+    {
+        CEnumerationPtr ptr_default = get_user_set_default_node(node_map);
+        return IsReadable(ptr_default) && string(ptr_default->GetCurrentEntry()->GetSymbolic().c_str()) == user_set;
+    }
+    catch (Spinnaker::Exception&)
+    {
+        return false;
+    }
+}
+
+/**
+ * Selects a UserSet for UserSetLoad/UserSetSave. The factory set "Default" is read only and cannot be used.
+ * @param node_map: The camera node map.
+ * @param user_set: The UserSet, e.g. "UserSet1".
+ * @return 0 if successful, -1 if the camera has no such UserSet.
+ */
+inline int select_user_set(INodeMap& node_map, const string& user_set)
+{
+    CEnumerationPtr ptr_selector = node_map.GetNode("UserSetSelector");
+    CEnumEntryPtr ptr_entry = IsWritable(ptr_selector) ? ptr_selector->GetEntryByName(user_set.c_str()) : CEnumEntryPtr();
+    if (user_set == "Default" || !IsReadable(ptr_entry))
+    {
+        cout << "Unable to select UserSet " << user_set << endl;
+        return -1;
+    }
+
+    ptr_selector->SetIntValue(ptr_entry->GetValue());
+    return 0;
+}
+
+/**
+ * Loads a UserSet into the camera: one command instead of a write per setting. Acquisition must be stopped.
+ * @param node_map: The camera node map.
+ * @param user_set: The UserSet, e.g. "UserSet1".
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int load_user_set(INodeMap& node_map, const string& user_set)
+{
+    try
+    {
+        if (select_user_set(node_map, user_set) != 0)
+        {
+            return -1;
+        }
+
+        CCommandPtr ptr_load = node_map.GetNode("UserSetLoad");
+        if (!IsWritable(ptr_load))
+        {
+            cout << "Unable to load UserSet " << user_set << endl;
+            return -1;
+        }
+        ptr_load->Execute();
+        cout << "UserSet " << user_set << " loaded" << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Saves the current configuration into a UserSet and makes it the power up default. Acquisition must be stopped.
+ * @param node_map: The camera node map.
+ * @param user_set: The UserSet, e.g. "UserSet1".
+ * @return 0 if successful, -1 otherwise.
+ */
+inline int save_user_set(INodeMap& node_map, const string& user_set)
+{
+    try
+    {
+        if (select_user_set(node_map, user_set) != 0)
+        {
+            return -1;
+        }
+
+        CCommandPtr ptr_save = node_map.GetNode("UserSetSave");
+        if (!IsWritable(ptr_save))
+        {
+            cout << "Unable to save UserSet " << user_set << endl;
+            return -1;
+        }
+        ptr_save->Execute();
+
+        CEnumerationPtr ptr_default = get_user_set_default_node(node_map);
+        CEnumEntryPtr ptr_entry = IsWritable(ptr_default) ? ptr_default->GetEntryByName(user_set.c_str()) : CEnumEntryPtr();
+        if (!IsReadable(ptr_entry))
+        {
+            cout << "UserSet " << user_set << " saved, but it cannot be made the power up default" << endl;
+            return -1;
+        }
+        ptr_default->SetIntValue(ptr_entry->GetValue());
+        cout << "UserSet " << user_set << " saved and set as the power up default" << endl;
+    }
+    catch (Spinnaker::Exception& e)
+    {
+        cout << "Error: " << e.what() << endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif // SPINNAKER_USER_SET_H
@@ -0,0 +1,437 @@
+// Description: Synthetic camera backend -> patterned frames at a configurable rate, size, jitter and drop rate
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "synthetic_camera.h"
+
+using namespace std;
+
+// The pattern moves 2 pixels per frame (keeps the Bayer phase) and wraps after PATTERN_TRAVEL pixels
+static const int64_t PATTERN_TRAVEL = 64;
+static const unsigned int LEVELS = 4096;
+
+/**
+ * Constructor for the SYNTHETIC_CAMERA class.
+ */
+SYNTHETIC_CAMERA::SYNTHETIC_CAMERA()
+    : config(default_synthetic_camera_config()), initialized(false), acquiring(false), pixel_format(FRAME_PIXEL_FORMAT_MONO8),
+      width(0), height(0), offset_x(0), offset_y(0), exposure_us(10000.0), gain_db(0.0), gamma(1.0), next_frame_id(0), random_state(1)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Destructor for the SYNTHETIC_CAMERA class.
+ */
+SYNTHETIC_CAMERA::~SYNTHETIC_CAMERA()
+{
+    deinit();
+}
+
+/**
+ * Sets the sensor, timing and error model. Call before init().
+ * @param camera_config: The configuration.
+ * @return 0 if the configuration is valid, -1 otherwise.
+ */
+int SYNTHETIC_CAMERA::configure(const SYNTHETIC_CAMERA_CONFIG& camera_config)
+{
+    if (initialized)
+    {
+        cerr << "[Synthetic camera] Configure before init()\n";
+        return -1;
+    }
+    if (camera_config.sensor_width < 2 || camera_config.sensor_height < 2 || camera_config.frame_rate < 0.0 ||
+        camera_config.jitter_us < 0.0 || camera_config.drop_rate < 0.0 || camera_config.drop_rate >= 1.0 || camera_config.buffer_count == 0)
+    {
+        cerr << "[Synthetic camera] Invalid configuration (sensor at least 2x2, frame rate >= 0, drop rate 0..1, at least 1 buffer)\n";
+        return -1;
+    }
+
+    config = camera_config;
+    width = 0;
+    height = 0;
+    return 0;
+}
+
+/**
+ * Opens the camera with the full sensor as ROI (unless an ROI was set).
+ * @return 0
+ */
+int SYNTHETIC_CAMERA::init()
+{
+    if (width == 0 || height == 0)
+    {
+        width = config.sensor_width;
+        height = config.sensor_height;
+        offset_x = 0;
+        offset_y = 0;
+    }
+    initialized = true;
+    return 0;
+}
+
+/**
+ * Stops acquisition and closes the camera.
+ * @return 0
+ */
+int SYNTHETIC_CAMERA::deinit()
+{
+    stop();
+    initialized = false;
+    return 0;
+}
+
+/**
+ * Sets the pixel format of the delivered frames.
+ * @param format: One of FRAME_PIXEL_FORMAT.
+ * @return 0 if successful, -1 if acquiring or the format is unknown.
+ */
+int SYNTHETIC_CAMERA::set_pixel_format(uint32_t format)
+{
+    if (acquiring || frame_bytes_per_pixel(format) == 0 || (format & FRAME_COMPRESSED_FLAG) != 0)
+    {
+        cerr << "[Synthetic camera] Unable to set pixel format " << get_frame_pixel_format_name(format) << endl;
+        return -1;
+    }
+    pixel_format = format;
+    return 0;
+}
+
+/**
+ * Sets the region of interest.
+ * @param roi_width: Width in pixels.
+ * @param roi_height: Height in pixels.
+ * @param roi_offset_x: OffsetX.
+ * @param roi_offset_y: OffsetY.
+ * @return 0 if successful, -1 if acquiring or the ROI does not fit the sensor.
+ */
+int SYNTHETIC_CAMERA::set_roi(int64_t roi_width, int64_t roi_height, int64_t roi_offset_x, int64_t roi_offset_y)
+{
+    if (acquiring || roi_width <= 0 || roi_height <= 0 || roi_offset_x < 0 || roi_offset_y < 0 ||
+        roi_offset_x + roi_width > config.sensor_width || roi_offset_y + roi_height > config.sensor_height)
+    {
+        cerr << "[Synthetic camera] Unable to set ROI " << roi_width << "x" << roi_height << "+" << roi_offset_x << "+" << roi_offset_y
+             << " (sensor " << config.sensor_width << "x" << config.sensor_height << ")\n";
+        return -1;
+    }
+
+    width = roi_width;
+    height = roi_height;
+    offset_x = roi_offset_x;
+    offset_y = roi_offset_y;
+    return 0;
+}
+
+/**
+ * Sets the exposure time (clamped to 10 us .. 30 s). Scales the brightness, 10 ms is the nominal level.
+ * @param exposure: Exposure time in microseconds.
+ * @return 0 if successful, -1 if acquiring.
+ */
+int SYNTHETIC_CAMERA::set_exposure(double exposure)
+{
+    if (acquiring)
+    {
+        return -1;
+    }
+    exposure_us = min(max(exposure, 10.0), 30000000.0);
+    return 0;
+}
+
+/**
+ * Sets the gain (clamped to 0 .. 48 dB).
+ * @param gain: Gain in dB.
+ * @return 0 if successful, -1 if acquiring.
+ */
+int SYNTHETIC_CAMERA::set_gain(double gain)
+{
+    if (acquiring)
+    {
+        return -1;
+    }
+    gain_db = min(max(gain, 0.0), 48.0);
+    return 0;
+}
+
+/**
+ * Sets the gamma (clamped to 0.25 .. 4).
+ * @param gamma_value: The gamma.
+ * @return 0 if successful, -1 if acquiring.
+ */
+int SYNTHETIC_CAMERA::set_gamma(double gamma_value)
+{
+    if (acquiring)
+    {
+        return -1;
+    }
+    gamma = min(max(gamma_value, 0.25), 4.0);
+    return 0;
+}
+
+/**
+ * Renders the pattern for the current ROI, pixel format and exposure. Diagonal gradient with a checkerboard, the
+ * colour channels differ so BGR8 and Bayer frames are not grey.
+ */
+void SYNTHETIC_CAMERA::render_pattern()
+{
+    uint32_t bytes_per_pixel = frame_bytes_per_pixel(pixel_format);
+    int64_t pattern_width = width + PATTERN_TRAVEL;
+    pattern.assign(static_cast<size_t>(pattern_width * height * bytes_per_pixel), 0);
+
+    // Level -> pixel value after gamma and exposure/gain, so the loop below does no floating point math
+    double brightness = exposure_us / 10000.0 * pow(10.0, gain_db / 20.0);
+    uint32_t max_value = pixel_format == FRAME_PIXEL_FORMAT_MONO16 ? 4095 : 255;
+    vector<uint16_t> lut(LEVELS);
+    for (unsigned int level = 0; level < LEVELS; level++)
+    {
+        double value = min(1.0, pow(static_cast<double>(level) / (LEVELS - 1), 1.0 / gamma) * brightness);
+        lut[level] = static_cast<uint16_t>(value * max_value + 0.5);
+    }
+
+    for (int64_t y = 0; y < height; y++)
+    {
+        int64_t sensor_y = offset_y + y;
+        uint8_t* row = pattern.data() + y * pattern_width * bytes_per_pixel;
+
+        for (int64_t x = 0; x < pattern_width; x++)
+        {
+            int64_t sensor_x = offset_x + x;
+            unsigned int gradient = static_cast<unsigned int>((sensor_x + sensor_y) % 1024) * (LEVELS * 7 / 10) / 1024;
+            unsigned int checker = ((sensor_x / 64 + sensor_y / 64) % 2) * (LEVELS * 3 / 10);
+            unsigned int level = min(gradient + checker, LEVELS - 1);
+
+            // Blue follows the pattern, green half of it, red the inverse
+            unsigned int channel_levels[3] = { level, level / 2 + LEVELS / 4, LEVELS - 1 - level };
+
+            switch (pixel_format)
+            {
+                case FRAME_PIXEL_FORMAT_MONO8:
+                    row[x] = static_cast<uint8_t>(lut[level]);
+                    break;
+                case FRAME_PIXEL_FORMAT_MONO16:
+                {
+                    uint16_t value = static_cast<uint16_t>(lut[level] << 4);   // 12 bit sensor data, MSB aligned
+                    memcpy(row + 2 * x, &value, sizeof(value));
+                    break;
+                }
+                case FRAME_PIXEL_FORMAT_BGR8:
+                    for (int channel = 0; channel < 3; channel++)
+                    {
+                        row[3 * x + channel] = static_cast<uint8_t>(lut[channel_levels[channel]]);
+                    }
+                    break;
+                case FRAME_PIXEL_FORMAT_BAYER_RG8:
+                {
+                    // RGGB: R G on even rows, G B on odd rows
+                    int channel = (sensor_y % 2 == 0) ? (sensor_x % 2 == 0 ? 2 : 1) : (sensor_x % 2 == 0 ? 1 : 0);
+                    row[x] = static_cast<uint8_t>(lut[channel_levels[channel]]);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    frame_buffer.assign(get_max_frame_bytes(), 0);
+}
+
+/**
+ * Returns the next pseudo random number (xorshift32).
+ * @return A number in 0..1.
+ */
+double SYNTHETIC_CAMERA::next_random()
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return static_cast<double>(random_state) / 4294967296.0;
+}
+
+/**
+ * Starts acquisition: renders the pattern and starts the frame clock. Frame IDs start at 0.
+ * @return 0 if successful, -1 if the camera was not initialized.
+ */
+int SYNTHETIC_CAMERA::start()
+{
+    if (!initialized)
+    {
+        cerr << "[Synthetic camera] init() first\n";
+        return -1;
+    }
+    if (acquiring)
+    {
+        return 0;
+    }
+
+    render_pattern();
+    memset(&stats, 0, sizeof(stats));
+    random_state = config.seed != 0 ? config.seed : 1;
+    next_frame_id = 0;
+    start_time = chrono::steady_clock::now();
+    acquiring = true;
+
+    cout << "[Synthetic camera] " << config.serial << ": " << width << "x" << height << "+" << offset_x << "+" << offset_y << " "
+         << get_frame_pixel_format_name(pixel_format) << ", ";
+    if (config.frame_rate > 0.0)
+    {
+        cout << config.frame_rate << " fps";
+    }
+    else
+    {
+        cout << "free running";
+    }
+    cout << ", jitter " << config.jitter_us << " us, drop rate " << config.drop_rate << endl;
+    return 0;
+}
+
+/**
+ * Stops acquisition.
+ * @return 0
+ */
+int SYNTHETIC_CAMERA::stop()
+{
+    acquiring = false;
+    return 0;
+}
+
+/**
+ * Waits until the next frame is due and renders it. Frames the consumer was too slow for are overwritten once more than
+ * buffer_count of them are waiting, like the camera's buffers would be.
+ * @param frame: Receives the frame (valid until release_frame() or the next call).
+ * @param timeout_ms: Longest wait.
+ * @return 0 with a frame, 1 if no frame was due within timeout_ms, -1 if not acquiring.
+ */
+int SYNTHETIC_CAMERA::next_frame(CAMERA_FRAME& frame, unsigned int timeout_ms)
+{
+    if (!acquiring)
+    {
+        return -1;
+    }
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    chrono::steady_clock::time_point due = now;
+
+    if (config.frame_rate > 0.0)
+    {
+        double period_ns = 1e9 / config.frame_rate;
+
+        // Frame n is complete at start_time + (n + 1) periods
+        uint64_t completed = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now - start_time).count() / period_ns);
+        if (completed > next_frame_id + config.buffer_count)
+        {
+            stats.overwritten += completed - config.buffer_count - next_frame_id;
+            next_frame_id = completed - config.buffer_count;
+        }
+
+        // Lost in transfer: the frame ID is used up, the consumer sees the gap
+        while (config.drop_rate > 0.0 && next_random() < config.drop_rate)
+        {
+            stats.dropped++;
+            next_frame_id++;
+        }
+
+        double jitter_ns = min(config.jitter_us * 1000.0, period_ns / 4.0) * (2.0 * next_random() - 1.0);
+        due = start_time + chrono::nanoseconds(static_cast<int64_t>((next_frame_id + 1) * period_ns + jitter_ns));
+        if (due > now + chrono::milliseconds(timeout_ms))
+        {
+            this_thread::sleep_for(chrono::milliseconds(timeout_ms));
+            return 1;
+        }
+        this_thread::sleep_until(due);
+    }
+    else
+    {
+        while (config.drop_rate > 0.0 && next_random() < config.drop_rate)
+        {
+            stats.dropped++;
+            next_frame_id++;
+        }
+    }
+
+    uint32_t bytes_per_pixel = frame_bytes_per_pixel(pixel_format);
+    size_t row_bytes = static_cast<size_t>(width) * bytes_per_pixel;
+    size_t pattern_row_bytes = static_cast<size_t>(width + PATTERN_TRAVEL) * bytes_per_pixel;
+    size_t shift_bytes = static_cast<size_t>((next_frame_id % (PATTERN_TRAVEL / 2)) * 2) * bytes_per_pixel;
+    for (int64_t y = 0; y < height; y++)
+    {
+        memcpy(frame_buffer.data() + y * row_bytes, pattern.data() + y * pattern_row_bytes + shift_bytes, row_bytes);
+    }
+
+    init_frame_header(frame.header, static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(row_bytes),
+                      pixel_format, frame_buffer.size());
+    frame.header.frame_id = next_frame_id;
+    frame.header.timestamp_ns = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(due.time_since_epoch()).count());
+    frame.header.offset_x = offset_x;
+    frame.header.offset_y = offset_y;
+    set_frame_serial(frame.header, config.serial);
+    frame.data = frame_buffer.data();
+
+    next_frame_id++;
+    stats.frames++;
+    return 0;
+}
+
+/**
+ * Releases the frame (the buffer is reused by the next frame).
+ */
+void SYNTHETIC_CAMERA::release_frame()
+{
+}
+
+/**
+ * Returns the configured serial number.
+ */
+string SYNTHETIC_CAMERA::get_serial() const
+{
+    return config.serial;
+}
+
+/**
+ * Returns the frame size for the current ROI and pixel format.
+ */
+size_t SYNTHETIC_CAMERA::get_max_frame_bytes() const
+{
+    return static_cast<size_t>(width * height) * frame_bytes_per_pixel(pixel_format);
+}
+
+/**
+ * Returns the backend name for logging.
+ */
+const char* SYNTHETIC_CAMERA::get_backend_name() const
+{
+    return "synthetic";
+}
+
+/**
+ * Returns a snapshot of the counters.
+ * @return The counters since start().
+ */
+SYNTHETIC_CAMERA_STATS SYNTHETIC_CAMERA::get_stats() const
+{
+    return stats;
+}
+
+/**
+ * Returns the default configuration.
+ * @return 2448x2048 sensor, 30 fps, no jitter, no drops, 10 buffers.
+ */
+SYNTHETIC_CAMERA_CONFIG default_synthetic_camera_config()
+{
+    SYNTHETIC_CAMERA_CONFIG camera_config;
+    camera_config.serial = "synthetic";
+    camera_config.sensor_width = 2448;
+    camera_config.sensor_height = 2048;
+    camera_config.frame_rate = 30.0;
+    camera_config.jitter_us = 0.0;
+    camera_config.drop_rate = 0.0;
+    camera_config.buffer_count = 10;
+    camera_config.seed = 1;
+    return camera_config;
+}
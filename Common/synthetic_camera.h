@@ -0,0 +1,98 @@
+// synthetic_camera.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef SYNTHETIC_CAMERA_H
+#define SYNTHETIC_CAMERA_H
+
+#include "camera_backend.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Struct to hold the synthetic camera configuration
+struct SYNTHETIC_CAMERA_CONFIG
+{
+    string serial;
+    int64_t sensor_width;       // Full sensor, the ROI has to fit in it
+    int64_t sensor_height;
+    double frame_rate;          // 0 -> a new frame whenever one is taken
+    double jitter_us;           // Timestamps vary uniformly by +- this much (limited to a quarter of the frame period)
+    double drop_rate;           // Chance (0..1) that a frame is lost in transfer, its frame ID is skipped
+    unsigned int buffer_count;  // Frames held for a slow consumer before the oldest are overwritten
+    uint32_t seed;
+};
+
+// Struct to hold the synthetic camera counters
+struct SYNTHETIC_CAMERA_STATS
+{
+    uint64_t frames;            // Delivered
+    uint64_t dropped;           // Lost in transfer (drop_rate)
+    uint64_t overwritten;       // Lost because next_frame was not called in time
+};
+
+// Camera without hardware: a moving test pattern at the configured rate, size and pixel format, with timestamp jitter
+// and frame drops. Exposure, gain and gamma change the brightness like they would on a sensor. Frame IDs, timestamps,
+// ROI offsets and the serial are filled in like a real camera does, so frame IDs skip over lost frames.
+class SYNTHETIC_CAMERA : public CAMERA_BACKEND
+{
+    private:
+        SYNTHETIC_CAMERA_CONFIG config;
+        SYNTHETIC_CAMERA_STATS stats;
+        bool initialized;
+        bool acquiring;
+
+        uint32_t pixel_format;
+        int64_t width;
+        int64_t height;
+        int64_t offset_x;
+        int64_t offset_y;
+        double exposure_us;
+        double gain_db;
+        double gamma;
+
+        vector<uint8_t> pattern;        // Rendered once per start(), wider than the ROI so it can move sideways
+        vector<uint8_t> frame_buffer;
+        uint64_t next_frame_id;
+        chrono::steady_clock::time_point start_time;
+        uint32_t random_state;
+
+        void render_pattern();
+        double next_random();   // 0..1
+
+    public:
+        SYNTHETIC_CAMERA();
+        ~SYNTHETIC_CAMERA();
+
+        int configure(const SYNTHETIC_CAMERA_CONFIG& camera_config);  // Before init()
+
+        int init();
+        int deinit();
+
+        int set_pixel_format(uint32_t format);
+        int set_roi(int64_t roi_width, int64_t roi_height, int64_t roi_offset_x, int64_t roi_offset_y);
+        int set_exposure(double exposure);
+        int set_gain(double gain);
+        int set_gamma(double gamma_value);
+
+        int start();
+        int stop();
+
+        int next_frame(CAMERA_FRAME& frame, unsigned int timeout_ms);
+        void release_frame();
+
+        string get_serial() const;
+        size_t get_max_frame_bytes() const;
+        const char* get_backend_name() const;
+
+        SYNTHETIC_CAMERA_STATS get_stats() const;
+};
+
+// Default configuration: 2448x2048 sensor (Blackfly S 5 MP), 30 fps, no jitter, no drops
+SYNTHETIC_CAMERA_CONFIG default_synthetic_camera_config();
+
+#endif // SYNTHETIC_CAMERA_H
@@ -0,0 +1,194 @@
+// Description: Opt-in per-thread event recorder that writes the acquisition timeline as a Chrome trace JSON file
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "trace_recorder.h"
+
+using namespace std;
+
+atomic<bool> TRACE_RECORDER::enabled(false);
+mutex TRACE_RECORDER::buffers_mutex;
+vector<TRACE_THREAD_BUFFER*> TRACE_RECORDER::buffers;
+string TRACE_RECORDER::output_path;
+size_t TRACE_RECORDER::events_per_thread = 0;
+uint64_t TRACE_RECORDER::start_ns = 0;
+
+static thread_local TRACE_THREAD_BUFFER* thread_buffer = nullptr;
+static thread_local string* pending_thread_name = nullptr;  // set_thread_name before the thread's first event
+
+static uint64_t trace_now_ns()
+{
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Starts recording.
+ * @param path: The JSON file written by stop().
+ * @param max_events_per_thread: Buffer size of every thread, later events are counted as dropped.
+ * @return 0 if successful, -1 if the recorder was already started.
+ */
+int TRACE_RECORDER::start(const string& path, size_t max_events_per_thread)
+{
+    lock_guard<mutex> lock(buffers_mutex);
+    if (enabled.load() || !output_path.empty())
+    {
+        return -1;  // One trace per process, the buffers of the first one may still be in use
+    }
+
+    output_path = path;
+    events_per_thread = max_events_per_thread > 0 ? max_events_per_thread : 1;
+    start_ns = trace_now_ns();
+    enabled.store(true);
+
+    cout << "[Trace] Recording acquisition events to " << path << " (" << events_per_thread << " events per thread)" << endl;
+    return 0;
+}
+
+/**
+ * Registers the calling thread (called on its first event while enabled).
+ * @return The thread's buffer.
+ */
+TRACE_THREAD_BUFFER* TRACE_RECORDER::create_thread_buffer()
+{
+    TRACE_THREAD_BUFFER* buffer = new TRACE_THREAD_BUFFER();
+    buffer->events.resize(events_per_thread);
+    buffer->count.store(0);
+    buffer->dropped.store(0);
+    buffer->thread_id = static_cast<long>(syscall(SYS_gettid));
+
+    lock_guard<mutex> lock(buffers_mutex);
+    buffer->thread_name = pending_thread_name ? *pending_thread_name : "thread " + to_string(buffer->thread_id);
+    buffers.push_back(buffer);
+    return buffer;
+}
+
+/**
+ * Appends an event to the calling thread's buffer. Use trace_begin/trace_end/TRACE_SCOPE, they check is_enabled() first.
+ * @param phase: 'B', 'E' or 'i'.
+ * @param name: Event name (string literal).
+ * @param arg_name: Argument name (string literal) or nullptr.
+ * @param arg_value: Argument value.
+ */
+void TRACE_RECORDER::record(char phase, const char* name, const char* arg_name, int64_t arg_value)
+{
+    if (!thread_buffer)
+    {
+        thread_buffer = create_thread_buffer();
+    }
+
+    size_t index = thread_buffer->count.load(memory_order_relaxed);
+    if (index >= thread_buffer->events.size())
+    {
+        thread_buffer->dropped.store(thread_buffer->dropped.load(memory_order_relaxed) + 1, memory_order_relaxed);
+        return;
+    }
+
+    TRACE_EVENT& event = thread_buffer->events[index];
+    event.time_ns = trace_now_ns();
+    event.name = name;
+    event.arg_name = arg_name;
+    event.arg_value = arg_value;
+    event.phase = phase;
+    thread_buffer->count.store(index + 1, memory_order_release);
+}
+
+/**
+ * Names the calling thread's track in the trace.
+ * @param name: The name, e.g. "acquisition" or "frame writer".
+ */
+void TRACE_RECORDER::set_thread_name(const string& name)
+{
+    if (!pending_thread_name)
+    {
+        pending_thread_name = new string();     // Lives as long as the thread might record
+    }
+
+    lock_guard<mutex> lock(buffers_mutex);
+    *pending_thread_name = name;
+    if (thread_buffer)
+    {
+        thread_buffer->thread_name = name;
+    }
+}
+
+/**
+ * Stops recording and writes every thread's events as a Chrome trace JSON file.
+ * @return 0 if successful, -1 otherwise.
+ */
+int TRACE_RECORDER::stop()
+{
+    if (!enabled.exchange(false))
+    {
+        return -1;
+    }
+
+    lock_guard<mutex> lock(buffers_mutex);
+
+    ofstream file(output_path);
+    if (!file.is_open())
+    {
+        cerr << "[Trace] Unable to open " << output_path << endl;
+        return -1;
+    }
+
+    long process_id = static_cast<long>(getpid());
+    size_t event_count = 0;
+    uint64_t dropped_count = 0;
+    bool first = true;
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << fixed << setprecision(3);
+
+    for (TRACE_THREAD_BUFFER* buffer : buffers)
+    {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << process_id << ",\"tid\":" << buffer->thread_id
+             << ",\"args\":{\"name\":\"" << buffer->thread_name << "\"}}";
+        first = false;
+
+        size_t count = buffer->count.load(memory_order_acquire);
+        for (size_t i = 0; i < count; i++)
+        {
+            const TRACE_EVENT& event = buffer->events[i];
+            double time_us = event.time_ns >= start_ns ? (event.time_ns - start_ns) / 1000.0 : 0.0;
+
+            file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"acquisition\",\"ph\":\"" << event.phase << "\",\"ts\":" << time_us
+                 << ",\"pid\":" << process_id << ",\"tid\":" << buffer->thread_id;
+            if (event.phase == 'i')
+            {
+                file << ",\"s\":\"t\"";
+            }
+            if (event.arg_name)
+            {
+                file << ",\"args\":{\"" << event.arg_name << "\":" << event.arg_value << "}";
+            }
+            file << "}";
+        }
+
+        event_count += count;
+        dropped_count += buffer->dropped.load(memory_order_relaxed);
+    }
+    file << "\n]}\n";
+
+    if (!file.good())
+    {
+        cerr << "[Trace] Write failed for " << output_path << endl;
+        return -1;
+    }
+
+    cout << "[Trace] " << event_count << " events from " << buffers.size() << " thread(s) written to " << output_path;
+    if (dropped_count > 0)
+    {
+        cout << ", " << dropped_count << " dropped (buffers full)";
+    }
+    cout << endl;
+    return 0;
+}
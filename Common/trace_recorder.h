@@ -0,0 +1,138 @@
+// trace_recorder.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// One begin/end/instant event. Names are string literals, only the pointer is stored.
+struct TRACE_EVENT
+{
+    uint64_t time_ns;           // steady_clock
+    const char* name;
+    const char* arg_name;       // nullptr -> no argument
+    int64_t arg_value;
+    char phase;                 // 'B' begin, 'E' end, 'i' instant
+};
+
+// Events of one thread. Only that thread appends; count is published with release so the writer of the file can read concurrently.
+struct TRACE_THREAD_BUFFER
+{
+    vector<TRACE_EVENT> events; // Allocated once with the capacity, never reallocated
+    atomic<size_t> count;
+    atomic<uint64_t> dropped;   // Events after the buffer was full
+    long thread_id;
+    string thread_name;         // Guarded by the recorder's buffers_mutex
+};
+
+// Opt-in timeline of the acquisition in Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+// Disabled, every trace point is one relaxed load and a not-taken branch. Enabled, a thread gets its own fixed size buffer on
+// its first event, so recording never takes a lock; stop() writes all buffers as one JSON file.
+// Buffers are kept until the process exits, threads that still hold one may record while the file is written.
+class TRACE_RECORDER
+{
+    private:
+        static atomic<bool> enabled;
+        static mutex buffers_mutex;
+        static vector<TRACE_THREAD_BUFFER*> buffers;
+        static string output_path;
+        static size_t events_per_thread;
+        static uint64_t start_ns;
+
+        static TRACE_THREAD_BUFFER* create_thread_buffer();
+
+    public:
+        static int start(const string& path, size_t max_events_per_thread); // Enable recording, the file is written by stop()
+        static int stop();                                                  // Disable recording and write the file
+
+        static inline bool is_enabled();
+        static void record(char phase, const char* name, const char* arg_name, int64_t arg_value);
+        static void set_thread_name(const string& name);                    // Shown as the track name in the viewer
+};
+
+/**
+ * Checks whether events are recorded.
+ * @return true between start() and stop().
+ */
+inline bool TRACE_RECORDER::is_enabled()
+{
+    return enabled.load(memory_order_relaxed);
+}
+
+/**
+ * Starts a duration event on this thread.
+ * @param name: Event name (string literal).
+ * @param arg_name: Optional argument name (string literal), e.g. "camera".
+ * @param arg_value: Argument value.
+ */
+inline void trace_begin(const char* name, const char* arg_name = nullptr, int64_t arg_value = 0)
+{
+    if (TRACE_RECORDER::is_enabled())
+    {
+        TRACE_RECORDER::record('B', name, arg_name, arg_value);
+    }
+}
+
+/**
+ * Ends the innermost duration event on this thread.
+ * @param name: Event name (string literal), same as in trace_begin.
+ */
+inline void trace_end(const char* name)
+{
+    if (TRACE_RECORDER::is_enabled())
+    {
+        TRACE_RECORDER::record('E', name, nullptr, 0);
+    }
+}
+
+/**
+ * Records a point in time (incomplete image, dropped frame, ...).
+ * @param name: Event name (string literal).
+ * @param arg_name: Optional argument name (string literal).
+ * @param arg_value: Argument value.
+ */
+inline void trace_instant(const char* name, const char* arg_name = nullptr, int64_t arg_value = 0)
+{
+    if (TRACE_RECORDER::is_enabled())
+    {
+        TRACE_RECORDER::record('i', name, arg_name, arg_value);
+    }
+}
+
+// Duration event for the enclosing scope (ends on every return and exception)
+class TRACE_SCOPE
+{
+    private:
+        const char* event_name;     // nullptr -> tracing was disabled at the begin
+
+    public:
+        inline TRACE_SCOPE(const char* name, const char* arg_name = nullptr, int64_t arg_value = 0) : event_name(nullptr)
+        {
+            if (TRACE_RECORDER::is_enabled())
+            {
+                event_name = name;
+                TRACE_RECORDER::record('B', name, arg_name, arg_value);
+            }
+        }
+
+        inline ~TRACE_SCOPE()
+        {
+            if (event_name)
+            {
+                TRACE_RECORDER::record('E', event_name, nullptr, 0);
+            }
+        }
+
+        TRACE_SCOPE(const TRACE_SCOPE&) = delete;
+        TRACE_SCOPE& operator=(const TRACE_SCOPE&) = delete;
+};
+
+#endif // TRACE_RECORDER_H
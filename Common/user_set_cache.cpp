@@ -0,0 +1,111 @@
+// Description: Host side record of the camera UserSets saved by the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "user_set_cache.h"
+
+using namespace std;
+
+/**
+ * Reads the cache file.
+ * @param path: The cache file.
+ * @return 0 if the file was read or does not exist yet, -1 if a line is malformed (the cache is then empty).
+ */
+int USER_SET_CACHE::load(const string& path)
+{
+    cache_path = path;
+    entries.clear();
+
+    ifstream file_in(path);
+    if (!file_in)
+    {
+        return 0;
+    }
+
+    string line;
+    int line_number = 0;
+    while (getline(file_in, line))
+    {
+        line_number++;
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        istringstream fields(line);
+        string serial;
+        USER_SET_ENTRY entry;
+        if (!(fields >> serial >> entry.user_set >> hex >> entry.hash))
+        {
+            cerr << "[UserSet] " << path << ":" << line_number << ": Expected <serial> <user set> <hash>, ignoring the cache" << endl;
+            entries.clear();
+            return -1;
+        }
+        entries[serial] = entry;
+    }
+
+    return 0;
+}
+
+/**
+ * Checks if the settings were saved into the UserSet of this camera.
+ * @param serial: The camera serial number.
+ * @param user_set: The UserSet the tool uses.
+ * @param hash: hash_camera_profile() of the settings the camera should run with.
+ * @return true if the camera's entry has the same UserSet and hash.
+ */
+bool USER_SET_CACHE::matches(const string& serial, const string& user_set, uint64_t hash) const
+{
+    map<string, USER_SET_ENTRY>::const_iterator it = entries.find(serial);
+    return it != entries.end() && it->second.user_set == user_set && it->second.hash == hash;
+}
+
+/**
+ * Records a saved UserSet and rewrites the cache file (temp file + rename, so a crash never leaves half of it).
+ * @param serial: The camera serial number.
+ * @param user_set: The UserSet the settings were saved into.
+ * @param hash: hash_camera_profile() of the saved settings.
+ * @return 0 if successful, -1 if the file cannot be written.
+ */
+int USER_SET_CACHE::store(const string& serial, const string& user_set, uint64_t hash)
+{
+    USER_SET_ENTRY entry = {user_set, hash};
+    entries[serial] = entry;
+
+    string temp_path = cache_path + ".tmp";
+    {
+        ofstream file_out(temp_path, ios::trunc);
+        if (!file_out)
+        {
+            cerr << "[UserSet] Unable to write " << temp_path << endl;
+            return -1;
+        }
+
+        file_out << "# <serial> <user set> <settings hash>, written by the capture tools" << endl;
+        for (const auto& it : entries)
+        {
+            file_out << it.first << " " << it.second.user_set << " " << hex << it.second.hash << dec << endl;
+        }
+        if (!file_out)
+        {
+            cerr << "[UserSet] Unable to write " << temp_path << endl;
+            return -1;
+        }
+    }
+
+    if (rename(temp_path.c_str(), cache_path.c_str()) != 0)
+    {
+        cerr << "[UserSet] Unable to replace " << cache_path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+// user_set_cache.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef USER_SET_CACHE_H
+#define USER_SET_CACHE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+using namespace std;
+
+// Struct to hold what was saved into the UserSet of one camera
+struct USER_SET_ENTRY
+{
+    string user_set;    // UserSetSelector entry, e.g. UserSet1
+    uint64_t hash;      // hash_camera_profile() of the saved settings
+};
+
+// Host side record of the UserSets the tools saved, one line per camera: "<serial> <user set> <hash>".
+// A camera whose entry matches the hash of its current settings (and still boots into that UserSet) only needs
+// UserSetLoad at startup instead of every node write.
+class USER_SET_CACHE
+{
+    private:
+        string cache_path;
+        map<string, USER_SET_ENTRY> entries;    // By serial number
+
+    public:
+        int load(const string& path);   // A missing file is an empty cache
+        bool matches(const string& serial, const string& user_set, uint64_t hash) const;
+        int store(const string& serial, const string& user_set, uint64_t hash);    // Update the entry and rewrite the file
+};
+
+#endif // USER_SET_CACHE_H
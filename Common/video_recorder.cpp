@@ -0,0 +1,633 @@
+// Description: Records frames into rotating, indexed uncompressed AVI files (one stream per camera/ROI)
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <unistd.h>
+
+#include "direct_file.h"
+#include "video_recorder.h"
+
+using namespace std;
+
+// The AVI headers are written into the first page, the 'movi' list starts right after it
+static const size_t AVI_HEADER_BLOCK = 4096;
+static const uint64_t AVI_MOVI_FOURCC_OFFSET = AVI_HEADER_BLOCK - 4;    // idx1 offsets are relative to this
+static const uint64_t AVI_MAX_SEGMENT_BYTES = 1024ULL * 1024 * 1024;    // AVI 1.0 readers expect at most 1 GB
+static const size_t AVI_CHUNK_HEADER = 8;
+static const uint32_t AVIF_HASINDEX = 0x10;
+static const uint32_t AVIIF_KEYFRAME = 0x10;
+static const double AVI_FALLBACK_FRAME_RATE = 30.0;
+
+/**
+ * Appends a little endian 32 bit value.
+ * @param block: The buffer.
+ * @param value: The value.
+ */
+static void put_u32(vector<uint8_t>& block, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        block.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+/**
+ * Appends a little endian 16 bit value.
+ * @param block: The buffer.
+ * @param value: The value.
+ */
+static void put_u16(vector<uint8_t>& block, uint16_t value)
+{
+    block.push_back(static_cast<uint8_t>(value));
+    block.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+/**
+ * Appends a four character code.
+ * @param block: The buffer.
+ * @param fourcc: Exactly four characters.
+ */
+static void put_fourcc(vector<uint8_t>& block, const char* fourcc)
+{
+    block.insert(block.end(), fourcc, fourcc + 4);
+}
+
+/**
+ * Returns the four character code as a little endian value (for fields that hold a FOURCC).
+ * @param fourcc: Exactly four characters.
+ * @return The value.
+ */
+static uint32_t fourcc_value(const char* fourcc)
+{
+    return static_cast<uint32_t>(static_cast<uint8_t>(fourcc[0])) | static_cast<uint32_t>(static_cast<uint8_t>(fourcc[1])) << 8 |
+           static_cast<uint32_t>(static_cast<uint8_t>(fourcc[2])) << 16 | static_cast<uint32_t>(static_cast<uint8_t>(fourcc[3])) << 24;
+}
+
+/**
+ * Returns the bytes of one stored row. 24 bit DIB rows are padded to 4 bytes, the grey formats are packed.
+ * @param width: Pixels per row.
+ * @param pixel_format: One of FRAME_PIXEL_FORMAT.
+ * @return Bytes per row, 0 for formats that cannot be stored.
+ */
+static uint32_t stored_row_bytes(uint32_t width, uint32_t pixel_format)
+{
+    switch (pixel_format)
+    {
+        case FRAME_PIXEL_FORMAT_MONO8:
+        case FRAME_PIXEL_FORMAT_BAYER_RG8:
+            return width;
+        case FRAME_PIXEL_FORMAT_MONO16:
+            return width * 2;
+        case FRAME_PIXEL_FORMAT_BGR8:
+            return (width * 3 + 3) & ~3u;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Builds the AVI header page: RIFF/hdrl with one video stream, JUNK padding and the 'movi' list header.
+ * @param width: Frame width.
+ * @param height: Frame height.
+ * @param pixel_format: One of FRAME_PIXEL_FORMAT.
+ * @param frame_bytes: Stored pixel bytes per frame.
+ * @param frames: Frames in the file (0 while recording).
+ * @param frame_rate: Frames per second.
+ * @param file_size: Total file size (0 while recording).
+ * @param movi_end: End of the last frame chunk (0 while recording).
+ * @return AVI_HEADER_BLOCK bytes.
+ */
+static vector<uint8_t> build_avi_headers(uint32_t width, uint32_t height, uint32_t pixel_format, uint32_t frame_bytes,
+                                         uint32_t frames, double frame_rate, uint64_t file_size, uint64_t movi_end)
+{
+    bool bgr = pixel_format == FRAME_PIXEL_FORMAT_BGR8;
+    const char* handler = bgr ? "DIB " : (pixel_format == FRAME_PIXEL_FORMAT_MONO16 ? "Y16 " : "Y800");
+    uint16_t bit_count = static_cast<uint16_t>(frame_bytes_per_pixel(pixel_format) * 8);
+    uint32_t rate = static_cast<uint32_t>(lround(frame_rate * 1000.0));
+    uint32_t chunk_bytes = frame_bytes + static_cast<uint32_t>(AVI_CHUNK_HEADER);
+
+    vector<uint8_t> block;
+    block.reserve(AVI_HEADER_BLOCK);
+
+    put_fourcc(block, "RIFF");
+    put_u32(block, file_size > 8 ? static_cast<uint32_t>(file_size - 8) : 0);
+    put_fourcc(block, "AVI ");
+
+    put_fourcc(block, "LIST");
+    put_u32(block, 4 + (8 + 56) + (8 + 116));
+    put_fourcc(block, "hdrl");
+
+    // MainAVIHeader
+    put_fourcc(block, "avih");
+    put_u32(block, 56);
+    put_u32(block, static_cast<uint32_t>(lround(1000000.0 / frame_rate)));     // dwMicroSecPerFrame
+    put_u32(block, static_cast<uint32_t>(frame_rate * chunk_bytes));          // dwMaxBytesPerSec
+    put_u32(block, 0);                          // dwPaddingGranularity
+    put_u32(block, AVIF_HASINDEX);
+    put_u32(block, frames);                     // dwTotalFrames
+    put_u32(block, 0);                          // dwInitialFrames
+    put_u32(block, 1);                          // dwStreams
+    put_u32(block, chunk_bytes);                // dwSuggestedBufferSize
+    put_u32(block, width);
+    put_u32(block, height);
+    for (int i = 0; i < 4; i++)
+    {
+        put_u32(block, 0);                      // dwReserved
+    }
+
+    put_fourcc(block, "LIST");
+    put_u32(block, 4 + (8 + 56) + (8 + 40));
+    put_fourcc(block, "strl");
+
+    // AVIStreamHeader
+    put_fourcc(block, "strh");
+    put_u32(block, 56);
+    put_fourcc(block, "vids");
+    put_fourcc(block, handler);
+    put_u32(block, 0);                          // dwFlags
+    put_u16(block, 0);                          // wPriority
+    put_u16(block, 0);                          // wLanguage
+    put_u32(block, 0);                          // dwInitialFrames
+    put_u32(block, 1000);                       // dwScale
+    put_u32(block, rate);                       // dwRate (frames per second = rate / scale)
+    put_u32(block, 0);                          // dwStart
+    put_u32(block, frames);                     // dwLength
+    put_u32(block, chunk_bytes);                // dwSuggestedBufferSize
+    put_u32(block, 0xFFFFFFFF);                 // dwQuality (default)
+    put_u32(block, 0);                          // dwSampleSize
+    put_u16(block, 0);                          // rcFrame
+    put_u16(block, 0);
+    put_u16(block, static_cast<uint16_t>(width));
+    put_u16(block, static_cast<uint16_t>(height));
+
+    // BITMAPINFOHEADER (negative height = top-down rows for BI_RGB, the grey formats are always top-down)
+    put_fourcc(block, "strf");
+    put_u32(block, 40);
+    put_u32(block, 40);
+    put_u32(block, width);
+    put_u32(block, bgr ? static_cast<uint32_t>(-static_cast<int32_t>(height)) : height);
+    put_u16(block, 1);                          // biPlanes
+    put_u16(block, bit_count);
+    put_u32(block, bgr ? 0 : fourcc_value(handler));    // biCompression (BI_RGB = 0)
+    put_u32(block, frame_bytes);                // biSizeImage
+    for (int i = 0; i < 4; i++)
+    {
+        put_u32(block, 0);                      // Resolution and palette
+    }
+
+    // Pad so the 'movi' list header ends exactly at the end of the page
+    put_fourcc(block, "JUNK");
+    put_u32(block, static_cast<uint32_t>(AVI_HEADER_BLOCK - 12 - block.size() - 4));
+    block.resize(AVI_HEADER_BLOCK - 12, 0);
+
+    put_fourcc(block, "LIST");
+    put_u32(block, movi_end > AVI_MOVI_FOURCC_OFFSET ? static_cast<uint32_t>(movi_end - AVI_MOVI_FOURCC_OFFSET) : 4);
+    put_fourcc(block, "movi");
+
+    return block;
+}
+
+/**
+ * Constructor for the VIDEO_RECORDER class.
+ */
+VIDEO_RECORDER::VIDEO_RECORDER()
+    : jobs_in_progress(0), stopping(false), frames_recorded(0), bytes_recorded(0), segments_opened(0), stalls(0), errors(0)
+{
+}
+
+/**
+ * Destructor for the VIDEO_RECORDER class -> writes what is queued, closes the files and stops the writer.
+ */
+VIDEO_RECORDER::~VIDEO_RECORDER()
+{
+    if (writer_thread.joinable())
+    {
+        flush();
+
+        {
+            lock_guard<mutex> lock(recorder_mutex);
+            stopping = true;
+        }
+        job_available.notify_all();
+        writer_thread.join();
+    }
+}
+
+/**
+ * Allocates the staging buffers and starts the writer thread. Files are created when the first frame of a
+ * camera/ROI arrives.
+ * @param recorder_config: The recorder configuration.
+ * @return 0 if successful, -1 otherwise.
+ */
+int VIDEO_RECORDER::init(const VIDEO_RECORDER_CONFIG& recorder_config)
+{
+    config = recorder_config;
+    config.max_segment_bytes = min(config.max_segment_bytes, AVI_MAX_SEGMENT_BYTES);
+
+    // Worst case: 24 bit rows padded to 4 bytes
+    size_t max_chunk_size = AVI_CHUNK_HEADER + config.max_frame_bytes + config.max_frame_bytes / 3 + 4;
+    if (AVI_HEADER_BLOCK + max_chunk_size + 64 > config.max_segment_bytes)
+    {
+        cerr << "[Video] Segment size " << config.max_segment_bytes << " is smaller than one frame\n";
+        return -1;
+    }
+
+    if (buffer_pool.init(config.buffer_count, max_chunk_size) != 0)
+    {
+        return -1;
+    }
+
+    writer_thread = thread(&VIDEO_RECORDER::writer_loop, this);
+
+    cout << "[Video] Recording AVI files to " << config.folder_path << " (";
+    if (config.segment_seconds > 0.0)
+    {
+        cout << config.segment_seconds << " s or ";
+    }
+    cout << config.max_segment_bytes / (1024 * 1024) << " MB per file, " << config.buffer_count << " buffers)" << endl;
+
+    return 0;
+}
+
+/**
+ * Finds the open stream for the frame's camera/ROI or creates one. A stream whose geometry changed is closed
+ * first, so every file holds frames of one size.
+ * @param header: The frame header.
+ * @return The stream.
+ */
+VIDEO_RECORDER::VIDEO_STREAM* VIDEO_RECORDER::find_stream(const FRAME_HEADER& header)
+{
+    string serial(header.serial, strnlen(header.serial, sizeof(header.serial)));
+    if (serial.empty())
+    {
+        serial = "camera";
+    }
+
+    for (auto& stream : streams)
+    {
+        if (stream->serial == serial && stream->offset_x == header.offset_x)
+        {
+            if (stream->width != header.width || stream->height != header.height || stream->pixel_format != header.pixel_format)
+            {
+                close_segment(*stream);
+                stream->width = header.width;
+                stream->height = header.height;
+                stream->pixel_format = header.pixel_format;
+                stream->frame_bytes = stored_row_bytes(header.width, header.pixel_format) * header.height;
+            }
+            return stream.get();
+        }
+    }
+
+    unique_ptr<VIDEO_STREAM> stream(new VIDEO_STREAM());
+    stream->serial = serial;
+    stream->offset_x = header.offset_x;
+    stream->width = header.width;
+    stream->height = header.height;
+    stream->pixel_format = header.pixel_format;
+    stream->frame_bytes = stored_row_bytes(header.width, header.pixel_format) * header.height;
+    stream->fd = -1;
+    stream->segment_index = 0;
+    stream->file_offset = 0;
+    streams.push_back(move(stream));
+    return streams.back().get();
+}
+
+/**
+ * Creates the next AVI file of a stream and writes provisional headers (they are completed on close).
+ * @param stream: The stream.
+ * @return 0 if successful, -1 otherwise.
+ */
+int VIDEO_RECORDER::open_segment(VIDEO_STREAM& stream)
+{
+    // Never truncate a file of an earlier run into the same folder: skip the indices in use, like SEGMENT_RECORDER
+    ostringstream path;
+    unsigned int first_index = stream.segment_index;
+    while (true)
+    {
+        path.str("");
+        path << config.folder_path;
+        if (!config.folder_path.empty() && config.folder_path.back() != '/')
+        {
+            path << '/';
+        }
+        path << config.prefix << "_" << stream.serial << "_X" << stream.offset_x << "_" << setw(6) << setfill('0') << stream.segment_index << ".avi";
+
+        bool direct_io_active = false;
+        stream.fd = open_new_output_file(path.str(), false, direct_io_active);
+        if (stream.fd >= 0)
+        {
+            break;
+        }
+        if (errno != EEXIST || stream.segment_index == UINT_MAX)
+        {
+            return -1;
+        }
+        stream.segment_index++;
+    }
+
+    if (stream.segment_index != first_index && first_index == 0)
+    {
+        cout << "[Video] " << config.folder_path << " has earlier files, continuing at " << path.str() << endl;
+    }
+
+    double frame_rate = config.frame_rate > 0.0 ? config.frame_rate : AVI_FALLBACK_FRAME_RATE;
+    vector<uint8_t> headers = build_avi_headers(stream.width, stream.height, stream.pixel_format, stream.frame_bytes, 0, frame_rate, 0, 0);
+    if (write_all(stream.fd, reinterpret_cast<const char*>(headers.data()), headers.size(), 0) != 0)
+    {
+        close(stream.fd);
+        stream.fd = -1;
+        return -1;
+    }
+
+    stream.path = path.str();
+    stream.file_offset = AVI_HEADER_BLOCK;
+    stream.opened_time = chrono::steady_clock::now();
+    stream.index.clear();
+    stream.segment_index++;
+    segments_opened++;
+
+    return 0;
+}
+
+/**
+ * Finishes the current file of a stream: appends the idx1 index, rewrites the headers with the frame count and
+ * the frame rate, and writes the .csv frame list next to it.
+ * @param stream: The stream.
+ */
+void VIDEO_RECORDER::close_segment(VIDEO_STREAM& stream)
+{
+    if (stream.fd < 0)
+    {
+        return;
+    }
+
+    vector<uint8_t> index_chunk;
+    index_chunk.reserve(8 + stream.index.size() * 16);
+    put_fourcc(index_chunk, "idx1");
+    put_u32(index_chunk, static_cast<uint32_t>(stream.index.size() * 16));
+    for (const auto& entry : stream.index)
+    {
+        put_fourcc(index_chunk, "00db");
+        put_u32(index_chunk, AVIIF_KEYFRAME);
+        put_u32(index_chunk, static_cast<uint32_t>(entry.offset - AVI_MOVI_FOURCC_OFFSET));
+        put_u32(index_chunk, entry.size);
+    }
+
+    // Frame rate from the camera timestamps unless it was configured
+    double frame_rate = config.frame_rate;
+    if (frame_rate <= 0.0 && stream.index.size() > 1 && stream.index.back().timestamp_ns > stream.index.front().timestamp_ns)
+    {
+        frame_rate = (stream.index.size() - 1) * 1e9 / (stream.index.back().timestamp_ns - stream.index.front().timestamp_ns);
+    }
+    if (frame_rate <= 0.0)
+    {
+        frame_rate = AVI_FALLBACK_FRAME_RATE;
+    }
+
+    uint64_t movi_end = stream.file_offset;
+    uint64_t file_size = movi_end + index_chunk.size();
+    vector<uint8_t> headers = build_avi_headers(stream.width, stream.height, stream.pixel_format, stream.frame_bytes,
+                                                static_cast<uint32_t>(stream.index.size()), frame_rate, file_size, movi_end);
+
+    if (write_all(stream.fd, reinterpret_cast<const char*>(index_chunk.data()), index_chunk.size(), movi_end) != 0 ||
+        write_all(stream.fd, reinterpret_cast<const char*>(headers.data()), headers.size(), 0) != 0)
+    {
+        cerr << "[Video] Unable to finish " << stream.path << ": " << strerror(errno) << endl;
+        errors++;
+    }
+
+    close(stream.fd);
+    stream.fd = -1;
+
+    string list_path = stream.path.substr(0, stream.path.size() - 4) + ".csv";
+    ofstream list(list_path);
+    if (!list)
+    {
+        cerr << "[Video] Unable to create " << list_path << endl;
+        errors++;
+        return;
+    }
+
+    list << "frame,frame_id,timestamp_ns,offset,size\n";
+    for (size_t i = 0; i < stream.index.size(); i++)
+    {
+        const INDEX_ENTRY& entry = stream.index[i];
+        list << i << "," << entry.frame_id << "," << entry.timestamp_ns << "," << entry.offset + AVI_CHUNK_HEADER << "," << entry.size << "\n";
+    }
+}
+
+/**
+ * Appends one frame chunk to the stream's file, starting a new file when the current one is old or full.
+ * @param header: The frame header.
+ * @param chunk: Chunk header + pixels.
+ * @param chunk_size: Bytes to write (even).
+ * @return 0 if successful, -1 otherwise.
+ */
+int VIDEO_RECORDER::write_chunk(const FRAME_HEADER& header, const char* chunk, size_t chunk_size)
+{
+    VIDEO_STREAM* stream = find_stream(header);
+
+    if (stream->fd >= 0)
+    {
+        bool too_old = config.segment_seconds > 0.0 &&
+                       chrono::duration<double>(chrono::steady_clock::now() - stream->opened_time).count() >= config.segment_seconds;
+        bool too_big = stream->file_offset + chunk_size + 8 + (stream->index.size() + 1) * 16 > config.max_segment_bytes;
+        if (too_old || too_big)
+        {
+            close_segment(*stream);
+        }
+    }
+
+    if (stream->fd < 0 && open_segment(*stream) != 0)
+    {
+        return -1;
+    }
+
+    if (write_all(stream->fd, chunk, chunk_size, stream->file_offset) != 0)
+    {
+        return -1;
+    }
+    drop_written_range(stream->fd, stream->file_offset, chunk_size);
+
+    INDEX_ENTRY entry = {stream->file_offset, stream->frame_bytes, header.frame_id, header.timestamp_ns};
+    stream->index.push_back(entry);
+    stream->file_offset += chunk_size;
+    return 0;
+}
+
+/**
+ * Writer thread: appends queued frames in order until the recorder is destroyed.
+ */
+void VIDEO_RECORDER::writer_loop()
+{
+    unique_lock<mutex> lock(recorder_mutex);
+
+    while (true)
+    {
+        job_available.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+        {
+            return; // stopping and nothing left to do
+        }
+
+        WRITE_JOB job = jobs.front();
+        jobs.pop_front();
+        jobs_in_progress++;
+        lock.unlock();
+
+        if (write_chunk(job.header, buffer_pool.get_buffer(job.buffer_index), job.chunk_size) == 0)
+        {
+            frames_recorded++;
+            bytes_recorded += job.chunk_size;
+        }
+        else
+        {
+            errors++;
+        }
+
+        buffer_pool.release(job.buffer_index);
+
+        lock.lock();
+        jobs_in_progress--;
+        jobs_done.notify_all();
+    }
+}
+
+/**
+ * Copies the frame into a staging buffer as a complete AVI chunk and queues it for the writer thread.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if the frame was queued, -1 otherwise.
+ */
+int VIDEO_RECORDER::consume_frame(const FRAME_HEADER& header, const void* data)
+{
+    uint32_t row_bytes = stored_row_bytes(header.width, header.pixel_format);
+    if (row_bytes == 0 || header.height == 0)
+    {
+        errors++;
+        return -1;   // Compressed or unknown pixel format
+    }
+
+    uint32_t source_row_bytes = header.width * frame_bytes_per_pixel(header.pixel_format);
+    size_t source_stride = header.stride != 0 ? header.stride : source_row_bytes;
+    size_t frame_bytes = static_cast<size_t>(row_bytes) * header.height;
+    size_t chunk_size = AVI_CHUNK_HEADER + frame_bytes + (frame_bytes & 1);
+
+    if (chunk_size > buffer_pool.get_buffer_size() || source_stride * (header.height - 1) + source_row_bytes > header.data_size)
+    {
+        cerr << "[Video] Frame of " << header.data_size << " bytes does not fit the configured maximum\n";
+        errors++;
+        return -1;
+    }
+
+    unsigned int buffer_index;
+    if (!buffer_pool.try_acquire(buffer_index))
+    {
+        stalls++;
+        buffer_index = buffer_pool.acquire();
+    }
+
+    char* buffer = buffer_pool.get_buffer(buffer_index);
+    uint32_t chunk_data_size = static_cast<uint32_t>(frame_bytes);
+    memcpy(buffer, "00db", 4);
+    memcpy(buffer + 4, &chunk_data_size, 4);
+
+    const char* source = static_cast<const char*>(data);
+    char* destination = buffer + AVI_CHUNK_HEADER;
+    if (source_stride == row_bytes)
+    {
+        memcpy(destination, source, frame_bytes);
+    }
+    else
+    {
+        for (uint32_t row = 0; row < header.height; row++)
+        {
+            memcpy(destination + static_cast<size_t>(row) * row_bytes, source + row * source_stride, source_row_bytes);
+            memset(destination + static_cast<size_t>(row) * row_bytes + source_row_bytes, 0, row_bytes - source_row_bytes);
+        }
+    }
+    if (frame_bytes & 1)
+    {
+        destination[frame_bytes] = 0;   // Chunks are padded to an even size
+    }
+
+    {
+        lock_guard<mutex> lock(recorder_mutex);
+        WRITE_JOB job = {buffer_index, chunk_size, header};
+        jobs.push_back(job);
+    }
+    job_available.notify_one();
+
+    return 0;
+}
+
+/**
+ * Waits until every queued frame has been written and finishes the open files, so they are complete even if
+ * the program is killed afterwards. The next frame of a stream starts a new file.
+ * @return 0 if no write failed so far, -1 otherwise.
+ */
+int VIDEO_RECORDER::flush()
+{
+    unique_lock<mutex> lock(recorder_mutex);
+    jobs_done.wait(lock, [this] { return jobs.empty() && jobs_in_progress == 0; });
+
+    // The writer thread is idle and cannot pick up a job while the lock is held
+    for (auto& stream : streams)
+    {
+        close_segment(*stream);
+    }
+
+    return errors.load() == 0 ? 0 : -1;
+}
+
+/**
+ * Returns the sink name.
+ */
+const char* VIDEO_RECORDER::get_sink_name() const
+{
+    return "video recorder";
+}
+
+/**
+ * Returns a snapshot of the recorder counters.
+ * @return The current statistics.
+ */
+VIDEO_RECORDER_STATS VIDEO_RECORDER::get_stats() const
+{
+    VIDEO_RECORDER_STATS stats;
+    stats.frames_recorded = frames_recorded.load();
+    stats.bytes_recorded = bytes_recorded.load();
+    stats.segments_opened = segments_opened.load();
+    stats.stalls = stalls.load();
+    stats.errors = errors.load();
+    return stats;
+}
+
+/**
+ * Returns a sensible default configuration: one minute per file, 1 GB at most, 16 staging buffers.
+ * @param folder_path: Where the files are created.
+ * @param max_frame_bytes: Largest pixel payload that will be recorded.
+ * @return The configuration.
+ */
+VIDEO_RECORDER_CONFIG default_video_recorder_config(const string& folder_path, size_t max_frame_bytes)
+{
+    VIDEO_RECORDER_CONFIG config;
+    config.folder_path = folder_path;
+    config.prefix = "video";
+    config.segment_seconds = 60.0;
+    config.max_segment_bytes = AVI_MAX_SEGMENT_BYTES;
+    config.buffer_count = 16;
+    config.max_frame_bytes = max_frame_bytes;
+    config.frame_rate = 0.0;
+    return config;
+}
@@ -0,0 +1,127 @@
+// video_recorder.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef VIDEO_RECORDER_H
+#define VIDEO_RECORDER_H
+
+#include "aligned_buffer_pool.h"
+#include "frame_format.h"
+#include "frame_sink.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Struct to hold the video recorder configuration
+struct VIDEO_RECORDER_CONFIG
+{
+    string folder_path;         // Where the video files are created
+    string prefix;              // -> <prefix>_<serial>_X<offset_x>_<index>.avi (+ .csv frame list)
+    double segment_seconds;     // Start a new file after this long (0 = only on size)
+    uint64_t max_segment_bytes; // Start a new file before it grows past this (at most 1 GB, AVI 1.0 index limit)
+    unsigned int buffer_count;  // Staging buffers (frames that can be queued)
+    size_t max_frame_bytes;     // Largest pixel payload that will be recorded
+    double frame_rate;          // Frame rate written to the headers, 0 = measured from the camera timestamps
+};
+
+// Struct to hold the video recorder counters
+struct VIDEO_RECORDER_STATS
+{
+    uint64_t frames_recorded;
+    uint64_t bytes_recorded;    // Including chunk headers and padding
+    uint64_t segments_opened;   // Summed over all camera/ROI streams
+    uint64_t stalls;            // consume_frame had to wait for a staging buffer
+    uint64_t errors;
+};
+
+// Records each camera/ROI stream (serial + offset_x) into uncompressed AVI files: Y800 for Mono8/Bayer, Y16 for
+// Mono16, 24 bit BGR for BGR8. Every segment has an idx1 index and a .csv listing frame ID, camera timestamp and
+// file offset of every frame. A writer thread appends the frames, so the acquisition loop only copies into a
+// staging buffer; no file is created per frame.
+class VIDEO_RECORDER : public FRAME_SINK
+{
+    private:
+        struct WRITE_JOB
+        {
+            unsigned int buffer_index;
+            size_t chunk_size;          // Chunk header + pixels + padding
+            FRAME_HEADER header;
+        };
+
+        struct INDEX_ENTRY
+        {
+            uint64_t offset;            // Of the chunk header in the file
+            uint32_t size;              // Pixel bytes
+            uint64_t frame_id;
+            uint64_t timestamp_ns;
+        };
+
+        // One open AVI file per camera/ROI, only touched by the writer thread
+        struct VIDEO_STREAM
+        {
+            string serial;
+            int64_t offset_x;
+            uint32_t width;
+            uint32_t height;
+            uint32_t pixel_format;
+            uint32_t frame_bytes;       // Pixel bytes per frame as stored (rows padded for BGR)
+
+            int fd;
+            unsigned int segment_index;
+            uint64_t file_offset;
+            string path;
+            chrono::steady_clock::time_point opened_time;
+            vector<INDEX_ENTRY> index;
+        };
+
+        VIDEO_RECORDER_CONFIG config;
+        ALIGNED_BUFFER_POOL buffer_pool;
+        vector<unique_ptr<VIDEO_STREAM>> streams;
+
+        thread writer_thread;
+        deque<WRITE_JOB> jobs;
+        unsigned int jobs_in_progress;
+        bool stopping;
+        mutex recorder_mutex;
+        condition_variable job_available;
+        condition_variable jobs_done;
+
+        atomic<uint64_t> frames_recorded;
+        atomic<uint64_t> bytes_recorded;
+        atomic<uint64_t> segments_opened;
+        atomic<uint64_t> stalls;
+        atomic<uint64_t> errors;
+
+        void writer_loop();
+        int write_chunk(const FRAME_HEADER& header, const char* chunk, size_t chunk_size);
+        VIDEO_STREAM* find_stream(const FRAME_HEADER& header);
+        int open_segment(VIDEO_STREAM& stream);     // Create the file and write the headers
+        void close_segment(VIDEO_STREAM& stream);   // Write idx1 and the .csv, patch the headers, close
+
+    public:
+        VIDEO_RECORDER();
+        ~VIDEO_RECORDER();
+
+        int init(const VIDEO_RECORDER_CONFIG& recorder_config);     // Allocate the buffers and start the writer thread
+
+        int consume_frame(const FRAME_HEADER& header, const void* data);
+        int flush();    // Writes what is queued and closes the open segments (the next frame starts new ones)
+        const char* get_sink_name() const;
+
+        VIDEO_RECORDER_STATS get_stats() const;
+};
+
+// Default configuration: one minute segments, 1 GB at most, 16 staging buffers, measured frame rate
+VIDEO_RECORDER_CONFIG default_video_recorder_config(const string& folder_path, size_t max_frame_bytes);
+
+#endif // VIDEO_RECORDER_H
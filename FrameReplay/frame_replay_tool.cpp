@@ -0,0 +1,502 @@
+// Description: Replays recorded frames (or a folder of saved JPEG images) through the capture pipeline as a virtual camera
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <string>
+#include <atomic>   // For std::atomic --> Cleared by Ctrl+C to stop the replay
+#include <memory>   // For std::unique_ptr
+#include <algorithm>
+#include <csignal>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "command_line.h"
+#include "frame_compressor.h"
+#include "frame_pipeline.h"
+#include "frame_replay.h"
+#include "frame_stream.h"
+#include "frame_writer.h"
+#include "jpeg_folder_source.h"
+#include "metrics_server.h"
+#include "segment_recorder.h"
+#include "shm_frame_ring.h"
+#include "synthetic_camera.h"
+#include "video_recorder.h"
+
+#ifdef WITH_SPINNAKER
+#include "spinnaker_camera.h"
+#endif
+
+using namespace std;
+
+static atomic<bool> global_running(true);
+
+#ifdef WITH_SPINNAKER
+// Spinnaker system and camera of --camera, released in the order the SDK needs (camera, list, system)
+struct SPINNAKER_SESSION
+{
+    SystemPtr system;
+    CameraList camera_list;
+    unique_ptr<SPINNAKER_CAMERA> camera;
+
+    ~SPINNAKER_SESSION()
+    {
+        camera.reset();
+        camera_list.Clear();
+        if (system)
+        {
+            system->ReleaseInstance();
+        }
+    }
+};
+#endif
+
+/**
+ * Stops the replay on Ctrl+C (the pipeline is still flushed).
+ * @param signal_number: The signal.
+ */
+static void handle_interrupt(int signal_number)
+{
+    (void)signal_number;
+    global_running.store(false);
+}
+
+/**
+ * Checks whether a path is a folder of JPEG images without any recordings in it.
+ * @param path: The --input path.
+ * @return true if the folder should be replayed with JPEG_FOLDER_SOURCE.
+ */
+static bool is_jpeg_folder(const string& path)
+{
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) != 0 || !S_ISDIR(path_stat.st_mode))
+    {
+        return false;
+    }
+
+    DIR* directory = opendir(path.c_str());
+    if (directory == nullptr)
+    {
+        return false;
+    }
+
+    bool has_jpeg = false;
+    bool has_recording = false;
+    while (struct dirent* entry = readdir(directory))
+    {
+        string name = entry->d_name;
+        if (name.size() < 5)
+        {
+            continue;
+        }
+        string extension = name.substr(name.size() - 4);
+        has_jpeg |= extension == ".jpg" || extension == ".JPG";
+        has_recording |= extension == ".rec" || extension == ".raw";
+    }
+    closedir(directory);
+
+    return has_jpeg && !has_recording;
+}
+
+int main(int argc, char** argv)
+{
+    // Print application build information
+    cout << "Application build date: " << __DATE__ << " " << __TIME__ << endl << endl;
+
+    // --input=<file|folder> -> .rec/.raw recordings (or a folder of them), or a folder of saved JPEG images
+    // --synthetic -> synthetic camera instead (--width, --height, --offset-x, --offset-y, --format, --fps, --jitter-us, --drop-rate)
+    // --camera[=<serial>] -> a Spinnaker camera instead (first one if no serial, same ROI/format options, built with the SDK only)
+    // --mode=realtime|fast|fixed -> recorded timing (--speed=<x>), as fast as possible, or --fps=<n>
+    // --loops=<n> (0 = until Ctrl+C), --frames=<n>, --preload -> read everything into memory first
+    // --writer=uring|pwrite|none (default) -> raw files into the disk ring in --out=<folder> (--ring-slots, --ring-sync)
+    // --record, --compress, --video, --shm, --stream -> the same frame sinks as the capture tools
+    // --metrics=<port> -> Prometheus metrics on http://127.0.0.1:<port>/metrics
+    COMMAND_LINE command_line(argc, argv);
+    string input_path = command_line.get_string("input", "");
+    string mode_name = command_line.get_string("mode", "realtime");
+    string writer_name = command_line.get_string("writer", "none");
+    string folder_path = command_line.get_string("out", "");
+    string record_path = command_line.get_string("record", "");
+    string video_path = command_line.get_string("video", "");
+    double video_seconds = command_line.get_double("video-seconds", 60.0);
+    string shm_name = command_line.get_string("shm", "");
+    long long shm_slots = command_line.get_int("shm-slots", 8);
+    string stream_address = command_line.has("stream") ? command_line.get_string("stream", "5600") : "";
+    long long stream_buffers = command_line.get_int("stream-buffers", 16);
+    long long segment_mb = command_line.get_int("segment-mb", 1024);
+    string codec_name = command_line.get_string("compress", "none");
+    COMPRESSION_CODEC compression_codec = COMPRESSION_NONE;
+    long long ring_slots = command_line.get_int("ring-slots", 5);
+    bool ring_sync = command_line.get_int("ring-sync", 1) != 0;
+    long long metrics_port = command_line.has("metrics") ? command_line.get_int("metrics", 9100) : 0;
+
+    bool synthetic = command_line.has("synthetic");
+    bool live_camera = command_line.has("camera");
+
+#ifndef WITH_SPINNAKER
+    if (live_camera)
+    {
+        cerr << "--camera needs the Spinnaker SDK at build time.\n";
+        return -1;
+    }
+#endif
+
+    if (input_path.empty() && !synthetic && !live_camera)
+    {
+        cerr << "Usage: " << argv[0] << " --input=<file|folder>|--synthetic|--camera[=<serial>] [--mode=realtime|fast|fixed] [--fps=<n>] [--speed=<x>] [--loops=<n>]"
+             << " [--frames=<n>] [--preload] [--writer=uring|pwrite|none --out=<folder>] [--record=<folder>] [--video=<folder>]"
+             << " [--shm=<name>] [--stream=<port>] [--metrics=<port>]\n";
+        return -1;
+    }
+
+    FRAME_REPLAY_CONFIG replay_config = default_frame_replay_config();
+    if (!parse_replay_mode(mode_name, replay_config.mode))
+    {
+        cerr << "Unknown mode: " << mode_name << ". Use realtime, fast or fixed.\n";
+        return -1;
+    }
+    replay_config.speed = command_line.get_double("speed", replay_config.speed);
+    replay_config.frame_rate = command_line.get_double("fps", replay_config.frame_rate);
+    replay_config.loops = static_cast<unsigned int>(max(0LL, command_line.get_int("loops", replay_config.loops)));
+    replay_config.max_frames = static_cast<uint64_t>(max(0LL, command_line.get_int("frames", 0)));
+    replay_config.preload = command_line.has("preload");
+    if (synthetic || live_camera)
+    {
+        replay_config.mode = REPLAY_FAST;   // The camera paces the frames (--fps is its frame rate)
+        if (replay_config.preload && replay_config.max_frames == 0)
+        {
+            cerr << "--preload with a camera needs --frames.\n";
+            return -1;
+        }
+    }
+
+    FRAME_REPLAY replay;
+    if (replay.init(replay_config) != 0)
+    {
+        return -1;
+    }
+
+    if (!parse_compression_codec(codec_name, compression_codec))
+    {
+        cerr << "Unknown codec: " << codec_name << ". Use none, lz4 or zstd.\n";
+        return -1;
+    }
+    if (!is_compression_codec_available(compression_codec))
+    {
+        cerr << "Built without " << codec_name << " (library not found at build time).\n";
+        return -1;
+    }
+    if (ring_slots < 1 || stream_buffers < 1 || shm_slots < 1)
+    {
+        cerr << "--ring-slots, --stream-buffers and --shm-slots must be at least 1.\n";
+        return -1;
+    }
+    if (command_line.has("shm") && shm_name.empty())
+    {
+        shm_name = "/spinnaker_frames";
+    }
+    else if (!shm_name.empty() && shm_name[0] != '/')
+    {
+        shm_name = "/" + shm_name;
+    }
+
+    FRAME_WRITER_BACKEND writer_backend = FRAME_WRITER_BACKEND_URING;
+    if (writer_name != "none" && !parse_frame_writer_backend(writer_name, writer_backend))
+    {
+        cerr << "Unknown writer: " << writer_name << ". Use uring, pwrite or none.\n";
+        return -1;
+    }
+    if (writer_name != "none" && folder_path.empty())
+    {
+        cerr << "--writer needs --out=<folder>.\n";
+        return -1;
+    }
+    if (!folder_path.empty() && folder_path.back() != '/')
+    {
+        folder_path += "/";
+    }
+
+    // Camera settings of --synthetic and --camera
+    CAMERA_BACKEND_SETTINGS settings = default_camera_backend_settings();
+    settings.width = command_line.get_int("width", 1216);
+    settings.height = command_line.get_int("height", 352);
+    settings.offset_x = command_line.get_int("offset-x", 0);
+    settings.offset_y = command_line.get_int("offset-y", 0);
+    settings.exposure_us = command_line.get_double("exposure", settings.exposure_us);
+    settings.gain_db = command_line.get_double("gain", settings.gain_db);
+    string format_name = command_line.get_string("format", "mono8");
+    if (!parse_frame_pixel_format(format_name, settings.pixel_format))
+    {
+        cerr << "Unknown format: " << format_name << ". Use mono8, mono16, bgr8 or bayer_rg8.\n";
+        return -1;
+    }
+
+    // Open the source (a camera, recordings, or a folder of JPEG images from the capture tools' default writer)
+#ifdef WITH_SPINNAKER
+    SPINNAKER_SESSION spinnaker_session;    // Outlives source, which reads from its camera
+#endif
+    unique_ptr<FRAME_SOURCE> source;
+    SYNTHETIC_CAMERA synthetic_camera;
+    if (live_camera)
+    {
+#ifdef WITH_SPINNAKER
+        spinnaker_session.system = System::GetInstance();
+        spinnaker_session.camera_list = spinnaker_session.system->GetCameras();
+        string serial = command_line.get_string("camera", "");
+        CameraPtr camera_pointer = serial.empty() ? (spinnaker_session.camera_list.GetSize() > 0 ? spinnaker_session.camera_list.GetByIndex(0) : CameraPtr())
+                                                  : spinnaker_session.camera_list.GetBySerial(serial);
+        if (!camera_pointer)
+        {
+            cerr << "No camera " << (serial.empty() ? string("found") : serial) << ". Exiting.\n";
+            return -1;
+        }
+
+        spinnaker_session.camera.reset(new SPINNAKER_CAMERA(camera_pointer));
+        SPINNAKER_CAMERA& camera = *spinnaker_session.camera;
+        if (camera.init() != 0 || configure_camera_backend(camera, settings) != 0 || camera.start() != 0)
+        {
+            cerr << "Failed to start the camera. Exiting.\n";
+            return -1;
+        }
+        source.reset(new CAMERA_SOURCE(&camera, 1000));
+        input_path = camera.get_serial();
+#endif
+    }
+    else if (synthetic)
+    {
+        SYNTHETIC_CAMERA_CONFIG camera_config = default_synthetic_camera_config();
+        camera_config.frame_rate = command_line.get_double("fps", camera_config.frame_rate);
+        camera_config.jitter_us = command_line.get_double("jitter-us", camera_config.jitter_us);
+        camera_config.drop_rate = command_line.get_double("drop-rate", camera_config.drop_rate);
+
+        if (synthetic_camera.configure(camera_config) != 0 || synthetic_camera.init() != 0 ||
+            configure_camera_backend(synthetic_camera, settings) != 0 || synthetic_camera.start() != 0)
+        {
+            cerr << "Failed to start the synthetic camera. Exiting.\n";
+            return -1;
+        }
+        source.reset(new CAMERA_SOURCE(&synthetic_camera, 1000));
+        input_path = synthetic_camera.get_serial();
+    }
+    else if (command_line.has("jpeg") || is_jpeg_folder(input_path))
+    {
+        JPEG_FOLDER_SOURCE* jpeg_source = new JPEG_FOLDER_SOURCE();
+        source.reset(jpeg_source);
+        if (jpeg_source->open_folder(input_path, command_line.has("mono16")) != 0)
+        {
+            cerr << "Failed to open " << input_path << ". Exiting.\n";
+            return -1;
+        }
+    }
+    else
+    {
+        RECORDING_SOURCE* recording_source = new RECORDING_SOURCE();
+        source.reset(recording_source);
+        if (recording_source->open_path(input_path) != 0)
+        {
+            cerr << "Failed to open " << input_path << ". Exiting.\n";
+            return -1;
+        }
+    }
+
+    size_t max_frame_bytes = source->get_max_frame_bytes();
+    cout << "[Replay] " << source->get_source_name() << " " << input_path << ", mode " << get_replay_mode_name(replay_config.mode) << endl;
+
+    FRAME_PIPELINE pipeline;
+    pipeline.set_save_images(writer_name != "none");
+    pipeline.set_ring_options(static_cast<unsigned int>(ring_slots), ring_sync);
+
+    // Create the frame writer if raw output was requested
+    unique_ptr<FRAME_WRITER> frame_writer;
+    if (writer_name != "none")
+    {
+        frame_writer = create_frame_writer(default_frame_writer_config(writer_backend, max_frame_bytes));
+        if (!frame_writer)
+        {
+            cerr << "Failed to create frame writer. Exiting.\n";
+            return -1;
+        }
+        pipeline.set_frame_writer(frame_writer.get());
+    }
+
+    // Create the segment recorder if recording was requested
+    unique_ptr<SEGMENT_RECORDER> segment_recorder;
+    unique_ptr<COMPRESSION_STAGE> compression_stage;   // Feeds segment_recorder, so it is destroyed first
+    if (!record_path.empty())
+    {
+        SEGMENT_RECORDER_CONFIG recorder_config = default_segment_recorder_config(record_path, compression_codec == COMPRESSION_NONE ?
+                                                                                  max_frame_bytes : get_max_compressed_frame_size(max_frame_bytes));
+        recorder_config.segment_size = static_cast<uint64_t>(segment_mb) * 1024 * 1024;
+
+        segment_recorder.reset(new SEGMENT_RECORDER());
+        if (segment_recorder->init(recorder_config) != 0)
+        {
+            cerr << "Failed to create segment recorder. Exiting.\n";
+            return -1;
+        }
+
+        if (compression_codec == COMPRESSION_NONE)
+        {
+            pipeline.add_frame_sink(segment_recorder.get());
+        }
+        else
+        {
+            COMPRESSION_CONFIG compression_config = default_compression_config(compression_codec, max_frame_bytes);
+            compression_config.level = static_cast<int>(command_line.get_int("compress-level", compression_config.level));
+            compression_config.threads = static_cast<unsigned int>(max(1LL, command_line.get_int("compress-threads", compression_config.threads)));
+
+            compression_stage.reset(new COMPRESSION_STAGE());
+            if (compression_stage->init(compression_config, segment_recorder.get(), recorder_config.buffer_count) != 0)
+            {
+                cerr << "Failed to create compression stage. Exiting.\n";
+                return -1;
+            }
+            pipeline.add_frame_sink(compression_stage.get());
+        }
+    }
+
+    // Create the video recorder if AVI recording was requested
+    unique_ptr<VIDEO_RECORDER> video_recorder;
+    if (!video_path.empty())
+    {
+        VIDEO_RECORDER_CONFIG video_config = default_video_recorder_config(video_path, max_frame_bytes);
+        video_config.segment_seconds = video_seconds;
+
+        video_recorder.reset(new VIDEO_RECORDER());
+        if (video_recorder->init(video_config) != 0)
+        {
+            cerr << "Failed to create video recorder. Exiting.\n";
+            return -1;
+        }
+        pipeline.add_frame_sink(video_recorder.get());
+    }
+
+    // Create the shared memory publisher if local readers were requested
+    unique_ptr<SHM_FRAME_PUBLISHER> shm_publisher;
+    if (!shm_name.empty())
+    {
+        shm_publisher.reset(new SHM_FRAME_PUBLISHER());
+        if (shm_publisher->init(shm_name, static_cast<unsigned int>(shm_slots), max_frame_bytes) != 0)
+        {
+            cerr << "Failed to create shared memory ring. Exiting.\n";
+            return -1;
+        }
+        pipeline.add_frame_sink(shm_publisher.get());
+    }
+
+    // Create the frame stream server if streaming was requested
+    unique_ptr<FRAME_STREAM_SERVER> stream_server;
+    if (!stream_address.empty())
+    {
+        FRAME_STREAM_CONFIG stream_config = default_frame_stream_config(stream_address, max_frame_bytes);
+        stream_config.packet_count = static_cast<unsigned int>(stream_buffers);
+
+        stream_server.reset(new FRAME_STREAM_SERVER());
+        if (stream_server->init(stream_config) != 0)
+        {
+            cerr << "Failed to start frame stream server. Exiting.\n";
+            return -1;
+        }
+        pipeline.add_frame_sink(stream_server.get());
+    }
+
+    // Create the metrics endpoint if requested (scraped from its own thread)
+    unique_ptr<METRICS_SERVER> metrics_server;
+    if (metrics_port > 0)
+    {
+        metrics_server.reset(new METRICS_SERVER());
+        metrics_server->set_frame_writer(frame_writer.get());
+        metrics_server->set_frame_pipeline(&pipeline);
+        if (metrics_server->init(static_cast<unsigned int>(metrics_port)) != 0)
+        {
+            cerr << "Failed to start metrics endpoint. Exiting.\n";
+            return -1;
+        }
+        pipeline.add_frame_sink(metrics_server.get());
+    }
+
+    if (pipeline.start(folder_path) != 0)
+    {
+        cerr << "Failed to prepare the output folder. Exiting.\n";
+        return -1;
+    }
+
+    signal(SIGINT, handle_interrupt);
+    int result = replay.run(*source, pipeline, global_running);
+
+    FRAME_REPLAY_STATS stats = replay.get_stats();
+    cout << "[Replay] " << stats.frames << " frames in " << stats.loops << " loop(s), " << stats.seconds << " s, "
+         << stats.frames_per_second << " fps\n";
+    cout << "[Replay] Pipeline per frame: p50 " << stats.process_p50_us << " us, p99 " << stats.process_p99_us
+         << " us, max " << stats.process_max_us << " us\n";
+    if (replay_config.mode != REPLAY_FAST)
+    {
+        cout << "[Replay] " << stats.late_frames << " late frame(s), latest by " << stats.max_late_ms << " ms\n";
+    }
+
+#ifdef WITH_SPINNAKER
+    if (spinnaker_session.camera)
+    {
+        spinnaker_session.camera->stop();
+    }
+#endif
+
+    if (synthetic)
+    {
+        synthetic_camera.stop();
+        SYNTHETIC_CAMERA_STATS camera_stats = synthetic_camera.get_stats();
+        cout << "[Synthetic camera] " << camera_stats.frames << " frames, " << camera_stats.dropped << " dropped in transfer, "
+             << camera_stats.overwritten << " overwritten (pipeline too slow)\n";
+    }
+
+    FRAME_PIPELINE_STATS pipeline_stats = pipeline.get_stats();
+    if (pipeline_stats.sink_rejections > 0 || pipeline_stats.write_errors > 0)
+    {
+        cout << "[Replay] " << pipeline_stats.sink_rejections << " sink rejection(s), " << pipeline_stats.write_errors << " write error(s)\n";
+    }
+
+    if (segment_recorder)
+    {
+        SEGMENT_RECORDER_STATS recorder_stats = segment_recorder->get_stats();
+        cout << "[Recorder] " << recorder_stats.frames_recorded << " frames, " << recorder_stats.bytes_recorded << " bytes in "
+             << recorder_stats.segments_opened << " segment(s), " << recorder_stats.stalls << " stalls, " << recorder_stats.errors
+             << " errors, slowest write " << recorder_stats.max_write_ms << " ms\n";
+    }
+
+    if (video_recorder)
+    {
+        VIDEO_RECORDER_STATS video_stats = video_recorder->get_stats();
+        cout << "[Video] " << video_stats.frames_recorded << " frames in " << video_stats.segments_opened << " file(s), "
+             << video_stats.stalls << " stalls, " << video_stats.errors << " errors\n";
+    }
+
+    if (compression_stage)
+    {
+        COMPRESSION_STATS compression_stats = compression_stage->get_stats();
+        cout << "[Compressor] " << compression_stats.frames << " frames, ratio "
+             << (compression_stats.compressed_bytes > 0 ? static_cast<double>(compression_stats.raw_bytes) / compression_stats.compressed_bytes : 0.0) << ", "
+             << (compression_stats.cpu_seconds > 0.0 ? compression_stats.raw_bytes / compression_stats.cpu_seconds / (1024.0 * 1024.0) : 0.0) << " MB/s per core, "
+             << compression_stats.stalls << " stalls, " << compression_stats.errors << " errors\n";
+    }
+
+    if (stream_server)
+    {
+        FRAME_STREAM_STATS stream_stats = stream_server->get_stats();
+        cout << "[Stream] " << stream_stats.clients_accepted << " client(s), " << stream_stats.frames_sent << " frames sent, "
+             << stream_stats.frames_dropped << " dropped for slow clients\n";
+        stream_server->stop();
+    }
+
+    if (shm_publisher)
+    {
+        cout << "[SHM] " << shm_publisher->get_published_count() << " frames published to " << shm_name << "\n";
+    }
+
+    if (!global_running)
+    {
+        cout << "Replay stopped by user.\n";
+    }
+
+    return result == 0 ? 0 : -1;
+}
@@ -0,0 +1,197 @@
+// Description: Frame source for folders of JPEG images saved by the capture tools
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <algorithm>
+#include <string>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#ifdef WITH_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+#include "jpeg_folder_source.h"
+
+using namespace std;
+
+/**
+ * Constructor for the JPEG_FOLDER_SOURCE class.
+ */
+JPEG_FOLDER_SOURCE::JPEG_FOLDER_SOURCE()
+    : next_image(0), max_frame_bytes(0), mono16(false)
+{
+}
+
+/**
+ * Lists the JPEG images of a folder in modification order and decodes the first one to size the pipeline.
+ * @param folder_path: The folder.
+ * @param widen_to_mono16: Replay grey images as Mono16 (value << 8) instead of Mono8.
+ * @return 0 if at least one image was found, -1 otherwise.
+ */
+int JPEG_FOLDER_SOURCE::open_folder(const string& folder_path, bool widen_to_mono16)
+{
+#ifndef WITH_OPENCV
+    (void)widen_to_mono16;
+    cerr << "[Replay] Built without OpenCV, JPEG folders cannot be replayed (" << folder_path << ")\n";
+    return -1;
+#else
+    mono16 = widen_to_mono16;
+    images.clear();
+
+    DIR* directory = opendir(folder_path.c_str());
+    if (directory == nullptr)
+    {
+        cerr << "[Replay] Unable to list " << folder_path << ": " << strerror(errno) << endl;
+        return -1;
+    }
+
+    string folder = folder_path.back() == '/' ? folder_path : folder_path + "/";
+    while (struct dirent* entry = readdir(directory))
+    {
+        string name = entry->d_name;
+        if (name[0] == '.' || name.size() < 5 || (name.compare(name.size() - 4, 4, ".jpg") != 0 && name.compare(name.size() - 4, 4, ".JPG") != 0))
+        {
+            continue;
+        }
+
+        struct stat file_stat;
+        if (stat((folder + name).c_str(), &file_stat) != 0)
+        {
+            continue;
+        }
+
+        IMAGE_FILE image;
+        image.path = folder + name;
+        image.modified_ns = static_cast<uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000ULL + static_cast<uint64_t>(file_stat.st_mtim.tv_nsec);
+        image.serial = "replay";
+        image.offset_x = 0;
+
+        // Serial_<serial>_OffsetX_<x>_Image_<slot>.jpg
+        size_t serial_end = name.find("_OffsetX_");
+        if (name.compare(0, 7, "Serial_") == 0 && serial_end != string::npos)
+        {
+            image.serial = name.substr(7, serial_end - 7);
+            image.offset_x = atoll(name.c_str() + serial_end + 9);
+        }
+
+        images.push_back(image);
+    }
+    closedir(directory);
+
+    sort(images.begin(), images.end(), [](const IMAGE_FILE& a, const IMAGE_FILE& b)
+    {
+        return a.modified_ns != b.modified_ns ? a.modified_ns < b.modified_ns : a.path < b.path;
+    });
+
+    if (images.empty())
+    {
+        cerr << "[Replay] No JPEG images found in " << folder_path << endl;
+        return -1;
+    }
+
+    cv::Mat first = cv::imread(images[0].path, cv::IMREAD_UNCHANGED);
+    if (first.empty())
+    {
+        cerr << "[Replay] Unable to decode " << images[0].path << endl;
+        return -1;
+    }
+    max_frame_bytes = static_cast<size_t>(first.cols) * first.rows * (first.channels() == 1 && mono16 ? 2 : first.channels());
+
+    cout << "[Replay] " << images.size() << " JPEG images, " << first.cols << "x" << first.rows << endl;
+    next_image = 0;
+    return 0;
+#endif
+}
+
+/**
+ * Decodes the next image into a frame (grey -> Mono8 or Mono16, colour -> BGR8).
+ * @param header: Receives the frame header.
+ * @param data: Receives the pixel data.
+ * @return 0 if a frame was read, -1 at the end or if the image cannot be decoded.
+ */
+int JPEG_FOLDER_SOURCE::read_frame(FRAME_HEADER& header, vector<uint8_t>& data)
+{
+#ifndef WITH_OPENCV
+    (void)header;
+    (void)data;
+    return -1;
+#else
+    if (next_image >= images.size())
+    {
+        return -1;
+    }
+
+    const IMAGE_FILE& image = images[next_image];
+    cv::Mat decoded = cv::imread(image.path, cv::IMREAD_UNCHANGED);
+    if (decoded.empty() || decoded.depth() != CV_8U || (decoded.channels() != 1 && decoded.channels() != 3))
+    {
+        cerr << "[Replay] Unable to decode " << image.path << endl;
+        return -1;
+    }
+
+    uint32_t width = static_cast<uint32_t>(decoded.cols);
+    uint32_t height = static_cast<uint32_t>(decoded.rows);
+    bool grey = decoded.channels() == 1;
+    uint32_t pixel_format = grey ? (mono16 ? FRAME_PIXEL_FORMAT_MONO16 : FRAME_PIXEL_FORMAT_MONO8) : FRAME_PIXEL_FORMAT_BGR8;
+    uint32_t row_bytes = width * frame_bytes_per_pixel(pixel_format);
+
+    init_frame_header(header, width, height, row_bytes, pixel_format, static_cast<uint64_t>(row_bytes) * height);
+    set_frame_serial(header, image.serial);
+    header.offset_x = image.offset_x;
+    header.frame_id = next_image;
+    header.timestamp_ns = image.modified_ns;
+    data.resize(header.data_size);
+
+    for (uint32_t row = 0; row < height; row++)
+    {
+        const uint8_t* source = decoded.ptr<uint8_t>(static_cast<int>(row));
+        uint8_t* destination = data.data() + static_cast<size_t>(row) * row_bytes;
+        if (pixel_format == FRAME_PIXEL_FORMAT_MONO16)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                destination[2 * x] = 0;
+                destination[2 * x + 1] = source[x];   // JPEGs of Mono16 frames keep the high byte
+            }
+        }
+        else
+        {
+            memcpy(destination, source, row_bytes);
+        }
+    }
+
+    next_image++;
+    return 0;
+#endif
+}
+
+/**
+ * Starts again from the first image.
+ * @return 0
+ */
+int JPEG_FOLDER_SOURCE::rewind()
+{
+    next_image = 0;
+    return 0;
+}
+
+/**
+ * Returns the frame size of the first image.
+ */
+size_t JPEG_FOLDER_SOURCE::get_max_frame_bytes() const
+{
+    return max_frame_bytes;
+}
+
+/**
+ * Returns the source name for logging.
+ */
+const char* JPEG_FOLDER_SOURCE::get_source_name() const
+{
+    return "JPEG folder";
+}
@@ -0,0 +1,46 @@
+// jpeg_folder_source.cpp Header File
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#ifndef JPEG_FOLDER_SOURCE_H
+#define JPEG_FOLDER_SOURCE_H
+
+#include "frame_replay.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Replays a folder of JPEG images saved by the capture tools (decoded with OpenCV, needs WITH_OPENCV).
+// Images are ordered by modification time, which is also used as the timestamp for real time replay. Serial and
+// OffsetX are taken from disk ring names (Serial_<serial>_OffsetX_<x>_Image_<slot>.jpg) when present.
+class JPEG_FOLDER_SOURCE : public FRAME_SOURCE
+{
+    private:
+        struct IMAGE_FILE
+        {
+            string path;
+            uint64_t modified_ns;
+            string serial;
+            int64_t offset_x;
+        };
+
+        vector<IMAGE_FILE> images;
+        size_t next_image;
+        size_t max_frame_bytes;
+        bool mono16;        // Widen 8 bit grey images to Mono16 (what MonoDualCameraAcquisition produces)
+
+    public:
+        JPEG_FOLDER_SOURCE();
+
+        int open_folder(const string& folder_path, bool widen_to_mono16);
+
+        int read_frame(FRAME_HEADER& header, vector<uint8_t>& data);
+        int rewind();
+        size_t get_max_frame_bytes() const;
+        const char* get_source_name() const;
+};
+
+#endif // JPEG_FOLDER_SOURCE_H
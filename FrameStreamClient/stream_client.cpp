@@ -0,0 +1,117 @@
+// Description: Connects to a capture tool's frame stream, prints rate and drop statistics and optionally saves the frames
+// Author: Gregor Kokk
+// Date: 18.10.2026
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+
+#include "command_line.h"
+#include "frame_format.h"
+#include "frame_stream.h"
+
+using namespace std;
+
+/**
+ * Saves a frame in the raw format used by the frame writers (FRAME_HEADER followed by the pixels).
+ * @param folder_path: The output folder.
+ * @param header: The frame header.
+ * @param data: The pixel data.
+ * @return 0 if successful, -1 otherwise.
+ */
+static int save_frame(const string& folder_path, const FRAME_HEADER& header, const vector<uint8_t>& data)
+{
+    ostringstream path;
+    path << folder_path << "/stream_" << string(header.serial, strnlen(header.serial, sizeof(header.serial)))
+         << "_X" << header.offset_x << "_" << setw(8) << setfill('0') << header.frame_id << ".raw";
+
+    ofstream file(path.str(), ios::binary);
+    if (!file)
+    {
+        cerr << "Unable to create " << path.str() << endl;
+        return -1;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+    return file ? 0 : -1;
+}
+
+int main(int argc, char** argv)
+{
+    COMMAND_LINE command_line(argc, argv);
+
+    string address = command_line.get_string("address", "5600");
+    string policy_name = command_line.get_string("policy", "latest");
+    unsigned int queue_depth = static_cast<unsigned int>(command_line.get_int("queue", 0));
+    unsigned long long max_frames = static_cast<unsigned long long>(command_line.get_int("frames", 0));
+    string save_path = command_line.get_string("save", "");
+
+    STREAM_DROP_POLICY policy;
+    if (!parse_stream_drop_policy(policy_name, policy))
+    {
+        cerr << "Unknown policy: " << policy_name << ". Use oldest, newest, latest or disconnect." << endl;
+        return 1;
+    }
+
+    FRAME_STREAM_CLIENT client;
+    if (client.connect_to(address, policy, queue_depth) != 0)
+    {
+        cerr << "Unable to connect to " << address << endl;
+        return 1;
+    }
+
+    cout << "Connected to " << address << " (policy " << policy_name << ")" << endl;
+
+    STREAM_MESSAGE_HEADER message;
+    FRAME_HEADER header;
+    vector<uint8_t> data;
+
+    unsigned long long total_frames = 0;
+    unsigned long long total_dropped = 0;
+    unsigned long long interval_frames = 0;
+    unsigned long long interval_dropped = 0;
+    unsigned long long interval_bytes = 0;
+    auto interval_start = chrono::steady_clock::now();
+
+    while (client.receive(message, header, data) == 0)
+    {
+        total_frames++;
+        total_dropped += message.dropped;
+        interval_frames++;
+        interval_dropped += message.dropped;
+        interval_bytes += sizeof(message) + sizeof(header) + data.size();
+
+        if (!save_path.empty())
+        {
+            save_frame(save_path, header, data);
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - interval_start).count();
+        if (seconds >= 1.0)
+        {
+            cout << fixed << setprecision(1) << interval_frames / seconds << " fps, "
+                 << interval_bytes / seconds / (1024.0 * 1024.0) << " MB/s, " << interval_dropped << " dropped, last frame "
+                 << header.frame_id << " (" << header.width << "x" << header.height << ", serial "
+                 << string(header.serial, strnlen(header.serial, sizeof(header.serial))) << ", offset_x " << header.offset_x << ")" << endl;
+
+            interval_frames = 0;
+            interval_dropped = 0;
+            interval_bytes = 0;
+            interval_start = chrono::steady_clock::now();
+        }
+
+        if (max_frames > 0 && total_frames >= max_frames)
+        {
+            break;
+        }
+    }
+
+    cout << "Received " << total_frames << " frames, " << total_dropped << " dropped by the server" << endl;
+    return 0;
+}
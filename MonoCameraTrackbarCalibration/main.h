@@ -11,35 +11,20 @@
 #include <iostream>
 #include <sstream>
 
+#include "camera_control.h"
+
 using namespace Spinnaker;
 using namespace Spinnaker::GenApi;
 using namespace Spinnaker::GenICam;
 
-class CAMERA_CONFIG
+// Node configuration and keyboard input come from CAMERA_CONTROL, only the trackbar window is specific to this tool
+class CAMERA_CONFIG : public CAMERA_CONTROL<MONO_CAMERA>
 {
     private:
-        static int reset_exposure(INodeMap& node_map); // Reset Exposure Time
-        static int acquire_and_display_images(CameraPtr pointer_cam, INodeMap& node_map, INodeMap& node_map_tl_device); // Acquire And Save Images From The Camera
-
-    public:	
-        int config_exposure(INodeMap& node_map, double current_exposure_value); // Custom Exposure Time
-        int config_gain(INodeMap& node_map, double current_gain_value); // Custom Gain
-        int config_gamma(INodeMap& node_map, double current_gamma_value); // Custom Gamma
+        static int acquire_and_display_images(CameraPtr pointer_cam, INodeMap& node_map); // Acquire And Save Images From The Camera
 
-        int config_pixel_format(INodeMap& node_map); // Custom Pixel Format
-        int config_roi(INodeMap& node_map, int64_t width_value, int64_t height_value, int64_t x_offset_value, int64_t y_offset_value); // Custom Region Of Interest
+    public:
         int run_single_camera(CameraPtr pointer_cam);   // Main Function For Camera Configuration
-        int config_sensor_shutter_mode(INodeMap& node_map); // Custom Sensor Shutter Mode
-        int config_black_level_clamping_enable(INodeMap& node_map); // Black Level Clamping -> !!! Testing
-        int keyboard_input(); // Keyboard Input
-        
-        void set_non_blocking_input(bool enable); // Set Non-Blocking Input
-        void setup_trackbar_and_window(CameraPtr pointer_cam); // Setup Trackbar And Window For Displaying Images
 };
 
-// Comment explaining why config_exposure is static
-// config_exposure does not rely on any instance-specific data 
-// so I made it static so that we do not need an object to call it.
-
-
 #endif // MAIN_H
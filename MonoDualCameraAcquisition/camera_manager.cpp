@@ -20,12 +20,70 @@
 
 #include "camera_manager.h"
 #include "camera_settings.h"
+#include "frame_writer.h"
+#include "async_logger.h"
+#include "spinnaker_frame.h"
+#include "spinnaker_profile.h"
+#include "spinnaker_snapshot.h"
+#include "spinnaker_user_set.h"
+#include "trace_recorder.h"
 
 using namespace Spinnaker;
 using namespace Spinnaker::GenApi;
 using namespace Spinnaker::GenICam;
 using namespace std;
 
+// What this tool configures besides the settings file, part of the settings hash of the UserSets and the snapshots
+static const string tool_settings = "dual acquisition, Global shutter, black level clamping";
+
+/**
+ * Constructor for the DEVICE_LINK_EVENTS class.
+ * @param camera_recovery: The state machine the events go to.
+ */
+DEVICE_LINK_EVENTS::DEVICE_LINK_EVENTS(CAMERA_RECOVERY& camera_recovery) : recovery(camera_recovery)
+{
+}
+
+/**
+ * Reads the serial number of the device of an event (the TL device node map stays readable after a removal).
+ * @param camera: The device.
+ * @return The serial number, empty if it cannot be read.
+ */
+string DEVICE_LINK_EVENTS::get_serial(CameraPtr camera)
+{
+    try
+    {
+        CStringPtr serial_ptr = camera->GetTLDeviceNodeMap().GetNode("DeviceSerialNumber");
+        return IsReadable(serial_ptr) ? string(serial_ptr->GetValue().c_str()) : "";
+    }
+    catch (const Spinnaker::Exception&)
+    {
+        return "";
+    }
+}
+
+/**
+ * Device arrival event: a camera that dropped off is re-opened by the acquisition loop.
+ * @param camera: The arrived device.
+ */
+void DEVICE_LINK_EVENTS::OnDeviceArrival(CameraPtr camera)
+{
+    string serial = get_serial(camera);
+    log_info(log_tag("Recovery"), "Device {} arrived", serial);
+    recovery.on_device_arrival(serial);
+}
+
+/**
+ * Device removal event: the acquisition loop stops grabbing from the camera until it is back.
+ * @param camera: The removed device.
+ */
+void DEVICE_LINK_EVENTS::OnDeviceRemoval(CameraPtr camera)
+{
+    string serial = get_serial(camera);
+    log_warning(log_tag("Recovery"), "Device {} removed", serial);
+    recovery.on_device_removal(serial);
+}
+
 /**
  * Constructor for the CAMERA_MANAGER class.
  * @param settings: The camera settings object to use for configuration.
@@ -47,6 +105,466 @@ CAMERA_MANAGER::CAMERA_MANAGER(const CAMERA_SETTINGS* settings)
  */
 CAMERA_MANAGER::~CAMERA_MANAGER() {}
 
+/**
+ * Sets the asynchronous frame writer used by capture_image.
+ * @param writer: The writer to use (not owned), or nullptr to save JPEGs with Image::Save.
+ */
+void CAMERA_MANAGER::set_frame_writer(FRAME_WRITER* writer)
+{
+    pipeline.set_frame_writer(writer);
+}
+
+/**
+ * Sets the on-disk ring options used by capture_image.
+ * @param slots: Number of files kept per camera/ROI.
+ * @param sync: fsync each frame and the directory before publishing it.
+ */
+void CAMERA_MANAGER::set_ring_options(unsigned int slots, bool sync)
+{
+    pipeline.set_ring_options(slots, sync);
+}
+
+/**
+ * Sets the metrics endpoint: counts every frame as a frame sink, gets the incomplete images and the camera sensors from the loop.
+ * @param server: The server to report to (not owned).
+ */
+void CAMERA_MANAGER::set_metrics_server(METRICS_SERVER* server)
+{
+    metrics_server = server;
+    metrics_server->set_frame_pipeline(&pipeline);
+    pipeline.add_frame_sink(server);
+}
+
+/**
+ * Adds a consumer that receives every captured frame (after the Mono16 conversion).
+ * @param sink: The sink to add (not owned). Flushed when acquisition stops.
+ */
+void CAMERA_MANAGER::add_frame_sink(FRAME_SINK* sink)
+{
+    pipeline.add_frame_sink(sink);
+}
+
+/**
+ * Enables or disables the per-frame files written by capture_image.
+ * @param enable: false -> frames only go to the frame sinks.
+ */
+void CAMERA_MANAGER::set_save_images(bool enable)
+{
+    pipeline.set_save_images(enable);
+}
+
+/**
+ * Sets the watch of the settings file checked by acquire_images between the ROI captures.
+ * @param watcher: The watcher (not owned), or nullptr to only read the settings at startup.
+ */
+void CAMERA_MANAGER::set_settings_watcher(SETTINGS_WATCHER* watcher)
+{
+    settings_watcher = watcher;
+}
+
+/**
+ * Sets the UserSet used for a fast startup.
+ * @param name: The UserSet, e.g. "UserSet1" (empty -> every setting is written at startup).
+ * @param cache: What was saved into the UserSet of each camera (not owned).
+ */
+void CAMERA_MANAGER::set_user_set(const string& name, USER_SET_CACHE* cache)
+{
+    user_set = name;
+    user_set_cache = cache;
+}
+
+/**
+ * Sets the directory of the node snapshots. A snapshot is taken of every camera after its configuration and restored
+ * in one pass at the next startup or reconnect, as long as the settings are the same.
+ * @param directory: The snapshot directory, <serial>.snapshot per camera (empty -> no snapshots).
+ */
+void CAMERA_MANAGER::set_snapshot_dir(const string& directory)
+{
+    snapshot_dir = directory;
+}
+
+/**
+ * Marks this run as a reconnect, so the time from the failure to the first frame is logged.
+ * @param failure_time: When the previous run failed.
+ */
+void CAMERA_MANAGER::set_reconnect_start(chrono::steady_clock::time_point failure_time)
+{
+    reconnect_start = failure_time;
+    is_reconnect = true;
+}
+
+/**
+ * Sets the System the cameras come from. With it, a camera that drops off during the acquisition is re-opened on its
+ * own (device events, snapshot restore) while the others keep streaming.
+ * @param system_ptr: The System.
+ */
+void CAMERA_MANAGER::set_system(SystemPtr system_ptr)
+{
+    system = system_ptr;
+}
+
+/**
+ * Returns the size of the largest frame the ROI configuration and the settings file produce (Mono16 -> 2 bytes per pixel).
+ * @return The frame size in bytes.
+ */
+size_t CAMERA_MANAGER::get_max_frame_bytes() const
+{
+    size_t max_bytes = static_cast<size_t>(camera_settings->get_config_file().get_max_roi_pixels() * 2);
+    for (const auto& roi : roi_config_values)
+    {
+        max_bytes = std::max(max_bytes, static_cast<size_t>(roi.width * roi.height * 2));
+    }
+    return max_bytes;
+}
+
+/**
+ * Returns how many camera/ROI streams the frame sinks can see: each camera alternates between its ROIs.
+ * @param camera_count: Number of cameras.
+ * @return camera_count times the most ROIs of the ROI configuration and the settings file.
+ */
+unsigned int CAMERA_MANAGER::get_max_stream_count(unsigned int camera_count) const
+{
+    size_t roi_count = std::max<size_t>(roi_config_values.size(), camera_settings->get_config_file().get_max_roi_count());
+    return camera_count * static_cast<unsigned int>(std::max<size_t>(roi_count, 1));
+}
+
+/**
+ * Resolves the settings of every camera by its serial number.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @param node_maps_tl_device: The transport layer node maps for the cameras.
+ */
+void CAMERA_MANAGER::load_camera_profiles(const vector<INodeMap*>& node_maps, const vector<INodeMap*>& node_maps_tl_device)
+{
+    cout << endl << endl << "*** LOADING CAMERA SETTINGS ***" << endl << endl;
+
+    camera_profiles.clear();
+    for (unsigned int i = 0; i < node_maps.size(); i++)
+    {
+        CAMERA_PROFILE profile = camera_settings->get_profile(get_camera_serial_number(node_maps_tl_device[i], i));
+
+        // What the file does not give keeps the values this tool always used
+        if (!profile.has(PROFILE_PIXEL_FORMAT))
+        {
+            profile.pixel_format = "Mono16";
+        }
+        if (!profile.has(PROFILE_ROIS))
+        {
+            profile.rois = roi_config_values;
+        }
+
+        cout << "[Camera " << i << "] Serial " << profile.serial << ": " << describe_camera_profile(profile) << endl;
+        camera_profiles.push_back(profile);
+    }
+
+    settings_hashes.clear();
+    for (const CAMERA_PROFILE& profile : camera_profiles)
+    {
+        settings_hashes.push_back(hash_camera_profile(profile, tool_settings));
+    }
+}
+
+/**
+ * Checks the settings of every camera against its limits, so a value the camera cannot take stops the tool before any node is written.
+ * @param cameras: The initialized cameras.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @return 0 if every camera accepts its settings, -1 otherwise.
+ */
+int CAMERA_MANAGER::validate_camera_profiles(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** VALIDATING CAMERA SETTINGS ***" << endl << endl;
+
+    for (unsigned int i = 0; i < node_maps.size() && i < camera_profiles.size(); i++)
+    {
+        try
+        {
+            if (validate_camera_profile(*node_maps[i], cameras[i]->GetTLStreamNodeMap(), camera_profiles[i]) != 0)
+            {
+                result = -1;
+            }
+        }
+        catch (const Spinnaker::Exception& e)
+        {
+            cerr << "[Camera " << i << "] Error validating settings: " << e.what() << endl;
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Loads the UserSet of every camera if each one boots into it and it holds the current settings (same hash as when it
+ * was saved, and the loaded values are spot-checked). All or nothing: the configuration steps below always run for both cameras together.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @return true if every camera was loaded from its UserSet, false if they have to be configured.
+ */
+bool CAMERA_MANAGER::load_user_sets(const vector<INodeMap*>& node_maps)
+{
+    bool from_user_set = !user_set.empty() && user_set_cache;
+
+    for (unsigned int i = 0; i < node_maps.size() && i < settings_hashes.size(); i++)
+    {
+        from_user_set = from_user_set && user_set_cache->matches(camera_profiles[i].serial, user_set, settings_hashes[i]) &&
+                        is_user_set_default(*node_maps[i], user_set);
+    }
+
+    for (unsigned int i = 0; from_user_set && i < node_maps.size(); i++)
+    {
+        from_user_set = load_user_set(*node_maps[i], user_set) == 0 && check_loaded_profile(*node_maps[i], camera_profiles[i]) == 0;
+    }
+
+    return from_user_set;
+}
+
+/**
+ * Saves the configuration of every camera into its UserSet and makes it the power up default, for the next startups.
+ * @param node_maps: The GenICam node maps for the cameras.
+ */
+void CAMERA_MANAGER::save_user_sets(const vector<INodeMap*>& node_maps)
+{
+    for (unsigned int i = 0; i < node_maps.size() && i < settings_hashes.size(); i++)
+    {
+        cout << "[Camera " << i << "] ";
+        if (save_user_set(*node_maps[i], user_set) == 0 && user_set_cache)
+        {
+            user_set_cache->store(camera_profiles[i].serial, user_set, settings_hashes[i]);
+        }
+    }
+}
+
+/**
+ * Restores the node snapshot of every camera if each one has a snapshot taken with the current settings. All or nothing
+ * like load_user_sets(); a camera that still has its values (reconnect without a power cycle) gets no writes at all.
+ * @param cameras: The initialized cameras.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @return true if every camera was restored, false if they have to be configured.
+ */
+bool CAMERA_MANAGER::restore_node_snapshots(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps)
+{
+    if (snapshot_dir.empty())
+    {
+        return false;
+    }
+
+    vector<NODE_SNAPSHOT> snapshots(node_maps.size());
+    for (unsigned int i = 0; i < node_maps.size() && i < settings_hashes.size(); i++)
+    {
+        if (snapshots[i].load(get_node_snapshot_path(snapshot_dir, camera_profiles[i].serial)) != 0 ||
+            snapshots[i].serial != camera_profiles[i].serial || snapshots[i].settings_hash != settings_hashes[i])
+        {
+            return false;   // Missing, or taken with other settings
+        }
+    }
+
+    for (unsigned int i = 0; i < node_maps.size() && i < snapshots.size(); i++)
+    {
+        unsigned int written = 0;
+        auto restore_start_time = chrono::steady_clock::now();
+        try
+        {
+            if (restore_node_snapshot(*node_maps[i], cameras[i]->GetTLStreamNodeMap(), snapshots[i], written) != 0)
+            {
+                cerr << "[Camera " << i << "] Snapshot could not be restored, configuring every setting\n";
+                return false;
+            }
+        }
+        catch (const Spinnaker::Exception& e)
+        {
+            cerr << "[Camera " << i << "] Error restoring the snapshot: " << e.what() << endl;
+            return false;
+        }
+        cout << "[Camera " << i << "] Snapshot restored: " << written << " of " << snapshots[i].values.size() << " nodes written in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - restore_start_time).count() << " ms\n";
+    }
+
+    camera_snapshots = snapshots;   // Also what a camera re-opened during the acquisition gets
+    return true;
+}
+
+/**
+ * Takes a snapshot of every configured camera, kept for re-opening a camera during the acquisition and written to the
+ * snapshot directory if one is set.
+ * @param cameras: The initialized cameras.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @param save: Whether to write the snapshots (false -> the configuration had errors, only kept in memory).
+ */
+void CAMERA_MANAGER::take_node_snapshots(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps, bool save)
+{
+    camera_snapshots.resize(node_maps.size());
+    for (unsigned int i = 0; i < node_maps.size() && i < settings_hashes.size(); i++)
+    {
+        NODE_SNAPSHOT snapshot;
+        if (take_node_snapshot(*node_maps[i], cameras[i]->GetTLStreamNodeMap(), camera_profiles[i].serial, settings_hashes[i], snapshot) != 0)
+        {
+            continue;   // Keeps the last one, e.g. the camera is out during a reload of the settings file
+        }
+        camera_snapshots[i] = snapshot;
+        if (save && !snapshot_dir.empty())
+        {
+            snapshot.save(get_node_snapshot_path(snapshot_dir, camera_profiles[i].serial));
+        }
+    }
+}
+
+/**
+ * Re-opens one camera during the acquisition: finds it again by its serial number, initializes it and restores its
+ * snapshot in one pass. The other cameras are not touched.
+ * @param camera_index: The camera.
+ * @param cameras: The initialized cameras, the entry of this camera is replaced.
+ * @param node_maps: The GenICam node maps, the entry of this camera is replaced.
+ * @param node_maps_tl_device: The transport layer node maps, the entry of this camera is replaced.
+ * @return 0 if the camera is configured again, -1 if it is not there (yet) or could not be configured.
+ */
+int CAMERA_MANAGER::reopen_camera(unsigned int camera_index, vector<CameraPtr>& cameras, vector<INodeMap*>& node_maps, vector<INodeMap*>& node_maps_tl_device)
+{
+    TRACE_SCOPE trace_scope("reopen_camera", "camera", camera_index);
+
+    if (!system || camera_index >= camera_snapshots.size() || camera_snapshots[camera_index].values.empty())
+    {
+        return -1;
+    }
+    const string& serial = camera_profiles[camera_index].serial;
+
+    try
+    {
+        // Let go of the old handle, the device behind it is gone or stopped answering
+        if (cameras[camera_index])
+        {
+            try
+            {
+                if (cameras[camera_index]->IsStreaming())
+                {
+                    cameras[camera_index]->EndAcquisition();
+                }
+                if (cameras[camera_index]->IsInitialized())
+                {
+                    cameras[camera_index]->DeInit();
+                }
+            }
+            catch (const Spinnaker::Exception&)
+            {
+            }
+        }
+
+        system->UpdateCameras();
+        CameraList camera_list = system->GetCameras();
+        CameraPtr camera = camera_list.GetBySerial(serial);
+        camera_list.Clear();
+        if (!camera)
+        {
+            return -1;
+        }
+
+        camera->Init();
+        INodeMap* node_map = &camera->GetNodeMap();
+
+        unsigned int written = 0;
+        if (restore_node_snapshot(*node_map, camera->GetTLStreamNodeMap(), camera_snapshots[camera_index], written) != 0)
+        {
+            camera->DeInit();
+            return -1;
+        }
+
+        cameras[camera_index] = camera;
+        node_maps[camera_index] = node_map;
+        node_maps_tl_device[camera_index] = &camera->GetTLDeviceNodeMap();
+        log_info(log_tag("Camera", camera_index), "Re-opened, snapshot restored ({} of {} nodes written)", written, camera_snapshots[camera_index].values.size());
+    }
+    catch (const Spinnaker::Exception& e)
+    {
+        log_warning(log_tag("Camera", camera_index), "Re-open failed: {}", e.what());
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Configures the frame rate and the stream buffers of the cameras whose settings give them.
+ * @param cameras: The initialized cameras.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @return 0 if successful, -1 if an error occurred during configuration.
+ */
+int CAMERA_MANAGER::config_stream(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps)
+{
+    int result = 0;
+
+    cout << endl << endl << "*** CONFIGURING FRAME RATE AND STREAM BUFFERS ***" << endl << endl;
+
+    for (unsigned int i = 0; i < node_maps.size() && i < camera_profiles.size(); i++)
+    {
+        try
+        {
+            if (camera_profiles[i].has(PROFILE_FRAME_RATE))
+            {
+                result |= config_frame_rate(*node_maps[i], camera_profiles[i].frame_rate);
+            }
+            result |= config_stream_buffers(cameras[i]->GetTLStreamNodeMap(), camera_profiles[i]);
+        }
+        catch (const Spinnaker::Exception& e)
+        {
+            cerr << "[Camera " << i << "] Error configuring the stream: " << e.what() << endl;
+            result = -1;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Applies a new version of the settings file. Called between two ROI captures, when no camera is acquiring, so the
+ * pixel format, the ROIs and the stream buffers can change as well; only ROIs larger than the frame buffers sized at
+ * startup need a restart.
+ * @param cameras: The initialized cameras.
+ * @param node_maps: The GenICam node maps for the cameras.
+ * @param config_file: The new version of the settings file.
+ */
+void CAMERA_MANAGER::reload_camera_settings(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps, const CAMERA_CONFIG_FILE& config_file)
+{
+    settings_changes.resize(camera_profiles.size(), SETTINGS_CHANGE{false, "", 0});
+    bool snapshots_stale = false;
+
+    for (unsigned int i = 0; i < node_maps.size() && i < camera_profiles.size(); i++)
+    {
+        if (recovery.get_state(i) != CAMERA_LINK_STREAMING)
+        {
+            log_warning(log_tag("Reload", i), "Camera {} is out, it comes back with its previous settings", camera_profiles[i].serial);
+            continue;
+        }
+
+        CAMERA_PROFILE updated = config_file.get_profile(camera_profiles[i].serial);
+        uint32_t applicable_fields = ~0u;
+        for (const ROI_SETTINGS& roi : updated.rois)
+        {
+            if (static_cast<size_t>(roi.width * roi.height * 2) > get_max_frame_bytes())
+            {
+                applicable_fields &= ~static_cast<uint32_t>(PROFILE_ROIS);
+            }
+        }
+
+        try
+        {
+            if (reload_camera_profile(*node_maps[i], cameras[i]->GetTLStreamNodeMap(), updated, camera_profiles[i], applicable_fields, settings_changes[i]) != 0 &&
+                i < settings_hashes.size())
+            {
+                settings_hashes[i] = hash_camera_profile(camera_profiles[i], tool_settings);
+                snapshots_stale = true;
+            }
+        }
+        catch (const Spinnaker::Exception& e)
+        {
+            log_error(log_tag("Camera", i), "Error applying the settings file: {}", e.what());
+        }
+    }
+
+    if (snapshots_stale)
+    {
+        take_node_snapshots(cameras, node_maps, true);   // A reconnect restores the new settings
+    }
+}
+
 /**
  * Configures Black Level Clamping Enable for the cameras.
  * @param node_maps: The GenICam node maps for the cameras.
@@ -160,46 +678,42 @@ int CAMERA_MANAGER::config_gain(const std::vector<INodeMap*>& node_maps)
         {
             try
             {
-                // Turn off automatic gain
-                CEnumerationPtr ptr_gain_auto = node_maps[i]->GetNode("GainAuto");
-                if (!IsReadable(ptr_gain_auto) || !IsWritable(ptr_gain_auto))
+                // Without a gain in the settings file the current gain is kept, with automatic gain off
+                bool from_file = i < camera_profiles.size() && camera_profiles[i].has(PROFILE_GAIN);
+                CFloatPtr ptr_gain = node_maps[i]->GetNode("Gain");
+                double gain_value = from_file ? camera_profiles[i].gain : (IsReadable(ptr_gain) ? ptr_gain->GetValue() : 0.0);
+                double requested_value = gain_value;
+
+                int status = set_float_setting(*node_maps[i], "GainAuto", nullptr, "Gain", gain_value);
+                if (status < 0)
                 {
-                    cout << "Unable to disable automatic gain for Camera " << i << ". Skipping.\n";
+                    cout << "[Camera " << i << "] Unable to get or set gain. Skipping. \n";
                     continue; // Skip this camera
                 }
-
-                CEnumEntryPtr ptr_gain_auto_off = ptr_gain_auto->GetEntryByName("Off");
-                if (IsReadable(ptr_gain_auto_off))
+                if (status == 1)
+                {
+                    cout << "Unable to disable automatic gain for Camera " << i << ".\n";
+                }
+                else
                 {
-                    ptr_gain_auto->SetIntValue(ptr_gain_auto_off->GetValue());
                     cout << "[Camera " << i << "] Automatic gain disabled. \n";
                 }
 
-                // Get and set manual gain
-                CFloatPtr ptr_gain = node_maps[i]->GetNode("Gain");
-                if (!IsReadable(ptr_gain) || !IsWritable(ptr_gain))
+                if (!from_file)
                 {
-                    cout << "[Camera " << i << "] Unable to get or set gain. Skipping. \n";
-                    continue; // Skip this camera
+                    cout << "[Camera " << i << "] No gain in the settings file. Keeping " << gain_value << endl;
+                    continue;
                 }
 
-                // Retrieve and validate gain value
-                double gain_value = camera_settings->get_gain();
-
-                if (gain_value > ptr_gain->GetMax())
+                if (gain_value < requested_value)
                 {
-                    gain_value = ptr_gain->GetMax();
                     cout << "Gain value too high. Set to maximum value: " << gain_value << endl;
                 }
-                else if (gain_value < ptr_gain->GetMin())
+                else if (gain_value > requested_value)
                 {
-                    gain_value = ptr_gain->GetMin();
                     cout << "Gain value too low. Set to minimum value: " << gain_value << endl;
                 }
-
-                // Apply gain to the camera
-                ptr_gain->SetValue(gain_value);
-                cout << "[Camera " << i << "] Gain set to: " << ptr_gain->GetValue() << endl;
+                cout << "[Camera " << i << "] Gain set to: " << gain_value << endl;
             }
             catch (const std::exception& e)
             {
@@ -234,39 +748,42 @@ int CAMERA_MANAGER::config_gamma(const std::vector<INodeMap*>& node_maps)
         {
             try
             {
-                // Turn on gamma
-                CBooleanPtr ptr_gamma_enable = node_maps[i]->GetNode("GammaEnable");
-                if (!IsReadable(ptr_gamma_enable) || !IsWritable(ptr_gamma_enable))
+                // Without a gamma in the settings file the current gamma is kept, with gamma enabled
+                bool from_file = i < camera_profiles.size() && camera_profiles[i].has(PROFILE_GAMMA);
+                CFloatPtr ptr_gamma = node_maps[i]->GetNode("Gamma");
+                double gamma_value = from_file ? camera_profiles[i].gamma : (IsReadable(ptr_gamma) ? ptr_gamma->GetValue() : 0.0);
+                double requested_value = gamma_value;
+
+                int status = set_float_setting(*node_maps[i], nullptr, "GammaEnable", "Gamma", gamma_value);
+                if (status < 0)
                 {
-                    cout << "Unable to enable gamma for Camera " << i << ". Skipping.\n";
+                    cout << "[Camera " << i << "] Unable to get or set gamma. Skipping.\n";
                     continue;
                 }
-                ptr_gamma_enable->SetValue(true);
-                cout << "[Camera " << i << "] Gamma enabled. \n";
+                if (status == 1)
+                {
+                    cout << "Unable to enable gamma for Camera " << i << ".\n";
+                }
+                else
+                {
+                    cout << "[Camera " << i << "] Gamma enabled. \n";
+                }
 
-                // Set gamma manually
-                CFloatPtr ptr_gamma = node_maps[i]->GetNode("Gamma");
-                if (!IsReadable(ptr_gamma) || !IsWritable(ptr_gamma))
+                if (!from_file)
                 {
-                    cout << "[Camera " << i << "] Unable to get or set gamma. Skipping.\n";
+                    cout << "[Camera " << i << "] No gamma in the settings file. Keeping " << gamma_value << endl;
                     continue;
                 }
 
-                double gamma_value = camera_settings->get_gamma();  // Retrieve and validate gamma value
-
-                if (gamma_value > ptr_gamma->GetMax())
+                if (gamma_value < requested_value)
                 {
-                    gamma_value = ptr_gamma->GetMax();
                     cout << "Gamma value too high. Set to maximum value: " << gamma_value << endl;
                 }
-                else if (gamma_value < ptr_gamma->GetMin())
+                else if (gamma_value > requested_value)
                 {
-                    gamma_value = ptr_gamma->GetMin();
                     cout << "Gamma value too low. Set to minimum value: " << gamma_value << endl;
                 }
-
-                ptr_gamma->SetValue(gamma_value);   // Apply gamma to the camera
-                cout << "[Camera " << i << "] Gamma set to: " << ptr_gamma->GetValue() << endl;
+                cout << "[Camera " << i << "] Gamma set to: " << gamma_value << endl;
             }
             catch (const std::exception& e)
             {
@@ -301,47 +818,42 @@ int CAMERA_MANAGER::config_exposure(const std::vector<INodeMap*>& node_maps)
         {
             try
             {
-                // Turn off automatic exposure
-                CEnumerationPtr ptr_exposure_auto = node_maps[i]->GetNode("ExposureAuto");
-                if (IsReadable(ptr_exposure_auto) && IsWritable(ptr_exposure_auto))
+                // Without an exposure in the settings file the current exposure is kept, with automatic exposure off
+                bool from_file = i < camera_profiles.size() && camera_profiles[i].has(PROFILE_EXPOSURE);
+                CFloatPtr ptr_exposure_time = node_maps[i]->GetNode("ExposureTime");
+                double exposure_value = from_file ? camera_profiles[i].exposure : (IsReadable(ptr_exposure_time) ? ptr_exposure_time->GetValue() : 0.0);
+                double requested_value = exposure_value;
+
+                int status = set_float_setting(*node_maps[i], "ExposureAuto", nullptr, "ExposureTime", exposure_value);
+                if (status < 0)
                 {
-                    CEnumEntryPtr ptr_exposure_auto_off = ptr_exposure_auto->GetEntryByName("Off");
-                    if (IsReadable(ptr_exposure_auto_off))
-                    {
-                        ptr_exposure_auto->SetIntValue(ptr_exposure_auto_off->GetValue());
-                        cout << "[Camera " << i << "] Automatic exposure disabled for Camera " << i << endl;
-                    }
+                    cout << "Unable to get or set exposure time for Camera " << i << ". Skipping.\n";
+                    continue;
+                }
+                if (status == 1)
+                {
+                    cout << "Unable to disable automatic exposure for Camera " << i << ".\n";
                 }
                 else
                 {
-                    cout << "Unable to disable automatic exposure for Camera " << i << ". Skipping.\n";
-                    continue;
+                    cout << "[Camera " << i << "] Automatic exposure disabled for Camera " << i << endl;
                 }
 
-                // Set exposure time manually
-                CFloatPtr ptr_exposure_time = node_maps[i]->GetNode("ExposureTime");
-                if (!IsReadable(ptr_exposure_time) || !IsWritable(ptr_exposure_time))
+                if (!from_file)
                 {
-                    cout << "Unable to get or set exposure time for Camera " << i << ". Skipping.\n";
+                    cout << "[Camera " << i << "] No exposure in the settings file. Keeping " << exposure_value << " μs" << endl;
                     continue;
                 }
 
-                // Retrieve and validate exposure value
-                double exposure_value = camera_settings->get_exposure();
-
-                if (exposure_value > ptr_exposure_time->GetMax())
+                if (exposure_value < requested_value)
                 {
-                    exposure_value = ptr_exposure_time->GetMax();
                     cout << "Exposure value too high. Set to maximum value: " << exposure_value << endl;
                 }
-                else if (exposure_value < ptr_exposure_time->GetMin())
+                else if (exposure_value > requested_value)
                 {
-                    exposure_value = ptr_exposure_time->GetMin();
                     cout << "Exposure value too low. Set to minimum value: " << exposure_value << endl;
                 }
-
-                ptr_exposure_time->SetValue(exposure_value);    // Apply exposure to the camera
-                cout << "[Camera " << i << "] Exposure set to: " << ptr_exposure_time->GetValue() << " μs" << endl;
+                cout << "[Camera " << i << "] Exposure set to: " << exposure_value << " μs" << endl;
             }
             catch (const std::exception& e)
             {
@@ -436,7 +948,7 @@ int CAMERA_MANAGER::config_pixel_format(const std::vector<INodeMap*>& node_maps)
                     continue;
                 }
 
-                CEnumEntryPtr ptr_pixel_format_custom = ptr_pixel_format->GetEntryByName("Mono16");
+                CEnumEntryPtr ptr_pixel_format_custom = ptr_pixel_format->GetEntryByName(i < camera_profiles.size() ? camera_profiles[i].pixel_format.c_str() : "Mono16");
                 if (IsReadable(ptr_pixel_format_custom))
                 {
                     int64_t custom_pixel_format = ptr_pixel_format_custom->GetValue();
@@ -476,50 +988,49 @@ int CAMERA_MANAGER::config_pixel_format(const std::vector<INodeMap*>& node_maps)
  */
 int CAMERA_MANAGER::config_roi(INodeMap* node_map, int64_t offset_x, int64_t offset_y, int64_t width, int64_t height, unsigned int camera_index)
 {
+    TRACE_SCOPE trace_scope("config_roi", "camera", camera_index);
     int result = 0;
 
-    cout << "\n\n*** CONFIGURING ROI: HEIGHT, WIDTH, OFFSET-X & OFFSET-Y ***\n\n";
-
     try
     {
         // Configure Width
         CIntegerPtr width_pointer = node_map->GetNode("Width");
         if (IsReadable(width_pointer) && IsWritable(width_pointer))
         {
-            cout << "[Camera " << camera_index << "] Width range: " << width_pointer->GetMin() << " to " << width_pointer->GetMax() << endl;
+            log_debug(log_tag("Camera", camera_index), "Width range: {} to {}", width_pointer->GetMin(), width_pointer->GetMax());
             if (width >= width_pointer->GetMin() && width <= width_pointer->GetMax())
             {
                 width_pointer->SetValue(width);	// Apply width
-                cout << "[Camera " << camera_index << "] Width set to " << width_pointer->GetValue() << endl;
+                log_debug(log_tag("Camera", camera_index), "Width set to {}", width_pointer->GetValue());
             }
             else
             {
-                cerr << "[Camera " << camera_index << "] Width value out of range. Must be between " << width_pointer->GetMin() << " and " << width_pointer->GetMax() << endl;
+                log_error(log_tag("Camera", camera_index), "Width value out of range. Must be between {} and {}", width_pointer->GetMin(), width_pointer->GetMax());
             }
         }
         else
         {
-            cerr << "[Camera " << camera_index << "] Width not readable or writable. Skipping.\n";
+            log_warning(log_tag("Camera", camera_index), "Width not readable or writable. Skipping.");
         }
         
         // Configure OffsetX
         CIntegerPtr ptr_offsetX = node_map->GetNode("OffsetX");
         if (IsReadable(ptr_offsetX) && IsWritable(ptr_offsetX))
         {
-            cout << "[Camera " << camera_index << "] OffsetX range: " << ptr_offsetX->GetMin() << " to " << ptr_offsetX->GetMax() << endl;
+            log_debug(log_tag("Camera", camera_index), "OffsetX range: {} to {}", ptr_offsetX->GetMin(), ptr_offsetX->GetMax());
             if (offset_x <= ptr_offsetX->GetMax() && offset_x >= ptr_offsetX->GetMin())
             {
                 ptr_offsetX->SetValue(offset_x);    // Apply offset_x
-                cout << "[Camera " << camera_index << "] OffsetX set to " << ptr_offsetX->GetValue() << endl;
+                log_debug(log_tag("Camera", camera_index), "OffsetX set to {}", ptr_offsetX->GetValue());
             }
             else
             {
-                cerr << "[Camera " << camera_index << "] OffsetX value out of range. Must be between " << ptr_offsetX->GetMin() <<  " and " <<ptr_offsetX->GetMax() << endl;
+                log_error(log_tag("Camera", camera_index), "OffsetX value out of range. Must be between {} and {}", ptr_offsetX->GetMin(), ptr_offsetX->GetMax());
             }
         }
         else
         {
-            cerr << "[Camera " << camera_index << "] OffsetX not readable or writable. Skipping.\n";
+            log_warning(log_tag("Camera", camera_index), "OffsetX not readable or writable. Skipping.");
         }
 
         // Configure Height
@@ -529,17 +1040,17 @@ int CAMERA_MANAGER::config_roi(INodeMap* node_map, int64_t offset_x, int64_t off
             if (height >= height_pointer->GetMin() && height <= height_pointer->GetMax())
             {
                 height_pointer->SetValue(height); // Apply height
-                cout << "[Camera " << camera_index << "] Height set to " << height_pointer->GetValue() << endl;
+                log_debug(log_tag("Camera", camera_index), "Height set to {}", height_pointer->GetValue());
             }
             else
             {
-                cerr << "[Camera " << camera_index << "] Height value out of range. Must be between " << height_pointer->GetMin() << " and " << height_pointer->GetMax() << endl;
+                log_error(log_tag("Camera", camera_index), "Height value out of range. Must be between {} and {}", height_pointer->GetMin(), height_pointer->GetMax());
                 result = -1;
             }
         }
         else
         {
-            cerr << "[Camera " << camera_index << "] Height not readable or writable. Skipping.\n";
+            log_warning(log_tag("Camera", camera_index), "Height not readable or writable. Skipping.");
         }
 
         // Configure OffsetY
@@ -549,16 +1060,16 @@ int CAMERA_MANAGER::config_roi(INodeMap* node_map, int64_t offset_x, int64_t off
             if (offset_y <= ptr_offsetY->GetMax() && offset_y >= ptr_offsetY->GetMin())
             {
                 ptr_offsetY->SetValue(offset_y); // Apply offset_y
-                cout << "[Camera " << camera_index << "] OffsetY set to " << ptr_offsetY->GetValue() << endl;
+                log_debug(log_tag("Camera", camera_index), "OffsetY set to {}", ptr_offsetY->GetValue());
             }
             else
             {
-                cerr << "[Camera " << camera_index << "] OffsetY value out of range. Must be between " << ptr_offsetY->GetMin() << " and " << ptr_offsetY->GetMax() << endl;
+                log_error(log_tag("Camera", camera_index), "OffsetY value out of range. Must be between {} and {}", ptr_offsetY->GetMin(), ptr_offsetY->GetMax());
             }
         }
         else
         {
-            cerr << "[Camera " << camera_index << "] OffsetY not readable or writable. Skipping.\n";
+            log_warning(log_tag("Camera", camera_index), "OffsetY not readable or writable. Skipping.");
         }
 
         // Debugging: Log the applied settings
@@ -572,7 +1083,7 @@ int CAMERA_MANAGER::config_roi(INodeMap* node_map, int64_t offset_x, int64_t off
     }
     catch (const Spinnaker::Exception& e)
     {
-        cerr << "Error during ROI configuration: " << e.what() << endl;
+        log_error(log_tag("Camera", camera_index), "Error during ROI configuration: {}", e.what());
         result = -1;
     }
 
@@ -633,56 +1144,115 @@ int CAMERA_MANAGER::keyboard_input()
 }
 
 /**
- * Captures an image for a specific region based on OffsetX.
+ * Captures an image for a specific region based on OffsetX and stores it in the next slot of the disk ring.
  * @param camera: The camera to capture the image.
  * @param timeout: The timeout for image acquisition.
- * @param folder_path: The folder path to save the image.
- * @param image_prexif: The prefix for the image filename.
  * @param device_serial: The serial number of the camera for the filename.
- * @param image_count: The current image count for the filename.
  * @param camera_index: The index of the camera.
  * @param offset_x: The current offset_x value for the region.
+ * @return 0 if a frame arrived (also an incomplete one or one that could not be saved), -1 if the grab failed.
  */
-void CAMERA_MANAGER::capture_image(
+int CAMERA_MANAGER::capture_image(
     CameraPtr& camera,
     uint64_t timeout,
-    const string& folder_path,
     const string& device_serial,
-    unsigned int image_index,
     unsigned int camera_index,
     int64_t offset_x)
 {
-    cout << "\n\n*** CAPTURING IMAGE FOR CAMERA ***\n\n";
+    TRACE_SCOPE trace_scope("capture_image", "camera", camera_index);
+    bool grabbed = false;   // The camera answered, failures after this are not the camera's
 
     try
     {
+        trace_begin("GetNextImage");
         ImagePtr image_ptr = camera->GetNextImage(timeout);
+        trace_end("GetNextImage");
+        grabbed = true;
+
+        if (camera_index < settings_changes.size() && settings_change_took_effect(settings_changes[camera_index], image_ptr->GetTimeStamp()))
+        {
+            log_info(log_tag("Camera", camera_index), "{} took effect at frame {} (OffsetX {})", settings_changes[camera_index].description, image_ptr->GetFrameID(), offset_x);
+            settings_changes[camera_index].pending = false;
+        }
+
         if (image_ptr->IsIncomplete())
         {
-            cerr << "[Camera " << camera_index << "] Incomplete image captured\n";
+            trace_instant("incomplete_image", "camera", camera_index);
+            log_warning(log_tag("Camera", camera_index), "Incomplete image captured (status {})", static_cast<int>(image_ptr->GetImageStatus()));
+            if (metrics_server)
+            {
+                CAMERA_METRICS* camera_metrics = metrics_server->get_camera(device_serial);
+                if (camera_metrics)
+                {
+                    camera_metrics->record_incomplete();
+                }
+            }
             image_ptr->Release();
-            return;
+            return 0;
         }
 
         // Convert the image to Mono16 format
+        trace_begin("Convert");
         ImageProcessor processor;
         ImagePtr converted_image = processor.Convert(image_ptr, PixelFormat_Mono16);
+        trace_end("Convert");
 
-        // Build the filename: <prefix>_Serial_<serial>_OffsetX_<offset_x>_Image_<circular_index>.jpg
-        unsigned int circular_index = image_index % 3; // Limit to 5 images per offset
-        string full_filename = folder_path + "Serial_" + device_serial +
-                               "_OffsetX_" + to_string(offset_x) + "_Image_" + to_string(circular_index) + ".jpg";
+        FRAME_HEADER header;
+        fill_frame_header(header, converted_image, device_serial, offset_x, 0);
+
+        // Sinks, then the raw file into the ring: <folder_path>Serial_<serial>_OffsetX_<offset_x>_Image_<slot>.<jpg|raw>
+        FRAME_PIPELINE_RESULT frame_result;
+        trace_begin("process_frame", "frame_id", static_cast<int64_t>(header.frame_id));
+        pipeline.process_frame(header, converted_image->GetData(), frame_result, camera_index < camera_profiles.size() ? camera_profiles[camera_index].outputs : FRAME_OUTPUT_ALL);
+        trace_end("process_frame");
+        if (frame_result.sinks_rejected > 0)
+        {
+            log_warning(log_tag("Camera", camera_index), "{} sink(s) rejected frame {}", frame_result.sinks_rejected, header.frame_id);
+        }
+
+        if (!pipeline.is_saving_images())
+        {
+            log_info(log_tag("Camera", camera_index), "Frame {} passed to {} sink(s)", header.frame_id, pipeline.get_sink_count());
+        }
+        else if (frame_result.queued)
+        {
+            log_info(log_tag("Camera", camera_index), "Image queued for: {}", frame_result.entry.final_path);
+        }
+        else if (!frame_result.needs_image_save)
+        {
+            log_error(log_tag("Camera", camera_index), "Unable to queue image: {}", frame_result.entry.final_path);
+        }
+        else
+        {
+            // Save to the temp path, then rename over the slot so readers never see a partial JPEG
+            DISK_RING& disk_ring = pipeline.get_disk_ring();
+            const DISK_RING_ENTRY& entry = frame_result.entry;
+
+            try
+            {
+                TRACE_SCOPE save_scope("Save");
+                converted_image->Save(entry.temp_path.c_str());
+            }
+            catch (const Spinnaker::Exception&)
+            {
+                disk_ring.complete(entry.temp_path, false);
+                throw;
+            }
 
-        // Save the image
-        converted_image->Save(full_filename.c_str());
-        cout << "[Camera " << camera_index << "] Image saved at: " << full_filename << endl;
+            if (disk_ring.complete(entry.temp_path, true) == 0)
+            {
+                log_info(log_tag("Camera", camera_index), "Image saved at: {} (slot {})", entry.final_path, entry.slot);
+            }
+        }
 
         image_ptr->Release();
     }
     catch (const Spinnaker::Exception& e)
     {
-        cerr << "[Camera " << camera_index << "] Error capturing image: " << e.what() << endl;
+        log_error(log_tag("Camera", camera_index), "Error capturing image: {}", e.what());
     }
+
+    return grabbed ? 0 : -1;
 }
 
 /**
@@ -691,8 +1261,6 @@ void CAMERA_MANAGER::capture_image(
  */
 void CAMERA_MANAGER::stop_camera_acquisition(vector<CameraPtr>& cameras)
 {
-    cout << "\n\n*** ENDING ACQUISITION ***\n\n";
-
     size_t stopped_count = 0;
 
     for (size_t i = 0; i < cameras.size(); ++i)
@@ -700,13 +1268,13 @@ void CAMERA_MANAGER::stop_camera_acquisition(vector<CameraPtr>& cameras)
         CameraPtr& camera = cameras[i];
         if (!camera)
         {
-            cout << "[Camera " << i << "] Camera pointer is null. Skipping.\n";
+            log_warning(log_tag("Camera", static_cast<int>(i)), "Camera pointer is null. Skipping.");
             continue;
         }
 
         if (!camera->IsInitialized())
         {
-            cout << "[Camera " << i << "] Camera is not initialized. Skipping.\n";
+            log_warning(log_tag("Camera", static_cast<int>(i)), "Camera is not initialized. Skipping.");
             continue;
         }
 
@@ -714,22 +1282,23 @@ void CAMERA_MANAGER::stop_camera_acquisition(vector<CameraPtr>& cameras)
         {
             if (camera->IsStreaming()) // Ensure the camera is streaming
             {
+                TRACE_SCOPE trace_scope("EndAcquisition", "camera", static_cast<int64_t>(i));
                 camera->EndAcquisition();
-                cout << "[Camera " << i << "] Acquisition stopped successfully.\n";
+                log_debug(log_tag("Camera", static_cast<int>(i)), "Acquisition stopped successfully.");
                 ++stopped_count;
             }
             else
             {
-                cout << "[Camera " << i << "] Camera is not streaming. Skipping.\n";
+                log_debug(log_tag("Camera", static_cast<int>(i)), "Camera is not streaming. Skipping.");
             }
         }
         catch (const Spinnaker::Exception& e)
         {
-            cerr << "[Camera " << i << "] Error stopping acquisition: " << e.what() << endl;
+            log_error(log_tag("Camera", static_cast<int>(i)), "Error stopping acquisition: {}", e.what());
         }
     }
 
-    cout << "\n*** STOPPING ACQUISITION COMPLETE: " << stopped_count << " out of " << cameras.size() << " cameras stopped successfully. ***\n";
+    log_debug(log_tag("Acquisition"), "{} out of {} cameras stopped", stopped_count, cameras.size());
 }
 
 /**
@@ -748,6 +1317,12 @@ bool CAMERA_MANAGER::handle_keyboard_interrupt()
         return true;  // Signal to stop the acquisition
     }
 
+    if (key == 't' || key == 'T')
+    {
+        // Event for the frame sinks (e.g. the pre-trigger ring saves the frames around it)
+        pipeline.on_event("keypress");
+    }
+
     return false;  // Continue the acquisition loop
 }
 
@@ -759,6 +1334,7 @@ bool CAMERA_MANAGER::handle_keyboard_interrupt()
  */
 int CAMERA_MANAGER::set_acquisition_mode(INodeMap* node_map, unsigned int camera_index)
 {
+    TRACE_SCOPE trace_scope("set_acquisition_mode", "camera", camera_index);
     int result = 0;
 
     try
@@ -767,7 +1343,7 @@ int CAMERA_MANAGER::set_acquisition_mode(INodeMap* node_map, unsigned int camera
         CEnumerationPtr ptr_acquisition_mode = node_map->GetNode("AcquisitionMode");
         if (!IsReadable(ptr_acquisition_mode) || !IsWritable(ptr_acquisition_mode))
         {
-            cerr << "[Camera " << camera_index << "] Unable to access or set AcquisitionMode. Skipping.\n";
+            log_error(log_tag("Camera", camera_index), "Unable to access or set AcquisitionMode. Skipping.");
             result = -1;
         }
 
@@ -775,7 +1351,7 @@ int CAMERA_MANAGER::set_acquisition_mode(INodeMap* node_map, unsigned int camera
         CEnumEntryPtr ptr_acquisition_mode_continuous = ptr_acquisition_mode->GetEntryByName("Continuous");
         if (!IsReadable(ptr_acquisition_mode_continuous))
         {
-            cerr << "Camera " << camera_index << ": Continuous acquisition mode is not readable. Skipping.\n";
+            log_error(log_tag("Camera", camera_index), "Continuous acquisition mode is not readable. Skipping.");
             result = -1;
         }
 
@@ -783,11 +1359,11 @@ int CAMERA_MANAGER::set_acquisition_mode(INodeMap* node_map, unsigned int camera
         const int64_t acquisition_mode_continuous = ptr_acquisition_mode_continuous->GetValue();
         ptr_acquisition_mode->SetIntValue(acquisition_mode_continuous);
 
-        cout << "[Camera " << camera_index << "] Acquisition mode set to Continuous.\n";
+        log_debug(log_tag("Camera", camera_index), "Acquisition mode set to Continuous.");
     }
     catch (const Spinnaker::Exception& e)
     {
-        cerr << "[Camera " << camera_index << "] Error setting acquisition mode: " << e.what() << endl;
+        log_error(log_tag("Camera", camera_index), "Error setting acquisition mode: {}", e.what());
         result = -1;
     }
 
@@ -802,17 +1378,17 @@ int CAMERA_MANAGER::set_acquisition_mode(INodeMap* node_map, unsigned int camera
  */
 int CAMERA_MANAGER::start_camera_acquisition(CameraPtr& camera, unsigned int camera_index)
 {
+    TRACE_SCOPE trace_scope("BeginAcquisition", "camera", camera_index);
     int result = 0;
 
     try
     {
         camera->BeginAcquisition();
-        cout << "[Camera " << camera_index << "] Acquisition started.\n";
-        result = -1;
+        log_debug(log_tag("Camera", camera_index), "Acquisition started.");
     }
     catch (const Spinnaker::Exception& e)
     {
-        cerr << "[Camera " << camera_index << "] Error starting acquisition: " << e.what() << endl;
+        log_error(log_tag("Camera", camera_index), "Error starting acquisition: {}", e.what());
         result = -1;
     }
 
@@ -937,7 +1513,7 @@ bool CAMERA_MANAGER::is_camera_valid(const CameraPtr& camera, INodeMap* node_map
 {
     if (!camera || !node_map)
     {
-        cerr << "[Camera " << camera_index << "] is invalid. Skipping.\n";
+        log_error(log_tag("Camera", camera_index), "Camera is invalid. Skipping.");
         return false;
     }
     return true;
@@ -957,8 +1533,8 @@ bool CAMERA_MANAGER::is_camera_valid(const CameraPtr& camera, INodeMap* node_map
 int CAMERA_MANAGER::acquire_images(
     vector<CameraPtr>& cameras,
     unsigned int number_of_cameras,
-    const vector<INodeMap*>& node_maps,
-    const vector<INodeMap*>& node_maps_tl_device,
+    vector<INodeMap*>& node_maps,
+    vector<INodeMap*>& node_maps_tl_device,
     atomic<bool>& global_running,
     const string& folder_path)
 {
@@ -972,6 +1548,16 @@ int CAMERA_MANAGER::acquire_images(
     vector<string> device_serial_numbers(number_of_cameras, "");
     vector<uint64_t> timeouts(number_of_cameras, 1000);
     vector<map<int64_t, unsigned int>> image_counts(number_of_cameras); // Track image counts for each offset_x
+    vector<chrono::steady_clock::time_point> sensor_times(number_of_cameras); // Last sensor reading for the metrics endpoint
+    DEVICE_LINK_EVENTS link_events(recovery);   // Registered while the cameras stream
+    bool link_events_registered = false;
+
+    // Slot files per camera/ROI, written atomically (temp file + rename) and published in the ring manifest
+    if (pipeline.start(folder_path) != 0)
+    {
+        set_non_blocking_input(false);
+        return -1;
+    }
 
     try
     {
@@ -988,60 +1574,144 @@ int CAMERA_MANAGER::acquire_images(
             timeouts[i] = calculate_exposure_timeout(node_maps[i], i);
         }
 
+        // Arrival/removal of the cameras, a camera that drops off is re-opened while the others keep streaming
+        for (unsigned int i = 0; i < number_of_cameras; i++)
+        {
+            recovery.add_camera(i < camera_profiles.size() ? camera_profiles[i].serial : device_serial_numbers[i]);
+        }
+        if (system)
+        {
+            system->RegisterEventHandler(link_events);
+            link_events_registered = true;
+        }
+
         // Main acquisition loop
+        CAMERA_CONFIG_FILE updated_file;
         while (local_running && global_running.load())
         {
+            // Settings file changed -> apply it before the next ROI cycle, while every camera is stopped
+            if (settings_watcher && settings_watcher->take_update(updated_file))
+            {
+                reload_camera_settings(cameras, node_maps, updated_file);
+                for (unsigned int i = 0; i < number_of_cameras; i++)
+                {
+                    timeouts[i] = calculate_exposure_timeout(node_maps[i], i);
+                }
+            }
+
+            bool any_streaming = false;
             for (unsigned int i = 0; i < number_of_cameras; i++) // Loop over cameras
             {
+                // Out -> re-open it when due (arrival event or retry interval), otherwise leave it to the next cycle
+                if (recovery.get_state(i) != CAMERA_LINK_STREAMING)
+                {
+                    if (!recovery.is_reopen_due(i))
+                        continue;
+
+                    CAMERA_INCIDENT incident;
+                    if (!recovery.on_reopen(i, reopen_camera(i, cameras, node_maps, node_maps_tl_device) == 0, incident))
+                        continue;
+
+                    timeouts[i] = calculate_exposure_timeout(node_maps[i], i);
+                    log_info(log_tag("Recovery", i), "Camera {} back after {} ms ({}): {} frames lost, {} re-open attempt(s)",
+                             incident.serial, incident.outage_ms, incident.cause, incident.frames_lost, incident.reopen_attempts);
+                }
+
                 if (!is_camera_valid(cameras[i], node_maps[i], i))
                     continue;
+                any_streaming = true;
 
-                for (const auto& roi : roi_config_values) // Alternate offsets for each camera
+                for (const auto& roi : camera_profiles[i].rois) // Alternate offsets for each camera (settings file or roi_config_values)
                 {
-                    // Calculate circular index for overwriting
-                    unsigned int circular_index = image_counts[i][roi.offset_x] % 5;
+                    TRACE_SCOPE roi_scope("roi_cycle", "offset_x", roi.offset_x);
 
                     // Apply ROI
-                    cout << "Applying ROI for Camera " << i
-                         << " - OffsetX: " << roi.offset_x
-                         << ", OffsetY: " << roi.offset_y
-                         << ", Width: " << roi.width
-                         << ", Height: " << roi.height << endl;
+                    log_debug(log_tag("Camera", i), "Applying ROI - OffsetX: {}, OffsetY: {}, Width: {}, Height: {}", roi.offset_x, roi.offset_y, roi.width, roi.height);
 
-                    result |= config_roi(node_maps[i], roi.offset_x, roi.offset_y, roi.width, roi.height, i);
+                    // Errors of a single camera go to the recovery, which re-opens it after a few in a row
+                    int capture_result = config_roi(node_maps[i], roi.offset_x, roi.offset_y, roi.width, roi.height, i);
 
                     // Start acquisition
-                    result |= set_acquisition_mode(node_maps[i], i);
-                    result |= start_camera_acquisition(cameras[i], i);
+                    capture_result |= set_acquisition_mode(node_maps[i], i);
+                    if (capture_result == 0)
+                    {
+                        capture_result = start_camera_acquisition(cameras[i], i);
+                    }
 
                     try
                     {
                         // Capture the image
                         //string camera_folder = combine_path(folder_path, "camera_" + to_string(i));
-                        capture_image(
-                            cameras[i],
-                            timeouts[i],
-                            folder_path,
-                            device_serial_numbers[i],
-                            circular_index, // Circular index to overwrite images
-                            i,
-                            roi.offset_x
-                        );
-                        cout << "[Camera " << i << "] Image captured successfully for OffsetX: " << roi.offset_x << " (Image Index: " << circular_index << ")\n";
-
-                        // Increment count for the current offset
-                        image_counts[i][roi.offset_x]++;
+                        if (capture_result == 0)
+                        {
+                            capture_result = capture_image(
+                                cameras[i],
+                                timeouts[i],
+                                device_serial_numbers[i],
+                                i,
+                                roi.offset_x
+                            );
+                        }
+                        recovery.on_grab(i, capture_result == 0);
+                    }
+                    catch (const Spinnaker::Exception& e)
+                    {
+                        log_error(log_tag("Camera", i), "Error capturing image: {}", e.what());
+                        recovery.on_grab(i, false);
+                        capture_result = -1;
+                    }
+
+                    try
+                    {
+                        if (capture_result == 0)
+                        {
+                            log_info(log_tag("Camera", i), "Image captured successfully for OffsetX: {} (Image Count: {})", roi.offset_x, image_counts[i][roi.offset_x] + 1);
+
+                            if (!first_frame_logged)
+                            {
+                                log_info(log_tag("Startup"), "First frame {} ms after the start",
+                                         chrono::duration<double, milli>(chrono::steady_clock::now() - startup_time).count());
+                                if (is_reconnect)
+                                {
+                                    log_info(log_tag("Startup"), "Reconnect to first frame {} ms (since the previous run failed)",
+                                             chrono::duration<double, milli>(chrono::steady_clock::now() - reconnect_start).count());
+                                }
+                                first_frame_logged = true;
+                            }
+
+                            // Increment count for the current offset
+                            image_counts[i][roi.offset_x]++;
+
+                            // Camera temperature and link throughput for the metrics endpoint, about once per second
+                            if (metrics_server && chrono::steady_clock::now() - sensor_times[i] >= chrono::seconds(1))
+                            {
+                                CAMERA_METRICS* camera_metrics = metrics_server->get_camera(device_serial_numbers[i]);
+                                if (camera_metrics)
+                                {
+                                    double temperature_c = 0.0;
+                                    double link_throughput = 0.0;
+                                    read_device_sensors(*node_maps[i], temperature_c, link_throughput);
+                                    camera_metrics->set_sensors(temperature_c, link_throughput);
+                                }
+                                sensor_times[i] = chrono::steady_clock::now();
+                            }
+                        }
                     }
                     catch (const Spinnaker::Exception& e)
                     {
-                        cerr << "[Camera " << i << "] Error capturing image: " << e.what() << endl;
-                        result = -1;
+                        log_error(log_tag("Camera", i), "Error reading the camera sensors: {}", e.what());
                     }
 
                     // Stop acquisition after capturing the image
                     vector<CameraPtr> acquisitioned_camera = {cameras[i]};
                     stop_camera_acquisition(acquisitioned_camera);
 
+                    if (recovery.get_state(i) != CAMERA_LINK_STREAMING)
+                    {
+                        log_warning(log_tag("Recovery", i), "Camera {} is out, the other cameras keep streaming", device_serial_numbers[i]);
+                        break;
+                    }
+
                     // Check for user input
                     if (keyboard_input() && handle_keyboard_interrupt())
                     {
@@ -1058,6 +1728,18 @@ int CAMERA_MANAGER::acquire_images(
 
             if (!local_running)
                 break;
+
+            // Every camera is out -> wait for them without spinning, 'q' still quits
+            if (!any_streaming)
+            {
+                this_thread::sleep_for(chrono::milliseconds(50));
+                if (keyboard_input() && handle_keyboard_interrupt())
+                {
+                    cout << "User requested termination (pressed 'q'). Exiting acquisition loop.\n";
+                    local_running = false;
+                    global_running.store(false);
+                }
+            }
         }
     }
     catch (const Spinnaker::Exception& e)
@@ -1066,6 +1748,29 @@ int CAMERA_MANAGER::acquire_images(
         result = -1;
     }
 
+    if (link_events_registered)
+    {
+        try
+        {
+            system->UnregisterEventHandler(link_events);
+        }
+        catch (const Spinnaker::Exception& e)
+        {
+            cerr << "Error unregistering the device events: " << e.what() << endl;
+        }
+    }
+
+    // Outage, frames lost and re-open attempts of every camera that dropped off
+    for (const CAMERA_INCIDENT& incident : recovery.get_incidents())
+    {
+        cout << "[Recovery] Camera " << incident.serial << " (" << incident.cause << "): out " << incident.outage_ms << " ms, "
+             << incident.frames_lost << " frames lost, " << incident.reopen_attempts << " re-open attempt(s)"
+             << (incident.recovered ? "" : ", still out") << "\n";
+    }
+
+    // Make sure every queued frame is written before the cameras are torn down
+    result |= pipeline.flush();
+
     return result;
 }
 
@@ -1172,12 +1877,12 @@ void CAMERA_MANAGER::de_initialize_cameras(vector<CameraPtr>& cameras, vector<Ca
 /**
  * Runs the camera configuration and image acquisition
  * @param cameras: The camera pointers to acquire images from.
- * @param cam_list: The camera list to select cameras from.
  * @param number_of_cameras: The number of cameras to acquire images from.
  * @param global_running: The atomic boolean to control the running state of the cameras.
+ * @param folder_path: Path prefix of the image files and the disk ring manifest.
  * @return 0 if successful, -1 if an error occurred during camera operations.
  */
-int CAMERA_MANAGER::run_multiple_cameras(vector<CameraPtr>& cameras, CameraList& cam_list, unsigned int number_of_cameras, atomic<bool>& global_running, const string& folder_path)
+int CAMERA_MANAGER::run_multiple_cameras(vector<CameraPtr>& cameras, unsigned int number_of_cameras, atomic<bool>& global_running, const string& folder_path)
 {
     int result = 0;
     int is_exposure_config_ok = 0;
@@ -1186,6 +1891,9 @@ int CAMERA_MANAGER::run_multiple_cameras(vector<CameraPtr>& cameras, CameraList&
     vector<INodeMap*> node_maps_tl_device;
     vector<CameraPtr> initialized_cameras;
 
+    startup_time = chrono::steady_clock::now(); // Cold start: Init, configuration and the first frame
+    first_frame_logged = false;
+
     try
     {
         // Initialize cameras and retrieve node maps
@@ -1248,22 +1956,69 @@ int CAMERA_MANAGER::run_multiple_cameras(vector<CameraPtr>& cameras, CameraList&
         }
 
         cout << "\n*** " << initialized_cameras.size() << " CAMERAS SUCCESSFULLY INITIALIZED ***\n";
+        auto init_end_time = chrono::steady_clock::now();
+
+        // Settings per serial number
+        load_camera_profiles(node_maps, node_maps_tl_device);
+
+        // Every camera has a snapshot of these settings -> one pass that only writes what the camera lost, e.g. after a reconnect.
+        // Otherwise every camera boots into a UserSet holding them -> load it instead of writing every node
+        bool from_snapshot = restore_node_snapshots(initialized_cameras, node_maps);
+        bool from_user_set = !from_snapshot && load_user_sets(node_maps);
+        if (from_snapshot)
+        {
+            cout << "Settings restored from the snapshots in " << snapshot_dir << ", skipping the configuration\n";
+        }
+        else if (from_user_set)
+        {
+            cout << "Settings unchanged since they were saved into " << user_set << ", skipping the configuration\n";
+            for (unsigned int i = 0; i < initialized_cameras.size() && i < camera_profiles.size(); i++)
+            {
+                result |= config_stream_buffers(initialized_cameras[i]->GetTLStreamNodeMap(), camera_profiles[i]);  // Host side, not in the UserSet
+            }
+        }
+        else
+        {
+            // Checked against the camera limits before anything is configured
+            if (validate_camera_profiles(initialized_cameras, node_maps) != 0)
+            {
+                cerr << "Camera settings do not fit the cameras. Terminating.\n";
+                de_initialize_cameras(cameras, initialized_cameras, node_maps, node_maps_tl_device);
+                return -1;
+            }
+
+            // Run camera configurations
+            cout << "Running camera configurations...\n";
+            result |= config_pixel_format(node_maps);
+            result |= config_sensor_shutter_mode(node_maps);
 
-        // Run camera configurations
-        cout << "Running camera configurations...\n";
-        result |= config_pixel_format(node_maps);
-        result |= config_sensor_shutter_mode(node_maps);
+            is_exposure_config_ok = config_exposure(node_maps);
+            if (is_exposure_config_ok < 0)
+            {
+                cerr << "Exposure configuration failed. Terminating.\n";
+                return is_exposure_config_ok;
+            }
+
+            result |= config_stream(initialized_cameras, node_maps);   // After the exposure, which limits the frame rate
+            result |= config_gain(node_maps);
+            result |= config_black_level_clamping_enable(node_maps);
+            result |= config_gamma(node_maps);
+
+            if (!user_set.empty() && result == 0)
+            {
+                save_user_sets(node_maps);   // The next startups only load it
+            }
+        }
 
-        is_exposure_config_ok = config_exposure(node_maps);
-        if (is_exposure_config_ok < 0)
+        if (!from_snapshot)
         {
-            cerr << "Exposure configuration failed. Terminating.\n";
-            return is_exposure_config_ok;
+            take_node_snapshots(initialized_cameras, node_maps, result == 0);   // A camera re-opened during the acquisition, the next startups and retries restore it
         }
 
-        result |= config_gain(node_maps);
-        result |= config_black_level_clamping_enable(node_maps);
-        result |= config_gamma(node_maps);
+        log_info(log_tag("Startup"), "Init {} ms, configuration {} ms ({})",
+                 chrono::duration<double, milli>(init_end_time - startup_time).count(),
+                 chrono::duration<double, milli>(chrono::steady_clock::now() - init_end_time).count(),
+                 from_snapshot ? "snapshot restored" : from_user_set ? "loaded " + user_set : "every setting written");
 
         // Run image acquisition
         result |= acquire_images(initialized_cameras, initialized_cameras.size(), node_maps, node_maps_tl_device, global_running, folder_path);
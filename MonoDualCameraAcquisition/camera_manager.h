@@ -8,54 +8,122 @@
 #include "Spinnaker.h"
 #include "SpinGenApi/SpinnakerGenApi.h"
 
+#include "camera_recovery.h"
 #include "camera_settings.h"
+#include "frame_pipeline.h"
+#include "frame_sink.h"
+#include "frame_writer.h"
+#include "metrics_server.h"
+#include "node_snapshot.h"
+#include "settings_watcher.h"
+#include "user_set_cache.h"
 
 #include <iostream>
 #include <string>
 #include <vector>
 #include <atomic>
+#include <chrono>
 
 using namespace Spinnaker;
 using namespace Spinnaker::GenApi;
 using namespace Spinnaker::GenICam;
 using namespace std;
 
+// Passes the device arrival/removal events of the System to the recovery state machine (Spinnaker event thread)
+class DEVICE_LINK_EVENTS : public InterfaceEventHandler
+{
+    private:
+        CAMERA_RECOVERY& recovery;
+
+        static string get_serial(CameraPtr camera);
+
+    public:
+        explicit DEVICE_LINK_EVENTS(CAMERA_RECOVERY& camera_recovery);
+
+        void OnDeviceArrival(CameraPtr camera) override;
+        void OnDeviceRemoval(CameraPtr camera) override;
+};
+
 class CAMERA_MANAGER
 {
     private:
         // Pointer to the camera settings object
         const CAMERA_SETTINGS* camera_settings;
 
+        // Frame sinks, optional raw frame writer (nullptr -> Image::Save as JPEG) and the on-disk ring per camera/ROI
+        FRAME_PIPELINE pipeline;
+
+        // Optional metrics endpoint, not owned (nullptr -> no metrics)
+        METRICS_SERVER* metrics_server = nullptr;
+
+        // Optional watch of the settings file, not owned (nullptr -> settings only change with a restart)
+        SETTINGS_WATCHER* settings_watcher = nullptr;
+
+        // Per camera: change of the settings file written to the camera, until the first frame taken with it arrives
+        vector<SETTINGS_CHANGE> settings_changes;
+
+        // UserSet the configuration is saved into and loaded from at startup (empty -> every setting is written), cache not owned
+        string user_set;
+        USER_SET_CACHE* user_set_cache = nullptr;
+
+        // Directory of the node snapshots restored after a reconnect (empty -> no snapshots)
+        string snapshot_dir;
+
+        // Per camera: hash_camera_profile() of the settings, keys the UserSet cache and the snapshots
+        vector<uint64_t> settings_hashes;
+
+        // Per camera: the configured nodes, restored when a camera is re-opened during the acquisition
+        vector<NODE_SNAPSHOT> camera_snapshots;
+
+        // System the cameras come from, for the device events and the re-open of a single camera (null -> no recovery)
+        SystemPtr system;
+        CAMERA_RECOVERY recovery;
+
+        // Start of run_multiple_cameras, for the time to the first frame
+        chrono::steady_clock::time_point startup_time;
+        bool first_frame_logged = false;
+
+        // When the previous run failed, for the time from the failure to the first frame of this run
+        chrono::steady_clock::time_point reconnect_start;
+        bool is_reconnect = false;
+
         int acquire_images(
             vector<CameraPtr>& cameras, 
             unsigned int number_of_cameras, 
-            const vector<INodeMap*>& node_maps, 
-            const vector<INodeMap*>& node_maps_tl_device, 
+            vector<INodeMap*>& node_maps,               // Entries of a re-opened camera are replaced
+            vector<INodeMap*>& node_maps_tl_device, 
             atomic<bool>& global_running, 
             const string& folder_path
         );
 
-        // Struct to hold ROI configuration values
-        struct ROI_CONFIG_VALUES
-        {
-            int64_t offset_x;
-            int64_t offset_y;
-            int64_t width;
-            int64_t height;
-        };
-
-        // Vector to hold ROI configuration values
-        vector<ROI_CONFIG_VALUES> roi_config_values = 
+        // ROIs of the cameras without a roi in the settings file
+        vector<ROI_SETTINGS> roi_config_values = 
         {
             {0, 0, 1216, 352},   // First ROI: offset_x = 0, offset_y = 0, width = 1216, height = 352
             {1216, 0, 1216, 352} // Second ROI: offset_x = 1216, offset_y = 0, width = 1216, height = 352
         };
 
+        // Settings of each initialized camera (same order as the node maps), resolved and validated before configuration
+        vector<CAMERA_PROFILE> camera_profiles;
+
 
     public:
         CAMERA_MANAGER(const CAMERA_SETTINGS* settings);    // Constructor
         ~CAMERA_MANAGER();   // Destructor
 
+        void set_frame_writer(FRAME_WRITER* writer); // Use an asynchronous raw frame writer instead of Image::Save
+        void add_frame_sink(FRAME_SINK* sink); // Pass every captured frame to an additional consumer
+        void set_save_images(bool enable); // Enable/disable the per-frame files (JPEG or frame writer)
+        void set_ring_options(unsigned int slots, bool sync); // Slot files per camera/ROI and whether commits are fsynced
+        void set_metrics_server(METRICS_SERVER* server); // Per-camera counters and sensor readings for the metrics endpoint
+        void set_settings_watcher(SETTINGS_WATCHER* watcher); // Apply changes of the settings file between the ROI captures
+        void set_user_set(const string& name, USER_SET_CACHE* cache); // Save the configuration into a UserSet, later startups only load it
+        void set_snapshot_dir(const string& directory); // Save a node snapshot per camera, later startups and reconnects restore it
+        void set_reconnect_start(chrono::steady_clock::time_point failure_time); // This run follows a failed one, logs the time to its first frame
+        void set_system(SystemPtr system_ptr); // Re-open a camera that drops off while the others keep streaming
+        size_t get_max_frame_bytes() const; // Largest Mono16 frame produced by the ROI configuration
+        unsigned int get_max_stream_count(unsigned int camera_count) const; // Camera/ROI streams the frame sinks can see
+
         // Function to get the camera serial number
         string get_camera_serial_number(INodeMap* node_map_tl_device, unsigned int camera_index);
 
@@ -68,13 +136,11 @@ class CAMERA_MANAGER
         bool is_camera_valid(const CameraPtr& camera, INodeMap* node_map, unsigned int camera_index);   // Checks if a camera_ptr and its node map are valid
         int set_acquisition_mode(INodeMap* node_map, unsigned int camera_index);   // Sets the acquisition mode to "Continuous"
         
-        // Captures an image for a specific region based on OffsetX
-        void capture_image(
+        // Captures an image for a specific region based on OffsetX, -1 if no frame arrived
+        int capture_image(
             CameraPtr& camera,
             uint64_t timeout,
-            const string& folder_path,
             const string& device_serial,
-            unsigned int image_index,
             unsigned int camera_index,
             int64_t offset_x
         );
@@ -89,6 +155,15 @@ class CAMERA_MANAGER
         int keyboard_input(); // Function to get keyboard input
        
         // Configurations for the camera
+        void load_camera_profiles(const vector<INodeMap*>& node_maps, const vector<INodeMap*>& node_maps_tl_device); // Settings Per Serial
+        int validate_camera_profiles(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps); // Checked Against The Camera Limits
+        bool load_user_sets(const vector<INodeMap*>& node_maps); // UserSetLoad If Every Camera Holds Its Settings
+        void save_user_sets(const vector<INodeMap*>& node_maps); // UserSetSave For The Next Startups
+        bool restore_node_snapshots(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps); // One Pass Per Camera If Every Snapshot Is Current
+        void take_node_snapshots(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps, bool save); // Snapshot Of The Configured Cameras
+        int reopen_camera(unsigned int camera_index, vector<CameraPtr>& cameras, vector<INodeMap*>& node_maps, vector<INodeMap*>& node_maps_tl_device); // Init And Snapshot Restore Of One Camera
+        int config_stream(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps); // Frame Rate And Stream Buffers
+        void reload_camera_settings(const vector<CameraPtr>& cameras, const vector<INodeMap*>& node_maps, const CAMERA_CONFIG_FILE& config_file); // Changes Of The Settings File, Acquisition Stopped
         int config_pixel_format(const vector<INodeMap*>& node_maps); // Custom Pixel Format
         int config_roi(INodeMap* node_map, int64_t offset_x, int64_t offset_y, int64_t width, int64_t height, unsigned int camera_index); // Custom Region Of Interest
         int config_exposure(const vector<INodeMap*>& node_maps); // Custom Exposure Time
@@ -99,6 +174,6 @@ class CAMERA_MANAGER
 	    int reset_exposure(const vector<INodeMap*>& node_maps); // Reset Exposure Time
 
         // Runs the camera configuration and image acquisition
-        int run_multiple_cameras(vector<CameraPtr>& cameras, CameraList& cam_list, unsigned int number_of_cameras, atomic<bool>& global_running, const string& folder_path);
+        int run_multiple_cameras(vector<CameraPtr>& cameras, unsigned int number_of_cameras, atomic<bool>& global_running, const string& folder_path);
 };      
 #endif // CAMERA_MANAGER_H
@@ -1,4 +1,4 @@
-// Description: Get camera setting values from a file and store them in a struct and provide getters for the values.
+// Description: Get camera setting values (defaults and per-camera overrides) from a file and provide getters for the values.
 // Author: Gregor Kokk
 // Date: 06.01.2025
 
@@ -28,74 +28,52 @@ std::vector<std::string> CAMERA_SETTINGS::load_from_file(const std::string &file
         file_content.push_back(line);
     }
 
+    source = filename;
     return file_content;
 }
 
-// Parse a single line into a key and value
-std::pair<std::string, double> CAMERA_SETTINGS::parse_line(const std::string &line)
+// Parse file content into the default and per-camera settings (see camera_config_file.h for the format)
+int CAMERA_SETTINGS::get_values(const std::vector<std::string> &file_content)
 {
-    std::stringstream ss(line);
-    std::string key;
-    double value;
+    std::cout << "\n*** GET VALUES ***\n\n";
+
+    int result = config_file.parse(file_content, source);
 
-    if (std::getline(ss, key, ':') && ss >> value)
+    std::cout << "Defaults: " << describe_camera_profile(config_file.get_defaults()) << "\n";
+    for (const CAMERA_PROFILE &camera : config_file.get_camera_sections())
     {
-        return {key, value};
+        std::cout << "Camera " << camera.serial << ": " << describe_camera_profile(camera) << "\n";
     }
 
-    std::cerr << "Error parsing line: " << line << '\n';
-    return {"", -1.0};
+    return result;
 }
 
-// Parse file content and assign values to camera settings
-int CAMERA_SETTINGS::get_values(const std::vector<std::string> &file_content)
+// Settings of one camera
+CAMERA_PROFILE CAMERA_SETTINGS::get_profile(const std::string &serial) const
 {
-    std::cout << "\n*** GET VALUES ***\n\n";
-
-    for (const auto &line : file_content)
-    {
-        std::pair<std::string, double> parsed_line = parse_line(line); // No structured bindings
-        const std::string& key = parsed_line.first; // Access key
-        double value = parsed_line.second;          // Access value
-
-        if (key == "Exposure")
-        {
-            settings.exposure = value;
-            std::cout << "Exposure: " << value << "\n";
-        }
-        else if (key == "Gain")
-        {
-            settings.gain = value;
-            std::cout << "Gain: " << value << "\n";
-        }
-        else if (key == "Gamma")
-        {
-            settings.gamma = value;
-            std::cout << "Gamma: " << value << "\n";
-        }
-        else
-        {
-            std::cerr << "Unknown key: " << key << '\n';
-        }
-    }
+    return config_file.get_profile(serial);
+}
 
-    return 0;
+// The parsed settings file
+const CAMERA_CONFIG_FILE& CAMERA_SETTINGS::get_config_file() const
+{
+    return config_file;
 }
 
 // Getter for Exposure
 double CAMERA_SETTINGS::get_exposure() const
 {
-    return settings.exposure;
+    return config_file.get_defaults().exposure;
 }
 
 // Getter for Gain
 double CAMERA_SETTINGS::get_gain() const
 {
-    return settings.gain;
+    return config_file.get_defaults().gain;
 }
 
 // Getter for Gamma
 double CAMERA_SETTINGS::get_gamma() const
 {
-    return settings.gamma;
-}
\ No newline at end of file
+    return config_file.get_defaults().gamma;
+}
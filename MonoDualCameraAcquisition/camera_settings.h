@@ -8,34 +8,31 @@
 #include <string>
 #include <vector>
 
+#include "camera_config_file.h"
+
 using namespace std;
 
 class CAMERA_SETTINGS
 {
 private:
-    struct SETTINGS // Struct to hold camera settings
-    {
-        double exposure;
-        double gain;
-        double gamma;
-    };
-
-    SETTINGS settings;   // Instance of settings struct
-
-    // Helper function to parse a line into a key-value pair
-    pair<string, double> parse_line(const string &line);
+    CAMERA_CONFIG_FILE config_file;   // [defaults] and the [camera <serial>] overrides
+    string source = "settings";       // File name for the messages
 
 public:
     // Function to load the content of a file into a vector of strings
     vector<string> load_from_file(const string &filename);
     
-    // Function to extract values from the file content
+    // Function to extract values from the file content, -1 if a line is invalid
     int get_values(const vector<string> &file_content);
 
-    // Getters for settings
+    // Settings of one camera: the defaults with its own section applied
+    CAMERA_PROFILE get_profile(const string &serial) const;
+    const CAMERA_CONFIG_FILE& get_config_file() const;
+
+    // Getters for the default settings
     double get_exposure() const;
     double get_gain() const;
     double get_gamma() const;
 };
 
-#endif // CAMERA_SETTINGS_H
\ No newline at end of file
+#endif // CAMERA_SETTINGS_H
@@ -8,12 +8,28 @@
 #include <chrono>	// For std::chrono::milliseconds
 #include <thread>	// For std::this_thread::sleep_for
 #include <atomic>   // For std::atomic --> To communicate between the acquire_images function and the main function
+#include <memory>   // For std::unique_ptr
+#include <cstdlib>  // For atexit
 
 #include "Spinnaker.h"
 #include "SpinGenApi/SpinnakerGenApi.h"
 
+#include "async_logger.h"
 #include "camera_manager.h"
 #include "camera_settings.h"
+#include "command_line.h"
+#include "control_fifo.h"
+#include "frame_compressor.h"
+#include "frame_stream.h"
+#include "frame_writer.h"
+#include "metrics_server.h"
+#include "pretrigger_ring.h"
+#include "segment_recorder.h"
+#include "settings_watcher.h"
+#include "user_set_cache.h"
+#include "shm_frame_ring.h"
+#include "trace_recorder.h"
+#include "video_recorder.h"
 
 using namespace Spinnaker;
 using namespace Spinnaker::GenApi;
@@ -29,7 +45,115 @@ int main(int argc, char** argv)
     int retries = 0;
     atomic<bool> global_running(true); // Indicates if the program should continue running
 
-    string folder_path = "/path/to/save/images";	// Folder path to save images
+    string folder_path = "/path/to/save/images/";	// Folder path to save images (prefix for the file names)
+
+    COMMAND_LINE command_line(argc, argv);
+
+    // --config=<file> -> camera settings: [defaults] and [camera <serial>] sections (see Common/camera_config_file.h)
+    string settings_path = command_line.get_string("config", "/path/to/database/mono.txt");
+
+    // --record=<folder> -> additionally record every frame into preallocated O_DIRECT segment files (--segment-mb=<size>)
+    string record_path = command_line.get_string("record", "");
+    long long segment_mb = command_line.get_int("segment-mb", 1024);
+
+    // --pretrigger=<folder> -> keep the last --pre-seconds in RAM and only save frames around events ('t' key, --control FIFO, --image-trigger)
+    string pretrigger_path = command_line.get_string("pretrigger", "");
+    string control_path = command_line.get_string("control", "");
+
+    // --video=<folder> -> record into rotating AVI files per camera/ROI instead of a file per frame (--video-seconds=<n>)
+    string video_path = command_line.get_string("video", "");
+    double video_seconds = command_line.get_double("video-seconds", 60.0);
+
+    // --shm=<name> -> publish every frame to a shared memory ring (--shm-slots=<n>) for local viewers/processing
+    string shm_name = command_line.get_string("shm", "");
+    long long shm_slots = command_line.get_int("shm-slots", 8);
+
+    // --stream=<port|host:port|unix:/path> -> serve frames to local clients (FrameStreamClient), --stream-buffers=<n>
+    string stream_address = command_line.has("stream") ? command_line.get_string("stream", "5600") : "";
+    long long stream_buffers = command_line.get_int("stream-buffers", 16);
+
+    // --writer=jpeg (default, Image::Save) | uring | pwrite -> raw frames through the asynchronous frame writer | none
+    string writer_name = command_line.get_string("writer", record_path.empty() && pretrigger_path.empty() && video_path.empty() ? "jpeg" : "none");
+
+    // --compress=lz4|zstd -> compress the recorded frames losslessly (--compress-level=<n>, --compress-threads=<n>)
+    string codec_name = command_line.get_string("compress", "none");
+    COMPRESSION_CODEC compression_codec = COMPRESSION_NONE;
+
+    long long ring_slots = command_line.get_int("ring-slots", 5);   // Image files kept per camera/ROI
+    bool ring_sync = command_line.get_int("ring-sync", 1) != 0;     // fsync every image before it is published
+
+    // --metrics=<port> -> Prometheus metrics (fps, drops, queue depth, temperature, link throughput) on http://127.0.0.1:<port>/metrics
+    long long metrics_port = command_line.has("metrics") ? command_line.get_int("metrics", 9100) : 0;
+
+    // --snapshot-dir=<dir> -> save a node snapshot per camera after the configuration, retries and later startups restore it in one pass
+    string snapshot_dir = command_line.get_string("snapshot-dir", "");
+
+    chrono::steady_clock::time_point failure_time;  // When the last run failed, for the reconnect time
+    bool has_failed = false;
+    if (ring_slots < 1)
+    {
+        cerr << "--ring-slots must be at least 1.\n";
+        return -1;
+    }
+    if (!parse_compression_codec(codec_name, compression_codec))
+    {
+        cerr << "Unknown codec: " << codec_name << ". Use none, lz4 or zstd.\n";
+        return -1;
+    }
+    if (!is_compression_codec_available(compression_codec))
+    {
+        cerr << "Built without " << codec_name << " (library not found at build time).\n";
+        return -1;
+    }
+    if (stream_buffers < 1)
+    {
+        cerr << "--stream-buffers must be at least 1.\n";
+        return -1;
+    }
+    if (shm_slots < 1)
+    {
+        cerr << "--shm-slots must be at least 1.\n";
+        return -1;
+    }
+    if (command_line.has("shm") && shm_name.empty())
+    {
+        shm_name = "/spinnaker_frames";
+    }
+    else if (!shm_name.empty() && shm_name[0] != '/')
+    {
+        shm_name = "/" + shm_name;
+    }
+    FRAME_WRITER_BACKEND writer_backend = FRAME_WRITER_BACKEND_URING;
+    if (writer_name != "jpeg" && writer_name != "none" && !parse_frame_writer_backend(writer_name, writer_backend))
+    {
+        cerr << "Unknown writer: " << writer_name << ". Use jpeg, uring, pwrite or none.\n";
+        return -1;
+    }
+
+    // --log=<file> -> per-frame messages through the asynchronous logger into a file instead of the console, --log-level=debug|info|warning|error
+    LOG_CONFIG log_config = default_log_config();
+    log_config.path = command_line.get_string("log", "");
+    if (!parse_log_level(command_line.get_string("log-level", "info"), log_config.min_level))
+    {
+        cerr << "Unknown log level. Use debug, info, warning or error.\n";
+        return -1;
+    }
+    if (ASYNC_LOGGER::start(log_config) != 0)
+    {
+        return -1;
+    }
+    atexit([] { ASYNC_LOGGER::stop(); });  // Registered before the trace recorder, so it is stopped last
+
+    // --trace=<file.json> -> record the acquisition timeline for chrome://tracing or ui.perfetto.dev, written at exit (--trace-events=<n> per thread)
+    string trace_path = command_line.get_string("trace", "");
+    if (!trace_path.empty())
+    {
+        TRACE_RECORDER::set_thread_name("acquisition");
+        if (TRACE_RECORDER::start(trace_path, static_cast<size_t>(max(1LL, command_line.get_int("trace-events", 65536)))) == 0)
+        {
+            atexit([] { TRACE_RECORDER::stop(); });  // Every return from main, including the error paths
+        }
+    }
 
     while (retries < max_retries)   // Retry initialization both cameras don't get detected, or if an error occurs
     {
@@ -73,19 +197,257 @@ int main(int argc, char** argv)
             CAMERA_SETTINGS camera_settings;
             CAMERA_MANAGER camera_manager(&camera_settings); // Pass pointer to camera settings object
 
-            // Load camera configuration from file
-            vector<string> file_content = camera_settings.load_from_file("/path/to/database/mono.txt");
+            // Load camera configuration from file first, its ROIs size the frame buffers below
+            vector<string> file_content = camera_settings.load_from_file(settings_path);
             if (file_content.empty())
             {
                 cerr << "Failed to load camera configuration from file. Exiting.\n";
                 return -1;
             }
 
-            result |= camera_settings.get_values(file_content); // Get values from file content
+            if (camera_settings.get_values(file_content) != 0) // Get values from file content
+            {
+                cerr << "Invalid camera configuration file. Exiting.\n";
+                return -1;
+            }
             cout << "Camera configuration loaded successfully.\n";
 
+            // Create the frame writer (sized for the largest ROI) if raw output was requested
+            unique_ptr<FRAME_WRITER> frame_writer;
+            camera_manager.set_save_images(writer_name != "none");
+            camera_manager.set_ring_options(static_cast<unsigned int>(ring_slots), ring_sync);
+            if (writer_name != "jpeg" && writer_name != "none")
+            {
+                frame_writer = create_frame_writer(default_frame_writer_config(writer_backend, camera_manager.get_max_frame_bytes()));
+                if (!frame_writer)
+                {
+                    cerr << "Failed to create frame writer. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.set_frame_writer(frame_writer.get());
+            }
+
+            // Create the segment recorder if recording was requested
+            unique_ptr<SEGMENT_RECORDER> segment_recorder;
+            unique_ptr<COMPRESSION_STAGE> compression_stage;   // Feeds segment_recorder, so it is destroyed first
+            if (!record_path.empty())
+            {
+                size_t record_frame_bytes = camera_manager.get_max_frame_bytes();
+                SEGMENT_RECORDER_CONFIG recorder_config = default_segment_recorder_config(record_path, compression_codec == COMPRESSION_NONE ?
+                                                                                          record_frame_bytes : get_max_compressed_frame_size(record_frame_bytes));
+                recorder_config.segment_size = static_cast<uint64_t>(segment_mb) * 1024 * 1024;
+
+                segment_recorder.reset(new SEGMENT_RECORDER());
+                if (segment_recorder->init(recorder_config) != 0)
+                {
+                    cerr << "Failed to create segment recorder. Exiting.\n";
+                    return -1;
+                }
+
+                if (compression_codec == COMPRESSION_NONE)
+                {
+                    camera_manager.add_frame_sink(segment_recorder.get());
+                }
+                else
+                {
+                    COMPRESSION_CONFIG compression_config = default_compression_config(compression_codec, record_frame_bytes);
+                    compression_config.level = static_cast<int>(command_line.get_int("compress-level", compression_config.level));
+                    compression_config.threads = static_cast<unsigned int>(max(1LL, command_line.get_int("compress-threads", compression_config.threads)));
+
+                    compression_stage.reset(new COMPRESSION_STAGE());
+                    if (compression_stage->init(compression_config, segment_recorder.get(), recorder_config.buffer_count) != 0)
+                    {
+                        cerr << "Failed to create compression stage. Exiting.\n";
+                        return -1;
+                    }
+                    camera_manager.add_frame_sink(compression_stage.get());
+                }
+            }
+
+            // Create the video recorder if AVI recording was requested
+            unique_ptr<VIDEO_RECORDER> video_recorder;
+            if (!video_path.empty())
+            {
+                VIDEO_RECORDER_CONFIG video_config = default_video_recorder_config(video_path, camera_manager.get_max_frame_bytes());
+                video_config.segment_seconds = video_seconds;
+
+                video_recorder.reset(new VIDEO_RECORDER());
+                if (video_recorder->init(video_config) != 0)
+                {
+                    cerr << "Failed to create video recorder. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.add_frame_sink(video_recorder.get());
+            }
+
+            // Create the shared memory publisher if local readers were requested
+            unique_ptr<SHM_FRAME_PUBLISHER> shm_publisher;
+            if (!shm_name.empty())
+            {
+                shm_publisher.reset(new SHM_FRAME_PUBLISHER());
+                if (shm_publisher->init(shm_name, static_cast<unsigned int>(shm_slots), camera_manager.get_max_frame_bytes()) != 0)
+                {
+                    cerr << "Failed to create shared memory ring. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.add_frame_sink(shm_publisher.get());
+            }
+
+            // Create the frame stream server if streaming was requested
+            unique_ptr<FRAME_STREAM_SERVER> stream_server;
+            if (!stream_address.empty())
+            {
+                FRAME_STREAM_CONFIG stream_config = default_frame_stream_config(stream_address, camera_manager.get_max_frame_bytes());
+                stream_config.packet_count = static_cast<unsigned int>(stream_buffers);
+
+                stream_server.reset(new FRAME_STREAM_SERVER());
+                if (stream_server->init(stream_config) != 0)
+                {
+                    cerr << "Failed to start frame stream server. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.add_frame_sink(stream_server.get());
+            }
+
+            // Create the pre-trigger ring if event recording was requested
+            unique_ptr<PRETRIGGER_RING> pretrigger_ring;
+            CONTROL_FIFO control_fifo;
+            if (!pretrigger_path.empty())
+            {
+                PRETRIGGER_RING_CONFIG ring_config = default_pretrigger_ring_config(pretrigger_path, camera_manager.get_max_frame_bytes());
+                ring_config.pre_seconds = command_line.get_double("pre-seconds", ring_config.pre_seconds);
+                ring_config.post_seconds = command_line.get_double("post-seconds", ring_config.post_seconds);
+                ring_config.frame_rate = command_line.get_double("ring-fps", ring_config.frame_rate);
+                ring_config.image_trigger_threshold = command_line.get_double("image-trigger", 0.0);
+                ring_config.max_streams = camera_manager.get_max_stream_count(number_of_cameras);  // Every camera/ROI has its own ring
+
+                pretrigger_ring.reset(new PRETRIGGER_RING());
+                if (pretrigger_ring->init(ring_config) != 0)
+                {
+                    cerr << "Failed to create pre-trigger ring. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.add_frame_sink(pretrigger_ring.get());
+
+                if (!control_path.empty())
+                {
+                    PRETRIGGER_RING* ring = pretrigger_ring.get();
+                    control_fifo.start(control_path, [ring](const string& command)
+                    {
+                        if (command.compare(0, 7, "trigger") == 0)
+                        {
+                            ring->trigger("control command");
+                        }
+                        else
+                        {
+                            cerr << "[Control] Unknown command: " << command << endl;
+                        }
+                    });
+                }
+            }
+
+            // Create the metrics endpoint if requested (scraped from its own thread)
+            unique_ptr<METRICS_SERVER> metrics_server;
+            if (metrics_port > 0)
+            {
+                metrics_server.reset(new METRICS_SERVER());
+                metrics_server->set_frame_writer(frame_writer.get());
+                if (metrics_server->init(static_cast<unsigned int>(metrics_port)) != 0)
+                {
+                    cerr << "Failed to start metrics endpoint. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.set_metrics_server(metrics_server.get());
+            }
+
+            // --user-set[=UserSet1] -> save the configuration into the cameras' UserSet and boot into it, later startups only load it (--user-set-cache=<file>)
+            USER_SET_CACHE user_set_cache;
+            if (command_line.has("user-set"))
+            {
+                string user_set_name = command_line.get_string("user-set", "");
+                user_set_cache.load(command_line.get_string("user-set-cache", settings_path + ".userset"));
+                camera_manager.set_user_set(user_set_name.empty() ? "UserSet1" : user_set_name, &user_set_cache);
+            }
+
+            // A camera that drops off while streaming is re-opened on its own, the retries here are for a failed startup
+            camera_manager.set_system(system);
+
+            // Node snapshots for a fast reconnect if requested
+            if (!snapshot_dir.empty())
+            {
+                camera_manager.set_snapshot_dir(snapshot_dir);
+            }
+            if (has_failed)
+            {
+                camera_manager.set_reconnect_start(failure_time);
+            }
+
+            // --watch-config -> apply changes of the settings file between the ROI captures, without restarting the acquisition
+            SETTINGS_WATCHER settings_watcher;
+            if (command_line.has("watch-config"))
+            {
+                if (settings_watcher.start(settings_path) != 0)
+                {
+                    cerr << "Failed to watch the settings file. Exiting.\n";
+                    return -1;
+                }
+                camera_manager.set_settings_watcher(&settings_watcher);
+            }
+
             // Run configuration and image acquisition on multiple cameras
-            result |= camera_manager.run_multiple_cameras(cameras, camera_list, number_of_cameras, global_running, folder_path);
+            result |= camera_manager.run_multiple_cameras(cameras, number_of_cameras, global_running, folder_path);
+            settings_watcher.stop();
+
+            if (settings_watcher.get_reload_count() > 0 || settings_watcher.get_rejected_count() > 0)
+            {
+                cout << "[Reload] " << settings_watcher.get_reload_count() << " change(s) of the settings file applied, "
+                     << settings_watcher.get_rejected_count() << " rejected\n";
+            }
+
+            if (segment_recorder)
+            {
+                SEGMENT_RECORDER_STATS stats = segment_recorder->get_stats();
+                cout << "[Recorder] " << stats.frames_recorded << " frames, " << stats.bytes_recorded << " bytes in "
+                     << stats.segments_opened << " segment(s), " << stats.stalls << " stalls, " << stats.errors
+                     << " errors, slowest write " << stats.max_write_ms << " ms\n";
+            }
+
+            if (video_recorder)
+            {
+                VIDEO_RECORDER_STATS stats = video_recorder->get_stats();
+                cout << "[Video] " << stats.frames_recorded << " frames in " << stats.segments_opened << " file(s), "
+                     << stats.stalls << " stalls, " << stats.errors << " errors\n";
+            }
+
+            if (compression_stage)
+            {
+                COMPRESSION_STATS stats = compression_stage->get_stats();
+                cout << "[Compressor] " << stats.frames << " frames, ratio "
+                     << (stats.compressed_bytes > 0 ? static_cast<double>(stats.raw_bytes) / stats.compressed_bytes : 0.0) << ", "
+                     << (stats.cpu_seconds > 0.0 ? stats.raw_bytes / stats.cpu_seconds / (1024.0 * 1024.0) : 0.0) << " MB/s per core, "
+                     << stats.stalls << " stalls, " << stats.errors << " errors\n";
+            }
+
+            if (stream_server)
+            {
+                FRAME_STREAM_STATS stats = stream_server->get_stats();
+                cout << "[Stream] " << stats.clients_accepted << " client(s), " << stats.frames_sent << " frames sent, "
+                     << stats.frames_dropped << " dropped for slow clients\n";
+                stream_server->stop();
+            }
+
+            if (shm_publisher)
+            {
+                cout << "[SHM] " << shm_publisher->get_published_count() << " frames published to " << shm_name << "\n";
+            }
+
+            if (pretrigger_ring)
+            {
+                control_fifo.stop();
+                PRETRIGGER_RING_STATS stats = pretrigger_ring->get_stats();
+                cout << "[Pre-trigger] " << stats.events << " event(s), " << stats.frames_buffered << " frames buffered, "
+                     << stats.frames_flushed << " saved (" << stats.bytes_flushed << " bytes), " << stats.frames_dropped << " dropped\n";
+            }
 
             if (result == 0)
             {
@@ -122,6 +484,11 @@ int main(int argc, char** argv)
         }
 
         cerr << "Retrying due to errors... (" << retries + 1 << "/" << max_retries << ")" << endl;
+        if (!has_failed)
+        {
+            failure_time = chrono::steady_clock::now();   // Measured from the first failure, over every retry
+            has_failed = true;
+        }
         retries++;
         this_thread::sleep_for(chrono::seconds(2)); // Delay before retry
     }